@@ -15,5 +15,10 @@
  */
 typedef ASCellNode * _Nonnull(^ASCellNodeBlock)();
 
+/**
+ * ASCellNode configuration block. Used to set up a node taken from an ASCellNodeReusePool for a specified indexPath.
+ */
+typedef void (^ASCellNodeConfigurationBlock)(__kindof ASCellNode * _Nonnull node);
+
 // Type for the cancellation checker block passed into the async display blocks. YES means the operation has been cancelled, NO means continue.
 typedef BOOL(^asdisplaynode_iscancelled_block_t)(void);
@@ -162,6 +162,17 @@ typedef NS_ENUM(NSUInteger, ASCellNodeVisibilityEvent) {
  */
 - (void)cellNodeVisibilityEvent:(ASCellNodeVisibilityEvent)event inScrollView:(nullable UIScrollView *)scrollView withCellFrame:(CGRect)cellFrame;
 
+/**
+ * @abstract Called when the node goes back to an ASCellNodeReusePool, before it is configured for another row or item.
+ *
+ * @discussion Reset any state that the data source's configuration block doesn't set. The node has already left the
+ *   interface, so its contents have been cleared. The default implementation deselects and unhighlights the node
+ *   and invalidates its calculated layout.
+ *
+ * @see ASCellNodeReusePool
+ */
+- (void)prepareForReuse ASDISPLAYNODE_REQUIRES_SUPER;
+
 #pragma mark - UITableViewCell specific passthrough properties
 
 /* @abstract The selection style when a tap on a cell occurs
@@ -267,6 +267,14 @@
   // To be overriden by subclasses
 }
 
+- (void)prepareForReuse
+{
+  // Skip the interaction delegate, the node no longer belongs to a row or item.
+  _selected = NO;
+  _highlighted = NO;
+  [self invalidateCalculatedLayout];
+}
+
 - (void)didEnterVisibleState
 {
   [super didEnterVisibleState];
@@ -19,7 +19,7 @@
 @protocol ASCollectionViewLayoutFacilitatorProtocol;
 @protocol ASCollectionDelegate;
 @protocol ASCollectionDataSource;
-@class ASCollectionView;
+@class ASCollectionView, ASAdaptiveRangePolicy, ASSnapshot;
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -151,6 +151,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)setTuningParameters:(ASRangeTuningParameters)tuningParameters forRangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType;
 
+/**
+ * A policy that scales the display and preload ranges in full mode with scroll speed and measured latency, within
+ * the policy's bounds. Defaults to nil, which uses the tuning parameters unchanged.
+ *
+ * @see ASAdaptiveRangePolicy
+ */
+@property (nonatomic, strong, nullable) ASAdaptiveRangePolicy *adaptiveRangePolicy;
+
 /**
  * Scrolls the collection to the given item.
  *
@@ -199,6 +207,29 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)performBatchUpdates:(nullable AS_NOESCAPE void (^)())updates completion:(nullable void (^)(BOOL finished))completion;
 
+/**
+ * Updates the collection to match the given snapshot. The snapshot is diffed against the previously applied one off the
+ * main thread, and the result is performed as a batch update, so only the inserted, reloaded and moved items are
+ * measured. This method must be called from the main thread.
+ *
+ * @param snapshot The sections and items the collection should contain.
+ * @param animated NO to disable animations for this batch.
+ * @param updates Called on the main thread inside the batch update. Switch the data source over to the data the
+ *   snapshot describes here; until then it must keep describing the previous snapshot's data.
+ * @param completion Called on the main thread when the batch update finishes.
+ *
+ * @discussion The first snapshot reloads the collection. Snapshots are applied in the order they're passed in. Don't mix
+ * snapshots with other edits or reloads, since the next diff would be against stale data.
+ *
+ * @see ASSnapshot
+ */
+- (void)applySnapshot:(ASSnapshot *)snapshot animated:(BOOL)animated updates:(nullable void (^)())updates completion:(nullable void (^)(BOOL finished))completion;
+
+/**
+ * The snapshot the collection currently matches, i.e. the last one whose updates block has run.
+ */
+@property (nonatomic, strong, readonly, nullable) ASSnapshot *currentSnapshot;
+
 /**
  *  Blocks execution of the main thread until all section and item updates are committed to the view. This method must be called from the main thread.
  */
@@ -489,6 +520,31 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (ASCellNode *)collectionNode:(ASCollectionNode *)collectionNode nodeForItemAtIndexPath:(NSIndexPath *)indexPath;
 
+/**
+ * Asks the data source whether the item at the given index path should use a reusable node, and of what class.
+ * Implement this together with -collectionNode:nodeConfigurationBlockForItemAtIndexPath: to opt in to node reuse.
+ *
+ * @param collectionNode The sender.
+ * @param indexPath The index path of the item.
+ *
+ * @return The class of the node, created with -init when the reuse pool has none, or nil to use the node block
+ *   for this item. The class should override -[ASCellNode prepareForReuse] to reset its state.
+ *
+ * @see ASCellNodeReusePool
+ */
+- (nullable Class)collectionNode:(ASCollectionNode *)collectionNode reusableNodeClassForItemAtIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ * Asks the data source for a block to set up a reusable node for the item at the given index path. The node is
+ * either new or was used by a deleted item. Like node blocks, the block is run concurrently in the background.
+ *
+ * @param collectionNode The sender.
+ * @param indexPath The index path of the item.
+ *
+ * @return a block that configures the node for display for this item. Must be thread-safe.
+ */
+- (ASCellNodeConfigurationBlock)collectionNode:(ASCollectionNode *)collectionNode nodeConfigurationBlockForItemAtIndexPath:(NSIndexPath *)indexPath;
+
 /**
  * Asks the data source to provide a node-block to display for the given supplementary element in the collection view.
  *
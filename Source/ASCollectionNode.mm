@@ -29,6 +29,7 @@
 #import <AsyncDisplayKit/ASCollectionView+Undeprecated.h>
 #import <AsyncDisplayKit/ASThread.h>
 #import <AsyncDisplayKit/ASRangeController.h>
+#import <AsyncDisplayKit/ASSnapshot.h>
 
 #pragma mark - _ASCollectionPendingState
 
@@ -104,6 +105,8 @@
 {
   ASDN::RecursiveMutex _environmentStateLock;
   Class _collectionViewClass;
+  // The snapshot the collection will match once all pending diffs are performed.
+  ASSnapshot *_targetSnapshot;
 }
 @property (nonatomic) _ASCollectionPendingState *pendingState;
 @end
@@ -419,6 +422,16 @@
   return [self.rangeController setTuningParameters:tuningParameters forRangeMode:rangeMode rangeType:rangeType];
 }
 
+- (ASAdaptiveRangePolicy *)adaptiveRangePolicy
+{
+  return self.rangeController.adaptiveRangePolicy;
+}
+
+- (void)setAdaptiveRangePolicy:(ASAdaptiveRangePolicy *)adaptiveRangePolicy
+{
+  self.rangeController.adaptiveRangePolicy = adaptiveRangePolicy;
+}
+
 #pragma mark - Selection
 
 - (NSArray<NSIndexPath *> *)indexPathsForSelectedItems
@@ -578,6 +591,68 @@
   [self performBatchAnimated:UIView.areAnimationsEnabled updates:updates completion:completion];
 }
 
+- (void)applySnapshot:(ASSnapshot *)snapshot animated:(BOOL)animated updates:(void (^)())updates completion:(void (^)(BOOL))completion
+{
+  ASDisplayNodeAssertMainThread();
+  ASSnapshot *previousSnapshot = _targetSnapshot;
+  _targetSnapshot = snapshot;
+
+  // Without a previous snapshot there's nothing to diff against, and an unloaded node reads everything on load.
+  if (previousSnapshot == nil || !self.nodeLoaded) {
+    _currentSnapshot = snapshot;
+    if (updates) {
+      updates();
+    }
+    if (!self.nodeLoaded) {
+      if (completion) {
+        completion(YES);
+      }
+      return;
+    }
+    [self reloadDataWithCompletion:^{
+      if (completion) {
+        completion(YES);
+      }
+    }];
+    return;
+  }
+
+  [ASSnapshotDiff diffFromSnapshot:previousSnapshot toSnapshot:snapshot completion:^(ASSnapshotDiff *diff) {
+    [self performBatchAnimated:animated updates:^{
+      _currentSnapshot = snapshot;
+      if (updates) {
+        updates();
+      }
+      [self _performSnapshotDiff:diff];
+    } completion:completion];
+  }];
+}
+
+- (void)_performSnapshotDiff:(ASSnapshotDiff *)diff
+{
+  if (diff.deletedSections.count > 0) {
+    [self deleteSections:diff.deletedSections];
+  }
+  if (diff.insertedSections.count > 0) {
+    [self insertSections:diff.insertedSections];
+  }
+  [diff.movedSections enumerateKeysAndObjectsUsingBlock:^(NSNumber *section, NSNumber *newSection, BOOL *stop) {
+    [self moveSection:section.integerValue toSection:newSection.integerValue];
+  }];
+  if (diff.deletedItems.count > 0) {
+    [self deleteItemsAtIndexPaths:diff.deletedItems];
+  }
+  if (diff.insertedItems.count > 0) {
+    [self insertItemsAtIndexPaths:diff.insertedItems];
+  }
+  if (diff.reloadedItems.count > 0) {
+    [self reloadItemsAtIndexPaths:diff.reloadedItems];
+  }
+  [diff.movedItems enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, NSIndexPath *newIndexPath, BOOL *stop) {
+    [self moveItemAtIndexPath:indexPath toIndexPath:newIndexPath];
+  }];
+}
+
 - (void)waitUntilAllUpdatesAreCommitted
 {
   ASDisplayNodeAssertMainThread();
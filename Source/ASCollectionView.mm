@@ -96,6 +96,8 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
   NSMutableSet *_registeredSupplementaryKinds;
   
   CGPoint _deceleratingVelocity;
+  CGPoint _deceleratingTargetContentOffset;
+  ASBatchFetchingVelocityEstimate _scrollVelocityEstimate;
 
   BOOL _zeroContentInsets;
   
@@ -194,6 +196,7 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
     unsigned int collectionViewNumberOfItemsInSection:1;
     unsigned int collectionNodeNodeForItem:1;
     unsigned int collectionNodeNodeBlockForItem:1;
+    unsigned int collectionNodeReusableNodeForItem:1; // if both reusable node methods are implemented
     unsigned int collectionNodeNodeForSupplementaryElement:1;
     unsigned int collectionNodeNodeBlockForSupplementaryElement:1;
     unsigned int collectionNodeSupplementaryElementKindsInSection:1;
@@ -431,6 +434,7 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
 
     _asyncDataSourceFlags.collectionNodeNodeForItem = [_asyncDataSource respondsToSelector:@selector(collectionNode:nodeForItemAtIndexPath:)];
     _asyncDataSourceFlags.collectionNodeNodeBlockForItem = [_asyncDataSource respondsToSelector:@selector(collectionNode:nodeBlockForItemAtIndexPath:)];
+    _asyncDataSourceFlags.collectionNodeReusableNodeForItem = [_asyncDataSource respondsToSelector:@selector(collectionNode:reusableNodeClassForItemAtIndexPath:)] && [_asyncDataSource respondsToSelector:@selector(collectionNode:nodeConfigurationBlockForItemAtIndexPath:)];
     _asyncDataSourceFlags.numberOfSectionsInCollectionNode = [_asyncDataSource respondsToSelector:@selector(numberOfSectionsInCollectionNode:)];
     _asyncDataSourceFlags.collectionNodeNumberOfItemsInSection = [_asyncDataSource respondsToSelector:@selector(collectionNode:numberOfItemsInSection:)];
     _asyncDataSourceFlags.collectionNodeContextForSection = [_asyncDataSource respondsToSelector:@selector(collectionNode:contextForSection:)];
@@ -1311,6 +1315,8 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
 
 - (void)scrollViewDidScroll:(UIScrollView *)scrollView
 {
+  ASBatchFetchingVelocityEstimateAddSample(&_scrollVelocityEstimate, scrollView.contentOffset, CACurrentMediaTime());
+
   // If a scroll happenes the current range mode needs to go to full
   ASInterfaceState interfaceState = [self interfaceStateForRangeController:_rangeController];
   if (ASInterfaceStateIncludesVisible(interfaceState)) {
@@ -1337,14 +1343,18 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
     contentOffset.y - ((targetContentOffset != NULL) ? targetContentOffset->y : 0)
   );
 
-  if (targetContentOffset != NULL) {
-    ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
-    [self _beginBatchFetchingIfNeededWithContentOffset:*targetContentOffset];
-  }
-  
   if (_asyncDelegateFlags.scrollViewWillEndDragging) {
     [_asyncDelegate scrollViewWillEndDragging:scrollView withVelocity:velocity targetContentOffset:(targetContentOffset ? : &contentOffset)];
   }
+
+  // Check after the delegate, which may have moved the target, e.g. for paging.
+  if (targetContentOffset != NULL) {
+    ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
+    _deceleratingTargetContentOffset = *targetContentOffset;
+    // UIKit gives the release velocity in points per millisecond.
+    CGPoint releaseVelocity = CGPointMake(velocity.x * 1000.0, velocity.y * 1000.0);
+    [self _beginBatchFetchingIfNeededWithContentOffset:_deceleratingTargetContentOffset velocity:releaseVelocity];
+  }
 }
 
 - (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView
@@ -1514,12 +1524,18 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
     return;
   }
   
-  [self _beginBatchFetchingIfNeededWithContentOffset:self.contentOffset];
+  // While decelerating, the scroll view comes to rest at the target it was given when dragging ended, so measure the
+  // remaining distance from there. The decaying velocity still widens the trigger while the fling is fast.
+  if (self.isDecelerating) {
+    [self _beginBatchFetchingIfNeededWithContentOffset:_deceleratingTargetContentOffset velocity:_scrollVelocityEstimate.velocity];
+  } else {
+    [self _beginBatchFetchingIfNeededWithContentOffset:self.contentOffset velocity:CGPointZero];
+  }
 }
 
-- (void)_beginBatchFetchingIfNeededWithContentOffset:(CGPoint)contentOffset
+- (void)_beginBatchFetchingIfNeededWithContentOffset:(CGPoint)contentOffset velocity:(CGPoint)velocity
 {
-  if (ASDisplayShouldFetchBatchForScrollView(self, self.scrollDirection, self.scrollableDirections, contentOffset)) {
+  if (ASDisplayShouldFetchBatchForScrollView(self, self.scrollDirection, self.scrollableDirections, contentOffset, velocity)) {
     [self _beginBatchFetching];
   }
 }
@@ -1604,6 +1620,36 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
   return block;
 }
 
+- (Class)dataController:(ASDataController *)dataController reusableNodeClassAtIndexPath:(NSIndexPath *)indexPath
+{
+  if (!_asyncDataSourceFlags.collectionNodeReusableNodeForItem) {
+    return Nil;
+  }
+  GET_COLLECTIONNODE_OR_RETURN(collectionNode, Nil);
+  return [_asyncDataSource collectionNode:collectionNode reusableNodeClassForItemAtIndexPath:indexPath];
+}
+
+- (ASCellNodeConfigurationBlock)dataController:(ASDataController *)dataController nodeConfigurationBlockAtIndexPath:(NSIndexPath *)indexPath
+{
+  ASCellNodeConfigurationBlock block = nil;
+  if (ASCollectionNode *collectionNode = self.collectionNode) {
+    block = [_asyncDataSource collectionNode:collectionNode nodeConfigurationBlockForItemAtIndexPath:indexPath];
+  }
+
+  // Wrap the configuration block like node blocks, since new nodes come straight from the reuse pool
+  __weak __typeof__(self) weakSelf = self;
+  return ^(ASCellNode *node) {
+    __typeof__(self) strongSelf = weakSelf;
+    if (block != nil) {
+      block(node);
+    }
+    [node enterHierarchyState:ASHierarchyStateRangeManaged];
+    // Reused nodes may come from another table or collection, so don't keep what it set.
+    node.interactionDelegate = strongSelf;
+    node.transform = (_inverted ? CATransform3DMakeScale(1, -1, 1) : CATransform3DIdentity);
+  };
+}
+
 - (NSUInteger)dataController:(ASDataController *)dataController rowsInSection:(NSUInteger)section
 {
   if (_asyncDataSourceFlags.collectionNodeNumberOfItemsInSection) {
@@ -1815,6 +1861,25 @@ static NSString * const kReuseIdentifier = @"_ASCollectionReuseIdentifier";
   return self.scrollDirection;
 }
 
+- (CGFloat)scrollSpeedForRangeController:(ASRangeController *)rangeController
+{
+  // The estimate is only updated while scrolling, so it goes stale once the scroll view comes to rest.
+  if (!self.isTracking && !self.isDecelerating) {
+    return 0;
+  }
+  CGPoint velocity = _scrollVelocityEstimate.velocity;
+  CGSize size = self.bounds.size;
+  ASScrollDirection scrollableDirections = [self scrollableDirections];
+  CGFloat speed = 0;
+  if (ASScrollDirectionContainsHorizontalDirection(scrollableDirections) && size.width > 0) {
+    speed = MAX(speed, ABS(velocity.x) / size.width);
+  }
+  if (ASScrollDirectionContainsVerticalDirection(scrollableDirections) && size.height > 0) {
+    speed = MAX(speed, ABS(velocity.y) / size.height);
+  }
+  return speed;
+}
+
 - (ASInterfaceState)interfaceStateForRangeController:(ASRangeController *)rangeController
 {
   return ASInterfaceStateForDisplayNode(self.collectionNode, self.window);
@@ -51,6 +51,21 @@ typedef struct {
   NSInteger layoutComputationNumberOfPasses;
 } ASDisplayNodePerformanceMeasurements;
 
+/**
+ * How a node applies its cornerRadius, see -cornerRoundingType.
+ */
+typedef NS_ENUM(NSInteger, ASCornerRoundingType) {
+  /// The layer's cornerRadius. Combined with clipsToBounds, this makes the compositor render the node offscreen on
+  /// every frame.
+  ASCornerRoundingTypeDefaultSlowCALayer,
+  /// The corners, background color and border are drawn into the node's contents, leaving the corners transparent.
+  /// Only applies to nodes that draw; others use the layer's cornerRadius.
+  ASCornerRoundingTypePrecomposited,
+  /// The corners are covered by an overlay of clipCornerColor, which should match what is behind the node. Suits nodes
+  /// that don't draw, such as containers, but cuts off the corners of layer borders.
+  ASCornerRoundingTypeClipping,
+};
+
 @interface ASDisplayNode (Beta)
 
 /**
@@ -150,6 +165,42 @@ typedef struct {
  */
 @property (nonatomic, assign) BOOL shouldRasterizeDescendants ASDISPLAYNODE_DEPRECATED_MSG("Deprecated in version 2.2");
 
+/**
+ * @abstract Whether a node rasterizing its descendants only redraws the descendants that changed.
+ *
+ * @discussion When set to YES, each rasterized descendant keeps an image of what it drew, and calling -setNeedsDisplay
+ * on one of them redraws only that descendant. Its image is composited into the previous backing store of this node,
+ * within the area it covers. Layout, visibility and background changes of descendants still redraw the whole subtree,
+ * reusing the images of descendants that didn't change. Defaults to NO.
+ *
+ * This suits cells that rasterize many static nodes along with one that updates often, such as a counter. It costs
+ * a backing store for each drawing descendant and for the previous contents of this node, which are released when this
+ * node's contents are cleared. Descendants drawing with blend modes other than normal may render differently.
+ */
+@property (nonatomic, assign) BOOL rasterizesDescendantsIncrementally;
+
+/**
+ * @abstract How the node rounds its corners. Defaults to ASCornerRoundingTypeDefaultSlowCALayer.
+ *
+ * @discussion With ASCornerRoundingTypePrecomposited, cornerRadius, backgroundColor, borderWidth and borderColor aren't
+ * applied to the layer. The display block fills the background within the rounded bounds, clips the node's drawing
+ * to them and strokes the border inside them, so clipsToBounds isn't needed for the contents to be rounded. Changing
+ * any of those properties redraws the node. Inside a container that rasterizes its descendants, the node is clipped
+ * to its rounded bounds and filled with its background color, but like the layer borders of other rasterized nodes,
+ * its border isn't drawn.
+ *
+ * With ASCornerRoundingTypeClipping, cornerRadius isn't applied to the layer either. Instead, four small layers on
+ * top of the node's sublayers paint clipCornerColor outside of the rounded bounds. They share a single image per
+ * radius and color.
+ */
+@property (nonatomic, assign) ASCornerRoundingType cornerRoundingType;
+
+/**
+ * @abstract The color of the corner overlay of ASCornerRoundingTypeClipping, typically the supernode's background
+ * color. Defaults to nil, which disables the overlay.
+ */
+@property (nonatomic, strong, nullable) UIColor *clipCornerColor;
+
 @end
 
 #pragma mark - Yoga Layout Support
@@ -28,7 +28,10 @@
 #import <AsyncDisplayKit/_ASScopeTimer.h>
 #import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
 #import <AsyncDisplayKit/ASEqualityHelpers.h>
+#import <AsyncDisplayKit/ASGraphicsBufferPool.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 #import <AsyncDisplayKit/ASLayoutElementStylePrivate.h>
 #import <AsyncDisplayKit/ASLayoutSpec.h>
@@ -557,6 +560,8 @@ static ASDisplayNodeMethodOverrides GetASDisplayNodeMethodOverrides(Class c)
     _layer.delegate = nil;
   [_layer removeFromSuperlayer];
   _layer = nil;
+  // The next locked read or write publishes the values read back into the new pending state.
+  _bridgedPropertySnapshot.invalidate();
 }
 
 - (BOOL)_locked_shouldLoadViewOrLayer
@@ -644,6 +649,9 @@ static ASDisplayNodeMethodOverrides GetASDisplayNodeMethodOverrides(Class c)
   _layer.asyncdisplaykit_node = self;
   
   self._locked_asyncLayer.asyncDelegate = self;
+
+  // From now on, bridged properties are read from the view or layer.
+  _bridgedPropertySnapshot.invalidate();
 }
 
 - (void)_didLoad
@@ -653,6 +661,12 @@ static ASDisplayNodeMethodOverrides GetASDisplayNodeMethodOverrides(Class c)
   ASDisplayNodeLogEvent(self, @"didLoad");
   TIME_SCOPED(_debugTimeForDidLoad);
   
+  __instanceLock__.lock();
+    BOOL needsClipCornerLayerUpdate = [self _locked_needsClipCornerLayerUpdate];
+  __instanceLock__.unlock();
+  if (needsClipCornerLayerUpdate) {
+    [self _updateClipCornerLayers];
+  }
   [self didLoad];
   
   __instanceLock__.lock();
@@ -988,6 +1002,7 @@ ASLayoutElementFinalLayoutElementDefault
   ASDisplayNodeAssertThreadAffinity(self);
   ASDisplayNodeAssertLockUnownedByCurrentThread(__instanceLock__);
   
+  BOOL needsClipCornerLayerUpdate = NO;
   {
     ASDN::MutexLocker l(__instanceLock__);
     CGRect bounds = _threadSafeBounds;
@@ -1012,11 +1027,15 @@ ASLayoutElementFinalLayoutElementDefault
     _pendingDisplayNodeLayout = nullptr;
     
     [self _locked_layoutPlaceholderIfNecessary];
+    needsClipCornerLayerUpdate = [self _locked_needsClipCornerLayerUpdate];
   }
   
   [self _layoutSublayouts];
   
   ASPerformBlockOnMainThread(^{
+    if (needsClipCornerLayerUpdate) {
+      [self _updateClipCornerLayers];
+    }
     [self layout];
     [self layoutDidFinish];
   });
@@ -1144,7 +1163,11 @@ ASLayoutElementFinalLayoutElementDefault
 {
   ASSizeRange styleAndParentSize = ASLayoutElementSizeResolve(self.style.size, parentSize);
   const ASSizeRange resolvedRange = ASSizeRangeIntersect(constrainedSize, styleAndParentSize);
-  return [self calculateLayoutThatFits:resolvedRange];
+  ASDN::TraceScope traceScope(ASTraceSpanLayout, [self class]);
+  CFTimeInterval startTime = CACurrentMediaTime();
+  ASLayout *layout = [self calculateLayoutThatFits:resolvedRange];
+  ASDisplayTelemetryRecordDuration([self class], ASDisplayTelemetryMetricLayoutTime, CACurrentMediaTime() - startTime);
+  return layout;
 }
 
 - (ASLayout *)calculateLayoutThatFits:(ASSizeRange)constrainedSize
@@ -2017,6 +2040,186 @@ NSString * const ASRenderingEngineDidDisplayNodesScheduledBeforeTimestamp = @"AS
   }
 }
 
+- (BOOL)rasterizesDescendantsIncrementally
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _flags.rasterizesDescendantsIncrementally;
+}
+
+- (void)setRasterizesDescendantsIncrementally:(BOOL)rasterizesDescendantsIncrementally
+{
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    if (_flags.rasterizesDescendantsIncrementally == rasterizesDescendantsIncrementally) {
+      return;
+    }
+    _flags.rasterizesDescendantsIncrementally = rasterizesDescendantsIncrementally;
+  }
+
+  if (!rasterizesDescendantsIncrementally) {
+    ASPerformBlockOnMainThread(^{
+      [self _clearRasterizationCaches];
+    });
+  }
+}
+
+#pragma mark - Corner Rounding
+
+- (ASCornerRoundingType)cornerRoundingType
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _cornerRoundingType;
+}
+
+- (void)setCornerRoundingType:(ASCornerRoundingType)cornerRoundingType
+{
+  CGFloat cornerRadius;
+  UIColor *backgroundColor;
+  CGFloat borderWidth;
+  UIColor *borderColor;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    if (_cornerRoundingType == cornerRoundingType) {
+      return;
+    }
+    cornerRadius = self.cornerRadius;
+    backgroundColor = self.backgroundColor;
+    borderWidth = self.borderWidth;
+    CGColorRef borderCGColor = self.borderColor;
+    borderColor = borderCGColor ? [UIColor colorWithCGColor:borderCGColor] : nil;
+  }
+
+  // Take the values from where the current type applies them, and hand them to the new one.
+  self.cornerRadius = 0;
+  self.backgroundColor = nil;
+  self.borderWidth = 0;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    _cornerRoundingType = cornerRoundingType;
+  }
+  self.cornerRadius = cornerRadius;
+  self.backgroundColor = backgroundColor;
+  self.borderWidth = borderWidth;
+  self.borderColor = borderColor.CGColor;
+
+  [self setNeedsDisplay];
+  ASPerformBlockOnMainThread(^{
+    [self _updateClipCornerLayers];
+  });
+}
+
+- (UIColor *)clipCornerColor
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _clipCornerColor;
+}
+
+- (void)setClipCornerColor:(UIColor *)clipCornerColor
+{
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    if (ASObjectIsEqual(_clipCornerColor, clipCornerColor)) {
+      return;
+    }
+    _clipCornerColor = clipCornerColor;
+  }
+  ASPerformBlockOnMainThread(^{
+    [self _updateClipCornerLayers];
+  });
+}
+
+- (BOOL)_locked_precompositesCorners
+{
+  return _cornerRoundingType == ASCornerRoundingTypePrecomposited
+      && (_flags.implementsDrawRect || _flags.implementsImageDisplay || _flags.implementsInstanceDrawRect || _flags.implementsInstanceImageDisplay);
+}
+
+- (BOOL)_locked_needsClipCornerLayerUpdate
+{
+  return _cornerRoundingType == ASCornerRoundingTypeClipping || _clipCornerLayers[0] != nil;
+}
+
+/**
+ * Returns an image of the given color with a transparent circle inscribed, whose quarters are the clip corners.
+ */
+static UIImage *ASClipCornerImage(CGFloat cornerRadius, UIColor *color, CGFloat scale)
+{
+  static NSCache<NSArray *, UIImage *> *__imageCache = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    __imageCache = [[NSCache alloc] init];
+    // Apps tend to use few radii and colors, these images are small.
+    __imageCache.countLimit = 20;
+  });
+
+  NSArray *key = @[ @(cornerRadius), color, @(scale) ];
+  UIImage *image = [__imageCache objectForKey:key];
+  if (image == nil) {
+    CGRect bounds = CGRectMake(0, 0, cornerRadius * 2, cornerRadius * 2);
+    ASGraphicsBeginImageContextWithOptions(bounds.size, NO, scale);
+    [color setFill];
+    UIRectFill(bounds);
+    [[UIBezierPath bezierPathWithOvalInRect:bounds] fillWithBlendMode:kCGBlendModeClear alpha:1];
+    image = ASGraphicsGetImageAndEndCurrentContext();
+    if (image != nil) {
+      [__imageCache setObject:image forKey:key];
+    }
+  }
+  return image;
+}
+
+- (void)_updateClipCornerLayers
+{
+  ASDisplayNodeAssertMainThread();
+  CALayer *layer;
+  CGFloat cornerRadius;
+  UIColor *clipCornerColor;
+  BOOL showsCorners;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    layer = _layer;
+    cornerRadius = _cornerRadius;
+    clipCornerColor = _clipCornerColor;
+    showsCorners = (_cornerRoundingType == ASCornerRoundingTypeClipping && layer != nil && cornerRadius > 0 && clipCornerColor != nil);
+  }
+
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  if (showsCorners) {
+    CGRect bounds = layer.bounds;
+    // Like the layer's cornerRadius, the radius is limited to half of the shortest side.
+    cornerRadius = MIN(cornerRadius, MIN(bounds.size.width, bounds.size.height) / 2);
+    UIImage *image = ASClipCornerImage(cornerRadius, clipCornerColor, ASScreenScale());
+    for (NSUInteger i = 0; i < 4; i++) {
+      CALayer *cornerLayer = _clipCornerLayers[i];
+      if (cornerLayer == nil) {
+        cornerLayer = [CALayer layer];
+        // Stay on top of the layers of subnodes added later.
+        cornerLayer.zPosition = 99999;
+        ASDN::MutexLocker l(__instanceLock__);
+        _clipCornerLayers[i] = cornerLayer;
+      }
+      if (cornerLayer.superlayer != layer) {
+        [layer addSublayer:cornerLayer];
+      }
+      BOOL isRight = (i % 2 == 1), isBottom = (i >= 2);
+      cornerLayer.contents = (id)image.CGImage;
+      cornerLayer.contentsScale = image.scale;
+      cornerLayer.contentsRect = CGRectMake(isRight ? 0.5 : 0, isBottom ? 0.5 : 0, 0.5, 0.5);
+      cornerLayer.frame = CGRectMake(isRight ? CGRectGetMaxX(bounds) - cornerRadius : CGRectGetMinX(bounds),
+                                     isBottom ? CGRectGetMaxY(bounds) - cornerRadius : CGRectGetMinY(bounds),
+                                     cornerRadius, cornerRadius);
+    }
+  } else {
+    for (NSUInteger i = 0; i < 4; i++) {
+      [_clipCornerLayers[i] removeFromSuperlayer];
+      ASDN::MutexLocker l(__instanceLock__);
+      _clipCornerLayers[i] = nil;
+    }
+  }
+  [CATransaction commit];
+}
+
 - (CGFloat)contentsScaleForDisplay
 {
   ASDN::MutexLocker l(__instanceLock__);
@@ -2221,6 +2424,7 @@ void recursivelyTriggerDisplayForLayer(CALayer *layer, BOOL shouldBlock)
 
 - (void)recursivelyEnsureDisplaySynchronously:(BOOL)synchronously
 {
+  ASDN::TraceScope traceScope(ASTraceSpanEnsureDisplay, [self class]);
   [self _recursivelyTriggerDisplayAndBlock:synchronously];
 }
 
@@ -2342,6 +2546,9 @@ static const char *ASDisplayNodeDrawingPriorityKey = "ASDrawingPriority";
     _flags.hasCustomDrawingPriority = YES;
     objc_setAssociatedObject(self, ASDisplayNodeDrawingPriorityKey, @(drawingPriority), OBJC_ASSOCIATION_RETAIN);
   }
+
+  // Requeue a display that is waiting for a drawing thread.
+  [_ASAsyncTransaction setPriority:drawingPriority ofOperationWithHandle:_pendingDisplayOperation.load()];
 }
 
 - (NSInteger)drawingPriority
@@ -3620,6 +3827,8 @@ ASDISPLAYNODE_INLINE BOOL nodeIsInRasterizedTree(ASDisplayNode *node) {
 
   if (nowVisible != wasVisible) {
     if (nowVisible) {
+      // A display that is still waiting should go ahead of displays of equal priority for nodes that are offscreen.
+      [_ASAsyncTransaction prioritizeOperationWithHandle:_pendingDisplayOperation.load()];
       [self didEnterVisibleState];
     } else {
       [self didExitVisibleState];
@@ -3761,6 +3970,8 @@ ASDISPLAYNODE_INLINE BOOL nodeIsInRasterizedTree(ASDisplayNode *node) {
   
   _placeholderLayer.contents = nil;
   _placeholderImage = nil;
+
+  [self _clearRasterizationCaches];
 }
 
 - (void)recursivelyClearContents
@@ -12,6 +12,10 @@
 
 #import <AsyncDisplayKit/ASImageNode.h>
 
+#import <tgmath.h>
+
+#import <AsyncDisplayKit/ASAnimatedImageDriver.h>
+#import <AsyncDisplayKit/ASAnimatedImageFrameBuffer.h>
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASBaseDefines.h>
 #import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
@@ -22,7 +26,6 @@
 #import <AsyncDisplayKit/ASImageProtocols.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 #import <AsyncDisplayKit/ASNetworkImageNode.h>
-#import <AsyncDisplayKit/ASWeakProxy.h>
 
 #define ASAnimatedImageDebug  0
 
@@ -30,8 +33,16 @@
 - (void)_locked_setDefaultImage:(UIImage *)image;
 @end
 
+@interface ASImageNode (AnimatedImageDriver) <ASAnimatedImageDriverClient>
+@end
+
 NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
 
+/// Frames kept predecoded ahead of the play head while visible. The frame buffer caps this by bytes.
+static const NSUInteger kASAnimatedImageVisibleLookaheadFrameCount = 16;
+/// While about to become visible, only the first frames are worth decoding.
+static const NSUInteger kASAnimatedImageDisplayLookaheadFrameCount = 2;
+
 @implementation ASImageNode (AnimatedImage)
 
 #pragma mark - GIF support
@@ -49,6 +60,10 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
   }
   
   _animatedImage = animatedImage;
+
+  [_frameBuffer setLookaheadFrameCount:0 startingAtIndex:0 forConsumer:self];
+  _frameBuffer = (animatedImage != nil) ? [ASAnimatedImageFrameBuffer frameBufferForAnimatedImage:animatedImage] : nil;
+  [self _locked_updateFrameBufferLookaheadStartingAtIndex:0];
   
   if (animatedImage != nil) {
     __weak ASImageNode *weakSelf = self;
@@ -100,7 +115,7 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
 - (void)_locked_setCoverImageCompleted:(UIImage *)coverImage
 {
   _displayLinkLock.lock();
-  BOOL setCoverImage = (_displayLink == nil) || _displayLink.paused;
+  BOOL setCoverImage = (_animating == NO);
   _displayLinkLock.unlock();
   
   if (setCoverImage) {
@@ -139,9 +154,8 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
     runLoopMode = ASAnimatedImageDefaultRunLoopMode;
   }
 
-  if (_displayLink != nil) {
-    [_displayLink removeFromRunLoop:[NSRunLoop mainRunLoop] forMode:_animatedImageRunLoopMode];
-    [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:runLoopMode];
+  if (_animating) {
+    [[ASAnimatedImageDriver sharedDriver] addClient:self runLoopMode:runLoopMode];
   }
   _animatedImageRunLoopMode = runLoopMode;
 }
@@ -205,15 +219,16 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
 #endif
 
   ASDN::MutexLocker l(_displayLinkLock);
-  if (_displayLink == nil) {
+  if (_animating) {
+    return;
+  }
+  if (_animationStarted == NO) {
     _playHead = 0;
-    _displayLink = [CADisplayLink displayLinkWithTarget:[ASWeakProxy weakProxyWithTarget:self] selector:@selector(displayLinkFired:)];
-    _displayLink.frameInterval = self.animatedImage.frameInterval;
-    
-    [_displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:_animatedImageRunLoopMode];
-  } else {
-    _displayLink.paused = NO;
+    _animationStarted = YES;
   }
+  _animating = YES;
+  _displayedFrameBuffer = nil;
+  [[ASAnimatedImageDriver sharedDriver] addClient:self runLoopMode:_animatedImageRunLoopMode];
 }
 
 - (void)stopAnimating
@@ -233,12 +248,41 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
 #endif
   ASDisplayNodeAssertMainThread();
   ASDN::MutexLocker l(_displayLinkLock);
-  _displayLink.paused = YES;
+  if (_animating) {
+    [[ASAnimatedImageDriver sharedDriver] removeClient:self];
+    _animating = NO;
+  }
   self.lastDisplayLinkFire = 0;
   
   [_animatedImage clearAnimatedImageCache];
 }
 
+#pragma mark - Frame Buffer
+
+- (void)_locked_updateFrameBufferLookaheadStartingAtIndex:(NSUInteger)index
+{
+  if (_frameBuffer == nil) {
+    return;
+  }
+
+  ASInterfaceState interfaceState = self.interfaceState;
+  NSUInteger lookaheadFrameCount = 0;
+  if (ASInterfaceStateIncludesVisible(interfaceState)) {
+    lookaheadFrameCount = kASAnimatedImageVisibleLookaheadFrameCount;
+  } else if (ASInterfaceStateIncludesDisplay(interfaceState)) {
+    lookaheadFrameCount = kASAnimatedImageDisplayLookaheadFrameCount;
+  }
+  [_frameBuffer setLookaheadFrameCount:lookaheadFrameCount startingAtIndex:index forConsumer:self];
+}
+
+- (void)_updateFrameBufferLookahead
+{
+  ASDisplayNodeAssertMainThread();
+  ASDN::MutexLocker l(_animatedImageLock);
+  NSUInteger index = (_animatedImage.playbackReady ? [_frameBuffer frameIndexAtPlayHead:_playHead] : 0);
+  [self _locked_updateFrameBufferLookaheadStartingAtIndex:index];
+}
+
 #pragma mark - ASDisplayNode
 
 - (void)didEnterVisibleState
@@ -249,6 +293,7 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
   if (self.animatedImage.coverImageReady) {
     [self setCoverImage:self.animatedImage.coverImage];
   }
+  [self _updateFrameBufferLookahead];
   [self startAnimating];
 }
 
@@ -258,11 +303,49 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
   [super didExitVisibleState];
   
   [self stopAnimating];
+  [self _updateFrameBufferLookahead];
+}
+
+- (void)didEnterDisplayState
+{
+  ASDisplayNodeAssertMainThread();
+  [super didEnterDisplayState];
+
+  [self _updateFrameBufferLookahead];
+}
+
+- (void)didExitDisplayState
+{
+  ASDisplayNodeAssertMainThread();
+  [super didExitDisplayState];
+
+  [self _updateFrameBufferLookahead];
 }
 
-#pragma mark - Display Link Callbacks
++ (ASAnimatedImagePlaybackMetrics)animatedImagePlaybackMetrics
+{
+  return [[ASAnimatedImageDriver sharedDriver] metrics];
+}
 
-- (void)displayLinkFired:(CADisplayLink *)displayLink
++ (void)resetAnimatedImagePlaybackMetrics
+{
+  [[ASAnimatedImageDriver sharedDriver] resetMetrics];
+}
+
+- (NSUInteger)frameIndexAtPlayHeadPosition:(CFTimeInterval)playHead
+{
+  ASDisplayNodeAssertMainThread();
+  ASDN::MutexLocker l(_animatedImageLock);
+  return [_frameBuffer frameIndexAtPlayHead:playHead];
+}
+
+@end
+
+#pragma mark - ASImageNode(AnimatedImageDriver)
+
+@implementation ASImageNode (AnimatedImageDriver)
+
+- (ASAnimatedImageDriverTickResult)animatedImageDriverTickWithTimestamp:(CFTimeInterval)timestamp
 {
   ASDisplayNodeAssertMainThread();
 
@@ -270,48 +353,56 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
   if (self.lastDisplayLinkFire == 0) {
     timeBetweenLastFire = 0;
   } else {
-    timeBetweenLastFire = CACurrentMediaTime() - self.lastDisplayLinkFire;
+    timeBetweenLastFire = timestamp - self.lastDisplayLinkFire;
   }
-  self.lastDisplayLinkFire = CACurrentMediaTime();
+  self.lastDisplayLinkFire = timestamp;
   
   _playHead += timeBetweenLastFire;
-  
-  while (_playHead > self.animatedImage.totalDuration) {
-    _playHead -= self.animatedImage.totalDuration;
-    _playedLoops++;
+
+  id <ASAnimatedImageProtocol> animatedImage;
+  ASAnimatedImageFrameBuffer *frameBuffer;
+  {
+    ASDN::MutexLocker l(_animatedImageLock);
+    animatedImage = _animatedImage;
+    frameBuffer = _frameBuffer;
+  }
+
+  CFTimeInterval totalDuration = animatedImage.totalDuration;
+  if (totalDuration > 0 && _playHead > totalDuration) {
+    CFTimeInterval loops = floor(_playHead / totalDuration);
+    _playHead -= loops * totalDuration;
+    _playedLoops += (NSUInteger)loops;
   }
   
-  if (self.animatedImage.loopCount > 0 && _playedLoops >= self.animatedImage.loopCount) {
+  if (animatedImage.loopCount > 0 && _playedLoops >= animatedImage.loopCount) {
     [self stopAnimating];
-    return;
+    return ASAnimatedImageDriverTickResultThrottled;
   }
+
+  // The play head keeps moving, but offscreen nodes and nodes asking for a lower frame rate don't touch their layer.
+  _ticksSinceFrameUpdate += 1;
+  if (_ticksSinceFrameUpdate < MAX(animatedImage.frameInterval, 1) || ASInterfaceStateIncludesVisible(self.interfaceState) == NO) {
+    return ASAnimatedImageDriverTickResultThrottled;
+  }
+  _ticksSinceFrameUpdate = 0;
   
-  NSUInteger frameIndex = [self frameIndexAtPlayHeadPosition:_playHead];
-  CGImageRef frameImage = [self.animatedImage imageAtIndex:frameIndex];
-  
+  NSUInteger frameIndex = [frameBuffer frameIndexAtPlayHead:_playHead];
+  if (frameBuffer == _displayedFrameBuffer && frameIndex == _displayedFrameIndex) {
+    return ASAnimatedImageDriverTickResultUnchanged;
+  }
+
+  CGImageRef frameImage = [frameBuffer frameAtIndex:frameIndex forConsumer:self];
   if (frameImage == nil) {
+    // The frame buffer is decoding it in the background. Hold the play head and keep ticking so that playback
+    // resumes as soon as the frame is ready.
     _playHead -= timeBetweenLastFire;
-    //Pause the display link until we get a file ready notification
-    displayLink.paused = YES;
-    self.lastDisplayLinkFire = 0;
-  } else {
-    self.contents = (__bridge id)frameImage;
+    return ASAnimatedImageDriverTickResultUnchanged;
   }
-}
 
-- (NSUInteger)frameIndexAtPlayHeadPosition:(CFTimeInterval)playHead
-{
-  ASDisplayNodeAssertMainThread();
-  NSUInteger frameIndex = 0;
-  for (NSUInteger durationIndex = 0; durationIndex < self.animatedImage.frameCount; durationIndex++) {
-    playHead -= [self.animatedImage durationAtIndex:durationIndex];
-    if (playHead < 0) {
-      return frameIndex;
-    }
-    frameIndex++;
-  }
-  
-  return frameIndex;
+  self.contents = (__bridge id)frameImage;
+  _displayedFrameBuffer = frameBuffer;
+  _displayedFrameIndex = frameIndex;
+  return ASAnimatedImageDriverTickResultUpdated;
 }
 
 @end
@@ -324,12 +415,13 @@ NSString *const ASAnimatedImageDefaultRunLoopMode = NSRunLoopCommonModes;
 {
   ASDN::MutexLocker l(_displayLinkLock);
 #if ASAnimatedImageDebug
-  if (_displayLink) {
-    NSLog(@"invalidating display link");
+  if (_animating) {
+    NSLog(@"invalidating animation");
   }
 #endif
-  [_displayLink invalidate];
-  _displayLink = nil;
+  // The shared driver holds nodes weakly and drops deallocated ones by itself. Unregistering here would hand a
+  // deallocating node to the main queue.
+  _animating = NO;
 }
 
 @end
@@ -24,6 +24,24 @@ NS_ASSUME_NONNULL_BEGIN
  */
 typedef UIImage * _Nullable (^asimagenode_modification_block_t)(UIImage *image);
 
+/**
+ * Counters for the clock that drives all animated image playback.
+ */
+typedef struct {
+  /// Display link callbacks handled.
+  NSUInteger frameCount;
+  /// Node ticks that put a new frame on screen.
+  NSUInteger updatedNodeCount;
+  /// Node ticks skipped because the frame to show hadn't changed.
+  NSUInteger unchangedNodeCount;
+  /// Node ticks skipped because the node was offscreen or its frame interval hadn't elapsed.
+  NSUInteger throttledNodeCount;
+  /// Total main thread time spent ticking nodes, in seconds.
+  CFTimeInterval totalFrameDuration;
+  /// The most main thread time spent in a single callback, in seconds.
+  CFTimeInterval maxFrameDuration;
+} ASAnimatedImagePlaybackMetrics;
+
 
 /**
  * @abstract Draws images.
@@ -161,6 +179,16 @@ typedef UIImage * _Nullable (^asimagenode_modification_block_t)(UIImage *image);
  */
 @property (nonatomic, strong) NSString *animatedImageRunLoopMode;
 
+/**
+ * @abstract A snapshot of the counters of the shared animation clock.
+ *
+ * @discussion All animating image nodes are ticked from one display link per run loop mode, in a single pass
+ * per frame. Use these counters to see what that pass costs on the main thread.
+ */
++ (ASAnimatedImagePlaybackMetrics)animatedImagePlaybackMetrics;
+
++ (void)resetAnimatedImagePlaybackMetrics;
+
 @end
 
 @interface ASImageNode (Unavailable)
@@ -17,6 +17,7 @@
 #import <AsyncDisplayKit/ASDimension.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkSubclasses.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
+#import <AsyncDisplayKit/ASGraphicsBufferPool.h>
 #import <AsyncDisplayKit/ASDisplayNode+Beta.h>
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASTextNode.h>
@@ -24,6 +25,7 @@
 #import <AsyncDisplayKit/ASImageNode+CGExtras.h>
 #import <AsyncDisplayKit/AsyncDisplayKit+Debug.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASMemoryAccountingInternal.h>
 #import <AsyncDisplayKit/ASEqualityHelpers.h>
 #import <AsyncDisplayKit/ASEqualityHashHelpers.h>
 #import <AsyncDisplayKit/ASWeakMap.h>
@@ -449,18 +451,27 @@ static ASDN::Mutex cacheLock;
   }
 }
 
+NSUInteger ASImageNodeContentsCacheEstimatedBytes(void)
+{
+  ASDN::MutexLocker l(cacheLock);
+  NSUInteger bytes = 0;
+  for (UIImage *contents in [cache allValues]) {
+    bytes += ASMemoryEstimatedBytesOfContents(contents);
+  }
+  return bytes;
+}
+
 + (UIImage *)createContentsForkey:(ASImageNodeContentsKey *)key isCancelled:(asdisplaynode_iscancelled_block_t)isCancelled
 {
-  // The following `UIGraphicsBeginImageContextWithOptions` call will sometimes take take longer than 5ms on an
-  // A5 processor for a 400x800 backingSize.
-  // Check for cancellation before we call it.
+  // Beginning the context will sometimes take longer than 5ms on an A5 processor for a 400x800 backingSize, unless
+  // the buffer pool has a buffer of the right size. Check for cancellation before we call it.
   if (isCancelled()) {
     return nil;
   }
 
   // Use contentsScale of 1.0 and do the contentsScale handling in boundsSizeInPixels so ASCroppedImageBackingSizeAndDrawRectInBounds
   // will do its rounding on pixel instead of point boundaries
-  UIGraphicsBeginImageContextWithOptions(key.backingSize, key.isOpaque, 1.0);
+  ASGraphicsBeginImageContextWithOptions(key.backingSize, key.isOpaque, 1.0);
   
   BOOL contextIsClean = YES;
   
@@ -501,16 +512,13 @@ static ASDN::Mutex cacheLock;
     key.postContextBlock(context);
   }
 
-  // The following `UIGraphicsGetImageFromCurrentImageContext` call will commonly take more than 20ms on an
-  // A5 processor.  Check for cancellation before we call it.
+  // Check for cancellation before making the image, so that the buffer goes straight back to the pool.
   if (isCancelled()) {
-    UIGraphicsEndImageContext();
+    ASGraphicsEndImageContext();
     return nil;
   }
 
-  UIImage *result = UIGraphicsGetImageFromCurrentImageContext();
-  
-  UIGraphicsEndImageContext();
+  UIImage *result = ASGraphicsGetImageAndEndCurrentContext();
   
   if (key.imageModificationBlock != NULL) {
     result = key.imageModificationBlock(result);
@@ -569,6 +577,23 @@ static ASDN::Mutex cacheLock;
   __instanceLock__.unlock();
 }
 
+#pragma mark Memory Accounting
+
+- (NSUInteger)estimatedBytesForMemoryCategory:(ASMemoryCategory)category
+{
+  NSUInteger bytes = [super estimatedBytesForMemoryCategory:category];
+  if (category == ASMemoryCategoryImage) {
+    UIImage *image = self.image;
+    id contents = self.contents;
+    // Images displayed as they are, like stretchable ones, are the backing store, which super counts already.
+    BOOL imageIsContents = (contents != nil && (contents == image || (__bridge CGImageRef)contents == image.CGImage));
+    if (!imageIsContents) {
+      bytes += ASMemoryEstimatedBytesOfContents(image);
+    }
+  }
+  return bytes;
+}
+
 #pragma mark - Cropping
 
 - (BOOL)isCropEnabled
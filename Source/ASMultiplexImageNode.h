@@ -56,6 +56,10 @@ typedef NS_ENUM(NSUInteger, ASMultiplexImageNodeErrorCode) {
  * example, it can display a low-resolution version of an image while the high-resolution version is loading.
  *
  * @discussion ASMultiplexImageNode begins loading images when its resource can either return a UIImage directly, or a URL the image node should load.
+ *
+ * When the best image has a URL that is loaded through the cache and downloader, every identifier better than the
+ * loaded one is looked up in the cache at the same time, and the best image found is displayed straight away. The best
+ * image starts downloading as soon as it's known not to be cached, rather than after the lesser images have loaded.
  */
 @interface ASMultiplexImageNode : ASImageNode
 
@@ -85,6 +89,9 @@ typedef NS_ENUM(NSUInteger, ASMultiplexImageNodeErrorCode) {
  * @discussion ASMultiplexImageNode immediately loads and displays the first image specified in <imageIdentifiers> (its
  * highest-quality image).  If that image is not immediately available or cached, the node can download and display
  * lesser-quality images.  Set `downloadsIntermediateImages` to YES to enable this behaviour.
+ *
+ * For downloaded images, the lowest-quality image is downloaded as a placeholder alongside the highest-quality one when
+ * none of the images are cached, and is cancelled if the highest-quality image lands first.
  */
 @property (nonatomic, readwrite, assign) BOOL downloadsIntermediateImages;
 
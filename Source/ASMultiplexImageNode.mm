@@ -74,6 +74,11 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
   // Networking.
   ASDN::RecursiveMutex _downloadIdentifierLock;
   id _downloadIdentifier;
+
+  // Tiered loading. Guarded by _downloadIdentifierLock.
+  NSUInteger _tierLoadGeneration;
+  id _placeholderImageIdentifier;
+  id _placeholderDownloadIdentifier;
   
   // Properties
   BOOL _shouldRenderProgressImages;
@@ -111,6 +116,30 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
  */
 - (void)_loadNextImage;
 
+/**
+  @abstract Loads every downloadable image tier better than the loaded one at the same time.
+  @discussion The cache is probed for all of the tiers at once and each hit is displayed as it arrives, if it's better than what's loaded. The best tier is downloaded as soon as its own probe misses. Once every probe has missed, if nothing is displayed yet and `downloadsIntermediateImages` is set, the worst tier is downloaded alongside the best one as a placeholder. The placeholder download is cancelled as soon as a better tier lands.
+  @result NO if the best image identifier doesn't have a downloadable URL, in which case nothing was started and the identifiers should be loaded one at a time instead.
+ */
+- (BOOL)_loadImageTiers;
+
+/**
+  @abstract Downloads the image tier at the given index, falling back to the next-best tier each time a download fails.
+  @param completion Called once a tier has been downloaded, or there's no tier left worth falling back to.
+ */
+- (void)_downloadImageTierAtIndex:(NSUInteger)tierIndex ofIdentifiers:(NSArray *)tierIdentifiers URLs:(NSArray<NSURL *> *)tierURLs generation:(NSUInteger)generation completion:(dispatch_block_t)completion;
+
+/**
+  @abstract Returns the index of the tier to download after the tier at the given index failed, or NSNotFound if there's none worth downloading.
+ */
+- (NSUInteger)_fallbackTierIndexAfterIndex:(NSUInteger)tierIndex ofIdentifiers:(NSArray *)tierIdentifiers generation:(NSUInteger)generation;
+
+/**
+  @abstract Displays an image loaded by the tiered loader, if it's still wanted and better than the loaded image.
+  @param generation The tiered load that loaded the image. Images from a superseded load are dropped.
+ */
+- (void)_finishedLoadingTierImage:(UIImage *)image forIdentifier:(id)imageIdentifier generation:(NSUInteger)generation;
+
 /**
   @abstract Fetches the image corresponding to the given imageIdentifier from the given URL from the session's image cache.
   @param imageIdentifier The identifier for the image to be fetched. May not be nil.
@@ -145,8 +174,30 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
  */
 - (void)_downloadImageWithIdentifier:(id)imageIdentifier URL:(NSURL *)imageURL completion:(void (^)(UIImage *image, NSError *error))completionBlock;
 
+/**
+ @abstract Downloads the image corresponding to the given imageIdentifier from the given URL.
+ @param placeholder Whether this is the tiered loader's placeholder download, which runs alongside the main download and doesn't render progress images.
+ */
+- (void)_downloadImageWithIdentifier:(id)imageIdentifier URL:(NSURL *)imageURL placeholder:(BOOL)placeholder completion:(void (^)(UIImage *image, NSError *error))completionBlock;
+
 @end
 
+/**
+ * Whether the URL is loaded through the cache and downloader, rather than from the assets library or Photos framework.
+ */
+static BOOL ASMultiplexImageNodeURLIsDownloadable(NSURL *URL)
+{
+  if (URL == nil) {
+    return NO;
+  }
+#if TARGET_OS_IOS
+  if ([URL.scheme isEqualToString:kAssetsLibraryURLScheme] || [ASPhotosFrameworkImageRequest requestWithURL:URL] != nil) {
+    return NO;
+  }
+#endif
+  return YES;
+}
+
 @implementation ASMultiplexImageNode
 
 #pragma mark - Getting Started / Tearing Down
@@ -200,6 +251,7 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
     
   [_phImageRequestOperation cancel];
 
+  [self _cancelTieredLoad];
   [self _setDownloadIdentifier:nil];
   
   if (_cacheSupportsClearing && self.loadedImageIdentifier != nil) {
@@ -261,14 +313,7 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
   
   [self didEnterPreloadState];
   
-  if (_downloaderImplementsSetPriority) {
-    {
-      ASDN::MutexLocker l(_downloadIdentifierLock);
-      if (_downloadIdentifier != nil) {
-        [_downloader setPriority:ASImageDownloaderPriorityImminent withDownloadIdentifier:_downloadIdentifier];
-      }
-    }
-  }
+  [self _setPriorityOfDownloads:ASImageDownloaderPriorityImminent];
 }
 
 /* didEnterVisibleState / didExitVisibleState in ASNetworkImageNode has a very similar implementation. Changes here are likely necessary
@@ -277,12 +322,7 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
 {
   [super didEnterVisibleState];
   
-  if (_downloaderImplementsSetPriority) {
-    ASDN::MutexLocker l(_downloadIdentifierLock);
-    if (_downloadIdentifier != nil) {
-      [_downloader setPriority:ASImageDownloaderPriorityVisible withDownloadIdentifier:_downloadIdentifier];
-    }
-  }
+  [self _setPriorityOfDownloads:ASImageDownloaderPriorityVisible];
   
   [self _updateProgressImageBlockOnDownloaderIfNeeded];
 }
@@ -291,12 +331,7 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
 {
   [super didExitVisibleState];
   
-  if (_downloaderImplementsSetPriority) {
-    ASDN::MutexLocker l(_downloadIdentifierLock);
-    if (_downloadIdentifier != nil) {
-      [_downloader setPriority:ASImageDownloaderPriorityPreload withDownloadIdentifier:_downloadIdentifier];
-    }
-  }
+  [self _setPriorityOfDownloads:ASImageDownloaderPriorityPreload];
   
   [self _updateProgressImageBlockOnDownloaderIfNeeded];
 }
@@ -435,6 +470,60 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
   _downloadIdentifier = downloadIdentifier;
 }
 
+/**
+ @abstract Records the download started for the placeholder tier, or cancels it if the placeholder was cancelled while the download was being started.
+ */
+- (void)_setPlaceholderDownloadIdentifier:(id)downloadIdentifier forImageIdentifier:(id)imageIdentifier
+{
+  ASDN::MutexLocker l(_downloadIdentifierLock);
+  if (!ASObjectIsEqual(_placeholderImageIdentifier, imageIdentifier)) {
+    if (downloadIdentifier) {
+      [_downloader cancelImageDownloadForIdentifier:downloadIdentifier];
+    }
+    return;
+  }
+
+  if (_placeholderDownloadIdentifier && !ASObjectIsEqual(_placeholderDownloadIdentifier, downloadIdentifier)) {
+    [_downloader cancelImageDownloadForIdentifier:_placeholderDownloadIdentifier];
+  }
+  _placeholderDownloadIdentifier = downloadIdentifier;
+}
+
+- (void)_cancelPlaceholderDownload
+{
+  ASDN::MutexLocker l(_downloadIdentifierLock);
+  if (_placeholderDownloadIdentifier) {
+    [_downloader cancelImageDownloadForIdentifier:_placeholderDownloadIdentifier];
+  }
+  _placeholderDownloadIdentifier = nil;
+  _placeholderImageIdentifier = nil;
+}
+
+/**
+ @abstract Stops the current tiered load, so that nothing it has in flight is displayed or starts further work.
+ */
+- (void)_cancelTieredLoad
+{
+  ASDN::MutexLocker l(_downloadIdentifierLock);
+  _tierLoadGeneration++;
+  [self _cancelPlaceholderDownload];
+}
+
+- (void)_setPriorityOfDownloads:(ASImageDownloaderPriority)priority
+{
+  if (!_downloaderImplementsSetPriority) {
+    return;
+  }
+
+  ASDN::MutexLocker l(_downloadIdentifierLock);
+  if (_downloadIdentifier != nil) {
+    [_downloader setPriority:priority withDownloadIdentifier:_downloadIdentifier];
+  }
+  if (_placeholderDownloadIdentifier != nil) {
+    [_downloader setPriority:priority withDownloadIdentifier:_placeholderDownloadIdentifier];
+  }
+}
+
 
 #pragma mark - Image Loading Machinery
 
@@ -566,6 +655,11 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
 
 - (void)_loadNextImage
 {
+  // If the best image is downloadable, look at every tier at once rather than stepping through them.
+  if ([self _loadImageTiers]) {
+    return;
+  }
+
   // Determine the next identifier to load (if any).
   id nextImageIdentifier = [self _nextImageIdentifierToDownload];
   if (!nextImageIdentifier) {
@@ -654,6 +748,203 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
     }];
   }
 }
+- (BOOL)_loadImageTiers
+{
+  if (!_dataSourceFlags.URL) {
+    return NO;
+  }
+
+  NSArray *candidateIdentifiers = nil;
+  {
+    ASDN::MutexLocker l(_imageIdentifiersLock);
+    id bestImageIdentifier = _imageIdentifiers.firstObject;
+    if (!bestImageIdentifier || ASObjectIsEqual(_loadedImageIdentifier, bestImageIdentifier)) {
+      return NO;
+    }
+
+    NSUInteger loadedIndex = _loadedImageIdentifier ? [_imageIdentifiers indexOfObject:_loadedImageIdentifier] : NSNotFound;
+    candidateIdentifiers = (loadedIndex == NSNotFound) ? _imageIdentifiers : [_imageIdentifiers subarrayWithRange:NSMakeRange(0, loadedIndex)];
+  }
+
+  // Only tiers that go through the cache and downloader are loaded here; the data source is asked for immediately
+  // available images by _loadImageIdentifiers, and local assets are loaded one at a time.
+  NSMutableArray *tierIdentifiers = [NSMutableArray arrayWithCapacity:candidateIdentifiers.count];
+  NSMutableArray<NSURL *> *tierURLs = [NSMutableArray arrayWithCapacity:candidateIdentifiers.count];
+  for (id imageIdentifier in candidateIdentifiers) {
+    NSURL *URL = [_dataSource multiplexImageNode:self URLForImageIdentifier:imageIdentifier];
+    if (!ASMultiplexImageNodeURLIsDownloadable(URL)) {
+      if (tierIdentifiers.count == 0) {
+        return NO;
+      }
+      continue;
+    }
+    [tierIdentifiers addObject:imageIdentifier];
+    [tierURLs addObject:URL];
+  }
+
+  id bestImageIdentifier = tierIdentifiers.firstObject;
+  NSUInteger tierCount = tierIdentifiers.count;
+  BOOL downloadsIntermediateImages = _downloadsIntermediateImages;
+
+  // Anything the previous tiered load still has in flight is superseded.
+  NSUInteger generation;
+  {
+    ASDN::MutexLocker l(_downloadIdentifierLock);
+    [self _cancelTieredLoad];
+    generation = _tierLoadGeneration;
+  }
+  self.loadingImageIdentifier = bestImageIdentifier;
+
+  ASMultiplexImageNodeLogDebug(@"[%p] Loading %lu image tiers, best ident: %@", self, (unsigned long)tierCount, bestImageIdentifier);
+
+  __weak __typeof__(self) weakSelf = self;
+  void (^finishedLoadingBestTier)(void) = ^{
+    __typeof__(self) strongSelf = weakSelf;
+    if (strongSelf && ASObjectIsEqual(strongSelf.loadingImageIdentifier, bestImageIdentifier)) {
+      strongSelf.loadingImageIdentifier = nil;
+    }
+  };
+
+  // Guarded by _downloadIdentifierLock.
+  __block NSUInteger pendingProbeCount = tierCount;
+
+  [tierIdentifiers enumerateObjectsUsingBlock:^(id imageIdentifier, NSUInteger tierIndex, BOOL *stop) {
+    NSURL *URL = tierURLs[tierIndex];
+    [self _fetchImageWithIdentifierFromCache:imageIdentifier URL:URL completion:^(UIImage *imageFromCache) {
+      __typeof__(self) strongSelf = weakSelf;
+      if (!strongSelf)
+        return;
+
+      if (imageFromCache) {
+        ASMultiplexImageNodeCLogDebug(@"[%p] Acquired image tier (%@) from cache", strongSelf, imageIdentifier);
+        [strongSelf _finishedLoadingTierImage:imageFromCache forIdentifier:imageIdentifier generation:generation];
+        if (tierIndex == 0) {
+          finishedLoadingBestTier();
+        }
+      }
+
+      BOOL startsBestDownload = NO;
+      BOOL startsPlaceholderDownload = NO;
+      {
+        ASDN::MutexLocker l(strongSelf->_downloadIdentifierLock);
+        if (generation != strongSelf->_tierLoadGeneration) {
+          return;
+        }
+
+        pendingProbeCount--;
+        startsBestDownload = (tierIndex == 0 && imageFromCache == nil);
+        // Fall back to downloading the worst tier only when no tier was cached at all.
+        if (pendingProbeCount == 0 && downloadsIntermediateImages && tierCount > 1 && strongSelf.loadedImageIdentifier == nil) {
+          startsPlaceholderDownload = YES;
+          strongSelf->_placeholderImageIdentifier = tierIdentifiers.lastObject;
+        }
+      }
+
+      if (startsBestDownload) {
+        [strongSelf _downloadImageTierAtIndex:0 ofIdentifiers:tierIdentifiers URLs:tierURLs generation:generation completion:finishedLoadingBestTier];
+      }
+
+      if (startsPlaceholderDownload) {
+        id placeholderIdentifier = tierIdentifiers.lastObject;
+        [strongSelf _downloadImageWithIdentifier:placeholderIdentifier URL:tierURLs.lastObject placeholder:YES completion:^(UIImage *downloadedImage, NSError *error) {
+          ASMultiplexImageNodeCLogDebug(@"[%p] Acquired placeholder image tier (%@) from download", weakSelf, placeholderIdentifier);
+          if (downloadedImage) {
+            [weakSelf _finishedLoadingTierImage:downloadedImage forIdentifier:placeholderIdentifier generation:generation];
+          }
+        }];
+      }
+    }];
+  }];
+
+  return YES;
+}
+
+- (void)_downloadImageTierAtIndex:(NSUInteger)tierIndex ofIdentifiers:(NSArray *)tierIdentifiers URLs:(NSArray<NSURL *> *)tierURLs generation:(NSUInteger)generation completion:(dispatch_block_t)completion
+{
+  id imageIdentifier = tierIdentifiers[tierIndex];
+  __weak __typeof__(self) weakSelf = self;
+  [self _downloadImageWithIdentifier:imageIdentifier URL:tierURLs[tierIndex] placeholder:NO completion:^(UIImage *downloadedImage, NSError *error) {
+    __typeof__(self) strongSelf = weakSelf;
+    if (!strongSelf)
+      return;
+
+    if (downloadedImage) {
+      ASMultiplexImageNodeCLogDebug(@"[%p] Acquired image tier (%@) from download", strongSelf, imageIdentifier);
+      [strongSelf _finishedLoadingTierImage:downloadedImage forIdentifier:imageIdentifier generation:generation];
+      completion();
+      return;
+    }
+
+    // The tiers between this one and the loaded one were skipped in favour of it, so try them in turn.
+    NSUInteger fallbackTierIndex = [strongSelf _fallbackTierIndexAfterIndex:tierIndex ofIdentifiers:tierIdentifiers generation:generation];
+    if (fallbackTierIndex == NSNotFound) {
+      completion();
+      return;
+    }
+
+    ASMultiplexImageNodeCLogDebug(@"[%p] Failed to download image tier (%@), falling back to %@: %@", strongSelf, imageIdentifier, tierIdentifiers[fallbackTierIndex], error);
+    [strongSelf _downloadImageTierAtIndex:fallbackTierIndex ofIdentifiers:tierIdentifiers URLs:tierURLs generation:generation completion:completion];
+  }];
+}
+
+- (NSUInteger)_fallbackTierIndexAfterIndex:(NSUInteger)tierIndex ofIdentifiers:(NSArray *)tierIdentifiers generation:(NSUInteger)generation
+{
+  ASDN::MutexLocker l(_downloadIdentifierLock);
+  NSUInteger fallbackTierIndex = tierIndex + 1;
+  if (generation != _tierLoadGeneration || fallbackTierIndex >= tierIdentifiers.count) {
+    return NSNotFound;
+  }
+
+  // The placeholder download is already bringing in the next tier.
+  id fallbackIdentifier = tierIdentifiers[fallbackTierIndex];
+  if (ASObjectIsEqual(_placeholderImageIdentifier, fallbackIdentifier)) {
+    return NSNotFound;
+  }
+
+  // Nothing to gain from a tier that's no better than the loaded one.
+  {
+    ASDN::MutexLocker l(_imageIdentifiersLock);
+    NSUInteger identifierIndex = [_imageIdentifiers indexOfObject:fallbackIdentifier];
+    NSUInteger loadedIndex = _loadedImageIdentifier ? [_imageIdentifiers indexOfObject:_loadedImageIdentifier] : NSNotFound;
+    if (identifierIndex == NSNotFound || identifierIndex >= loadedIndex) {
+      return NSNotFound;
+    }
+  }
+  return fallbackTierIndex;
+}
+
+- (void)_finishedLoadingTierImage:(UIImage *)image forIdentifier:(id)imageIdentifier generation:(NSUInteger)generation
+{
+  ASDisplayNodeAssertNotNil(image, @"image is required");
+
+  {
+    ASDN::MutexLocker l(_downloadIdentifierLock);
+    if (generation != _tierLoadGeneration) {
+      return;
+    }
+
+    // Only ever step up in quality; a tier that lands after a better one is dropped.
+    {
+      ASDN::MutexLocker l(_imageIdentifiersLock);
+      NSUInteger tierIndex = [_imageIdentifiers indexOfObject:imageIdentifier];
+      NSUInteger loadedIndex = _loadedImageIdentifier ? [_imageIdentifiers indexOfObject:_loadedImageIdentifier] : NSNotFound;
+      if (tierIndex == NSNotFound || tierIndex >= loadedIndex) {
+        return;
+      }
+    }
+
+    // The placeholder is the worst tier, so it's of no use once anything else has landed.
+    if (ASObjectIsEqual(_placeholderImageIdentifier, imageIdentifier)) {
+      _placeholderImageIdentifier = nil;
+      _placeholderDownloadIdentifier = nil;
+    } else {
+      [self _cancelPlaceholderDownload];
+    }
+  }
+
+  [self _setLoadedImage:image forIdentifier:imageIdentifier];
+}
+
 #if TARGET_OS_IOS
 - (void)_loadALAssetWithIdentifier:(id)imageIdentifier URL:(NSURL *)assetURL completion:(void (^)(UIImage *image, NSError *error))completionBlock
 {
@@ -780,6 +1071,11 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
 }
 
 - (void)_downloadImageWithIdentifier:(id)imageIdentifier URL:(NSURL *)imageURL completion:(void (^)(UIImage *image, NSError *error))completionBlock
+{
+  [self _downloadImageWithIdentifier:imageIdentifier URL:imageURL placeholder:NO completion:completionBlock];
+}
+
+- (void)_downloadImageWithIdentifier:(id)imageIdentifier URL:(NSURL *)imageURL placeholder:(BOOL)placeholder completion:(void (^)(UIImage *image, NSError *error))completionBlock
 {
   ASDisplayNodeAssertNotNil(imageIdentifier, @"imageIdentifier is required");
   ASDisplayNodeAssertNotNil(imageURL, @"imageURL is required");
@@ -802,28 +1098,34 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
 
   // Download!
   ASPerformBlockOnBackgroundThread(^{
-    [self _setDownloadIdentifier:[_downloader downloadImageWithURL:imageURL
-                                                     callbackQueue:dispatch_get_main_queue()
-                                                  downloadProgress:downloadProgressBlock
-                                                        completion:^(id <ASImageContainerProtocol> imageContainer, NSError *error, id downloadIdentifier) {
-                                                          // We dereference iVars directly, so we can't have weakSelf going nil on us.
-                                                          __typeof__(self) strongSelf = weakSelf;
-                                                          if (!strongSelf)
-                                                            return;
-                                                          
-                                                          ASDN::MutexLocker l(_downloadIdentifierLock);
-                                                          //Getting a result back for a different download identifier, download must not have been successfully canceled
-                                                          if (ASObjectIsEqual(_downloadIdentifier, downloadIdentifier) == NO && downloadIdentifier != nil) {
-                                                            return;
-                                                          }
-                                                          
-                                                          completionBlock([imageContainer asdk_image], error);
-                                                          
-                                                          // Delegateify.
-                                                          if (strongSelf->_delegateFlags.downloadFinish)
-                                                            [strongSelf->_delegate multiplexImageNode:weakSelf didFinishDownloadingImageWithIdentifier:imageIdentifier error:error];
-                                                        }]];
-    [self _updateProgressImageBlockOnDownloaderIfNeeded];
+    id downloadIdentifier = [_downloader downloadImageWithURL:imageURL
+                                                callbackQueue:dispatch_get_main_queue()
+                                             downloadProgress:downloadProgressBlock
+                                                   completion:^(id <ASImageContainerProtocol> imageContainer, NSError *error, id downloadIdentifier) {
+                                                     // We dereference iVars directly, so we can't have weakSelf going nil on us.
+                                                     __typeof__(self) strongSelf = weakSelf;
+                                                     if (!strongSelf)
+                                                       return;
+                                                     
+                                                     ASDN::MutexLocker l(_downloadIdentifierLock);
+                                                     //Getting a result back for a different download identifier, download must not have been successfully canceled
+                                                     id currentDownloadIdentifier = placeholder ? _placeholderDownloadIdentifier : _downloadIdentifier;
+                                                     if (ASObjectIsEqual(currentDownloadIdentifier, downloadIdentifier) == NO && downloadIdentifier != nil) {
+                                                       return;
+                                                     }
+                                                     
+                                                     completionBlock([imageContainer asdk_image], error);
+                                                     
+                                                     // Delegateify.
+                                                     if (strongSelf->_delegateFlags.downloadFinish)
+                                                       [strongSelf->_delegate multiplexImageNode:weakSelf didFinishDownloadingImageWithIdentifier:imageIdentifier error:error];
+                                                   }];
+    if (placeholder) {
+      [self _setPlaceholderDownloadIdentifier:downloadIdentifier forImageIdentifier:imageIdentifier];
+    } else {
+      [self _setDownloadIdentifier:downloadIdentifier];
+      [self _updateProgressImageBlockOnDownloaderIfNeeded];
+    }
   });
 }
 
@@ -844,17 +1146,7 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
   // We explicitly perform this check because our datasource often doesn't give back immediately available images, even though we might have downloaded one already.
   // Because we seed this call with bestImmediatelyAvailableImageFromDataSource, we must be careful not to trample an existing image.
   if (image || imageIdentifierCount == 0) {
-    ASMultiplexImageNodeLogDebug(@"[%p] loaded -> displaying (%@, %@)", self, imageIdentifier, image);
-    id previousIdentifier = self.loadedImageIdentifier;
-    UIImage *previousImage = self.image;
-
-    self.loadedImageIdentifier = imageIdentifier;
-    [self _setImage:image];
-
-    if (_delegateFlags.updatedImage) {
-      [_delegate multiplexImageNode:self didUpdateImage:image withIdentifier:imageIdentifier fromImage:previousImage withIdentifier:previousIdentifier];
-    }
-
+    [self _setLoadedImage:image forIdentifier:imageIdentifier];
   }
 
   // Load our next image, if we have one to load.
@@ -862,6 +1154,20 @@ typedef void(^ASMultiplexImageLoadCompletionBlock)(UIImage *image, id imageIdent
     [self _loadNextImage];
 }
 
+- (void)_setLoadedImage:(UIImage *)image forIdentifier:(id)imageIdentifier
+{
+  ASMultiplexImageNodeLogDebug(@"[%p] loaded -> displaying (%@, %@)", self, imageIdentifier, image);
+  id previousIdentifier = self.loadedImageIdentifier;
+  UIImage *previousImage = self.image;
+
+  self.loadedImageIdentifier = imageIdentifier;
+  [self _setImage:image];
+
+  if (_delegateFlags.updatedImage) {
+    [_delegate multiplexImageNode:self didUpdateImage:image withIdentifier:imageIdentifier fromImage:previousImage withIdentifier:previousIdentifier];
+  }
+}
+
 @end
 
 @implementation NSURL (ASPhotosFrameworkURLs)
@@ -39,7 +39,8 @@ NS_ASSUME_NONNULL_BEGIN
 /**
  * Convenience initializer.
  *
- * @return An ASNetworkImageNode configured to use the NSURLSession-powered ASBasicImageDownloader, and no extra cache.
+ * @return An ASNetworkImageNode configured to use the NSURLSession-powered ASBasicImageDownloader as its downloader
+ * and cache, or ASPINRemoteImageDownloader if PINRemoteImage is available.
  */
 - (instancetype)init;
 
@@ -99,6 +100,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 @property (nonatomic, assign, readwrite) BOOL shouldRenderProgressImages;
 
+/**
+ * If the downloader supports it and this value is YES, downloaded images are decoded at the node's size in pixels
+ * rather than at full size, as long as the result still covers the node. This saves memory and decode time for large
+ * images shown in small nodes. Only applies when <contentMode> is one of the scaling content modes and the node has
+ * been laid out by the time the download starts. Defaults to NO.
+ */
+@property (nonatomic, assign, readwrite) BOOL shouldDownsampleImage;
+
 /**
  * The image quality of the current image. This is a number between 0 and 1 and can be used to track
  * progressive progress. Calculated by dividing number of bytes / expected number of total bytes.
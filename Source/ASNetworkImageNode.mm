@@ -26,6 +26,17 @@
 
 static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
 
+static ASImageDownloaderPriority ASImageDownloaderPriorityWithInterfaceState(ASInterfaceState interfaceState)
+{
+  if (ASInterfaceStateIncludesVisible(interfaceState)) {
+    return ASImageDownloaderPriorityVisible;
+  }
+  if (ASInterfaceStateIncludesDisplay(interfaceState)) {
+    return ASImageDownloaderPriorityImminent;
+  }
+  return ASImageDownloaderPriorityPreload;
+}
+
 @interface ASNetworkImageNode ()
 {
   // Only access any of these with __instanceLock__.
@@ -44,6 +55,7 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
   CGFloat _currentImageQuality;
   CGFloat _renderedImageQuality;
   BOOL _shouldRenderProgressImages;
+  BOOL _shouldDownsampleImage;
 
   struct {
     unsigned int delegateDidStartFetchingData:1;
@@ -60,6 +72,7 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
     unsigned int downloaderImplementsSetPriority:1;
     unsigned int downloaderImplementsAnimatedImage:1;
     unsigned int downloaderImplementsCancelWithResume:1;
+    unsigned int downloaderImplementsDownloadWithTargetSize:1;
   } _downloaderFlags;
 
   // Immutable and set on init only. We don't need to lock in this case.
@@ -88,6 +101,7 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
   _downloaderFlags.downloaderImplementsSetPriority = [downloader respondsToSelector:@selector(setPriority:withDownloadIdentifier:)];
   _downloaderFlags.downloaderImplementsAnimatedImage = [downloader respondsToSelector:@selector(animatedImageWithData:)];
   _downloaderFlags.downloaderImplementsCancelWithResume = [downloader respondsToSelector:@selector(cancelImageDownloadWithResumePossibilityForIdentifier:)];
+  _downloaderFlags.downloaderImplementsDownloadWithTargetSize = [downloader respondsToSelector:@selector(downloadImageWithURL:targetPixelSize:callbackQueue:downloadProgress:completion:)];
 
   _cacheFlags.cacheSupportsClearing = [cache respondsToSelector:@selector(clearFetchedImageFromCacheWithURL:)];
   _cacheFlags.cacheSupportsSynchronousFetch = [cache respondsToSelector:@selector(synchronouslyFetchedCachedImageWithURL:)];
@@ -104,7 +118,7 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
 #if AS_PIN_REMOTE_IMAGE
   return [self initWithCache:[ASPINRemoteImageDownloader sharedDownloader] downloader:[ASPINRemoteImageDownloader sharedDownloader]];
 #else
-  return [self initWithCache:nil downloader:[ASBasicImageDownloader sharedImageDownloader]];
+  return [self initWithCache:[ASBasicImageDownloader sharedImageDownloader] downloader:[ASBasicImageDownloader sharedImageDownloader]];
 #endif
 }
 
@@ -299,6 +313,18 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
   return _shouldRenderProgressImages;
 }
 
+- (void)setShouldDownsampleImage:(BOOL)shouldDownsampleImage
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  _shouldDownsampleImage = shouldDownsampleImage;
+}
+
+- (BOOL)shouldDownsampleImage
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _shouldDownsampleImage;
+}
+
 - (BOOL)placeholderShouldPersist
 {
   ASDN::MutexLocker l(__instanceLock__);
@@ -370,12 +396,29 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
   __instanceLock__.unlock();
   
   if (downloadIdentifier != nil) {
-    [_downloader setPriority:ASImageDownloaderPriorityPreload withDownloadIdentifier:downloadIdentifier];
+    // Still in the display range, the image is needed soon.
+    [_downloader setPriority:ASImageDownloaderPriorityWithInterfaceState(self.interfaceState) withDownloadIdentifier:downloadIdentifier];
   }
   
   [self _updateProgressImageBlockOnDownloaderIfNeeded];
 }
 
+- (void)didExitDisplayState
+{
+  [super didExitDisplayState];
+
+  __instanceLock__.lock();
+    id downloadIdentifier = nil;
+    if (_downloaderFlags.downloaderImplementsSetPriority) {
+      downloadIdentifier = _downloadIdentifier;
+    }
+  __instanceLock__.unlock();
+
+  if (downloadIdentifier != nil) {
+    [_downloader setPriority:ASImageDownloaderPriorityPreload withDownloadIdentifier:downloadIdentifier];
+  }
+}
+
 - (void)didExitPreloadState
 {
   [super didExitPreloadState];
@@ -531,7 +574,37 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
   _cacheUUID = nil;
 }
 
+- (CGSize)_targetPixelSizeForDownload
+{
+  if (_downloaderFlags.downloaderImplementsDownloadWithTargetSize == NO || self.shouldDownsampleImage == NO) {
+    return CGSizeZero;
+  }
+
+  // Reading contentMode off the main thread is only safe before the node is loaded. Decoding at full size is
+  // always correct, so fall back to it rather than wait.
+  if (ASDisplayNodeThreadIsMain() == NO && self.nodeLoaded) {
+    return CGSizeZero;
+  }
+
+  switch (self.contentMode) {
+    case UIViewContentModeScaleToFill:
+    case UIViewContentModeScaleAspectFit:
+    case UIViewContentModeScaleAspectFill: {
+      CGSize boundsSize = self.threadSafeBounds.size;
+      CGFloat contentsScale = self.contentsScaleForDisplay;
+      return CGSizeMake(ceil(boundsSize.width * contentsScale), ceil(boundsSize.height * contentsScale));
+    }
+    default:
+      return CGSizeZero;
+  }
+}
+
 - (void)_downloadImageWithCompletion:(void (^)(id <ASImageContainerProtocol> imageContainer, NSError*, id downloadIdentifier))finished
+{
+  [self _downloadImageWithTargetPixelSize:[self _targetPixelSizeForDownload] completion:finished];
+}
+
+- (void)_downloadImageWithTargetPixelSize:(CGSize)targetPixelSize completion:(void (^)(id <ASImageContainerProtocol> imageContainer, NSError*, id downloadIdentifier))finished
 {
   ASPerformBlockOnBackgroundThread(^{
     NSURL *url;
@@ -546,14 +619,24 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
       url = _URL;
     }
     
-    downloadIdentifier = [_downloader downloadImageWithURL:url
-                                             callbackQueue:dispatch_get_main_queue()
-                                          downloadProgress:NULL
-                                                completion:^(id <ASImageContainerProtocol> _Nullable imageContainer, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
-                                                  if (finished != NULL) {
-                                                    finished(imageContainer, error, downloadIdentifier);
-                                                  }
-                                                }];
+    ASImageDownloaderCompletion completion = ^(id <ASImageContainerProtocol> _Nullable imageContainer, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+      if (finished != NULL) {
+        finished(imageContainer, error, downloadIdentifier);
+      }
+    };
+    
+    if (_downloaderFlags.downloaderImplementsDownloadWithTargetSize) {
+      downloadIdentifier = [_downloader downloadImageWithURL:url
+                                             targetPixelSize:targetPixelSize
+                                               callbackQueue:dispatch_get_main_queue()
+                                            downloadProgress:NULL
+                                                  completion:completion];
+    } else {
+      downloadIdentifier = [_downloader downloadImageWithURL:url
+                                               callbackQueue:dispatch_get_main_queue()
+                                            downloadProgress:NULL
+                                                  completion:completion];
+    }
   
     {
       ASDN::MutexLocker l(__instanceLock__);
@@ -571,9 +654,15 @@ static const CGSize kMinReleaseImageOnBackgroundSize = {20.0, 20.0};
       if (downloadIdentifier != nil) {
         [_downloader cancelImageDownloadForIdentifier:downloadIdentifier];
       }
-      [self _downloadImageWithCompletion:finished];
+      [self _downloadImageWithTargetPixelSize:targetPixelSize completion:finished];
       return;
     }
+
+    // The interface state callbacks only report changes, so tell the downloader where we are now. Downloaders that
+    // schedule by priority would otherwise treat a visible node like any other.
+    if (downloadIdentifier != nil && _downloaderFlags.downloaderImplementsSetPriority) {
+      [_downloader setPriority:ASImageDownloaderPriorityWithInterfaceState(self.interfaceState) withDownloadIdentifier:downloadIdentifier];
+    }
     
     [self _updateProgressImageBlockOnDownloaderIfNeeded];
   });
@@ -20,7 +20,7 @@ NS_ASSUME_NONNULL_BEGIN
 
 @protocol ASTableDataSource;
 @protocol ASTableDelegate;
-@class ASTableView, ASBatchContext;
+@class ASTableView, ASBatchContext, ASAdaptiveRangePolicy, ASSnapshot;
 
 /**
  * ASTableNode is a node based class that wraps an ASTableView. It can be used
@@ -111,6 +111,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)setTuningParameters:(ASRangeTuningParameters)tuningParameters forRangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType;
 
+/**
+ * A policy that scales the display and preload ranges in full mode with scroll speed and measured latency, within
+ * the policy's bounds. Defaults to nil, which uses the tuning parameters unchanged.
+ *
+ * @see ASAdaptiveRangePolicy
+ */
+@property (nonatomic, strong, nullable) ASAdaptiveRangePolicy *adaptiveRangePolicy;
+
 /**
  * Scrolls the table to the given row.
  *
@@ -168,6 +176,29 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)performBatchUpdates:(nullable AS_NOESCAPE void (^)())updates completion:(nullable void (^)(BOOL finished))completion;
 
+/**
+ * Updates the table to match the given snapshot. The snapshot is diffed against the previously applied one off the
+ * main thread, and the result is performed as a batch update, so only the inserted, reloaded and moved rows are
+ * measured. This method must be called from the main thread.
+ *
+ * @param snapshot The sections and rows the table should contain.
+ * @param animated NO to disable animations for this batch.
+ * @param updates Called on the main thread inside the batch update. Switch the data source over to the data the
+ *   snapshot describes here; until then it must keep describing the previous snapshot's data.
+ * @param completion Called on the main thread when the batch update finishes.
+ *
+ * @discussion The first snapshot reloads the table. Snapshots are applied in the order they're passed in. Don't mix
+ * snapshots with other edits or reloads, since the next diff would be against stale data.
+ *
+ * @see ASSnapshot
+ */
+- (void)applySnapshot:(ASSnapshot *)snapshot animated:(BOOL)animated updates:(nullable void (^)())updates completion:(nullable void (^)(BOOL finished))completion;
+
+/**
+ * The snapshot the table currently matches, i.e. the last one whose updates block has run.
+ */
+@property (nonatomic, strong, readonly, nullable) ASSnapshot *currentSnapshot;
+
 /**
  *  Blocks execution of the main thread until all section and row updates are committed. This method must be called from the main thread.
  */
@@ -460,6 +491,31 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (ASCellNode *)tableNode:(ASTableNode *)tableNode nodeForRowAtIndexPath:(NSIndexPath *)indexPath;
 
+/**
+ * Asks the data source whether the row at the given index path should use a reusable node, and of what class.
+ * Implement this together with -tableNode:nodeConfigurationBlockForRowAtIndexPath: to opt in to node reuse.
+ *
+ * @param tableNode The sender.
+ * @param indexPath The index path of the row.
+ *
+ * @return The class of the node, created with -init when the reuse pool has none, or nil to use the node block
+ *   for this row. The class should override -[ASCellNode prepareForReuse] to reset its state.
+ *
+ * @see ASCellNodeReusePool
+ */
+- (nullable Class)tableNode:(ASTableNode *)tableNode reusableNodeClassForRowAtIndexPath:(NSIndexPath *)indexPath;
+
+/**
+ * Asks the data source for a block to set up a reusable node for the row at the given index path. The node is
+ * either new or was used by a deleted row. Like node blocks, the block is run concurrently in the background.
+ *
+ * @param tableNode The sender.
+ * @param indexPath The index path of the row.
+ *
+ * @return a block that configures the node for display at this indexpath. Must be thread-safe.
+ */
+- (ASCellNodeConfigurationBlock)tableNode:(ASTableNode *)tableNode nodeConfigurationBlockForRowAtIndexPath:(NSIndexPath *)indexPath;
+
 /**
  * Similar to -tableView:cellForRowAtIndexPath:.
  *
@@ -23,6 +23,7 @@
 #import <AsyncDisplayKit/ASThread.h>
 #import <AsyncDisplayKit/ASDisplayNode+Beta.h>
 #import <AsyncDisplayKit/ASRangeController.h>
+#import <AsyncDisplayKit/ASSnapshot.h>
 
 #pragma mark - _ASTablePendingState
 
@@ -59,6 +60,8 @@
 @interface ASTableNode ()
 {
   ASDN::RecursiveMutex _environmentStateLock;
+  // The snapshot the table will match once all pending diffs are performed.
+  ASSnapshot *_targetSnapshot;
 }
 
 @property (nonatomic, strong) _ASTablePendingState *pendingState;
@@ -368,6 +371,16 @@ ASLayoutElementCollectionTableSetTraitCollection(_environmentStateLock)
   return [self.rangeController setTuningParameters:tuningParameters forRangeMode:rangeMode rangeType:rangeType];
 }
 
+- (ASAdaptiveRangePolicy *)adaptiveRangePolicy
+{
+  return self.rangeController.adaptiveRangePolicy;
+}
+
+- (void)setAdaptiveRangePolicy:(ASAdaptiveRangePolicy *)adaptiveRangePolicy
+{
+  self.rangeController.adaptiveRangePolicy = adaptiveRangePolicy;
+}
+
 #pragma mark - Selection
 
 - (void)selectRowAtIndexPath:(nullable NSIndexPath *)indexPath animated:(BOOL)animated scrollPosition:(UITableViewScrollPosition)scrollPosition
@@ -573,6 +586,69 @@ ASLayoutElementCollectionTableSetTraitCollection(_environmentStateLock)
   [self performBatchAnimated:YES updates:updates completion:completion];
 }
 
+- (void)applySnapshot:(ASSnapshot *)snapshot animated:(BOOL)animated updates:(void (^)())updates completion:(void (^)(BOOL))completion
+{
+  ASDisplayNodeAssertMainThread();
+  ASSnapshot *previousSnapshot = _targetSnapshot;
+  _targetSnapshot = snapshot;
+
+  // Without a previous snapshot there's nothing to diff against, and an unloaded node reads everything on load.
+  if (previousSnapshot == nil || !self.nodeLoaded) {
+    _currentSnapshot = snapshot;
+    if (updates) {
+      updates();
+    }
+    if (!self.nodeLoaded) {
+      if (completion) {
+        completion(YES);
+      }
+      return;
+    }
+    [self reloadDataWithCompletion:^{
+      if (completion) {
+        completion(YES);
+      }
+    }];
+    return;
+  }
+
+  [ASSnapshotDiff diffFromSnapshot:previousSnapshot toSnapshot:snapshot completion:^(ASSnapshotDiff *diff) {
+    [self performBatchAnimated:animated updates:^{
+      _currentSnapshot = snapshot;
+      if (updates) {
+        updates();
+      }
+      [self _performSnapshotDiff:diff];
+    } completion:completion];
+  }];
+}
+
+- (void)_performSnapshotDiff:(ASSnapshotDiff *)diff
+{
+  UITableViewRowAnimation animation = UITableViewRowAnimationAutomatic;
+  if (diff.deletedSections.count > 0) {
+    [self deleteSections:diff.deletedSections withRowAnimation:animation];
+  }
+  if (diff.insertedSections.count > 0) {
+    [self insertSections:diff.insertedSections withRowAnimation:animation];
+  }
+  [diff.movedSections enumerateKeysAndObjectsUsingBlock:^(NSNumber *section, NSNumber *newSection, BOOL *stop) {
+    [self moveSection:section.integerValue toSection:newSection.integerValue];
+  }];
+  if (diff.deletedItems.count > 0) {
+    [self deleteRowsAtIndexPaths:diff.deletedItems withRowAnimation:animation];
+  }
+  if (diff.insertedItems.count > 0) {
+    [self insertRowsAtIndexPaths:diff.insertedItems withRowAnimation:animation];
+  }
+  if (diff.reloadedItems.count > 0) {
+    [self reloadRowsAtIndexPaths:diff.reloadedItems withRowAnimation:animation];
+  }
+  [diff.movedItems enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *indexPath, NSIndexPath *newIndexPath, BOOL *stop) {
+    [self moveRowAtIndexPath:indexPath toIndexPath:newIndexPath];
+  }];
+}
+
 - (void)insertSections:(NSIndexSet *)sections withRowAnimation:(UITableViewRowAnimation)animation
 {
   ASDisplayNodeAssertMainThread();
@@ -141,6 +141,8 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
   CGFloat _contentOffsetAdjustmentTopVisibleNodeOffset;
   
   CGPoint _deceleratingVelocity;
+  CGPoint _deceleratingTargetContentOffset;
+  ASBatchFetchingVelocityEstimate _scrollVelocityEstimate;
   
   /**
    * Our layer, retained. Under iOS < 9, when table views are removed from the hierarchy,
@@ -224,6 +226,7 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
     unsigned int tableNodeNodeBlockForRow:1;
     unsigned int tableViewNodeForRow:1;
     unsigned int tableNodeNodeForRow:1;
+    unsigned int tableNodeReusableNodeForRow:1; // if both reusable node methods are implemented
     unsigned int tableViewCanMoveRow:1;
     unsigned int tableNodeCanMoveRow:1;
     unsigned int tableViewMoveRow:1;
@@ -382,6 +385,7 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
     _asyncDataSourceFlags.tableNodeNodeForRow = [_asyncDataSource respondsToSelector:@selector(tableNode:nodeForRowAtIndexPath:)];
     _asyncDataSourceFlags.tableViewNodeBlockForRow = [_asyncDataSource respondsToSelector:@selector(tableView:nodeBlockForRowAtIndexPath:)];
     _asyncDataSourceFlags.tableNodeNodeBlockForRow = [_asyncDataSource respondsToSelector:@selector(tableNode:nodeBlockForRowAtIndexPath:)];
+    _asyncDataSourceFlags.tableNodeReusableNodeForRow = [_asyncDataSource respondsToSelector:@selector(tableNode:reusableNodeClassForRowAtIndexPath:)] && [_asyncDataSource respondsToSelector:@selector(tableNode:nodeConfigurationBlockForRowAtIndexPath:)];
     _asyncDataSourceFlags.tableViewCanMoveRow = [_asyncDataSource respondsToSelector:@selector(tableView:canMoveRowAtIndexPath:)];
     _asyncDataSourceFlags.tableViewMoveRow = [_asyncDataSource respondsToSelector:@selector(tableView:moveRowAtIndexPath:toIndexPath:)];
     _asyncDataSourceFlags.sectionIndexMethods = [_asyncDataSource respondsToSelector:@selector(sectionIndexTitlesForTableView:)] && [_asyncDataSource respondsToSelector:@selector(tableView:sectionForSectionIndexTitle:atIndex:)];
@@ -1166,6 +1170,8 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
 
 - (void)scrollViewDidScroll:(UIScrollView *)scrollView
 {
+  ASBatchFetchingVelocityEstimateAddSample(&_scrollVelocityEstimate, scrollView.contentOffset, CACurrentMediaTime());
+
   // If a scroll happenes the current range mode needs to go to full
   ASInterfaceState interfaceState = [self interfaceStateForRangeController:_rangeController];
   if (ASInterfaceStateIncludesVisible(interfaceState)) {
@@ -1191,14 +1197,18 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
     contentOffset.y - ((targetContentOffset != NULL) ? targetContentOffset->y : 0)
   );
 
-  if (targetContentOffset != NULL) {
-    ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
-    [self _beginBatchFetchingIfNeededWithContentOffset:*targetContentOffset];
-  }
-  
   if (_asyncDelegateFlags.scrollViewWillEndDragging) {
     [_asyncDelegate scrollViewWillEndDragging:scrollView withVelocity:velocity targetContentOffset:(targetContentOffset ? : &contentOffset)];
   }
+
+  // Check after the delegate, which may have moved the target, e.g. for paging.
+  if (targetContentOffset != NULL) {
+    ASDisplayNodeAssert(_batchContext != nil, @"Batch context should exist");
+    _deceleratingTargetContentOffset = *targetContentOffset;
+    // UIKit gives the release velocity in points per millisecond.
+    CGPoint releaseVelocity = CGPointMake(velocity.x * 1000.0, velocity.y * 1000.0);
+    [self _beginBatchFetchingIfNeededWithContentOffset:_deceleratingTargetContentOffset velocity:releaseVelocity];
+  }
 }
 
 - (void)scrollViewDidEndDecelerating:(UIScrollView *)scrollView
@@ -1326,12 +1336,18 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
     return;
   }
   
-  [self _beginBatchFetchingIfNeededWithContentOffset:self.contentOffset];
+  // While decelerating, the scroll view comes to rest at the target it was given when dragging ended, so measure the
+  // remaining distance from there. The decaying velocity still widens the trigger while the fling is fast.
+  if (self.isDecelerating) {
+    [self _beginBatchFetchingIfNeededWithContentOffset:_deceleratingTargetContentOffset velocity:_scrollVelocityEstimate.velocity];
+  } else {
+    [self _beginBatchFetchingIfNeededWithContentOffset:self.contentOffset velocity:CGPointZero];
+  }
 }
 
-- (void)_beginBatchFetchingIfNeededWithContentOffset:(CGPoint)contentOffset
+- (void)_beginBatchFetchingIfNeededWithContentOffset:(CGPoint)contentOffset velocity:(CGPoint)velocity
 {
-  if (ASDisplayShouldFetchBatchForScrollView(self, self.scrollDirection, ASScrollDirectionVerticalDirections, contentOffset)) {
+  if (ASDisplayShouldFetchBatchForScrollView(self, self.scrollDirection, ASScrollDirectionVerticalDirections, contentOffset, velocity)) {
     [self _beginBatchFetching];
   }
 }
@@ -1395,6 +1411,16 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
   return self.scrollDirection;
 }
 
+- (CGFloat)scrollSpeedForRangeController:(ASRangeController *)rangeController
+{
+  // The estimate is only updated while scrolling, so it goes stale once the scroll view comes to rest.
+  CGFloat height = self.bounds.size.height;
+  if ((!self.isTracking && !self.isDecelerating) || height <= 0) {
+    return 0;
+  }
+  return ABS(_scrollVelocityEstimate.velocity.y) / height;
+}
+
 - (ASInterfaceState)interfaceStateForRangeController:(ASRangeController *)rangeController
 {
   return ASInterfaceStateForDisplayNode(self.tableNode, self.window);
@@ -1617,6 +1643,36 @@ static NSString * const kCellReuseIdentifier = @"_ASTableViewCell";
   return block;
 }
 
+- (Class)dataController:(ASDataController *)dataController reusableNodeClassAtIndexPath:(NSIndexPath *)indexPath
+{
+  if (!_asyncDataSourceFlags.tableNodeReusableNodeForRow) {
+    return Nil;
+  }
+  GET_TABLENODE_OR_RETURN(tableNode, Nil);
+  return [_asyncDataSource tableNode:tableNode reusableNodeClassForRowAtIndexPath:indexPath];
+}
+
+- (ASCellNodeConfigurationBlock)dataController:(ASDataController *)dataController nodeConfigurationBlockAtIndexPath:(NSIndexPath *)indexPath
+{
+  ASCellNodeConfigurationBlock block = nil;
+  if (ASTableNode *tableNode = self.tableNode) {
+    block = [_asyncDataSource tableNode:tableNode nodeConfigurationBlockForRowAtIndexPath:indexPath];
+  }
+
+  // Wrap the configuration block like node blocks, since new nodes come straight from the reuse pool
+  __weak __typeof__(self) weakSelf = self;
+  return ^(ASCellNode *node) {
+    __typeof__(self) strongSelf = weakSelf;
+    if (block != nil) {
+      block(node);
+    }
+    [node enterHierarchyState:ASHierarchyStateRangeManaged];
+    // Reused nodes may come from another table or collection, so don't keep what it set.
+    node.interactionDelegate = strongSelf;
+    node.transform = (_inverted ? CATransform3DMakeScale(1, -1, 1) : CATransform3DIdentity);
+  };
+}
+
 - (ASSizeRange)dataController:(ASDataController *)dataController constrainedSizeForNodeAtIndexPath:(NSIndexPath *)indexPath
 {
   ASSizeRange constrainedSize = ASSizeRangeZero;
@@ -13,6 +13,7 @@
 #import <UIKit/UIKit.h>
 
 #import <AsyncDisplayKit/ASTextNode.h>
+#import <AsyncDisplayKit/ASTextNodeTypes.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -35,4 +36,31 @@ NS_ASSUME_NONNULL_BEGIN
 
 @end
 
+@interface ASTextNode (RasterizedTextCache)
+
+/**
+ @abstract Whether text nodes share a cache of rasterized text.
+ @discussion When enabled, a text node that redisplays with the same attributes, constrained size and contents scale
+ as an earlier display (e.g. after its contents were cleared by leaving the display range) copies the cached bitmap
+ instead of re-running TextKit layout and glyph drawing. The cache is bounded by +rasterizedTextCacheByteLimit and is
+ purged on memory warnings.
+ @default NO
+ */
++ (void)setRasterizedTextCacheEnabled:(BOOL)enabled;
++ (BOOL)rasterizedTextCacheEnabled;
+
+/**
+ @abstract The maximum number of bytes of bitmap data held by the rasterized text cache.
+ @default 8MB
+ */
++ (void)setRasterizedTextCacheByteLimit:(NSUInteger)byteLimit;
++ (NSUInteger)rasterizedTextCacheByteLimit;
+
+/**
+ @abstract Hit, miss and eviction counters for the rasterized text cache.
+ */
++ (ASTextNodeRasterCacheMetrics)rasterizedTextCacheMetrics;
+
+@end
+
 NS_ASSUME_NONNULL_END
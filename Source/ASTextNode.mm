@@ -11,7 +11,9 @@
 #import <AsyncDisplayKit/ASTextNode.h>
 #import <AsyncDisplayKit/ASTextNode+Beta.h>
 
+#include <atomic>
 #include <mutex>
+#import <objc/runtime.h>
 #import <tgmath.h>
 
 #import <AsyncDisplayKit/_ASDisplayLayer.h>
@@ -20,11 +22,13 @@
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 
 #import <AsyncDisplayKit/ASTextKitCoreTextAdditions.h>
+#import <AsyncDisplayKit/ASTextKitRasterCache.h>
 #import <AsyncDisplayKit/ASTextKitRenderer+Positioning.h>
 #import <AsyncDisplayKit/ASTextKitShadower.h>
 
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 #import <AsyncDisplayKit/ASLayout.h>
+#import <AsyncDisplayKit/ASMemoryAccountingInternal.h>
 
 #import <AsyncDisplayKit/CoreGraphics+ASConvenience.h>
 #import <AsyncDisplayKit/ASEqualityHashHelpers.h>
@@ -48,6 +52,7 @@ static NSString *ASTextNodeTruncationTokenAttributeName = @"ASTextNodeTruncation
 struct ASTextNodeDrawParameter {
   CGRect bounds;
   UIColor *backgroundColor;
+  CGFloat contentsScale;
 };
 
 #pragma mark - ASTextKitRenderer
@@ -75,13 +80,43 @@ struct ASTextNodeDrawParameter {
 
 @end
 
+// The text storage, glyphs and line fragments TextKit keeps per character, roughly.
+static const NSUInteger ASTextNodeRendererEstimatedBytesPerCharacter = 64;
+
+static NSUInteger ASTextNodeRendererEstimatedBytes(ASTextKitRenderer *renderer)
+{
+  return class_getInstanceSize([ASTextKitRenderer class]) + renderer.attributes.attributedString.length * ASTextNodeRendererEstimatedBytesPerCharacter;
+}
+
+/**
+ NSCache can't be enumerated and doesn't report its total cost, so the estimated bytes of the renderers it holds are
+ kept as a running total: added on cache misses, and subtracted when the cache evicts them. Two threads missing the
+ same key at once replace one renderer with the other without an eviction, which makes the total an overestimate.
+ */
+static std::atomic<NSUInteger> rendererCacheEstimatedBytes(0);
+
+@interface ASTextNodeRendererCacheDelegate : NSObject <NSCacheDelegate>
+@end
+
+@implementation ASTextNodeRendererCacheDelegate
+
+- (void)cache:(NSCache *)cache willEvictObject:(id)obj
+{
+  rendererCacheEstimatedBytes -= ASTextNodeRendererEstimatedBytes(obj);
+}
+
+@end
+
 static NSCache *sharedRendererCache()
 { 
  static dispatch_once_t onceToken;
  static NSCache *__rendererCache = nil;
+ static ASTextNodeRendererCacheDelegate *__rendererCacheDelegate = nil;
  dispatch_once(&onceToken, ^{
    __rendererCache = [[NSCache alloc] init];
    __rendererCache.countLimit = 500; // 500 renders cache
+   __rendererCacheDelegate = [[ASTextNodeRendererCacheDelegate alloc] init];
+   __rendererCache.delegate = __rendererCacheDelegate;
  });
  return __rendererCache;
 }
@@ -103,12 +138,22 @@ static ASTextKitRenderer *rendererForAttributes(ASTextKitAttributes attributes,
   ASTextKitRenderer *renderer = [cache objectForKey:key];
   if (renderer == nil) {
     renderer = [[ASTextKitRenderer alloc] initWithTextKitAttributes:attributes constrainedSize:constrainedSize];
-    [cache setObject:renderer forKey:key];
+    // The cache has no cost limit, so the cost is only used for accounting.
+    NSUInteger cost = ASTextNodeRendererEstimatedBytes(renderer);
+    rendererCacheEstimatedBytes += cost;
+    [cache setObject:renderer forKey:key cost:cost];
   }
   
   return renderer;
 }
 
+NSUInteger ASTextNodeRendererCacheEstimatedBytes(void)
+{
+  return rendererCacheEstimatedBytes.load();
+}
+
+static BOOL __rasterizedTextCacheEnabled = NO;
+
 @interface ASTextNode () <UIGestureRecognizerDelegate>
 
 @end
@@ -441,7 +486,8 @@ static NSArray *DefaultLinkAttributeNames = @[ NSLinkAttributeName ];
   
   _drawParameter = {
     .backgroundColor = self.backgroundColor,
-    .bounds = self.bounds
+    .bounds = self.bounds,
+    .contentsScale = self.contentsScaleForDisplay
   };
   return nil;
 }
@@ -462,16 +508,31 @@ static NSArray *DefaultLinkAttributeNames = @[ NSLinkAttributeName ];
   
   CGContextTranslateCTM(context, _textContainerInset.left, _textContainerInset.top);
   
-  ASTextKitRenderer *renderer = [self _rendererWithBoundsSlow:drawParameterBounds];
-  
   // Fill background
   if (backgroundColor != nil) {
     [backgroundColor setFill];
     UIRectFillUsingBlendMode(CGContextGetClipBoundingBox(context), kCGBlendModeCopy);
   }
   
-  // Draw text
-  [renderer drawInContext:context bounds:drawParameterBounds];
+  // Draw text, reusing an earlier rasterization when possible
+  UIImage *rasterizedText = nil;
+  if (__rasterizedTextCacheEnabled && CGPointEqualToPoint(drawParameterBounds.origin, CGPointZero)) {
+    CGSize constrainedSize = drawParameterBounds.size;
+    constrainedSize.width -= (_textContainerInset.left + _textContainerInset.right);
+    constrainedSize.height -= (_textContainerInset.top + _textContainerInset.bottom);
+    rasterizedText = [[ASTextKitRasterCache sharedCache] imageForAttributes:[self _rendererAttributes]
+                                                            constrainedSize:constrainedSize
+                                                              contentsScale:drawParameter.contentsScale
+                                                              rendererBlock:^{
+      return [self _rendererWithBoundsSlow:drawParameterBounds];
+    }];
+    [rasterizedText drawInRect:(CGRect){ .size = constrainedSize }];
+  }
+  
+  if (rasterizedText == nil) {
+    ASTextKitRenderer *renderer = [self _rendererWithBoundsSlow:drawParameterBounds];
+    [renderer drawInContext:context bounds:drawParameterBounds];
+  }
   
   CGContextRestoreGState(context);
 }
@@ -1344,6 +1405,38 @@ static NSAttributedString *DefaultTruncationAttributedString()
 
 @end
 
+@implementation ASTextNode (RasterizedTextCache)
+
++ (void)setRasterizedTextCacheEnabled:(BOOL)enabled
+{
+  __rasterizedTextCacheEnabled = enabled;
+  if (enabled == NO) {
+    [[ASTextKitRasterCache sharedCache] removeAllImages];
+  }
+}
+
++ (BOOL)rasterizedTextCacheEnabled
+{
+  return __rasterizedTextCacheEnabled;
+}
+
++ (void)setRasterizedTextCacheByteLimit:(NSUInteger)byteLimit
+{
+  [ASTextKitRasterCache sharedCache].byteLimit = byteLimit;
+}
+
++ (NSUInteger)rasterizedTextCacheByteLimit
+{
+  return [ASTextKitRasterCache sharedCache].byteLimit;
+}
+
++ (ASTextNodeRasterCacheMetrics)rasterizedTextCacheMetrics
+{
+  return [[ASTextKitRasterCache sharedCache] metrics];
+}
+
+@end
+
 @implementation ASTextNode (Deprecated)
 
 - (void)setAttributedString:(NSAttributedString *)attributedString
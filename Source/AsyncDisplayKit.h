@@ -24,6 +24,7 @@
 
 #import <AsyncDisplayKit/ASImageProtocols.h>
 #import <AsyncDisplayKit/ASBasicImageDownloader.h>
+#import <AsyncDisplayKit/ASBasicImageCache.h>
 #import <AsyncDisplayKit/ASPINRemoteImageDownloader.h>
 #import <AsyncDisplayKit/ASMultiplexImageNode.h>
 #import <AsyncDisplayKit/ASNetworkImageNode.h>
@@ -61,8 +62,11 @@
 #import <AsyncDisplayKit/ASNavigationController.h>
 #import <AsyncDisplayKit/ASTabBarController.h>
 #import <AsyncDisplayKit/ASRangeControllerUpdateRangeProtocol+Beta.h>
+#import <AsyncDisplayKit/ASAdaptiveRangePolicy.h>
 
 #import <AsyncDisplayKit/ASDataController.h>
+#import <AsyncDisplayKit/ASSnapshot.h>
+#import <AsyncDisplayKit/ASCellNodeReusePool.h>
 
 #import <AsyncDisplayKit/ASLayout.h>
 #import <AsyncDisplayKit/ASDimension.h>
@@ -104,6 +108,10 @@
 #import <AsyncDisplayKit/ASVisibilityProtocols.h>
 #import <AsyncDisplayKit/ASWeakSet.h>
 #import <AsyncDisplayKit/ASEventLog.h>
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+#import <AsyncDisplayKit/ASHitchDetector.h>
+#import <AsyncDisplayKit/ASMemoryAccounting.h>
 
 #import <AsyncDisplayKit/CoreGraphics+ASConvenience.h>
 #import <AsyncDisplayKit/NSMutableAttributedString+TextKitAdditions.h>
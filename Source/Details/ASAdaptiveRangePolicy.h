@@ -0,0 +1,97 @@
+//
+//  ASAdaptiveRangePolicy.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <QuartzCore/QuartzCore.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASLayoutRangeType.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * One change made by an @c ASAdaptiveRangePolicy to the tuning parameters of a range type, so that traces can be
+ * compared against the static tuning parameters.
+ */
+typedef struct {
+  CFTimeInterval timestamp;
+  ASLayoutRangeType rangeType;
+  /// The scroll speed the decision was made for, in screenfuls per second.
+  CGFloat scrollSpeed;
+  /// The latency estimate for the range type, in seconds. Zero until a latency has been recorded.
+  NSTimeInterval latency;
+  ASRangeTuningParameters staticTuningParameters;
+  ASRangeTuningParameters adaptedTuningParameters;
+} ASRangeTuningDecision;
+
+typedef void (^ASRangeTuningDecisionHandler)(ASRangeTuningDecision decision);
+
+/**
+ * @abstract Scales the buffers of a range controller in full range mode with scroll speed and measured latency.
+ *
+ * @discussion The leading buffer grows to cover the distance scrolled while a cell's work is in progress, so that
+ * cells are ready by the time they come onscreen, and shrinks back to the static value gradually once scrolling
+ * slows down so that work in flight isn't thrown away. The trailing buffer shrinks as the scroll speed increases.
+ * When cells cross the whole display range faster than they can be displayed, the display range is cut to its minimum
+ * instead, since rendering those cells would be wasted work.
+ *
+ * At rest, and until latencies have been recorded, the static tuning parameters are used unchanged. The adapted
+ * tuning parameters are kept within the configured bounds, widened to include the static tuning parameters.
+ *
+ * This class is not thread-safe; use it on the main thread.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASAdaptiveRangePolicy : NSObject
+
+/**
+ * Sets the bounds of the adapted tuning parameters for a range type.
+ *
+ * The defaults are { 0.25, 0.25 } to { 2, 1 } screenfuls for the display range, and { 0.5, 0.25 } to { 6, 2 }
+ * screenfuls for the preload range.
+ */
+- (void)setMinimumTuningParameters:(ASRangeTuningParameters)minimumTuningParameters
+           maximumTuningParameters:(ASRangeTuningParameters)maximumTuningParameters
+                      forRangeType:(ASLayoutRangeType)rangeType;
+
+- (ASRangeTuningParameters)minimumTuningParametersForRangeType:(ASLayoutRangeType)rangeType;
+
+- (ASRangeTuningParameters)maximumTuningParametersForRangeType:(ASLayoutRangeType)rangeType;
+
+/**
+ * Records how long the work for a range type took for one cell, in seconds.
+ *
+ * The range controller records display latencies itself. Preload latencies depend on the app's data sources, so apps
+ * that want the preload range to adapt should record them, e.g. when an image download for a cell finishes.
+ */
+- (void)recordLatency:(NSTimeInterval)latency forRangeType:(ASLayoutRangeType)rangeType;
+
+/**
+ * A moving average of the recorded latencies for the range type, or zero if none have been recorded.
+ */
+- (NSTimeInterval)estimatedLatencyForRangeType:(ASLayoutRangeType)rangeType;
+
+/**
+ * Returns the tuning parameters to use in place of the static ones.
+ *
+ * @param scrollSpeed The scroll speed along the scrollable axis, in screenfuls per second.
+ * @param timestamp The current time, used to pace the shrinking of the leading buffer.
+ */
+- (ASRangeTuningParameters)tuningParametersForRangeType:(ASLayoutRangeType)rangeType
+                                 staticTuningParameters:(ASRangeTuningParameters)staticTuningParameters
+                                            scrollSpeed:(CGFloat)scrollSpeed
+                                              timestamp:(CFTimeInterval)timestamp;
+
+/**
+ * Called with every decision whose adapted tuning parameters differ from the previous decision for its range type.
+ */
+@property (nonatomic, copy, nullable) ASRangeTuningDecisionHandler decisionHandler;
+
+@end
+
+NS_ASSUME_NONNULL_END
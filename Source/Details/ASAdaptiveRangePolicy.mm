@@ -0,0 +1,171 @@
+//
+//  ASAdaptiveRangePolicy.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASAdaptiveRangePolicy.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+
+// How far beyond the distance scrolled during a cell's latency the leading buffer reaches, to absorb jitter.
+static CGFloat const kASAdaptiveRangeLatencyHeadroom = 1.5;
+
+// How quickly a grown leading buffer shrinks back, in screenfuls per second.
+static CGFloat const kASAdaptiveRangeLeadingShrinkRate = 1.0;
+
+// The weight of a new sample in the latency moving average.
+static NSTimeInterval const kASAdaptiveRangeLatencySmoothing = 0.25;
+
+typedef struct {
+  ASRangeTuningParameters minimum;
+  ASRangeTuningParameters maximum;
+  NSTimeInterval latency;
+  BOOL hasLeadingBuffer;
+  CGFloat leadingBuffer;
+  CFTimeInterval leadingBufferTimestamp;
+  BOOL hasDecision;
+  ASRangeTuningParameters lastAdaptedTuningParameters;
+} ASAdaptiveRangeState;
+
+static inline CGFloat ASAdaptiveRangeClamp(CGFloat value, CGFloat minimum, CGFloat maximum)
+{
+  return MIN(MAX(value, minimum), maximum);
+}
+
+@implementation ASAdaptiveRangePolicy
+{
+  ASAdaptiveRangeState _states[ASLayoutRangeTypeCount];
+}
+
+- (instancetype)init
+{
+  if (!(self = [super init])) {
+    return nil;
+  }
+  _states[ASLayoutRangeTypeDisplay].minimum = { .leadingBufferScreenfuls = 0.25, .trailingBufferScreenfuls = 0.25 };
+  _states[ASLayoutRangeTypeDisplay].maximum = { .leadingBufferScreenfuls = 2, .trailingBufferScreenfuls = 1 };
+  _states[ASLayoutRangeTypePreload].minimum = { .leadingBufferScreenfuls = 0.5, .trailingBufferScreenfuls = 0.25 };
+  _states[ASLayoutRangeTypePreload].maximum = { .leadingBufferScreenfuls = 6, .trailingBufferScreenfuls = 2 };
+  return self;
+}
+
+#pragma mark - Bounds
+
+- (void)setMinimumTuningParameters:(ASRangeTuningParameters)minimumTuningParameters
+           maximumTuningParameters:(ASRangeTuningParameters)maximumTuningParameters
+                      forRangeType:(ASLayoutRangeType)rangeType
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  ASDisplayNodeAssert(minimumTuningParameters.leadingBufferScreenfuls <= maximumTuningParameters.leadingBufferScreenfuls
+                      && minimumTuningParameters.trailingBufferScreenfuls <= maximumTuningParameters.trailingBufferScreenfuls,
+                      @"Minimum tuning parameters must not exceed the maximum tuning parameters");
+  _states[rangeType].minimum = minimumTuningParameters;
+  _states[rangeType].maximum = maximumTuningParameters;
+}
+
+- (ASRangeTuningParameters)minimumTuningParametersForRangeType:(ASLayoutRangeType)rangeType
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  return _states[rangeType].minimum;
+}
+
+- (ASRangeTuningParameters)maximumTuningParametersForRangeType:(ASLayoutRangeType)rangeType
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  return _states[rangeType].maximum;
+}
+
+#pragma mark - Latency
+
+- (void)recordLatency:(NSTimeInterval)latency forRangeType:(ASLayoutRangeType)rangeType
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  if (!(latency > 0)) {
+    return;
+  }
+  ASAdaptiveRangeState &state = _states[rangeType];
+  if (state.latency == 0) {
+    state.latency = latency;
+  } else {
+    state.latency += (latency - state.latency) * kASAdaptiveRangeLatencySmoothing;
+  }
+}
+
+- (NSTimeInterval)estimatedLatencyForRangeType:(ASLayoutRangeType)rangeType
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  return _states[rangeType].latency;
+}
+
+#pragma mark - Tuning Parameters
+
+- (ASRangeTuningParameters)tuningParametersForRangeType:(ASLayoutRangeType)rangeType
+                                 staticTuningParameters:(ASRangeTuningParameters)staticTuningParameters
+                                            scrollSpeed:(CGFloat)scrollSpeed
+                                              timestamp:(CFTimeInterval)timestamp
+{
+  ASDisplayNodeAssert(rangeType < ASLayoutRangeTypeCount, @"Invalid range type");
+  ASAdaptiveRangeState &state = _states[rangeType];
+  CGFloat speed = isfinite(scrollSpeed) ? fabs(scrollSpeed) : 0;
+  NSTimeInterval latency = state.latency;
+
+  // Widen the bounds to include the static tuning parameters, so that they are always used unchanged at rest.
+  ASRangeTuningParameters minimum = {
+    .leadingBufferScreenfuls = MIN(state.minimum.leadingBufferScreenfuls, staticTuningParameters.leadingBufferScreenfuls),
+    .trailingBufferScreenfuls = MIN(state.minimum.trailingBufferScreenfuls, staticTuningParameters.trailingBufferScreenfuls)
+  };
+  ASRangeTuningParameters maximum = {
+    .leadingBufferScreenfuls = MAX(state.maximum.leadingBufferScreenfuls, staticTuningParameters.leadingBufferScreenfuls),
+    .trailingBufferScreenfuls = MAX(state.maximum.trailingBufferScreenfuls, staticTuningParameters.trailingBufferScreenfuls)
+  };
+
+  // Reach far enough ahead to cover the distance scrolled while a cell's work is in progress.
+  CGFloat leading = MAX(staticTuningParameters.leadingBufferScreenfuls, speed * latency * kASAdaptiveRangeLatencyHeadroom);
+  if (state.hasLeadingBuffer) {
+    // Shrink gradually so that a short pause doesn't throw away work in flight for cells just ahead.
+    CFTimeInterval elapsed = MAX(timestamp - state.leadingBufferTimestamp, 0);
+    leading = MAX(leading, state.leadingBuffer - elapsed * kASAdaptiveRangeLeadingShrinkRate);
+  }
+  leading = ASAdaptiveRangeClamp(leading, minimum.leadingBufferScreenfuls, maximum.leadingBufferScreenfuls);
+  state.hasLeadingBuffer = YES;
+  state.leadingBuffer = leading;
+  state.leadingBufferTimestamp = timestamp;
+
+  // Content behind a fast scroll is unlikely to be revisited soon.
+  CGFloat trailing = staticTuningParameters.trailingBufferScreenfuls / (1 + speed);
+  trailing = ASAdaptiveRangeClamp(trailing, minimum.trailingBufferScreenfuls, maximum.trailingBufferScreenfuls);
+
+  ASRangeTuningParameters adapted = { .leadingBufferScreenfuls = leading, .trailingBufferScreenfuls = trailing };
+
+  // A cell takes (1 + leading) / speed seconds to cross the screen and its leading buffer. If displaying it takes
+  // longer than that, it will be offscreen before it's drawn.
+  if (rangeType == ASLayoutRangeTypeDisplay && latency > 0
+      && speed * latency > 1 + staticTuningParameters.leadingBufferScreenfuls) {
+    adapted = minimum;
+  }
+
+  if (!state.hasDecision || !ASRangeTuningParametersEqualToRangeTuningParameters(adapted, state.lastAdaptedTuningParameters)) {
+    state.hasDecision = YES;
+    state.lastAdaptedTuningParameters = adapted;
+    if (_decisionHandler) {
+      ASRangeTuningDecision decision = {
+        .timestamp = timestamp,
+        .rangeType = rangeType,
+        .scrollSpeed = speed,
+        .latency = latency,
+        .staticTuningParameters = staticTuningParameters,
+        .adaptedTuningParameters = adapted
+      };
+      _decisionHandler(decision);
+    }
+  }
+
+  return adapted;
+}
+
+@end
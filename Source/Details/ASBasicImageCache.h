@@ -0,0 +1,116 @@
+//
+//  ASBasicImageCache.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASImageProtocols.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Counters for @c ASBasicImageCache.
+ */
+typedef struct {
+  /// Lookups served from the memory cache.
+  NSUInteger memoryHitCount;
+  /// Lookups served from the disk cache.
+  NSUInteger diskHitCount;
+  /// Lookups found in neither cache.
+  NSUInteger missCount;
+  /// Images dropped from memory to stay within the memory byte limit.
+  NSUInteger memoryEvictionCount;
+  /// Files removed from disk to stay within the disk byte limit.
+  NSUInteger diskEvictionCount;
+  /// Bytes of decoded bitmap data currently held in memory.
+  NSUInteger memoryByteCount;
+  /// Bytes of encoded image data currently held on disk. Only accurate once the disk index has been loaded.
+  unsigned long long diskByteCount;
+} ASBasicImageCacheMetrics;
+
+/**
+ * @abstract A two level image cache used by @c ASBasicImageDownloader.
+ *
+ * @discussion Decoded images are held in a memory cache that is split into independently locked shards. The memory
+ * byte limit applies to all shards together: adding an image evicts the least recently used images of its own shard
+ * first, then of the others. Encoded image data is written to
+ * a directory in the user's caches directory, evicting least recently used files to stay within the disk byte limit,
+ * and is read back memory-mapped.
+ *
+ * Only images decoded at full size are put in the memory cache, so a downsampled image is never returned to a
+ * node that needs the full size image.
+ *
+ * The memory cache is emptied on memory warnings. This class is thread-safe.
+ *
+ * It doesn't implement @c -clearFetchedImageFromCacheWithURL:, which image nodes call whenever they leave the preload
+ * range: a cell scrolled back into the range should find its image in memory. Images are only evicted by the byte
+ * limit, memory warnings and the explicit removal methods below.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASBasicImageCache : NSObject <ASImageCacheProtocol>
+
+/**
+ * @param name A name for the cache, used as the name of its directory in the user's caches directory.
+ * @param memoryByteLimit The maximum number of bytes of decoded images held in memory.
+ * @param diskByteLimit The maximum number of bytes of encoded image data held on disk.
+ */
+- (instancetype)initWithName:(NSString *)name memoryByteLimit:(NSUInteger)memoryByteLimit diskByteLimit:(unsigned long long)diskByteLimit;
+
+/**
+ * @param directoryURL The directory to store encoded image data in. It is created if necessary.
+ * @param memoryByteLimit The maximum number of bytes of decoded images held in memory.
+ * @param diskByteLimit The maximum number of bytes of encoded image data held on disk.
+ */
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL memoryByteLimit:(NSUInteger)memoryByteLimit diskByteLimit:(unsigned long long)diskByteLimit NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, strong, readonly) NSURL *directoryURL;
+
+@property (atomic, assign) NSUInteger memoryByteLimit;
+
+@property (atomic, assign) unsigned long long diskByteLimit;
+
+/**
+ * Adds an image to the cache.
+ *
+ * @param image The decoded image. Put in the memory cache unless it was downsampled.
+ * @param data The encoded image data to write to disk, or nil to only cache in memory. Written asynchronously.
+ * @param downsampled Whether the image was decoded at less than its full size.
+ */
+- (void)setImage:(nullable UIImage *)image data:(nullable NSData *)data downsampled:(BOOL)downsampled forURL:(NSURL *)URL;
+
+/**
+ * Returns the image for the URL if it is in the memory cache. Never touches the disk.
+ */
+- (nullable UIImage *)memoryCachedImageForURL:(NSURL *)URL;
+
+/**
+ * Whether encoded data for the URL is on disk. Blocks on the disk queue; avoid calling on the main thread.
+ */
+- (BOOL)containsDataOnDiskForURL:(NSURL *)URL;
+
+/**
+ * Removes the image for the URL from the memory cache. Its data stays on disk.
+ */
+- (void)removeImageFromMemoryForURL:(NSURL *)URL;
+
+- (void)removeAllImagesFromMemory;
+
+/**
+ * Removes all images from memory and disk. The disk is cleared asynchronously.
+ */
+- (void)removeAllImages;
+
+- (ASBasicImageCacheMetrics)metrics;
+
+- (void)resetMetrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,528 @@
+//
+//  ASBasicImageCache.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASBasicImageCache.h>
+
+#import <CommonCrypto/CommonDigest.h>
+#include <atomic>
+#include <list>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASImageContainerProtocolCategories.h>
+#import <AsyncDisplayKit/ASImageDecoding.h>
+#import <AsyncDisplayKit/ASThread.h>
+
+/// Lookups for different URLs rarely contend because each shard has its own lock.
+static const NSUInteger kASBasicImageCacheShardCount = 8;
+
+#pragma mark - Memory
+
+typedef std::list<NSString *> ASBasicImageCacheLRUList;
+
+@interface ASBasicImageCacheMemoryEntry : NSObject
+{
+@package
+  UIImage *_image;
+  NSUInteger _cost;
+  ASBasicImageCacheLRUList::iterator _lruPosition;
+}
+@end
+
+@implementation ASBasicImageCacheMemoryEntry
+@end
+
+struct ASBasicImageCacheShard {
+  ASDN::Mutex lock;
+  NSMutableDictionary<NSString *, ASBasicImageCacheMemoryEntry *> *entries;
+  // Front is least recently used.
+  ASBasicImageCacheLRUList lruList;
+};
+
+#pragma mark - Disk
+
+@interface ASBasicImageCacheDiskEntry : NSObject
+{
+@package
+  unsigned long long _size;
+  NSDate *_lastAccessDate;
+}
+@end
+
+@implementation ASBasicImageCacheDiskEntry
+@end
+
+static NSString *ASBasicImageCacheFileNameForKey(NSString *key)
+{
+  NSData *keyData = [key dataUsingEncoding:NSUTF8StringEncoding];
+  unsigned char digest[CC_SHA256_DIGEST_LENGTH];
+  CC_SHA256(keyData.bytes, (CC_LONG)keyData.length, digest);
+  NSMutableString *fileName = [NSMutableString stringWithCapacity:CC_SHA256_DIGEST_LENGTH * 2];
+  for (NSUInteger i = 0; i < CC_SHA256_DIGEST_LENGTH; i++) {
+    [fileName appendFormat:@"%02x", digest[i]];
+  }
+  return fileName;
+}
+
+static NSUInteger ASBasicImageCacheCostForImage(UIImage *image)
+{
+  CGImageRef imageRef = image.CGImage;
+  return CGImageGetBytesPerRow(imageRef) * CGImageGetHeight(imageRef);
+}
+
+#pragma mark - Cache
+
+@implementation ASBasicImageCache {
+  ASBasicImageCacheShard _shards[kASBasicImageCacheShardCount];
+  std::atomic<NSUInteger> _memoryByteLimit;
+  // Across all shards, so that the limit applies to the cache as a whole and any image up to the limit can be held.
+  std::atomic<NSUInteger> _memoryByteCount;
+
+  // Only accessed on _diskQueue.
+  dispatch_queue_t _diskQueue;
+  NSMutableDictionary<NSString *, ASBasicImageCacheDiskEntry *> *_diskIndex;
+  BOOL _diskIndexLoaded;
+  unsigned long long _diskIndexByteCount;
+  unsigned long long _diskByteLimit;
+
+  std::atomic<NSUInteger> _memoryHitCount;
+  std::atomic<NSUInteger> _diskHitCount;
+  std::atomic<NSUInteger> _missCount;
+  std::atomic<NSUInteger> _memoryEvictionCount;
+  std::atomic<NSUInteger> _diskEvictionCount;
+  std::atomic<unsigned long long> _diskByteCount;
+}
+
+- (instancetype)initWithName:(NSString *)name memoryByteLimit:(NSUInteger)memoryByteLimit diskByteLimit:(unsigned long long)diskByteLimit
+{
+  NSURL *cachesURL = [[[NSFileManager defaultManager] URLsForDirectory:NSCachesDirectory inDomains:NSUserDomainMask] firstObject];
+  return [self initWithDirectoryURL:[cachesURL URLByAppendingPathComponent:name isDirectory:YES]
+                    memoryByteLimit:memoryByteLimit
+                      diskByteLimit:diskByteLimit];
+}
+
+- (instancetype)initWithDirectoryURL:(NSURL *)directoryURL memoryByteLimit:(NSUInteger)memoryByteLimit diskByteLimit:(unsigned long long)diskByteLimit
+{
+  if (self = [super init]) {
+    _directoryURL = directoryURL;
+    _memoryByteLimit = memoryByteLimit;
+    _diskByteLimit = diskByteLimit;
+    for (NSUInteger i = 0; i < kASBasicImageCacheShardCount; i++) {
+      _shards[i].entries = [NSMutableDictionary dictionary];
+    }
+    _diskQueue = dispatch_queue_create("org.AsyncDisplayKit.ASBasicImageCache.diskQueue", DISPATCH_QUEUE_SERIAL);
+    _diskIndex = [NSMutableDictionary dictionary];
+
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(didReceiveMemoryWarning:)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification
+{
+  [self removeAllImagesFromMemory];
+}
+
+#pragma mark Memory Cache
+
+- (NSUInteger)_shardIndexForKey:(NSString *)key
+{
+  return key.hash % kASBasicImageCacheShardCount;
+}
+
+- (NSUInteger)memoryByteLimit
+{
+  return _memoryByteLimit;
+}
+
+- (void)setMemoryByteLimit:(NSUInteger)memoryByteLimit
+{
+  _memoryByteLimit = memoryByteLimit;
+  [self _trimMemoryStartingAtShardIndex:0];
+}
+
+- (void)_locked_removeEntryForKey:(NSString *)key fromShard:(ASBasicImageCacheShard &)shard
+{
+  ASBasicImageCacheMemoryEntry *entry = shard.entries[key];
+  if (entry != nil) {
+    _memoryByteCount -= entry->_cost;
+    shard.lruList.erase(entry->_lruPosition);
+    [shard.entries removeObjectForKey:key];
+  }
+}
+
+/**
+ * Evicts the least recently used images of the shard until the whole cache is within the limit, or only the image
+ * for keptKey is left in the shard.
+ */
+- (void)_locked_trimShard:(ASBasicImageCacheShard &)shard keepingKey:(NSString *)keptKey
+{
+  while (_memoryByteCount > _memoryByteLimit && shard.lruList.empty() == NO) {
+    NSString *key = shard.lruList.front();
+    if (keptKey != nil && [key isEqualToString:keptKey]) {
+      break;
+    }
+    [self _locked_removeEntryForKey:key fromShard:shard];
+    _memoryEvictionCount++;
+  }
+}
+
+/**
+ * Evicts from each shard in turn, locking one at a time, until the whole cache is within the limit.
+ */
+- (void)_trimMemoryStartingAtShardIndex:(NSUInteger)firstIndex
+{
+  for (NSUInteger i = 0; i < kASBasicImageCacheShardCount && _memoryByteCount > _memoryByteLimit; i++) {
+    ASBasicImageCacheShard &shard = _shards[(firstIndex + i) % kASBasicImageCacheShardCount];
+    ASDN::MutexLocker l(shard.lock);
+    [self _locked_trimShard:shard keepingKey:nil];
+  }
+}
+
+- (UIImage *)_memoryCachedImageForKey:(NSString *)key
+{
+  ASBasicImageCacheShard &shard = _shards[[self _shardIndexForKey:key]];
+  ASDN::MutexLocker l(shard.lock);
+  ASBasicImageCacheMemoryEntry *entry = shard.entries[key];
+  if (entry == nil) {
+    return nil;
+  }
+  shard.lruList.splice(shard.lruList.end(), shard.lruList, entry->_lruPosition);
+  return entry->_image;
+}
+
+- (void)_setMemoryCachedImage:(UIImage *)image forKey:(NSString *)key
+{
+  NSUInteger cost = ASBasicImageCacheCostForImage(image);
+  if (cost > _memoryByteLimit) {
+    return;
+  }
+
+  NSUInteger shardIndex = [self _shardIndexForKey:key];
+  {
+    ASBasicImageCacheShard &shard = _shards[shardIndex];
+    ASDN::MutexLocker l(shard.lock);
+    [self _locked_removeEntryForKey:key fromShard:shard];
+
+    ASBasicImageCacheMemoryEntry *entry = [[ASBasicImageCacheMemoryEntry alloc] init];
+    entry->_image = image;
+    entry->_cost = cost;
+    entry->_lruPosition = shard.lruList.insert(shard.lruList.end(), key);
+    shard.entries[key] = entry;
+    _memoryByteCount += cost;
+
+    // Make room in the shard being written first, which is already locked.
+    [self _locked_trimShard:shard keepingKey:key];
+  }
+
+  if (_memoryByteCount > _memoryByteLimit) {
+    [self _trimMemoryStartingAtShardIndex:shardIndex + 1];
+  }
+}
+
+- (void)_removeMemoryCachedImageForKey:(NSString *)key
+{
+  ASBasicImageCacheShard &shard = _shards[[self _shardIndexForKey:key]];
+  ASDN::MutexLocker l(shard.lock);
+  [self _locked_removeEntryForKey:key fromShard:shard];
+}
+
+- (UIImage *)memoryCachedImageForURL:(NSURL *)URL
+{
+  return [self _memoryCachedImageForKey:URL.absoluteString];
+}
+
+- (void)removeImageFromMemoryForURL:(NSURL *)URL
+{
+  if (URL == nil) {
+    return;
+  }
+  [self _removeMemoryCachedImageForKey:URL.absoluteString];
+}
+
+- (void)removeAllImagesFromMemory
+{
+  for (NSUInteger i = 0; i < kASBasicImageCacheShardCount; i++) {
+    ASDN::MutexLocker l(_shards[i].lock);
+    for (ASBasicImageCacheMemoryEntry *entry in _shards[i].entries.objectEnumerator) {
+      _memoryByteCount -= entry->_cost;
+    }
+    [_shards[i].entries removeAllObjects];
+    _shards[i].lruList.clear();
+  }
+}
+
+#pragma mark Disk Cache
+
+- (unsigned long long)diskByteLimit
+{
+  __block unsigned long long diskByteLimit;
+  dispatch_sync(_diskQueue, ^{
+    diskByteLimit = _diskByteLimit;
+  });
+  return diskByteLimit;
+}
+
+- (void)setDiskByteLimit:(unsigned long long)diskByteLimit
+{
+  dispatch_async(_diskQueue, ^{
+    _diskByteLimit = diskByteLimit;
+    [self _onDiskQueue_trimToByteLimit];
+  });
+}
+
+- (NSURL *)_fileURLForFileName:(NSString *)fileName
+{
+  return [_directoryURL URLByAppendingPathComponent:fileName isDirectory:NO];
+}
+
+- (void)_onDiskQueue_loadIndexIfNeeded
+{
+  if (_diskIndexLoaded) {
+    return;
+  }
+  _diskIndexLoaded = YES;
+
+  NSFileManager *fileManager = [NSFileManager defaultManager];
+  [fileManager createDirectoryAtURL:_directoryURL withIntermediateDirectories:YES attributes:nil error:NULL];
+
+  NSArray *keys = @[ NSURLFileSizeKey, NSURLContentModificationDateKey ];
+  NSArray<NSURL *> *fileURLs = [fileManager contentsOfDirectoryAtURL:_directoryURL
+                                          includingPropertiesForKeys:keys
+                                                             options:NSDirectoryEnumerationSkipsHiddenFiles
+                                                               error:NULL];
+  for (NSURL *fileURL in fileURLs) {
+    NSDictionary *values = [fileURL resourceValuesForKeys:keys error:NULL];
+    ASBasicImageCacheDiskEntry *entry = [[ASBasicImageCacheDiskEntry alloc] init];
+    entry->_size = [values[NSURLFileSizeKey] unsignedLongLongValue];
+    entry->_lastAccessDate = values[NSURLContentModificationDateKey] ?: [NSDate distantPast];
+    _diskIndex[fileURL.lastPathComponent] = entry;
+    _diskIndexByteCount += entry->_size;
+  }
+  _diskByteCount = _diskIndexByteCount;
+  [self _onDiskQueue_trimToByteLimit];
+}
+
+- (void)_onDiskQueue_removeFileName:(NSString *)fileName
+{
+  ASBasicImageCacheDiskEntry *entry = _diskIndex[fileName];
+  if (entry == nil) {
+    return;
+  }
+  [[NSFileManager defaultManager] removeItemAtURL:[self _fileURLForFileName:fileName] error:NULL];
+  _diskIndexByteCount -= entry->_size;
+  [_diskIndex removeObjectForKey:fileName];
+  _diskByteCount = _diskIndexByteCount;
+}
+
+- (void)_onDiskQueue_trimToByteLimit
+{
+  if (_diskIndexLoaded == NO || _diskIndexByteCount <= _diskByteLimit) {
+    return;
+  }
+
+  // Sorting is only paid for when the limit is exceeded.
+  NSArray<NSString *> *fileNames = [_diskIndex keysSortedByValueUsingComparator:^NSComparisonResult(ASBasicImageCacheDiskEntry *a, ASBasicImageCacheDiskEntry *b) {
+    return [a->_lastAccessDate compare:b->_lastAccessDate];
+  }];
+  for (NSString *fileName in fileNames) {
+    if (_diskIndexByteCount <= _diskByteLimit) {
+      break;
+    }
+    [self _onDiskQueue_removeFileName:fileName];
+    _diskEvictionCount++;
+  }
+}
+
+- (void)_onDiskQueue_writeData:(NSData *)data forKey:(NSString *)key
+{
+  [self _onDiskQueue_loadIndexIfNeeded];
+
+  NSString *fileName = ASBasicImageCacheFileNameForKey(key);
+  [self _onDiskQueue_removeFileName:fileName];
+  if (data.length > _diskByteLimit) {
+    return;
+  }
+  if ([data writeToURL:[self _fileURLForFileName:fileName] options:NSDataWritingAtomic error:NULL] == NO) {
+    return;
+  }
+
+  ASBasicImageCacheDiskEntry *entry = [[ASBasicImageCacheDiskEntry alloc] init];
+  entry->_size = data.length;
+  entry->_lastAccessDate = [NSDate date];
+  _diskIndex[fileName] = entry;
+  _diskIndexByteCount += entry->_size;
+  _diskByteCount = _diskIndexByteCount;
+  [self _onDiskQueue_trimToByteLimit];
+}
+
+- (NSData *)_onDiskQueue_dataForKey:(NSString *)key
+{
+  [self _onDiskQueue_loadIndexIfNeeded];
+
+  NSString *fileName = ASBasicImageCacheFileNameForKey(key);
+  ASBasicImageCacheDiskEntry *entry = _diskIndex[fileName];
+  if (entry == nil) {
+    return nil;
+  }
+
+  NSURL *fileURL = [self _fileURLForFileName:fileName];
+  NSData *data = [NSData dataWithContentsOfURL:fileURL options:NSDataReadingMappedIfSafe error:NULL];
+  if (data == nil) {
+    [self _onDiskQueue_removeFileName:fileName];
+    return nil;
+  }
+
+  // Record the access on the file itself so that LRU order survives relaunches.
+  entry->_lastAccessDate = [NSDate date];
+  [fileURL setResourceValue:entry->_lastAccessDate forKey:NSURLContentModificationDateKey error:NULL];
+  return data;
+}
+
+- (BOOL)containsDataOnDiskForURL:(NSURL *)URL
+{
+  ASDisplayNodeAssertNotNil(URL, @"URL must not be nil");
+  NSString *fileName = ASBasicImageCacheFileNameForKey(URL.absoluteString);
+  __block BOOL contains;
+  dispatch_sync(_diskQueue, ^{
+    [self _onDiskQueue_loadIndexIfNeeded];
+    contains = (_diskIndex[fileName] != nil);
+  });
+  return contains;
+}
+
+- (void)removeAllImages
+{
+  [self removeAllImagesFromMemory];
+  dispatch_async(_diskQueue, ^{
+    [[NSFileManager defaultManager] removeItemAtURL:_directoryURL error:NULL];
+    [_diskIndex removeAllObjects];
+    _diskIndexByteCount = 0;
+    _diskByteCount = 0;
+    // Nothing is left on disk, so there is nothing to index.
+    _diskIndexLoaded = NO;
+  });
+}
+
+#pragma mark Adding Images
+
+- (void)setImage:(UIImage *)image data:(NSData *)data downsampled:(BOOL)downsampled forURL:(NSURL *)URL
+{
+  if (URL == nil) {
+    return;
+  }
+  NSString *key = URL.absoluteString;
+  if (image != nil && downsampled == NO) {
+    [self _setMemoryCachedImage:image forKey:key];
+  }
+  if (data != nil) {
+    dispatch_async(_diskQueue, ^{
+      [self _onDiskQueue_writeData:data forKey:key];
+    });
+  }
+}
+
+#pragma mark ASImageCacheProtocol
+
+- (void)cachedImageWithURL:(NSURL *)URL callbackQueue:(dispatch_queue_t)callbackQueue completion:(ASImageCacherCompletion)completion
+{
+  if (callbackQueue == nil) {
+    callbackQueue = dispatch_get_main_queue();
+  }
+
+  if (URL == nil) {
+    dispatch_async(callbackQueue, ^{
+      completion(nil);
+    });
+    return;
+  }
+
+  NSString *key = URL.absoluteString;
+  UIImage *image = [self _memoryCachedImageForKey:key];
+  if (image != nil) {
+    _memoryHitCount++;
+    dispatch_async(callbackQueue, ^{
+      completion(image);
+    });
+    return;
+  }
+
+  dispatch_async(_diskQueue, ^{
+    NSData *data = [self _onDiskQueue_dataForKey:key];
+    if (data == nil) {
+      _missCount++;
+      dispatch_async(callbackQueue, ^{
+        completion(nil);
+      });
+      return;
+    }
+
+    // Decode off the serial disk queue so reads for other URLs aren't held up.
+    dispatch_async(dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+      UIImage *decodedImage = ASDecodedImageWithData(data, CGSizeZero, NULL);
+      if (decodedImage != nil) {
+        _diskHitCount++;
+        [self _setMemoryCachedImage:decodedImage forKey:key];
+      } else {
+        _missCount++;
+      }
+      dispatch_async(callbackQueue, ^{
+        completion(decodedImage);
+      });
+    });
+  });
+}
+
+- (id<ASImageContainerProtocol>)synchronouslyFetchedCachedImageWithURL:(NSURL *)URL
+{
+  if (URL == nil) {
+    return nil;
+  }
+  UIImage *image = [self _memoryCachedImageForKey:URL.absoluteString];
+  if (image != nil) {
+    _memoryHitCount++;
+  }
+  return image;
+}
+
+
+#pragma mark Metrics
+
+- (ASBasicImageCacheMetrics)metrics
+{
+  ASBasicImageCacheMetrics metrics = {
+    .memoryHitCount = _memoryHitCount,
+    .diskHitCount = _diskHitCount,
+    .missCount = _missCount,
+    .memoryEvictionCount = _memoryEvictionCount,
+    .diskEvictionCount = _diskEvictionCount,
+    .memoryByteCount = _memoryByteCount,
+    .diskByteCount = _diskByteCount,
+  };
+  return metrics;
+}
+
+- (void)resetMetrics
+{
+  _memoryHitCount = 0;
+  _diskHitCount = 0;
+  _missCount = 0;
+  _memoryEvictionCount = 0;
+  _diskEvictionCount = 0;
+}
+
+@end
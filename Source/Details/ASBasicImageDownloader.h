@@ -10,23 +10,95 @@
 
 #import <AsyncDisplayKit/ASImageProtocols.h>
 
+@class ASBasicImageCache;
+
 NS_ASSUME_NONNULL_BEGIN
 
+/**
+ * Counters for the decode stage of @c ASBasicImageDownloader.
+ */
+typedef struct {
+  /// Number of downloaded images decoded.
+  NSUInteger decodedImageCount;
+  /// Number of decoded images that were downsampled to a requested target size.
+  NSUInteger downsampledImageCount;
+  /// Total wall-clock time spent decoding, in seconds.
+  NSTimeInterval totalDecodeDuration;
+  /// Decoded bitmap bytes avoided by downsampling instead of decoding at full size.
+  unsigned long long bytesSavedByDownsampling;
+} ASBasicImageDownloaderDecodeMetrics;
+
+/**
+ * Counters for the download scheduler of @c ASBasicImageDownloader.
+ */
+typedef struct {
+  /// Downloads currently queued, waiting for a connection.
+  NSUInteger pendingDownloadCount;
+  /// Downloads currently using a connection.
+  NSUInteger runningDownloadCount;
+  /// Downloads that were given a connection.
+  NSUInteger startedDownloadCount;
+  /// Downloads cancelled while queued, which never used a connection.
+  NSUInteger cancelledBeforeStartCount;
+  /// Downloads that produced an image after being raised to the visible priority.
+  NSUInteger visibleImageCount;
+  /// Total time from a download being raised to the visible priority until its image was decoded, in seconds.
+  NSTimeInterval totalTimeToVisibleImage;
+  /// The longest such time, in seconds.
+  NSTimeInterval maxTimeToVisibleImage;
+} ASBasicImageDownloaderSchedulerMetrics;
+
 /**
  * @abstract Simple NSURLSession-based image downloader.
+ *
+ * @discussion Downloaded images are decoded on a bounded background queue before completion blocks are called, so the
+ * first draw doesn't pay for decompression. If the download was requested with a target pixel size, the image is
+ * downsampled to that size as it is decoded.
+ *
+ * At most @c maxConcurrentDownloads downloads run at once. The rest wait in a queue ordered by the priority set with
+ * @c -setPriority:withDownloadIdentifier: (visible, then imminent, then preload, first come first served within each),
+ * and downloads cancelled while queued never use a connection.
+ *
+ * Concurrent requests for the same URL share one download, scheduled at the highest priority of the requests, and only
+ * cancelled once every request for it is. Downloaded images are kept in an @c ASBasicImageCache,
+ * which the downloader exposes through @c ASImageCacheProtocol so it can be passed as both cache and downloader.
  */
-@interface ASBasicImageDownloader : NSObject <ASImageDownloaderProtocol>
+@interface ASBasicImageDownloader : NSObject <ASImageDownloaderProtocol, ASImageCacheProtocol>
 
 /**
  * A shared image downloader which can be used by @c ASNetworkImageNodes and @c ASMultiplexImageNodes
  *
- * This is a very basic image downloader. It does not support caching, progressive downloading and likely
- * isn't something you should use in production. If you'd like something production ready, see @c ASPINRemoteImageDownloader
+ * This is a very basic image downloader. It does not support progressive downloading and likely isn't something
+ * you should use in production. If you'd like something production ready, see @c ASPINRemoteImageDownloader
  *
  * @note It is strongly recommended you include PINRemoteImage and use @c ASPINRemoteImageDownloader instead.
  */
 + (instancetype)sharedImageDownloader;
 
+/**
+ * The memory and disk cache downloaded images are stored in.
+ */
+@property (nonatomic, strong, readonly) ASBasicImageCache *cache;
+
+/**
+ * The maximum number of downloads running at once. Defaults to 4.
+ */
+@property (atomic, assign) NSUInteger maxConcurrentDownloads;
+
+/**
+ * A snapshot of the download scheduler counters.
+ */
+- (ASBasicImageDownloaderSchedulerMetrics)schedulerMetrics;
+
+- (void)resetSchedulerMetrics;
+
+/**
+ * A snapshot of the decode stage counters.
+ */
+- (ASBasicImageDownloaderDecodeMetrics)decodeMetrics;
+
+- (void)resetDecodeMetrics;
+
 + (instancetype)new __attribute__((unavailable("+[ASBasicImageDownloader sharedImageDownloader] must be used.")));
 - (instancetype)init __attribute__((unavailable("+[ASBasicImageDownloader sharedImageDownloader] must be used.")));
 
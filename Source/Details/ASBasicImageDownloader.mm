@@ -13,37 +13,92 @@
 #import <objc/runtime.h>
 
 #import <AsyncDisplayKit/ASBasicImageDownloaderInternal.h>
+#import <AsyncDisplayKit/ASBasicImageCache.h>
 #import <AsyncDisplayKit/ASImageContainerProtocolCategories.h>
+#import <AsyncDisplayKit/ASImageDecoding.h>
 #import <AsyncDisplayKit/ASThread.h>
 
+/// Decoding is CPU and memory bound; don't let a burst of completed downloads decode all at once.
+static const NSInteger kASBasicImageDownloaderMaxConcurrentDecodes = 2;
+
+/// Matches NSURLSession's default per-host connection limit, so queued requests wait here where they can be reordered.
+static const NSUInteger kASBasicImageDownloaderDefaultMaxConcurrentDownloads = 4;
+
+static const NSUInteger kASBasicImageDownloaderMemoryCacheByteLimit = 32 * 1024 * 1024;
+static const unsigned long long kASBasicImageDownloaderDiskCacheByteLimit = 100 * 1024 * 1024;
+
+static float ASBasicImageDownloaderTaskPriority(ASImageDownloaderPriority priority)
+{
+  switch (priority) {
+    case ASImageDownloaderPriorityVisible:
+      return NSURLSessionTaskPriorityHigh;
+    case ASImageDownloaderPriorityImminent:
+      return NSURLSessionTaskPriorityDefault;
+    case ASImageDownloaderPriorityPreload:
+      return NSURLSessionTaskPriorityLow;
+  }
+}
 
-#pragma mark -
 /**
- * Collection of properties associated with a download request.
+ * Whether an image decoded at decodedPixelSize is large enough for a request for requestedPixelSize. CGSizeZero stands
+ * for the full size image.
  */
+static BOOL ASBasicImageDownloaderPixelSizeCovers(CGSize decodedPixelSize, CGSize requestedPixelSize)
+{
+  if (decodedPixelSize.width <= 0 || decodedPixelSize.height <= 0) {
+    return YES;
+  }
+  if (requestedPixelSize.width <= 0 || requestedPixelSize.height <= 0) {
+    return NO;
+  }
+  return requestedPixelSize.width <= decodedPixelSize.width && requestedPixelSize.height <= decodedPixelSize.height;
+}
 
-NSString * const kASBasicImageDownloaderContextCallbackQueue = @"kASBasicImageDownloaderContextCallbackQueue";
-NSString * const kASBasicImageDownloaderContextProgressBlock = @"kASBasicImageDownloaderContextProgressBlock";
-NSString * const kASBasicImageDownloaderContextCompletionBlock = @"kASBasicImageDownloaderContextCompletionBlock";
+#pragma mark -
+
+@implementation ASBasicImageDownloaderRequest
+
+- (instancetype)initWithCallbackQueue:(dispatch_queue_t)callbackQueue
+                      targetPixelSize:(CGSize)targetPixelSize
+                     downloadProgress:(ASImageDownloaderProgress)downloadProgress
+                           completion:(ASImageDownloaderCompletion)completion
+{
+  if (self = [super init]) {
+    _callbackQueue = callbackQueue;
+    _targetPixelSize = targetPixelSize;
+    _downloadProgress = [downloadProgress copy];
+    _completion = [completion copy];
+    _priority = ASImageDownloaderPriorityImminent;
+  }
+  return self;
+}
+
+@end
+
+#pragma mark -
 
 @interface ASBasicImageDownloaderContext ()
 {
   BOOL _invalid;
+  BOOL _completed;
+  ASImageDownloaderPriority _priority;
+  CFTimeInterval _visibleTime;
+  NSMutableArray<ASBasicImageDownloaderRequest *> *_requests;
   ASDN::RecursiveMutex __instanceLock__;
 }
 
-@property (nonatomic, strong) NSMutableArray *callbackDatas;
-
 @end
 
 @implementation ASBasicImageDownloaderContext
 
-static NSMutableDictionary *currentRequests = nil;
-static ASDN::RecursiveMutex currentRequestsLock;
+// Contexts of in-flight requests only. A context is removed once it completes or is cancelled, so a later request
+// for the same URL starts over (and is served by the cache if possible).
+static NSMutableDictionary<NSURL *, ASBasicImageDownloaderContext *> *currentRequests = nil;
+static ASDN::StaticMutex currentRequestsLock = ASDISPLAYNODE_MUTEX_INITIALIZER;
 
 + (ASBasicImageDownloaderContext *)contextForURL:(NSURL *)URL
 {
-  ASDN::MutexLocker l(currentRequestsLock);
+  ASDN::StaticMutexLocker l(currentRequestsLock);
   if (!currentRequests) {
     currentRequests = [[NSMutableDictionary alloc] init];
   }
@@ -55,11 +110,37 @@ static ASDN::RecursiveMutex currentRequestsLock;
   return context;
 }
 
-+ (void)cancelContextWithURL:(NSURL *)URL
++ (ASBasicImageDownloaderContext *)contextForURL:(NSURL *)URL joiningRequest:(ASBasicImageDownloaderRequest *)request createdContext:(BOOL *)createdContext
 {
-  ASDN::MutexLocker l(currentRequestsLock);
-  if (currentRequests) {
-    [currentRequests removeObjectForKey:URL];
+  ASDN::StaticMutexLocker l(currentRequestsLock);
+  if (!currentRequests) {
+    currentRequests = [[NSMutableDictionary alloc] init];
+  }
+  ASBasicImageDownloaderContext *context = currentRequests[URL];
+  *createdContext = (context == nil);
+  if (!context) {
+    context = [[ASBasicImageDownloaderContext alloc] initWithURL:URL];
+    currentRequests[URL] = context;
+  }
+  // Contexts are unregistered with this lock held before they complete or are cancelled, so a registered context
+  // always takes the request.
+  __unused BOOL added = [context addRequest:request];
+  ASDisplayNodeAssert(added, @"Registered download context %@ didn't accept a request", context);
+  request.context = context;
+  return context;
+}
+
++ (void)removeContext:(ASBasicImageDownloaderContext *)context
+{
+  ASDN::StaticMutexLocker l(currentRequestsLock);
+  [self _locked_removeContext:context];
+}
+
++ (void)_locked_removeContext:(ASBasicImageDownloaderContext *)context
+{
+  // A newer context may have replaced this one already.
+  if (currentRequests[context.URL] == context) {
+    [currentRequests removeObjectForKey:context.URL];
   }
 }
 
@@ -67,15 +148,53 @@ static ASDN::RecursiveMutex currentRequestsLock;
 {
   if (self = [super init]) {
     _URL = URL;
-    _callbackDatas = [NSMutableArray array];
+    _requests = [NSMutableArray array];
+    _priority = ASImageDownloaderPriorityImminent;
   }
   return self;
 }
 
+- (ASImageDownloaderPriority)priority
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _priority;
+}
+
+- (void)setPriority:(ASImageDownloaderPriority)priority
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  _priority = priority;
+  if (priority == ASImageDownloaderPriorityVisible && _visibleTime == 0) {
+    _visibleTime = CACurrentMediaTime();
+  }
+}
+
+- (ASImageDownloaderPriority)highestRequestPriority
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  ASImageDownloaderPriority priority = ASImageDownloaderPriorityPreload;
+  for (ASBasicImageDownloaderRequest *request in _requests) {
+    priority = MAX(priority, request.priority);
+  }
+  return priority;
+}
+
+- (CFTimeInterval)visibleTime
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _visibleTime;
+}
+
 - (void)cancel
 {
+  // Always take the registry lock first; joining a request takes both in this order.
+  ASDN::StaticMutexLocker registryLock(currentRequestsLock);
   ASDN::MutexLocker l(__instanceLock__);
+  [self _locked_cancel];
+}
 
+- (void)_locked_cancel
+{
   NSURLSessionTask *sessionTask = self.sessionTask;
   if (sessionTask) {
     [sessionTask cancel];
@@ -83,7 +202,8 @@ static ASDN::RecursiveMutex currentRequestsLock;
   }
 
   _invalid = YES;
-  [self.class cancelContextWithURL:self.URL];
+  [_requests removeAllObjects];
+  [self.class _locked_removeContext:self];
 }
 
 - (BOOL)isCancelled
@@ -92,21 +212,52 @@ static ASDN::RecursiveMutex currentRequestsLock;
   return _invalid;
 }
 
-- (void)addCallbackData:(NSDictionary *)callbackData
+- (BOOL)addRequest:(ASBasicImageDownloaderRequest *)request
 {
   ASDN::MutexLocker l(__instanceLock__);
-  [self.callbackDatas addObject:callbackData];
+  // Completion calls and drops the requests it has, so a request added after it would never be called back.
+  if (_invalid || _completed) {
+    return NO;
+  }
+  [_requests addObject:request];
+  return YES;
 }
 
-- (void)performProgressBlocks:(CGFloat)progress
+- (BOOL)removeRequest:(ASBasicImageDownloaderRequest *)request
 {
+  ASDN::StaticMutexLocker registryLock(currentRequestsLock);
   ASDN::MutexLocker l(__instanceLock__);
-  for (NSDictionary *callbackData in self.callbackDatas) {
-    ASImageDownloaderProgress progressBlock = callbackData[kASBasicImageDownloaderContextProgressBlock];
-    dispatch_queue_t callbackQueue = callbackData[kASBasicImageDownloaderContextCallbackQueue];
+  [_requests removeObjectIdenticalTo:request];
+  // Nobody is waiting for the download any more. Cancel under the same locks so that no request can join in between.
+  if (_requests.count == 0 && !_completed && !_invalid) {
+    [self _locked_cancel];
+    return YES;
+  }
+  return NO;
+}
+
+- (CGSize)targetPixelSize
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  CGSize targetPixelSize = CGSizeZero;
+  for (ASBasicImageDownloaderRequest *request in _requests) {
+    CGSize size = request.targetPixelSize;
+    if (size.width <= 0 || size.height <= 0) {
+      return CGSizeZero;
+    }
+    targetPixelSize.width = MAX(targetPixelSize.width, size.width);
+    targetPixelSize.height = MAX(targetPixelSize.height, size.height);
+  }
+  return targetPixelSize;
+}
 
+- (void)performProgressBlocks:(CGFloat)progress
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  for (ASBasicImageDownloaderRequest *request in _requests) {
+    ASImageDownloaderProgress progressBlock = request.downloadProgress;
     if (progressBlock) {
-      dispatch_async(callbackQueue, ^{
+      dispatch_async(request.callbackQueue, ^{
         progressBlock(progress);
       });
     }
@@ -115,20 +266,37 @@ static ASDN::RecursiveMutex currentRequestsLock;
 
 - (void)completeWithImage:(UIImage *)image error:(NSError *)error
 {
-  ASDN::MutexLocker l(__instanceLock__);
-  for (NSDictionary *callbackData in self.callbackDatas) {
-    ASImageDownloaderCompletion completionBlock = callbackData[kASBasicImageDownloaderContextCompletionBlock];
-    dispatch_queue_t callbackQueue = callbackData[kASBasicImageDownloaderContextCallbackQueue];
+  __unused BOOL completed = [self completeWithImage:image decodedPixelSize:CGSizeZero error:error];
+  ASDisplayNodeAssert(completed, @"A full size image should complete every request");
+}
 
+- (BOOL)completeWithImage:(UIImage *)image decodedPixelSize:(CGSize)decodedPixelSize error:(NSError *)error
+{
+  ASDN::StaticMutexLocker registryLock(currentRequestsLock);
+  ASDN::MutexLocker l(__instanceLock__);
+  NSMutableArray<ASBasicImageDownloaderRequest *> *remainingRequests = [NSMutableArray array];
+  for (ASBasicImageDownloaderRequest *request in _requests) {
+    // Requests that joined after decoding started may need a larger image; without an image there's nothing to redo.
+    if (image != nil && !ASBasicImageDownloaderPixelSizeCovers(decodedPixelSize, request.targetPixelSize)) {
+      [remainingRequests addObject:request];
+      continue;
+    }
+    ASImageDownloaderCompletion completionBlock = request.completion;
     if (completionBlock) {
-      dispatch_async(callbackQueue, ^{
+      dispatch_async(request.callbackQueue, ^{
         completionBlock(image, error, nil);
       });
     }
   }
+  _requests = remainingRequests;
+  if (remainingRequests.count > 0) {
+    return NO;
+  }
 
+  _completed = YES;
   self.sessionTask = nil;
-  [self.callbackDatas removeAllObjects];
+  [self.class _locked_removeContext:self];
+  return YES;
 }
 
 - (NSURLSessionTask *)createSessionTaskIfNecessaryWithBlock:(NSURLSessionTask *(^)())creationBlock {
@@ -191,7 +359,21 @@ static const char *kContextKey = NSStringFromClass(ASBasicImageDownloaderContext
 @interface ASBasicImageDownloader () <NSURLSessionDownloadDelegate>
 {
   NSOperationQueue *_sessionDelegateQueue;
+  NSOperationQueue *_decodeQueue;
   NSURLSession *_session;
+
+  ASDN::Mutex _decodeMetricsLock;
+  ASBasicImageDownloaderDecodeMetrics _decodeMetrics;
+
+  ASDN::Mutex _schedulerLock;
+  // Contexts waiting for a connection, one FIFO per ASImageDownloaderPriority.
+  NSArray<NSMutableOrderedSet<ASBasicImageDownloaderContext *> *> *_pendingContexts;
+  // Tasks started by the scheduler that haven't completed yet.
+  NSMutableSet<NSURLSessionTask *> *_runningTasks;
+  // Includes contexts popped from the queue whose task is still being created.
+  NSUInteger _activeDownloadCount;
+  NSUInteger _maxConcurrentDownloads;
+  ASBasicImageDownloaderSchedulerMetrics _schedulerMetrics;
 }
 
 @end
@@ -211,15 +393,42 @@ static const char *kContextKey = NSStringFromClass(ASBasicImageDownloaderContext
 #pragma mark Lifecycle.
 
 - (instancetype)_init
+{
+  ASBasicImageCache *cache = [[ASBasicImageCache alloc] initWithName:@"org.AsyncDisplayKit.ASBasicImageDownloader"
+                                                     memoryByteLimit:kASBasicImageDownloaderMemoryCacheByteLimit
+                                                       diskByteLimit:kASBasicImageDownloaderDiskCacheByteLimit];
+  return [self _initWithSessionConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration] cache:cache];
+}
+
+- (instancetype)_initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration
+{
+  // Other instances mustn't share the shared downloader's directory: each cache keeps its own index of the files in it.
+  NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSString stringWithFormat:@"org.AsyncDisplayKit.ASBasicImageDownloader.%@", [NSUUID UUID].UUIDString]];
+  ASBasicImageCache *cache = [[ASBasicImageCache alloc] initWithDirectoryURL:[NSURL fileURLWithPath:path isDirectory:YES]
+                                                             memoryByteLimit:kASBasicImageDownloaderMemoryCacheByteLimit
+                                                               diskByteLimit:kASBasicImageDownloaderDiskCacheByteLimit];
+  return [self _initWithSessionConfiguration:configuration cache:cache];
+}
+
+- (instancetype)_initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration cache:(ASBasicImageCache *)cache
 {
   if (!(self = [super init]))
     return nil;
 
   _sessionDelegateQueue = [[NSOperationQueue alloc] init];
-  _session = [NSURLSession sessionWithConfiguration:[NSURLSessionConfiguration defaultSessionConfiguration]
+  _decodeQueue = [[NSOperationQueue alloc] init];
+  _decodeQueue.name = @"org.AsyncDisplayKit.ASBasicImageDownloader.decodeQueue";
+  _decodeQueue.maxConcurrentOperationCount = kASBasicImageDownloaderMaxConcurrentDecodes;
+  _decodeQueue.qualityOfService = NSQualityOfServiceUtility;
+  _cache = cache;
+  _session = [NSURLSession sessionWithConfiguration:configuration
                                            delegate:self
                                       delegateQueue:_sessionDelegateQueue];
 
+  _pendingContexts = @[ [NSMutableOrderedSet orderedSet], [NSMutableOrderedSet orderedSet], [NSMutableOrderedSet orderedSet] ];
+  _runningTasks = [NSMutableSet set];
+  _maxConcurrentDownloads = kASBasicImageDownloaderDefaultMaxConcurrentDownloads;
+
   return self;
 }
 
@@ -231,47 +440,291 @@ static const char *kContextKey = NSStringFromClass(ASBasicImageDownloaderContext
                    downloadProgress:(nullable ASImageDownloaderProgress)downloadProgress
                          completion:(ASImageDownloaderCompletion)completion
 {
-  ASBasicImageDownloaderContext *context = [ASBasicImageDownloaderContext contextForURL:URL];
+  return [self downloadImageWithURL:URL
+                    targetPixelSize:CGSizeZero
+                      callbackQueue:callbackQueue
+                   downloadProgress:downloadProgress
+                         completion:completion];
+}
+
+- (id)downloadImageWithURL:(NSURL *)URL
+           targetPixelSize:(CGSize)targetPixelSize
+             callbackQueue:(dispatch_queue_t)callbackQueue
+          downloadProgress:(nullable ASImageDownloaderProgress)downloadProgress
+                completion:(ASImageDownloaderCompletion)completion
+{
+  // Serve memory cache hits without touching the network. The memory cache only holds full size images, which are
+  // fine for any target size.
+  UIImage *cachedImage = [_cache memoryCachedImageForURL:URL];
+  if (cachedImage != nil) {
+    if (completion) {
+      dispatch_async(callbackQueue ? : dispatch_get_main_queue(), ^{
+        completion(cachedImage, nil, nil);
+      });
+    }
+    return nil;
+  }
+
+  ASBasicImageDownloaderRequest *request = [[ASBasicImageDownloaderRequest alloc] initWithCallbackQueue:(callbackQueue ? : dispatch_get_main_queue())
+                                                                                    targetPixelSize:targetPixelSize
+                                                                                   downloadProgress:downloadProgress
+                                                                                         completion:completion];
+
+  // Join the in-flight download for the URL, or start a new one, in one step under the registry lock, so the download
+  // can't complete without calling us.
+  BOOL createdContext = NO;
+  ASBasicImageDownloaderContext *context = [ASBasicImageDownloaderContext contextForURL:URL joiningRequest:request createdContext:&createdContext];
+
+  // The previous download for the URL may have completed into the memory cache since it was checked above.
+  if (createdContext) {
+    cachedImage = [_cache memoryCachedImageForURL:URL];
+    if (cachedImage != nil) {
+      [context removeRequest:request];
+      if (completion) {
+        dispatch_async(callbackQueue ? : dispatch_get_main_queue(), ^{
+          completion(cachedImage, nil, nil);
+        });
+      }
+      return nil;
+    }
+  }
 
   // NSURLSessionDownloadTask will do file I/O to create a temp directory. If called on the main thread this will
   // cause significant performance issues.
   dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
-    // associate metadata with it
-    NSMutableDictionary *callbackData = [NSMutableDictionary dictionary];
-    callbackData[kASBasicImageDownloaderContextCallbackQueue] = callbackQueue ? : dispatch_get_main_queue();
+    [self _updatePriorityOfContext:context];
+    [self _enqueueContextIfNeeded:context];
+    [self _startPendingDownloads];
+  });
 
-    if (downloadProgress) {
-      callbackData[kASBasicImageDownloaderContextProgressBlock] = [downloadProgress copy];
-    }
+  return request;
+}
 
-    if (completion) {
-      callbackData[kASBasicImageDownloaderContextCompletionBlock] = [completion copy];
+- (void)cancelImageDownloadForIdentifier:(id)downloadIdentifier
+{
+  ASDisplayNodeAssert([downloadIdentifier isKindOfClass:ASBasicImageDownloaderRequest.class], @"unexpected downloadIdentifier");
+  ASBasicImageDownloaderRequest *request = (ASBasicImageDownloaderRequest *)downloadIdentifier;
+  ASBasicImageDownloaderContext *context = request.context;
+
+  // Other requests for the URL keep the download going, at the highest priority of those left.
+  if ([context removeRequest:request] == NO) {
+    [self _updatePriorityOfContext:context];
+    return;
+  }
+
+  ASDN::MutexLocker l(_schedulerLock);
+  NSMutableOrderedSet *pending = _pendingContexts[context.priority];
+  if ([pending containsObject:context]) {
+    [pending removeObject:context];
+    _schedulerMetrics.cancelledBeforeStartCount += 1;
+  }
+}
+
+- (void)setPriority:(ASImageDownloaderPriority)priority withDownloadIdentifier:(id)downloadIdentifier
+{
+  ASDisplayNodeAssert([downloadIdentifier isKindOfClass:ASBasicImageDownloaderRequest.class], @"unexpected downloadIdentifier");
+  ASBasicImageDownloaderRequest *request = (ASBasicImageDownloaderRequest *)downloadIdentifier;
+  request.priority = priority;
+  [self _updatePriorityOfContext:request.context];
+}
+
+/**
+ * Coalesced requests share a context, which is scheduled at the highest priority of its requests, so that a request
+ * lowering its priority doesn't demote a download that another request still needs soon.
+ */
+- (void)_updatePriorityOfContext:(ASBasicImageDownloaderContext *)context
+{
+  ASDN::MutexLocker l(_schedulerLock);
+  if ([context isCancelled]) {
+    return;
+  }
+  ASImageDownloaderPriority priority = [context highestRequestPriority];
+  NSMutableOrderedSet *pending = _pendingContexts[context.priority];
+  BOOL isPending = [pending containsObject:context];
+  if (isPending) {
+    [pending removeObject:context];
+  }
+  context.priority = priority;
+  if (isPending) {
+    [_pendingContexts[priority] addObject:context];
+  }
+  context.sessionTask.priority = ASBasicImageDownloaderTaskPriority(priority);
+}
+
+#pragma mark Scheduling.
+
+- (NSUInteger)maxConcurrentDownloads
+{
+  ASDN::MutexLocker l(_schedulerLock);
+  return _maxConcurrentDownloads;
+}
+
+- (void)setMaxConcurrentDownloads:(NSUInteger)maxConcurrentDownloads
+{
+  {
+    ASDN::MutexLocker l(_schedulerLock);
+    _maxConcurrentDownloads = maxConcurrentDownloads;
+  }
+  // Task creation does file I/O, keep it off the caller's thread.
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    [self _startPendingDownloads];
+  });
+}
+
+- (void)_enqueueContextIfNeeded:(ASBasicImageDownloaderContext *)context
+{
+  ASDN::MutexLocker l(_schedulerLock);
+  // Coalesced requests join a context that is already queued or downloading. Completed contexts are never joined, so
+  // a scheduled context never needs scheduling again.
+  if ([context isCancelled] || context.scheduled) {
+    return;
+  }
+  context.scheduled = YES;
+  [_pendingContexts[context.priority] addObject:context];
+}
+
+- (ASBasicImageDownloaderContext *)_locked_dequeueContext
+{
+  for (NSInteger priority = ASImageDownloaderPriorityVisible; priority >= ASImageDownloaderPriorityPreload; priority--) {
+    NSMutableOrderedSet *pending = _pendingContexts[priority];
+    while (pending.count > 0) {
+      ASBasicImageDownloaderContext *context = pending.firstObject;
+      [pending removeObjectAtIndex:0];
+      if ([context isCancelled] == NO) {
+        return context;
+      }
     }
+  }
+  return nil;
+}
 
-    [context addCallbackData:[NSDictionary dictionaryWithDictionary:callbackData]];
+- (void)_startPendingDownloads
+{
+  while (YES) {
+    ASBasicImageDownloaderContext *context = nil;
+    {
+      ASDN::MutexLocker l(_schedulerLock);
+      if (_activeDownloadCount >= _maxConcurrentDownloads) {
+        return;
+      }
+      context = [self _locked_dequeueContext];
+      if (context == nil) {
+        return;
+      }
+      // Reserve the slot now so that concurrent callers don't overcommit while the task is being created.
+      _activeDownloadCount += 1;
+    }
 
-    // Create new task if necessary
-    NSURLSessionDownloadTask *task = (NSURLSessionDownloadTask *)[context createSessionTaskIfNecessaryWithBlock:^(){return [_session downloadTaskWithURL:URL];}];
+    NSURL *URL = context.URL;
+    NSURLSessionTask *task = [context createSessionTaskIfNecessaryWithBlock:^(){return [_session downloadTaskWithURL:URL];}];
 
-    if (task) {
-      task.originalRequest.asyncdisplaykit_context = context;
+    ASDN::MutexLocker l(_schedulerLock);
+    if (task == nil) {
+      // Cancelled while the task was being created.
+      _activeDownloadCount -= 1;
+      continue;
+    }
+    task.originalRequest.asyncdisplaykit_context = context;
+    task.priority = ASBasicImageDownloaderTaskPriority(context.priority);
+    [_runningTasks addObject:task];
+    _schedulerMetrics.startedDownloadCount += 1;
+    [task resume];
+  }
+}
 
-      // start downloading
-      [task resume];
+- (void)_didCompleteTask:(NSURLSessionTask *)task
+{
+  {
+    ASDN::MutexLocker l(_schedulerLock);
+    if ([_runningTasks containsObject:task] == NO) {
+      return;
     }
-  });
+    [_runningTasks removeObject:task];
+    _activeDownloadCount -= 1;
+  }
+  [self _startPendingDownloads];
+}
 
-  return context;
+- (void)_recordCompletionOfContext:(ASBasicImageDownloaderContext *)context
+{
+  CFTimeInterval visibleTime = context.visibleTime;
+  if (visibleTime == 0) {
+    return;
+  }
+  CFTimeInterval timeToVisibleImage = CACurrentMediaTime() - visibleTime;
+  ASDN::MutexLocker l(_schedulerLock);
+  _schedulerMetrics.visibleImageCount += 1;
+  _schedulerMetrics.totalTimeToVisibleImage += timeToVisibleImage;
+  _schedulerMetrics.maxTimeToVisibleImage = MAX(_schedulerMetrics.maxTimeToVisibleImage, timeToVisibleImage);
 }
 
-- (void)cancelImageDownloadForIdentifier:(id)downloadIdentifier
+- (ASBasicImageDownloaderSchedulerMetrics)schedulerMetrics
 {
-  ASDisplayNodeAssert([downloadIdentifier isKindOfClass:ASBasicImageDownloaderContext.class], @"unexpected downloadIdentifier");
-  ASBasicImageDownloaderContext *context = (ASBasicImageDownloaderContext *)downloadIdentifier;
+  ASDN::MutexLocker l(_schedulerLock);
+  ASBasicImageDownloaderSchedulerMetrics metrics = _schedulerMetrics;
+  metrics.runningDownloadCount = _activeDownloadCount;
+  for (NSMutableOrderedSet *pending in _pendingContexts) {
+    metrics.pendingDownloadCount += pending.count;
+  }
+  return metrics;
+}
+
+- (void)resetSchedulerMetrics
+{
+  ASDN::MutexLocker l(_schedulerLock);
+  _schedulerMetrics = {};
+}
+
+
+#pragma mark Decoding.
+
+- (UIImage *)_decodedImageWithData:(NSData *)data targetPixelSize:(CGSize)targetPixelSize downsampled:(BOOL *)downsampled
+{
+  CFTimeInterval start = CACurrentMediaTime();
+  NSUInteger bytesSaved = 0;
+  UIImage *image = ASDecodedImageWithData(data, targetPixelSize, &bytesSaved);
+  *downsampled = (bytesSaved > 0);
+  if (image == nil) {
+    // Fall back to UIKit for anything ImageIO can't handle. This decodes lazily at first draw.
+    return [UIImage imageWithData:data];
+  }
+  CFTimeInterval duration = CACurrentMediaTime() - start;
+
+  ASDN::MutexLocker l(_decodeMetricsLock);
+  _decodeMetrics.decodedImageCount += 1;
+  _decodeMetrics.totalDecodeDuration += duration;
+  if (bytesSaved > 0) {
+    _decodeMetrics.downsampledImageCount += 1;
+    _decodeMetrics.bytesSavedByDownsampling += bytesSaved;
+  }
+  return image;
+}
+
+- (ASBasicImageDownloaderDecodeMetrics)decodeMetrics
+{
+  ASDN::MutexLocker l(_decodeMetricsLock);
+  return _decodeMetrics;
+}
 
-  [context cancel];
+- (void)resetDecodeMetrics
+{
+  ASDN::MutexLocker l(_decodeMetricsLock);
+  _decodeMetrics = {};
 }
 
+#pragma mark ASImageCacheProtocol.
+
+- (void)cachedImageWithURL:(NSURL *)URL
+             callbackQueue:(dispatch_queue_t)callbackQueue
+                completion:(ASImageCacherCompletion)completion
+{
+  [_cache cachedImageWithURL:URL callbackQueue:callbackQueue completion:completion];
+}
+
+- (id<ASImageContainerProtocol>)synchronouslyFetchedCachedImageWithURL:(NSURL *)URL
+{
+  return [_cache synchronouslyFetchedCachedImageWithURL:URL];
+}
 
 #pragma mark NSURLSessionDownloadDelegate.
 
@@ -294,8 +747,36 @@ static const char *kContextKey = NSStringFromClass(ASBasicImageDownloaderContext
   }
 
   if (context) {
-    UIImage *image = [UIImage imageWithData:[NSData dataWithContentsOfURL:location]];
-    [context completeWithImage:image error:nil];
+    // Map the temporary file rather than copying it. The mapping stays valid after NSURLSession removes the file
+    // once this method returns.
+    NSData *data = [NSData dataWithContentsOfURL:location options:NSDataReadingMappedIfSafe error:NULL];
+    // Don't cache error pages that happen to decode.
+    NSHTTPURLResponse *response = (NSHTTPURLResponse *)downloadTask.response;
+    BOOL cacheable = ([response isKindOfClass:[NSHTTPURLResponse class]] == NO
+                      || (response.statusCode >= 200 && response.statusCode < 300));
+    [_decodeQueue addOperationWithBlock:^{
+      // Requests can still join while the image is decoded for the ones already there. If one of them needs a larger
+      // image, decode again from the same data, at a size covering every request still waiting.
+      BOOL completed = NO;
+      BOOL recordedCompletion = NO;
+      while (completed == NO) {
+        if ([context isCancelled]) {
+          return;
+        }
+        CGSize targetPixelSize = context.targetPixelSize;
+        BOOL downsampled = NO;
+        UIImage *image = [self _decodedImageWithData:data targetPixelSize:targetPixelSize downsampled:&downsampled];
+        if (image != nil && cacheable) {
+          [_cache setImage:image data:data downsampled:downsampled forURL:context.URL];
+        }
+        if (image != nil && recordedCompletion == NO) {
+          [self _recordCompletionOfContext:context];
+          recordedCompletion = YES;
+        }
+        // An image that wasn't downsampled is full size, which covers any request.
+        completed = [context completeWithImage:image decodedPixelSize:(downsampled ? targetPixelSize : CGSizeZero) error:nil];
+      }
+    }];
   }
 }
 
@@ -307,6 +788,8 @@ static const char *kContextKey = NSStringFromClass(ASBasicImageDownloaderContext
   if (context && error) {
     [context completeWithImage:nil error:error];
   }
+  // Decoding continues on the decode queue, but the connection is free for the next download.
+  [self _didCompleteTask:task];
 }
 
 @end
@@ -61,6 +61,14 @@ NS_ASSUME_NONNULL_BEGIN
  */
 - (void)beginBatchFetching;
 
+/**
+ * How long a batch fetch is expected to take.
+ *
+ * @discussion A moving average of the time from -beginBatchFetching to -completeBatchFetching:YES over recent
+ * fetches, used to start fetching early enough during fast scrolling. Zero until a fetch has completed.
+ */
+- (NSTimeInterval)estimatedFetchDuration;
+
 @end
 
 NS_ASSUME_NONNULL_END
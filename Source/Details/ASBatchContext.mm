@@ -9,9 +9,15 @@
 //
 
 #import <AsyncDisplayKit/ASBatchContext.h>
+#import <AsyncDisplayKit/ASBatchContext+Private.h>
+
+#import <QuartzCore/QuartzCore.h>
 
 #import <AsyncDisplayKit/ASThread.h>
 
+/// The weight of the most recent fetch in the fetch duration estimate.
+static const NSTimeInterval kASBatchContextFetchDurationSmoothing = 0.25;
+
 typedef NS_ENUM(NSInteger, ASBatchContextState) {
   ASBatchContextStateFetching,
   ASBatchContextStateCancelled,
@@ -21,6 +27,8 @@ typedef NS_ENUM(NSInteger, ASBatchContextState) {
 @interface ASBatchContext ()
 {
   ASBatchContextState _state;
+  CFTimeInterval _fetchStartTime;
+  NSTimeInterval _estimatedFetchDuration;
   ASDN::RecursiveMutex __instanceLock__;
 }
 @end
@@ -48,19 +56,45 @@ typedef NS_ENUM(NSInteger, ASBatchContextState) {
 }
 
 - (void)beginBatchFetching
+{
+  [self beginBatchFetchingAtTime:CACurrentMediaTime()];
+}
+
+- (void)beginBatchFetchingAtTime:(CFTimeInterval)time
 {
   ASDN::MutexLocker l(__instanceLock__);
   _state = ASBatchContextStateFetching;
+  _fetchStartTime = time;
 }
 
 - (void)completeBatchFetching:(BOOL)didComplete
+{
+  [self completeBatchFetching:didComplete atTime:CACurrentMediaTime()];
+}
+
+- (void)completeBatchFetching:(BOOL)didComplete atTime:(CFTimeInterval)time
 {
   if (didComplete) {
     ASDN::MutexLocker l(__instanceLock__);
+    // Only time fetches that ran to completion; a cancelled fetch says nothing about how long fetches take.
+    if (_state == ASBatchContextStateFetching && time >= _fetchStartTime) {
+      NSTimeInterval duration = time - _fetchStartTime;
+      if (_estimatedFetchDuration == 0) {
+        _estimatedFetchDuration = duration;
+      } else {
+        _estimatedFetchDuration += kASBatchContextFetchDurationSmoothing * (duration - _estimatedFetchDuration);
+      }
+    }
     _state = ASBatchContextStateCompleted;
   }
 }
 
+- (NSTimeInterval)estimatedFetchDuration
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  return _estimatedFetchDuration;
+}
+
 - (void)cancelBatchFetching
 {
   ASDN::MutexLocker l(__instanceLock__);
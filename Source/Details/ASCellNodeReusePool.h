@@ -0,0 +1,100 @@
+//
+//  ASCellNodeReusePool.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+@class ASCellNode;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Counters for @c ASCellNodeReusePool.
+ */
+typedef struct {
+  /// Nodes created because the pool had none of the requested class.
+  NSUInteger allocatedNodeCount;
+  /// Nodes handed out from the pool instead of being created.
+  NSUInteger reusedNodeCount;
+  /// Nodes taken into the pool.
+  NSUInteger enqueuedNodeCount;
+  /// Nodes turned away because they were still visible or the pool was full.
+  NSUInteger discardedNodeCount;
+  /// Nodes dropped from the pool by -drain, e.g. on a memory warning.
+  NSUInteger drainedNodeCount;
+  /// The number of nodes allocated and laid out by the last update that filled in new elements.
+  NSUInteger lastFillNodeCount;
+  /// How long that took, including running node blocks and configuration blocks.
+  NSTimeInterval lastFillDuration;
+} ASCellNodeReusePoolMetrics;
+
+/**
+ * @abstract A bounded pool of cell nodes that have left their table or collection, keyed by node class.
+ *
+ * @discussion Data sources opt in per row or item by returning a node class from
+ * -tableNode:reusableNodeClassForRowAtIndexPath: or -collectionNode:reusableNodeClassForItemAtIndexPath:. Nodes of
+ * those classes are taken from the pool, or created with -init when there are none, and handed to the data source's
+ * configuration block instead of running a node block. Once their elements are deleted and they're no longer visible,
+ * they get -prepareForReuse and go back to the pool.
+ *
+ * The pool holds at most capacityPerClass nodes of each class and is drained on memory warnings. Nodes are taken from
+ * the pool on any thread and returned to it on the main thread.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASCellNodeReusePool : NSObject
+
+/**
+ * Creates a pool holding up to 32 nodes per class.
+ */
+- (instancetype)init;
+
+- (instancetype)initWithCapacityPerClass:(NSUInteger)capacityPerClass NS_DESIGNATED_INITIALIZER;
+
+@property (atomic, assign) NSUInteger capacityPerClass;
+
+/**
+ * Returns a node from the pool, or a new one if there's none of the given class. Thread-safe.
+ *
+ * @param nodeClass ASCellNode or a subclass of it.
+ */
+- (__kindof ASCellNode *)nodeOfClass:(Class)nodeClass AS_WARN_UNUSED_RESULT;
+
+/**
+ * Returns the node to the pool, if it's of a class that has been requested from the pool, it isn't visible and there's
+ * room. The node leaves the interface, its view is removed from its superview and it gets -prepareForReuse.
+ *
+ * @return Whether the node was taken into the pool.
+ */
+- (BOOL)enqueueNode:(ASCellNode *)node;
+
+/**
+ * Whether any nodes have been requested from the pool, i.e. whether it's worth offering it nodes.
+ */
+@property (atomic, readonly) BOOL isInUse;
+
+- (NSUInteger)countOfNodesOfClass:(Class)nodeClass AS_WARN_UNUSED_RESULT;
+
+/**
+ * Drops every node in the pool.
+ */
+- (void)drain;
+
+/**
+ * Records how long it took to allocate and lay out the nodes of an update. Called by @c ASDataController.
+ */
+- (void)recordFillOfNodeCount:(NSUInteger)nodeCount duration:(NSTimeInterval)duration;
+
+- (ASCellNodeReusePoolMetrics)metrics;
+
+- (void)resetMetrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
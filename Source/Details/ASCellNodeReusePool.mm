@@ -0,0 +1,188 @@
+//
+//  ASCellNodeReusePool.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASCellNodeReusePool.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASCellNode+Internal.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+#import <AsyncDisplayKit/ASThread.h>
+
+static const NSUInteger ASCellNodeReusePoolDefaultCapacityPerClass = 32;
+
+@implementation ASCellNodeReusePool {
+  ASDN::Mutex _lock;
+  NSMapTable<Class, NSMutableArray<ASCellNode *> *> *_nodesByClass;
+  NSUInteger _capacityPerClass;
+  ASCellNodeReusePoolMetrics _metrics;
+}
+
+- (instancetype)init
+{
+  return [self initWithCapacityPerClass:ASCellNodeReusePoolDefaultCapacityPerClass];
+}
+
+- (instancetype)initWithCapacityPerClass:(NSUInteger)capacityPerClass
+{
+  if (self = [super init]) {
+    _capacityPerClass = capacityPerClass;
+    _nodesByClass = [NSMapTable strongToStrongObjectsMapTable];
+
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(didReceiveMemoryWarning:)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification
+{
+  [self drain];
+}
+
+#pragma mark Capacity
+
+- (NSUInteger)capacityPerClass
+{
+  ASDN::MutexLocker l(_lock);
+  return _capacityPerClass;
+}
+
+- (void)setCapacityPerClass:(NSUInteger)capacityPerClass
+{
+  // Release trimmed nodes after unlocking; their dealloc may be expensive.
+  NSMutableArray<ASCellNode *> *trimmedNodes = [NSMutableArray array];
+  {
+    ASDN::MutexLocker l(_lock);
+    _capacityPerClass = capacityPerClass;
+    for (Class nodeClass in _nodesByClass) {
+      NSMutableArray<ASCellNode *> *nodes = [_nodesByClass objectForKey:nodeClass];
+      if (nodes.count > capacityPerClass) {
+        NSRange trimmedRange = NSMakeRange(capacityPerClass, nodes.count - capacityPerClass);
+        [trimmedNodes addObjectsFromArray:[nodes subarrayWithRange:trimmedRange]];
+        [nodes removeObjectsInRange:trimmedRange];
+      }
+    }
+    _metrics.drainedNodeCount += trimmedNodes.count;
+  }
+}
+
+#pragma mark Reuse
+
+- (ASCellNode *)nodeOfClass:(Class)nodeClass
+{
+  ASDisplayNodeAssert([nodeClass isSubclassOfClass:[ASCellNode class]], @"Reusable node class %@ is not a subclass of ASCellNode", nodeClass);
+  {
+    ASDN::MutexLocker l(_lock);
+    NSMutableArray<ASCellNode *> *nodes = [_nodesByClass objectForKey:nodeClass];
+    if (nodes == nil) {
+      // Record the class so that its nodes are taken back.
+      [_nodesByClass setObject:[NSMutableArray array] forKey:nodeClass];
+    } else if (ASCellNode *node = nodes.lastObject) {
+      [nodes removeLastObject];
+      _metrics.reusedNodeCount++;
+      return node;
+    }
+    _metrics.allocatedNodeCount++;
+  }
+  return [[nodeClass alloc] init];
+}
+
+- (BOOL)enqueueNode:(ASCellNode *)node
+{
+  ASDisplayNodeAssertMainThread();
+  Class nodeClass = [node class];
+  {
+    ASDN::MutexLocker l(_lock);
+    NSMutableArray<ASCellNode *> *nodes = [_nodesByClass objectForKey:nodeClass];
+    if (nodes == nil) {
+      return NO;
+    }
+    // A visible node may still be on screen, e.g. in a cell animating out after its row was deleted.
+    if (nodes.count >= _capacityPerClass || node.isVisible) {
+      _metrics.discardedNodeCount++;
+      return NO;
+    }
+  }
+
+  [node recursivelySetInterfaceState:ASInterfaceStateNone];
+  if (node.isNodeLoaded) {
+    [node.view removeFromSuperview];
+  }
+  node.collectionElement = nil;
+  // Pooled nodes shouldn't report size changes to the table or collection they left.
+  node.interactionDelegate = nil;
+  [node prepareForReuse];
+
+  ASDN::MutexLocker l(_lock);
+  NSMutableArray<ASCellNode *> *nodes = [_nodesByClass objectForKey:nodeClass];
+  if (nodes.count >= _capacityPerClass) {
+    _metrics.discardedNodeCount++;
+    return NO;
+  }
+  [nodes addObject:node];
+  _metrics.enqueuedNodeCount++;
+  return YES;
+}
+
+- (BOOL)isInUse
+{
+  ASDN::MutexLocker l(_lock);
+  return _nodesByClass.count > 0;
+}
+
+- (NSUInteger)countOfNodesOfClass:(Class)nodeClass
+{
+  ASDN::MutexLocker l(_lock);
+  return [_nodesByClass objectForKey:nodeClass].count;
+}
+
+- (void)drain
+{
+  NSMutableArray<ASCellNode *> *drainedNodes = [NSMutableArray array];
+  {
+    ASDN::MutexLocker l(_lock);
+    for (Class nodeClass in _nodesByClass) {
+      NSMutableArray<ASCellNode *> *nodes = [_nodesByClass objectForKey:nodeClass];
+      [drainedNodes addObjectsFromArray:nodes];
+      [nodes removeAllObjects];
+    }
+    _metrics.drainedNodeCount += drainedNodes.count;
+  }
+}
+
+#pragma mark Metrics
+
+- (void)recordFillOfNodeCount:(NSUInteger)nodeCount duration:(NSTimeInterval)duration
+{
+  ASDN::MutexLocker l(_lock);
+  _metrics.lastFillNodeCount = nodeCount;
+  _metrics.lastFillDuration = duration;
+}
+
+- (ASCellNodeReusePoolMetrics)metrics
+{
+  ASDN::MutexLocker l(_lock);
+  return _metrics;
+}
+
+- (void)resetMetrics
+{
+  ASDN::MutexLocker l(_lock);
+  _metrics = {};
+}
+
+@end
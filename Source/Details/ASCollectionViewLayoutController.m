@@ -50,18 +50,31 @@ typedef struct ASRangeGeometry ASRangeGeometry;
 - (NSSet<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType map:(ASElementMap *)map
 {
   ASRangeTuningParameters tuningParameters = [self tuningParametersForRangeMode:rangeMode rangeType:rangeType];
+  return [self elementsForScrolling:scrollDirection tuningParameters:tuningParameters map:map];
+}
+
+- (NSSet<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection tuningParameters:(ASRangeTuningParameters)tuningParameters map:(ASElementMap *)map
+{
   CGRect rangeBounds = [self rangeBoundsWithScrollDirection:scrollDirection rangeTuningParameters:tuningParameters];
   return [self elementsWithinRangeBounds:rangeBounds map:map];
 }
 
 - (void)allElementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode displaySet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)displaySet preloadSet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)preloadSet map:(ASElementMap *)map
+{
+  [self allElementsForScrolling:scrollDirection
+        displayTuningParameters:[self tuningParametersForRangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay]
+        preloadTuningParameters:[self tuningParametersForRangeMode:rangeMode rangeType:ASLayoutRangeTypePreload]
+                     displaySet:displaySet
+                     preloadSet:preloadSet
+                            map:map];
+}
+
+- (void)allElementsForScrolling:(ASScrollDirection)scrollDirection displayTuningParameters:(ASRangeTuningParameters)displayParams preloadTuningParameters:(ASRangeTuningParameters)preloadParams displaySet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)displaySet preloadSet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)preloadSet map:(ASElementMap *)map
 {
   if (displaySet == NULL || preloadSet == NULL) {
     return;
   }
   
-  ASRangeTuningParameters displayParams = [self tuningParametersForRangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay];
-  ASRangeTuningParameters preloadParams = [self tuningParametersForRangeMode:rangeMode rangeType:ASLayoutRangeTypePreload];
   CGRect displayBounds = [self rangeBoundsWithScrollDirection:scrollDirection rangeTuningParameters:displayParams];
   CGRect preloadBounds = [self rangeBoundsWithScrollDirection:scrollDirection rangeTuningParameters:preloadParams];
   
@@ -27,6 +27,7 @@ NS_ASSUME_NONNULL_BEGIN
 #endif
 
 @class ASCellNode;
+@class ASCellNodeReusePool;
 @class ASCollectionElement;
 @class ASDataController;
 @class ASElementMap;
@@ -87,6 +88,14 @@ extern NSString * const ASCollectionInvalidUpdateException;
 
 - (nullable id<ASSectionContext>)dataController:(ASDataController *)dataController contextForSection:(NSInteger)section;
 
+/**
+ The class of the reusable node for the row at the given index path, or nil to use the node block.
+ If this returns a class, the node is taken from the node reuse pool and set up with the configuration block.
+ */
+- (nullable Class)dataController:(ASDataController *)dataController reusableNodeClassAtIndexPath:(NSIndexPath *)indexPath;
+
+- (ASCellNodeConfigurationBlock)dataController:(ASDataController *)dataController nodeConfigurationBlockAtIndexPath:(NSIndexPath *)indexPath;
+
 @end
 
 @protocol ASDataControllerEnvironmentDelegate
@@ -190,6 +199,12 @@ extern NSString * const ASCollectionInvalidUpdateException;
  */
 @property (nonatomic, weak) id<ASDataControllerLayoutDelegate> layoutDelegate;
 
+/**
+ * Where nodes of reusable node classes come from, and where they go once their elements have been deleted and the
+ * change is deployed. Can be shared between data controllers. Main thread only.
+ */
+@property (nonatomic, strong) ASCellNodeReusePool *nodeReusePool;
+
 #ifdef __cplusplus
 /**
  * Returns the most recently gathered item counts from the data source. If the counts
@@ -13,6 +13,7 @@
 #import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASCellNodeReusePool.h>
 #import <AsyncDisplayKit/ASCollectionElement.h>
 #import <AsyncDisplayKit/ASCollectionLayoutContext.h>
 #import <AsyncDisplayKit/ASDispatch.h>
@@ -21,6 +22,7 @@
 #import <AsyncDisplayKit/ASMainSerialQueue.h>
 #import <AsyncDisplayKit/ASMutableElementMap.h>
 #import <AsyncDisplayKit/ASThread.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
 #import <AsyncDisplayKit/ASTwoDimensionalArrayUtils.h>
 #import <AsyncDisplayKit/ASSection.h>
 
@@ -75,6 +77,7 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
     unsigned int constrainedSizeForNodeAtIndexPath:1;
     unsigned int constrainedSizeForSupplementaryNodeOfKindAtIndexPath:1;
     unsigned int contextForSection:1;
+    unsigned int reusableNodeClassAtIndexPath:1;
   } _dataSourceFlags;
 }
 
@@ -98,12 +101,15 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   _dataSourceFlags.constrainedSizeForNodeAtIndexPath = [_dataSource respondsToSelector:@selector(dataController:constrainedSizeForNodeAtIndexPath:)];
   _dataSourceFlags.constrainedSizeForSupplementaryNodeOfKindAtIndexPath = [_dataSource respondsToSelector:@selector(dataController:constrainedSizeForSupplementaryNodeOfKind:atIndexPath:)];
   _dataSourceFlags.contextForSection = [_dataSource respondsToSelector:@selector(dataController:contextForSection:)];
+  _dataSourceFlags.reusableNodeClassAtIndexPath = [_dataSource respondsToSelector:@selector(dataController:reusableNodeClassAtIndexPath:)]
+    && [_dataSource respondsToSelector:@selector(dataController:nodeConfigurationBlockAtIndexPath:)];
   
 #if ASEVENTLOG_ENABLE
   _eventLog = eventLog;
 #endif
 
   _visibleMap = _pendingMap = [[ASElementMap alloc] init];
+  _nodeReusePool = [[ASCellNodeReusePool alloc] init];
   
   _nextSectionID = 0;
   
@@ -151,6 +157,19 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   }
 }
 
+- (ASCellNodeReusePool *)nodeReusePool
+{
+  ASDisplayNodeAssertMainThread();
+  return _nodeReusePool;
+}
+
+- (void)setNodeReusePool:(ASCellNodeReusePool *)nodeReusePool
+{
+  ASDisplayNodeAssertMainThread();
+  ASDisplayNodeAssertNotNil(nodeReusePool, @"Node reuse pool must not be nil");
+  _nodeReusePool = nodeReusePool;
+}
+
 #pragma mark - Cell Layout
 
 - (void)batchAllocateNodesFromElements:(NSArray<ASCollectionElement *> *)elements andLayout:(BOOL)shouldLayout batchSize:(NSInteger)batchSize batchCompletion:(ASDataControllerCompletionBlock)batchCompletionHandler
@@ -205,6 +224,7 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
     return @[];
   }
 
+  ASDN::TraceScope traceScope(ASTraceSpanDataControllerAllocateNodes, Nil);
   __strong ASCellNode **allocatedNodeBuffer = (__strong ASCellNode **)calloc(nodeCount, sizeof(ASCellNode *));
 
   dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
@@ -386,7 +406,7 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   for (NSIndexPath *indexPath in indexPaths) {
     ASCellNodeBlock nodeBlock;
     if (isRowKind) {
-      nodeBlock = [_dataSource dataController:self nodeBlockAtIndexPath:indexPath];
+      nodeBlock = [self _reusableNodeBlockAtIndexPath:indexPath] ?: [_dataSource dataController:self nodeBlockAtIndexPath:indexPath];
     } else {
       nodeBlock = [_dataSource dataController:self supplementaryNodeBlockOfKind:kind atIndexPath:indexPath];
     }
@@ -405,6 +425,32 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   }
 }
 
+/**
+ * Returns a node block that takes a node from the reuse pool and configures it, if the data source opted in to reuse
+ * for the row at the given index path.
+ */
+- (ASCellNodeBlock)_reusableNodeBlockAtIndexPath:(NSIndexPath *)indexPath
+{
+  ASDisplayNodeAssertMainThread();
+
+  if (!_dataSourceFlags.reusableNodeClassAtIndexPath) {
+    return nil;
+  }
+  Class nodeClass = [_dataSource dataController:self reusableNodeClassAtIndexPath:indexPath];
+  if (nodeClass == Nil) {
+    return nil;
+  }
+  ASCellNodeConfigurationBlock configurationBlock = [_dataSource dataController:self nodeConfigurationBlockAtIndexPath:indexPath];
+  ASCellNodeReusePool *pool = _nodeReusePool;
+  return ^{
+    ASCellNode *node = [pool nodeOfClass:nodeClass];
+    if (configurationBlock != nil) {
+      configurationBlock(node);
+    }
+    return node;
+  };
+}
+
 - (void)invalidateDataSourceItemCounts
 {
   ASDisplayNodeAssertMainThread();
@@ -536,6 +582,7 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   BOOL canDelegateLayout = (_layoutDelegate != nil);
 
   // Step 1: Update the mutable copies to match the data source's state
+  ASTraceBufferBeginSpan(ASTraceSpanDataControllerUpdateElements, Nil);
   [self _updateSectionContextsInMap:mutableMap changeSet:changeSet];
   __weak id<ASTraitEnvironment> environment = [self.environmentDelegate dataControllerEnvironment];
   __weak ASDisplayNode *owningNode = (ASDisplayNode *)environment; // This is gross!
@@ -551,7 +598,9 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
   if (canDelegateLayout) {
     layoutContext = [_layoutDelegate layoutContextWithElements:newMap];
   }
+  ASTraceBufferEndSpan(ASTraceSpanDataControllerUpdateElements, Nil);
   
+  ASCellNodeReusePool *nodeReusePool = _nodeReusePool;
   dispatch_group_async(_editingTransactionGroup, _editingTransactionQueue, ^{
     // Step 4: Allocate and layout elements if can't delegate
     NSArray<ASCollectionElement *> *elementsToProcess;
@@ -567,25 +616,76 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
                                                (element.nodeIfAllocated.calculatedLayout == nil ? element : nil));
     }
     
+    CFTimeInterval fillStartTime = CACurrentMediaTime();
     [self batchAllocateNodesFromElements:elementsToProcess andLayout:(! canDelegateLayout) batchSize:elementsToProcess.count batchCompletion:^(NSArray<ASCollectionElement *> *elements, NSArray<ASCellNode *> *nodes) {
       ASSERT_ON_EDITING_QUEUE;
 
       if (canDelegateLayout) {
         [_layoutDelegate prepareLayoutWithContext:layoutContext];
       }
+      if (nodes.count > 0) {
+        [nodeReusePool recordFillOfNodeCount:nodes.count duration:CACurrentMediaTime() - fillStartTime];
+      }
       
       [_mainSerialQueue performBlockOnMainThread:^{
+        ASDN::TraceScope traceScope(ASTraceSpanDataControllerDeployUpdate, Nil);
         [_delegate dataController:self willUpdateWithChangeSet:changeSet];
 
         // Step 5: Deploy the new data as "completed" and inform delegate
+        ASElementMap *oldMap = _visibleMap;
         _visibleMap = newMap;
         
         [_delegate dataController:self didUpdateWithChangeSet:changeSet];
+
+        // Step 6: Now that the views have been updated, offer the nodes of removed elements for reuse
+        [self _enqueueReusableNodesRemovedFromMap:oldMap changeSet:changeSet];
       }];
     }];
   });
 }
 
+/**
+ * Offers the nodes of the row elements the change set removed from the old map to the reuse pool.
+ */
+- (void)_enqueueReusableNodesRemovedFromMap:(ASElementMap *)oldMap changeSet:(_ASHierarchyChangeSet *)changeSet
+{
+  ASDisplayNodeAssertMainThread();
+
+  if (!_nodeReusePool.isInUse) {
+    return;
+  }
+
+  if (changeSet.includesReloadData) {
+    for (ASCollectionElement *element in oldMap.itemElements) {
+      [self _enqueueReusableNodeOfElement:element];
+    }
+    return;
+  }
+
+  // Reloads and moves are deletes and inserts by now, and item deletes in deleted sections are left out, so these
+  // are exactly the removed rows.
+  for (_ASHierarchyItemChange *change in [changeSet itemChangesOfType:_ASHierarchyChangeTypeDelete]) {
+    for (NSIndexPath *indexPath in change.indexPaths) {
+      [self _enqueueReusableNodeOfElement:[oldMap elementForItemAtIndexPath:indexPath]];
+    }
+  }
+  for (_ASHierarchySectionChange *change in [changeSet sectionChangesOfType:_ASHierarchyChangeTypeDelete]) {
+    [change.indexSet enumerateIndexesUsingBlock:^(NSUInteger section, BOOL * _Nonnull stop) {
+      NSInteger itemCount = [oldMap numberOfItemsInSection:section];
+      for (NSInteger item = 0; item < itemCount; item++) {
+        [self _enqueueReusableNodeOfElement:[oldMap elementForItemAtIndexPath:[NSIndexPath indexPathForItem:item inSection:section]]];
+      }
+    }];
+  }
+}
+
+- (void)_enqueueReusableNodeOfElement:(ASCollectionElement *)element
+{
+  if (ASCellNode *node = element.nodeIfAllocated) {
+    [_nodeReusePool enqueueNode:node];
+  }
+}
+
 /**
  * Update sections based on the given change set.
  */
@@ -750,6 +850,7 @@ typedef void (^ASDataControllerCompletionBlock)(NSArray<ASCollectionElement *> *
 - (void)_relayoutAllNodes
 {
   ASDisplayNodeAssertMainThread();
+  ASDN::TraceScope traceScope(ASTraceSpanDataControllerRelayout, Nil);
   for (ASCollectionElement *element in _visibleMap) {
     ASSizeRange constrainedSize = [self constrainedSizeForElement:element inElementMap:_visibleMap];
     if (ASSizeRangeHasSignificantArea(constrainedSize)) {
@@ -0,0 +1,127 @@
+//
+//  ASDisplayTelemetry.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <QuartzCore/QuartzCore.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * What ASDisplayTelemetry measures for each node class.
+ */
+typedef NS_ENUM(NSInteger, ASDisplayTelemetryMetric) {
+  /// Time spent in display blocks, drawing the node's contents.
+  ASDisplayTelemetryMetricDrawTime,
+  /// Time asynchronous display operations waited in the display queue before they started drawing.
+  ASDisplayTelemetryMetricQueueWaitTime,
+  /// Time spent calculating the node's layout, including the layouts of its subnodes.
+  ASDisplayTelemetryMetricLayoutTime,
+};
+
+/**
+ * A snapshot of the durations recorded for one metric of one node class.
+ *
+ * Durations fall into power-of-two buckets of microseconds: the first bucket holds durations under 1µs, bucket i holds
+ * durations under 2^i µs, and the last bucket holds everything longer.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASDisplayTelemetryHistogram : NSObject
+
+@property (nonatomic, readonly) NSUInteger count;
+@property (nonatomic, readonly) NSTimeInterval totalDuration;
+@property (nonatomic, readonly) NSTimeInterval maximumDuration;
+@property (nonatomic, readonly) NSTimeInterval averageDuration;
+
+/// The number of durations in each bucket.
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *bucketCounts;
+
+/**
+ * Returns the upper bound of the bucket holding the given percentile, from 0 to 100, or 0 if the histogram is empty.
+ * The last bucket is bounded by maximumDuration.
+ */
+- (NSTimeInterval)durationAtPercentile:(double)percentile AS_WARN_UNUSED_RESULT;
+
+/**
+ * The exclusive upper bound of the durations in the bucket at the given index, or DBL_MAX for the last bucket.
+ */
++ (NSTimeInterval)upperBoundOfBucketAtIndex:(NSUInteger)index AS_WARN_UNUSED_RESULT;
+
+@end
+
+/**
+ * A snapshot of what was recorded for one node class.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASDisplayTelemetryRecord : NSObject
+
+/// The node class, or nil for samples of classes that didn't fit in the telemetry tables.
+@property (nonatomic, readonly, nullable) Class nodeClass;
+
+/// Displays whose contents were applied to the layer.
+@property (nonatomic, readonly) NSUInteger completedDisplayCount;
+
+/// Displays that were cancelled, whether they were purged from the queue, bailed out or finished too late.
+@property (nonatomic, readonly) NSUInteger cancelledDisplayCount;
+
+/// The fraction of displays that were cancelled, from 0 to 1.
+@property (nonatomic, readonly) double cancellationRate;
+
+- (ASDisplayTelemetryHistogram *)histogramForMetric:(ASDisplayTelemetryMetric)metric AS_WARN_UNUSED_RESULT;
+
+@end
+
+/**
+ * @abstract Always-available timing of the display pipeline, by node class.
+ *
+ * @discussion Nodes record how long they take to draw and lay out, how long their display operations wait in the
+ * queue and how often their displays are cancelled. Samples go into per-thread tables of per-class histograms, using
+ * relaxed atomic counters rather than locks, so recording costs a clock read and a few atomic additions and is cheap
+ * enough to leave enabled in release builds. Snapshots sum the tables of all threads.
+ *
+ * Each thread tracks up to 64 node classes; samples of further classes are recorded under a nil class.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASDisplayTelemetry : NSObject
+
+/**
+ * Whether nodes record samples. Defaults to YES.
+ */
+@property (class, atomic, assign, getter=isEnabled) BOOL enabled;
+
+/**
+ * Returns the records of all node classes with samples since the last reset, by descending total draw time.
+ */
++ (NSArray<ASDisplayTelemetryRecord *> *)snapshot AS_WARN_UNUSED_RESULT;
+
+/**
+ * Like -snapshot, but also resets the counters, so that no sample is missed or counted twice by consecutive calls.
+ */
++ (NSArray<ASDisplayTelemetryRecord *> *)snapshotAndReset AS_WARN_UNUSED_RESULT;
+
++ (void)reset;
+
+@end
+
+ASDISPLAYNODE_EXTERN_C_BEGIN
+
+/**
+ * Records a duration for the node class, if telemetry is enabled. Lock-free, may be called on any thread.
+ */
+extern void ASDisplayTelemetryRecordDuration(Class nodeClass, ASDisplayTelemetryMetric metric, CFTimeInterval duration);
+
+/**
+ * Records the outcome of a display of the node class, if telemetry is enabled. Lock-free, may be called on any thread.
+ */
+extern void ASDisplayTelemetryRecordDisplay(Class nodeClass, BOOL cancelled);
+
+ASDISPLAYNODE_EXTERN_C_END
+
+NS_ASSUME_NONNULL_END
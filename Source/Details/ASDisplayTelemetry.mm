@@ -0,0 +1,418 @@
+//
+//  ASDisplayTelemetry.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+
+#import <algorithm>
+#import <atomic>
+#import <map>
+#import <pthread.h>
+#import <vector>
+
+#import <AsyncDisplayKit/ASThread.h>
+
+static const NSUInteger ASDisplayTelemetryBucketCount = 24;
+static const NSUInteger ASDisplayTelemetryMetricCount = 3;
+// A power of two, so that classes hash to entries with a mask.
+static const size_t ASDisplayTelemetryClassCount = 64;
+
+static std::atomic<bool> __enabled(true);
+
+#pragma mark - Tables
+
+namespace {
+  struct ASTelemetryHistogram {
+    std::atomic<uint32_t> buckets[ASDisplayTelemetryBucketCount];
+    std::atomic<uint64_t> totalNanoseconds;
+    std::atomic<uint64_t> maximumNanoseconds;
+  };
+
+  /// The counters of one node class. Only the thread owning the table adds to them, snapshots read and reset them.
+  struct ASTelemetryEntry {
+    std::atomic<uintptr_t> nodeClass;   // 0 while the entry is unused.
+    ASTelemetryHistogram histograms[ASDisplayTelemetryMetricCount];
+    std::atomic<uint32_t> completedDisplayCount;
+    std::atomic<uint32_t> cancelledDisplayCount;
+  };
+
+  /// An open-addressed table of entries, with one more for the classes that don't fit.
+  struct ASTelemetryTable {
+    ASTelemetryEntry entries[ASDisplayTelemetryClassCount];
+    ASTelemetryEntry overflowEntry;
+  };
+
+  /// Plain counters that snapshots sum the entries of all tables into.
+  struct ASTelemetryHistogramSum {
+    uint64_t buckets[ASDisplayTelemetryBucketCount];
+    uint64_t totalNanoseconds;
+    uint64_t maximumNanoseconds;
+  };
+
+  struct ASTelemetryEntrySum {
+    ASTelemetryHistogramSum histograms[ASDisplayTelemetryMetricCount];
+    uint64_t completedDisplayCount;
+    uint64_t cancelledDisplayCount;
+  };
+}
+
+// Guards the list of live tables, so that snapshots don't read tables of threads as they exit, and the retired table.
+static ASDN::StaticMutex __tablesLock = ASDISPLAYNODE_MUTEX_INITIALIZER;
+static std::vector<ASTelemetryTable *> *__liveTables;
+// Holds the counters of threads that exited.
+static ASTelemetryTable *__retiredTable;
+
+static ASTelemetryEntry &ASTelemetryEntryForClass(ASTelemetryTable &table, uintptr_t nodeClass)
+{
+  size_t index = (nodeClass >> 4) & (ASDisplayTelemetryClassCount - 1);
+  for (size_t i = 0; i < ASDisplayTelemetryClassCount; i++) {
+    ASTelemetryEntry &entry = table.entries[(index + i) & (ASDisplayTelemetryClassCount - 1)];
+    uintptr_t entryClass = entry.nodeClass.load(std::memory_order_relaxed);
+    if (entryClass == nodeClass) {
+      return entry;
+    }
+    if (entryClass == 0) {
+      // The counters of unused entries are zero, publish the class to snapshots.
+      entry.nodeClass.store(nodeClass, std::memory_order_release);
+      return entry;
+    }
+  }
+  return table.overflowEntry;
+}
+
+static uint64_t ASTelemetryTake(std::atomic<uint32_t> &counter, bool reset)
+{
+  return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+}
+
+static uint64_t ASTelemetryTake(std::atomic<uint64_t> &counter, bool reset)
+{
+  return reset ? counter.exchange(0, std::memory_order_relaxed) : counter.load(std::memory_order_relaxed);
+}
+
+/**
+ * Adds the counters of the entry to the sum, resetting them if requested.
+ */
+static void ASTelemetrySumEntry(ASTelemetryEntry &entry, ASTelemetryEntrySum &sum, bool reset)
+{
+  for (NSUInteger m = 0; m < ASDisplayTelemetryMetricCount; m++) {
+    ASTelemetryHistogram &histogram = entry.histograms[m];
+    ASTelemetryHistogramSum &histogramSum = sum.histograms[m];
+    for (NSUInteger b = 0; b < ASDisplayTelemetryBucketCount; b++) {
+      histogramSum.buckets[b] += ASTelemetryTake(histogram.buckets[b], reset);
+    }
+    histogramSum.totalNanoseconds += ASTelemetryTake(histogram.totalNanoseconds, reset);
+    histogramSum.maximumNanoseconds = std::max(histogramSum.maximumNanoseconds, ASTelemetryTake(histogram.maximumNanoseconds, reset));
+  }
+  sum.completedDisplayCount += ASTelemetryTake(entry.completedDisplayCount, reset);
+  sum.cancelledDisplayCount += ASTelemetryTake(entry.cancelledDisplayCount, reset);
+}
+
+/**
+ * Sums the entries of the table by class. Classes that didn't fit are summed under 0.
+ */
+static void ASTelemetrySumTable(ASTelemetryTable &table, std::map<uintptr_t, ASTelemetryEntrySum> &sums, bool reset)
+{
+  for (ASTelemetryEntry &entry : table.entries) {
+    uintptr_t nodeClass = entry.nodeClass.load(std::memory_order_acquire);
+    if (nodeClass != 0) {
+      ASTelemetrySumEntry(entry, sums[nodeClass], reset);
+    }
+  }
+  ASTelemetrySumEntry(table.overflowEntry, sums[0], reset);
+}
+
+/**
+ * Called when a thread with a table exits. Moves its counters to the retired table.
+ */
+static void ASTelemetryRetireTable(void *context)
+{
+  ASTelemetryTable *table = (ASTelemetryTable *)context;
+  std::map<uintptr_t, ASTelemetryEntrySum> sums;
+  {
+    ASDN::StaticMutexLocker l(__tablesLock);
+    __liveTables->erase(std::remove(__liveTables->begin(), __liveTables->end(), table), __liveTables->end());
+    ASTelemetrySumTable(*table, sums, true);
+
+    for (auto &pair : sums) {
+      ASTelemetryEntry &entry = (pair.first == 0 ? __retiredTable->overflowEntry : ASTelemetryEntryForClass(*__retiredTable, pair.first));
+      const ASTelemetryEntrySum &sum = pair.second;
+      for (NSUInteger m = 0; m < ASDisplayTelemetryMetricCount; m++) {
+        for (NSUInteger b = 0; b < ASDisplayTelemetryBucketCount; b++) {
+          entry.histograms[m].buckets[b].fetch_add((uint32_t)sum.histograms[m].buckets[b], std::memory_order_relaxed);
+        }
+        entry.histograms[m].totalNanoseconds.fetch_add(sum.histograms[m].totalNanoseconds, std::memory_order_relaxed);
+        uint64_t maximum = std::max(entry.histograms[m].maximumNanoseconds.load(std::memory_order_relaxed), sum.histograms[m].maximumNanoseconds);
+        entry.histograms[m].maximumNanoseconds.store(maximum, std::memory_order_relaxed);
+      }
+      entry.completedDisplayCount.fetch_add((uint32_t)sum.completedDisplayCount, std::memory_order_relaxed);
+      entry.cancelledDisplayCount.fetch_add((uint32_t)sum.cancelledDisplayCount, std::memory_order_relaxed);
+    }
+  }
+  delete table;
+}
+
+static pthread_key_t ASTelemetryTableKey()
+{
+  static pthread_key_t key;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    __liveTables = new std::vector<ASTelemetryTable *>();
+    __retiredTable = new ASTelemetryTable();
+    pthread_key_create(&key, ASTelemetryRetireTable);
+  });
+  return key;
+}
+
+static ASTelemetryTable &ASTelemetryCurrentTable()
+{
+  pthread_key_t key = ASTelemetryTableKey();
+  ASTelemetryTable *table = (ASTelemetryTable *)pthread_getspecific(key);
+  if (table == NULL) {
+    // Value-initialized, so all counters start at zero.
+    table = new ASTelemetryTable();
+    {
+      ASDN::StaticMutexLocker l(__tablesLock);
+      __liveTables->push_back(table);
+    }
+    pthread_setspecific(key, table);
+  }
+  return *table;
+}
+
+/**
+ * Returns the bucket of the duration: 0 under 1µs, i under 2^i µs.
+ */
+static NSUInteger ASTelemetryBucketIndex(uint64_t nanoseconds)
+{
+  uint64_t microseconds = nanoseconds / 1000;
+  if (microseconds == 0) {
+    return 0;
+  }
+  NSUInteger index = 64 - __builtin_clzll(microseconds);
+  return MIN(index, ASDisplayTelemetryBucketCount - 1);
+}
+
+#pragma mark - Recording
+
+void ASDisplayTelemetryRecordDuration(Class nodeClass, ASDisplayTelemetryMetric metric, CFTimeInterval duration)
+{
+  if (!__enabled.load(std::memory_order_relaxed) || nodeClass == Nil || duration < 0) {
+    return;
+  }
+  ASTelemetryEntry &entry = ASTelemetryEntryForClass(ASTelemetryCurrentTable(), (uintptr_t)(__bridge void *)nodeClass);
+  ASTelemetryHistogram &histogram = entry.histograms[metric];
+  uint64_t nanoseconds = (uint64_t)(duration * NSEC_PER_SEC);
+  histogram.buckets[ASTelemetryBucketIndex(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+  histogram.totalNanoseconds.fetch_add(nanoseconds, std::memory_order_relaxed);
+  // Snapshots may reset the maximum at any time, so compare and swap rather than store.
+  uint64_t maximum = histogram.maximumNanoseconds.load(std::memory_order_relaxed);
+  while (nanoseconds > maximum && !histogram.maximumNanoseconds.compare_exchange_weak(maximum, nanoseconds, std::memory_order_relaxed)) {
+  }
+}
+
+void ASDisplayTelemetryRecordDisplay(Class nodeClass, BOOL cancelled)
+{
+  if (!__enabled.load(std::memory_order_relaxed) || nodeClass == Nil) {
+    return;
+  }
+  ASTelemetryEntry &entry = ASTelemetryEntryForClass(ASTelemetryCurrentTable(), (uintptr_t)(__bridge void *)nodeClass);
+  (cancelled ? entry.cancelledDisplayCount : entry.completedDisplayCount).fetch_add(1, std::memory_order_relaxed);
+}
+
+#pragma mark - Snapshots
+
+@interface ASDisplayTelemetryHistogram ()
+- (instancetype)initWithSum:(const ASTelemetryHistogramSum &)sum;
+@end
+
+@interface ASDisplayTelemetryRecord ()
+- (instancetype)initWithNodeClass:(Class)nodeClass sum:(const ASTelemetryEntrySum &)sum;
+- (BOOL)isEmpty;
+@end
+
+@implementation ASDisplayTelemetryHistogram {
+  ASTelemetryHistogramSum _sum;
+}
+
+- (instancetype)initWithSum:(const ASTelemetryHistogramSum &)sum
+{
+  if (self = [super init]) {
+    _sum = sum;
+    for (uint64_t bucketCount : sum.buckets) {
+      _count += bucketCount;
+    }
+  }
+  return self;
+}
+
+- (NSTimeInterval)totalDuration
+{
+  return (NSTimeInterval)_sum.totalNanoseconds / NSEC_PER_SEC;
+}
+
+- (NSTimeInterval)maximumDuration
+{
+  return (NSTimeInterval)_sum.maximumNanoseconds / NSEC_PER_SEC;
+}
+
+- (NSTimeInterval)averageDuration
+{
+  return _count > 0 ? self.totalDuration / _count : 0;
+}
+
+- (NSArray<NSNumber *> *)bucketCounts
+{
+  NSMutableArray<NSNumber *> *bucketCounts = [NSMutableArray arrayWithCapacity:ASDisplayTelemetryBucketCount];
+  for (uint64_t bucketCount : _sum.buckets) {
+    [bucketCounts addObject:@(bucketCount)];
+  }
+  return bucketCounts;
+}
+
+- (NSTimeInterval)durationAtPercentile:(double)percentile
+{
+  if (_count == 0) {
+    return 0;
+  }
+  uint64_t rank = MAX(1, (uint64_t)ceil(MIN(MAX(percentile, 0), 100) / 100 * _count));
+  uint64_t cumulativeCount = 0;
+  for (NSUInteger b = 0; b < ASDisplayTelemetryBucketCount; b++) {
+    cumulativeCount += _sum.buckets[b];
+    if (cumulativeCount >= rank) {
+      return MIN([ASDisplayTelemetryHistogram upperBoundOfBucketAtIndex:b], self.maximumDuration);
+    }
+  }
+  return self.maximumDuration;
+}
+
++ (NSTimeInterval)upperBoundOfBucketAtIndex:(NSUInteger)index
+{
+  if (index >= ASDisplayTelemetryBucketCount - 1) {
+    return DBL_MAX;
+  }
+  return (NSTimeInterval)(1ull << index) / USEC_PER_SEC;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; count = %tu, average = %.3fms, p95 = %.3fms, max = %.3fms>",
+          self.class, self, _count, self.averageDuration * 1000, [self durationAtPercentile:95] * 1000, self.maximumDuration * 1000];
+}
+
+@end
+
+@implementation ASDisplayTelemetryRecord {
+  NSArray<ASDisplayTelemetryHistogram *> *_histograms;
+}
+
+- (instancetype)initWithNodeClass:(Class)nodeClass sum:(const ASTelemetryEntrySum &)sum
+{
+  if (self = [super init]) {
+    _nodeClass = nodeClass;
+    _completedDisplayCount = (NSUInteger)sum.completedDisplayCount;
+    _cancelledDisplayCount = (NSUInteger)sum.cancelledDisplayCount;
+    NSMutableArray<ASDisplayTelemetryHistogram *> *histograms = [NSMutableArray arrayWithCapacity:ASDisplayTelemetryMetricCount];
+    for (const ASTelemetryHistogramSum &histogramSum : sum.histograms) {
+      [histograms addObject:[[ASDisplayTelemetryHistogram alloc] initWithSum:histogramSum]];
+    }
+    _histograms = histograms;
+  }
+  return self;
+}
+
+- (double)cancellationRate
+{
+  NSUInteger displayCount = _completedDisplayCount + _cancelledDisplayCount;
+  return displayCount > 0 ? (double)_cancelledDisplayCount / displayCount : 0;
+}
+
+- (ASDisplayTelemetryHistogram *)histogramForMetric:(ASDisplayTelemetryMetric)metric
+{
+  return _histograms[metric];
+}
+
+- (BOOL)isEmpty
+{
+  if (_completedDisplayCount > 0 || _cancelledDisplayCount > 0) {
+    return NO;
+  }
+  for (ASDisplayTelemetryHistogram *histogram in _histograms) {
+    if (histogram.count > 0) {
+      return NO;
+    }
+  }
+  return YES;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; class = %@, draw = %@, queue wait = %@, layout = %@, cancelled = %.1f%%>",
+          self.class, self, _nodeClass, _histograms[ASDisplayTelemetryMetricDrawTime], _histograms[ASDisplayTelemetryMetricQueueWaitTime],
+          _histograms[ASDisplayTelemetryMetricLayoutTime], self.cancellationRate * 100];
+}
+
+@end
+
+@implementation ASDisplayTelemetry
+
++ (BOOL)isEnabled
+{
+  return __enabled.load();
+}
+
++ (void)setEnabled:(BOOL)enabled
+{
+  __enabled.store(enabled);
+}
+
++ (NSArray<ASDisplayTelemetryRecord *> *)_snapshotResetting:(BOOL)reset
+{
+  ASTelemetryTableKey();
+  std::map<uintptr_t, ASTelemetryEntrySum> sums;
+  {
+    ASDN::StaticMutexLocker l(__tablesLock);
+    for (ASTelemetryTable *table : *__liveTables) {
+      ASTelemetrySumTable(*table, sums, reset);
+    }
+    ASTelemetrySumTable(*__retiredTable, sums, reset);
+  }
+
+  NSMutableArray<ASDisplayTelemetryRecord *> *records = [NSMutableArray arrayWithCapacity:sums.size()];
+  for (const auto &pair : sums) {
+    Class nodeClass = (__bridge Class)(void *)pair.first;
+    ASDisplayTelemetryRecord *record = [[ASDisplayTelemetryRecord alloc] initWithNodeClass:nodeClass sum:pair.second];
+    if (![record isEmpty]) {
+      [records addObject:record];
+    }
+  }
+  [records sortUsingComparator:^NSComparisonResult(ASDisplayTelemetryRecord *record1, ASDisplayTelemetryRecord *record2) {
+    NSTimeInterval drawTime1 = [record1 histogramForMetric:ASDisplayTelemetryMetricDrawTime].totalDuration;
+    NSTimeInterval drawTime2 = [record2 histogramForMetric:ASDisplayTelemetryMetricDrawTime].totalDuration;
+    return drawTime1 > drawTime2 ? NSOrderedAscending : (drawTime1 < drawTime2 ? NSOrderedDescending : NSOrderedSame);
+  }];
+  return records;
+}
+
++ (NSArray<ASDisplayTelemetryRecord *> *)snapshot
+{
+  return [self _snapshotResetting:NO];
+}
+
++ (NSArray<ASDisplayTelemetryRecord *> *)snapshotAndReset
+{
+  return [self _snapshotResetting:YES];
+}
+
++ (void)reset
+{
+  (void)[self _snapshotResetting:YES];
+}
+
+@end
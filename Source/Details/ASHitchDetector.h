@@ -0,0 +1,110 @@
+//
+//  ASHitchDetector.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <QuartzCore/QuartzCore.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A span of framework work that ran on the main thread during a hitch.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASHitchSpan : NSObject
+
+@property (nonatomic, readonly) ASTraceSpan kind;
+
+/// The class the span was about, such as the node class of a layout, or nil.
+@property (nonatomic, readonly, nullable) Class spanClass;
+
+/// The name of the class, or of the kind of span if it has no class.
+@property (nonatomic, copy, readonly) NSString *name;
+
+/// The time from the beginning of the hitch to the beginning of the span.
+@property (nonatomic, readonly) NSTimeInterval startOffset;
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+/// The number of spans this one is nested in.
+@property (nonatomic, readonly) NSUInteger depth;
+
+/// A JSON-compatible representation, for logging.
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation AS_WARN_UNUSED_RESULT;
+
+@end
+
+/**
+ * What the main thread did during one run loop iteration that took longer than the threshold of a detector.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASHitchReport : NSObject
+
+/// When the iteration started, in the time base of CACurrentMediaTime().
+@property (nonatomic, readonly) CFTimeInterval startTime;
+@property (nonatomic, readonly) NSTimeInterval duration;
+
+/**
+ * The framework spans that began during the iteration, in the order they began, so that nested spans follow the span
+ * they are nested in. Spans that began before the iteration, such as ones running a nested run loop, aren't included.
+ */
+@property (nonatomic, copy, readonly) NSArray<ASHitchSpan *> *spans;
+
+/// The time the iteration spent outside of framework spans, in application code and UIKit.
+@property (nonatomic, readonly) NSTimeInterval unattributedDuration;
+
+/// A JSON-compatible representation, for logging.
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation AS_WARN_UNUSED_RESULT;
+
+@end
+
+/**
+ * @abstract Reports main run loop iterations that take longer than a threshold, with the framework work that ran in them.
+ *
+ * @discussion An iteration lasts from when the main run loop wakes up, or is entered, until it goes back to sleep, or
+ * exits, including the Core Animation commit. Nested runs of the main run loop split the iteration that runs them.
+ *
+ * While detectors are running, the spans of ASTraceBuffer are recorded on all threads, and the spans recorded on the main
+ * thread during a long iteration are attributed to it. Each thread buffers its latest 4096 events, so the earliest
+ * spans of iterations with more events are left out.
+ *
+ * In tests, start a detector, drive the interface, for example scrolling through a collection, then assert that
+ * reports is empty, to catch main thread work over the threshold.
+ *
+ * Detectors must be used on the main thread.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASHitchDetector : NSObject
+
+- (instancetype)initWithThreshold:(NSTimeInterval)threshold NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, readonly) NSTimeInterval threshold;
+
+/**
+ * Called on the main thread with each report, at the end of the iteration that took too long.
+ */
+@property (nonatomic, copy, nullable) void (^hitchHandler)(ASHitchReport *report);
+
+@property (nonatomic, readonly, getter=isRunning) BOOL running;
+
+- (void)start;
+- (void)stop;
+
+/**
+ * The reports since the detector started or the reports were removed, oldest first. The latest 100 reports are kept.
+ */
+@property (nonatomic, copy, readonly) NSArray<ASHitchReport *> *reports;
+
+- (void)removeAllReports;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,236 @@
+//
+//  ASHitchDetector.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASHitchDetector.h>
+
+#import <mach/mach_time.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASTraceBufferInternal.h>
+
+static const NSUInteger ASHitchDetectorMaximumReportCount = 100;
+
+static NSTimeInterval ASHitchSecondsFromMachTime(uint64_t machTime)
+{
+  static double secondsPerTick;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    mach_timebase_info_data_t timebase;
+    mach_timebase_info(&timebase);
+    secondsPerTick = (double)timebase.numer / timebase.denom / NSEC_PER_SEC;
+  });
+  return machTime * secondsPerTick;
+}
+
+#pragma mark - ASHitchSpan
+
+@interface ASHitchSpan ()
+- (instancetype)initWithInterval:(const ASTraceSpanInterval &)interval hitchStartTime:(uint64_t)hitchStartTime;
+@end
+
+@implementation ASHitchSpan
+
+- (instancetype)initWithInterval:(const ASTraceSpanInterval &)interval hitchStartTime:(uint64_t)hitchStartTime
+{
+  if (self = [super init]) {
+    _kind = interval.span;
+    _spanClass = (__bridge Class)(void *)interval.cls;
+    _name = (_spanClass != Nil ? NSStringFromClass(_spanClass) : ASTraceSpanGetName(_kind));
+    _startOffset = ASHitchSecondsFromMachTime(interval.beginTime - hitchStartTime);
+    _duration = ASHitchSecondsFromMachTime(interval.endTime - interval.beginTime);
+    _depth = interval.depth;
+  }
+  return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  return @{
+    @"name" : _name,
+    @"category" : ASTraceSpanGetName(_kind),
+    @"startOffset" : @(_startOffset),
+    @"duration" : @(_duration),
+    @"depth" : @(_depth),
+  };
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; %@ (%@), %.3fms at +%.3fms>",
+          self.class, self, _name, ASTraceSpanGetName(_kind), _duration * 1000, _startOffset * 1000];
+}
+
+@end
+
+#pragma mark - ASHitchReport
+
+@interface ASHitchReport ()
+- (instancetype)initWithStartTime:(uint64_t)startTime endTime:(uint64_t)endTime spans:(const std::vector<ASTraceSpanInterval> &)spans;
+@end
+
+@implementation ASHitchReport
+
+- (instancetype)initWithStartTime:(uint64_t)startTime endTime:(uint64_t)endTime spans:(const std::vector<ASTraceSpanInterval> &)spans
+{
+  if (self = [super init]) {
+    _startTime = ASHitchSecondsFromMachTime(startTime);
+    _duration = ASHitchSecondsFromMachTime(endTime - startTime);
+    NSMutableArray<ASHitchSpan *> *hitchSpans = [NSMutableArray arrayWithCapacity:spans.size()];
+    NSTimeInterval attributedDuration = 0;
+    for (const ASTraceSpanInterval &interval : spans) {
+      ASHitchSpan *span = [[ASHitchSpan alloc] initWithInterval:interval hitchStartTime:startTime];
+      if (span.depth == 0) {
+        attributedDuration += span.duration;
+      }
+      [hitchSpans addObject:span];
+    }
+    _spans = hitchSpans;
+    _unattributedDuration = MAX(_duration - attributedDuration, 0);
+  }
+  return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  NSMutableArray<NSDictionary *> *spans = [NSMutableArray arrayWithCapacity:_spans.count];
+  for (ASHitchSpan *span in _spans) {
+    [spans addObject:[span dictionaryRepresentation]];
+  }
+  return @{
+    @"startTime" : @(_startTime),
+    @"duration" : @(_duration),
+    @"unattributedDuration" : @(_unattributedDuration),
+    @"spans" : spans,
+  };
+}
+
+- (NSString *)description
+{
+  NSMutableString *description = [NSMutableString stringWithFormat:@"<%@: %p; duration = %.3fms, unattributed = %.3fms>",
+                                  self.class, self, _duration * 1000, _unattributedDuration * 1000];
+  for (ASHitchSpan *span in _spans) {
+    [description appendFormat:@"\n%*s%@ (%@) %.3fms at +%.3fms", (int)(span.depth + 1) * 2, "",
+     span.name, ASTraceSpanGetName(span.kind), span.duration * 1000, span.startOffset * 1000];
+  }
+  return description;
+}
+
+@end
+
+#pragma mark - ASHitchDetector
+
+@implementation ASHitchDetector {
+  CFRunLoopObserverRef _beginObserver;
+  CFRunLoopObserverRef _endObserver;
+  BOOL _inIteration;
+  uint64_t _iterationStartTime;
+  uint64_t _iterationTracePosition;
+  NSMutableArray<ASHitchReport *> *_reports;
+}
+
+- (instancetype)initWithThreshold:(NSTimeInterval)threshold
+{
+  if (self = [super init]) {
+    _threshold = threshold;
+    _reports = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [self stop];
+}
+
+- (void)start
+{
+  ASDisplayNodeAssertMainThread();
+  if (_running) {
+    return;
+  }
+  _running = YES;
+  ASTraceBufferRetainRecording();
+
+  // The detector stops observing before it is deallocated.
+  __unsafe_unretained __typeof__(self) weakSelf = self;
+  // Begin before any other observer runs, and end after all of them, including the Core Animation commit.
+  _beginObserver = CFRunLoopObserverCreateWithHandler(NULL, kCFRunLoopEntry | kCFRunLoopAfterWaiting, true, LONG_MIN, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+    [weakSelf _beginIteration];
+  });
+  _endObserver = CFRunLoopObserverCreateWithHandler(NULL, kCFRunLoopBeforeWaiting | kCFRunLoopExit, true, LONG_MAX, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+    [weakSelf _endIteration];
+    if (activity == kCFRunLoopExit) {
+      // Back in the iteration of the run loop that ran this one.
+      [weakSelf _beginIteration];
+    }
+  });
+  CFRunLoopAddObserver(CFRunLoopGetMain(), _beginObserver, kCFRunLoopCommonModes);
+  CFRunLoopAddObserver(CFRunLoopGetMain(), _endObserver, kCFRunLoopCommonModes);
+}
+
+- (void)stop
+{
+  ASDisplayNodeAssertMainThread();
+  if (!_running) {
+    return;
+  }
+  _running = NO;
+  _inIteration = NO;
+  CFRunLoopObserverInvalidate(_beginObserver);
+  CFRunLoopObserverInvalidate(_endObserver);
+  CFRelease(_beginObserver);
+  CFRelease(_endObserver);
+  _beginObserver = NULL;
+  _endObserver = NULL;
+  ASTraceBufferReleaseRecording();
+}
+
+- (NSArray<ASHitchReport *> *)reports
+{
+  ASDisplayNodeAssertMainThread();
+  return [_reports copy];
+}
+
+- (void)removeAllReports
+{
+  ASDisplayNodeAssertMainThread();
+  [_reports removeAllObjects];
+}
+
+- (void)_beginIteration
+{
+  _inIteration = YES;
+  _iterationStartTime = mach_absolute_time();
+  _iterationTracePosition = ASTraceBufferCurrentThreadPosition();
+}
+
+- (void)_endIteration
+{
+  if (!_inIteration) {
+    return;
+  }
+  _inIteration = NO;
+  uint64_t endTime = mach_absolute_time();
+  if (ASHitchSecondsFromMachTime(endTime - _iterationStartTime) <= _threshold) {
+    return;
+  }
+
+  std::vector<ASTraceSpanInterval> spans = ASTraceBufferCurrentThreadSpans(_iterationTracePosition, endTime);
+  ASHitchReport *report = [[ASHitchReport alloc] initWithStartTime:_iterationStartTime endTime:endTime spans:spans];
+  [_reports addObject:report];
+  if (_reports.count > ASHitchDetectorMaximumReportCount) {
+    [_reports removeObjectAtIndex:0];
+  }
+  if (_hitchHandler) {
+    _hitchHandler(report);
+  }
+}
+
+@end
@@ -109,6 +109,24 @@ typedef NS_ENUM(NSUInteger, ASImageDownloaderPriority) {
 
 @optional
 
+/**
+ @abstract Downloads an image with the given URL, decoding it for display at the given size.
+ @param URL The URL of the image to download.
+ @param targetPixelSize The size in pixels the image will be displayed at, or CGSizeZero to decode at full size. The
+ downloader may decode a smaller image as long as it still covers this size.
+ @param callbackQueue The queue to call `downloadProgressBlock` and `completion` on.
+ @param downloadProgress The block to be invoked when the download of `URL` progresses.
+ @param completion The block to be invoked when the download has completed, or has failed.
+ @discussion If implemented, this method is called instead of `downloadImageWithURL:callbackQueue:downloadProgress:completion:`.
+ @result An opaque identifier to be used in canceling the download, via `cancelImageDownloadForIdentifier:`. You must
+ retain the identifier if you wish to use it later.
+ */
+- (nullable id)downloadImageWithURL:(NSURL *)URL
+                    targetPixelSize:(CGSize)targetPixelSize
+                      callbackQueue:(dispatch_queue_t)callbackQueue
+                   downloadProgress:(nullable ASImageDownloaderProgress)downloadProgress
+                         completion:(ASImageDownloaderCompletion)completion;
+
 /**
  @abstract Cancels an image download, however indicating resume data should be stored in case of redownload.
  @param downloadIdentifier The opaque download identifier object returned from
@@ -206,6 +224,8 @@ withDownloadIdentifier:(id)downloadIdentifier;
 
 /**
  @abstract Return the image at a given index.
+ @discussion Called from a background queue to predecode frames ahead of playback, as well as from the main thread.
+ Return NULL if the frame isn't available yet.
  */
 - (CGImageRef)imageAtIndex:(NSUInteger)index;
 /**
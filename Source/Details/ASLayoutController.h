@@ -40,6 +40,18 @@ ASDISPLAYNODE_EXTERN_C_END
 
 @optional
 
+/**
+ * Like -elementsForScrolling:rangeMode:rangeType:map:, but with explicit tuning parameters in place of the ones stored
+ * for a range mode. Used to apply an adaptive range policy.
+ */
+- (NSSet<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection tuningParameters:(ASRangeTuningParameters)tuningParameters map:(ASElementMap *)map;
+
+/**
+ * Like -allElementsForScrolling:rangeMode:displaySet:preloadSet:map:, but with explicit tuning parameters in place of
+ * the ones stored for a range mode.
+ */
+- (void)allElementsForScrolling:(ASScrollDirection)scrollDirection displayTuningParameters:(ASRangeTuningParameters)displayTuningParameters preloadTuningParameters:(ASRangeTuningParameters)preloadTuningParameters displaySet:(NSSet<ASCollectionElement *> * _Nullable * _Nullable)displaySet preloadSet:(NSSet<ASCollectionElement *> * _Nullable * _Nullable)preloadSet map:(ASElementMap *)map;
+
 @end
 
 NS_ASSUME_NONNULL_END
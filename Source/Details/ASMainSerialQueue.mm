@@ -13,6 +13,7 @@
 #import <AsyncDisplayKit/ASMainSerialQueue.h>
 
 #import <AsyncDisplayKit/ASThread.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 
 @interface ASMainSerialQueue ()
@@ -48,6 +49,7 @@
 - (void)runBlocks
 {
   dispatch_block_t mainThread = ^{
+    ASDN::TraceScope traceScope(ASTraceSpanMainSerialQueueDrain, Nil);
     do {
       ASDN::MutexLocker l(_serialQueueLock);
       dispatch_block_t block;
@@ -0,0 +1,129 @@
+//
+//  ASMemoryAccounting.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASDisplayNode.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * What the framework holds memory for.
+ */
+typedef NS_ENUM(NSInteger, ASMemoryCategory) {
+  /// Bitmaps of node contents: the contents of loaded layers and the pending contents of unloaded nodes.
+  ASMemoryCategoryBackingStore,
+  /// Source images held by image nodes. Images shared by several nodes are counted for each of them.
+  ASMemoryCategoryImage,
+  /// Pending view and layer properties, which nodes hold until their view or layer is loaded and range-managed nodes drop after.
+  ASMemoryCategoryPendingState,
+  /// The elements of the element maps of table and collection views.
+  ASMemoryCategoryElementMap,
+  /// Decoded images in the ASImageNode contents cache. The cache only keeps the contents image nodes retain, so these
+  /// are bitmaps already counted as their backing stores, and snapshots leave them out of the total.
+  ASMemoryCategoryImageContentsCache,
+  /// TextKit renderers in the ASTextNode renderer cache.
+  ASMemoryCategoryTextRendererCache,
+  /// Bitmaps in the rasterized text cache.
+  ASMemoryCategoryRasterizedTextCache,
+};
+
+/**
+ * Returns a short name for the category, like "backingStore".
+ */
+ASDISPLAYNODE_EXTERN_C_BEGIN
+NSString *ASMemoryCategoryGetName(ASMemoryCategory category);
+ASDISPLAYNODE_EXTERN_C_END
+
+/**
+ * Estimated bytes held by one owner, by category.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASMemoryUsage : NSObject
+
+/// What holds the memory, like the data source class of a table view, or "caches".
+@property (nonatomic, copy, readonly) NSString *name;
+
+@property (nonatomic, readonly) NSUInteger totalBytes;
+
+- (NSUInteger)bytesForCategory:(ASMemoryCategory)category AS_WARN_UNUSED_RESULT;
+
+/**
+ * The usage as JSON-compatible objects: {"name": ..., "totalBytes": ..., "categories": {"backingStore": ..., ...}}.
+ */
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+/**
+ * A snapshot of the memory held by the framework.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASMemorySnapshot : NSObject
+
+/// The shared caches and all range controllers.
+@property (nonatomic, strong, readonly) ASMemoryUsage *totalUsage;
+
+/// The shared caches of image nodes and text nodes.
+@property (nonatomic, strong, readonly) ASMemoryUsage *cacheUsage;
+
+/// The usage of each live range controller, that is of each table and collection view, by descending total bytes.
+@property (nonatomic, copy, readonly) NSArray<ASMemoryUsage *> *rangeControllerUsages;
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+/**
+ * @abstract Estimates of the memory the framework holds.
+ *
+ * @discussion Nodes report the bitmaps and pending state they hold, and the shared caches report their contents.
+ * Range controllers add up their element maps and their allocated cell nodes, including subnodes, so the biggest
+ * consumers can be found. Taking a snapshot walks every allocated cell node, so it is meant for diagnostics rather
+ * than for reacting to memory warnings.
+ *
+ * Bitmaps are counted by their bytes per row and height; other objects by their instance sizes and by per-character
+ * estimates for text. The numbers are estimates for comparing consumers, not exact heap sizes. Nodes outside table
+ * and collection views are only counted when asked for directly.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASMemoryAccounting : NSObject
+
+/**
+ * Returns the memory held by the shared caches and all range controllers. Must be called on the main thread, as it
+ * reads the contents of loaded layers.
+ */
++ (ASMemorySnapshot *)snapshot AS_WARN_UNUSED_RESULT;
+
+/**
+ * Returns the memory held by the shared caches. Can be called on any thread.
+ */
++ (ASMemoryUsage *)cacheUsage AS_WARN_UNUSED_RESULT;
+
+@end
+
+@interface ASDisplayNode (ASMemoryAccounting)
+
+/**
+ * Returns the estimated bytes the node itself holds in the category, not counting its subnodes.
+ *
+ * @discussion Subclasses that hold memory of their own override this method and add to what super returns.
+ * Must be called on the main thread if the node is loaded.
+ */
+- (NSUInteger)estimatedBytesForMemoryCategory:(ASMemoryCategory)category AS_WARN_UNUSED_RESULT;
+
+/**
+ * Returns the estimated memory held by the node and all of its subnodes.
+ */
+- (ASMemoryUsage *)estimatedMemoryUsage AS_WARN_UNUSED_RESULT;
+
+@end
+
+NS_ASSUME_NONNULL_END
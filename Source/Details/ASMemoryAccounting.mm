@@ -0,0 +1,228 @@
+//
+//  ASMemoryAccounting.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASMemoryAccountingInternal.h>
+
+#import <objc/runtime.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkSubclasses.h>
+#import <AsyncDisplayKit/ASDisplayNodeExtras.h>
+#import <AsyncDisplayKit/ASDisplayNodeInternal.h>
+#import <AsyncDisplayKit/ASRangeController.h>
+#import <AsyncDisplayKit/ASTextKitRasterCache.h>
+#import <AsyncDisplayKit/_ASPendingState.h>
+
+static const NSUInteger ASMemoryCategoryCount = ASMemoryCategoryRasterizedTextCache + 1;
+
+NSString *ASMemoryCategoryGetName(ASMemoryCategory category)
+{
+  switch (category) {
+    case ASMemoryCategoryBackingStore:
+      return @"backingStore";
+    case ASMemoryCategoryImage:
+      return @"image";
+    case ASMemoryCategoryPendingState:
+      return @"pendingState";
+    case ASMemoryCategoryElementMap:
+      return @"elementMap";
+    case ASMemoryCategoryImageContentsCache:
+      return @"imageContentsCache";
+    case ASMemoryCategoryTextRendererCache:
+      return @"textRendererCache";
+    case ASMemoryCategoryRasterizedTextCache:
+      return @"rasterizedTextCache";
+  }
+  return @"unknown";
+}
+
+NSUInteger ASMemoryEstimatedBytesOfContents(id contents)
+{
+  if (contents == nil) {
+    return 0;
+  }
+  if ([contents isKindOfClass:[UIImage class]]) {
+    UIImage *image = contents;
+    if (image.CGImage == NULL) {
+      // Not backed by a bitmap yet, e.g. a CIImage: assume it will be drawn into one of four bytes per pixel.
+      return (NSUInteger)(image.size.width * image.scale * image.size.height * image.scale * 4);
+    }
+    contents = (__bridge id)image.CGImage;
+  }
+  if (CFGetTypeID((__bridge CFTypeRef)contents) != CGImageGetTypeID()) {
+    return 0;
+  }
+  CGImageRef image = (__bridge CGImageRef)contents;
+  return CGImageGetBytesPerRow(image) * CGImageGetHeight(image);
+}
+
+#pragma mark - ASMemoryUsage
+
+@implementation ASMemoryUsage {
+  NSUInteger _bytes[ASMemoryCategoryCount];
+}
+
+- (instancetype)initWithName:(NSString *)name
+{
+  if (self = [super init]) {
+    _name = [name copy];
+  }
+  return self;
+}
+
+- (void)addBytes:(NSUInteger)bytes forCategory:(ASMemoryCategory)category
+{
+  ASDisplayNodeAssert(category >= 0 && category < ASMemoryCategoryCount, @"Invalid memory category %zd", category);
+  _bytes[category] += bytes;
+  _totalBytes += bytes;
+}
+
+- (void)addUsage:(ASMemoryUsage *)usage
+{
+  for (NSUInteger category = 0; category < ASMemoryCategoryCount; category++) {
+    [self addBytes:usage->_bytes[category] forCategory:(ASMemoryCategory)category];
+  }
+}
+
+- (NSUInteger)bytesForCategory:(ASMemoryCategory)category
+{
+  if (category < 0 || category >= ASMemoryCategoryCount) {
+    return 0;
+  }
+  return _bytes[category];
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  NSMutableDictionary<NSString *, NSNumber *> *categories = [NSMutableDictionary dictionaryWithCapacity:ASMemoryCategoryCount];
+  for (NSUInteger category = 0; category < ASMemoryCategoryCount; category++) {
+    categories[ASMemoryCategoryGetName((ASMemoryCategory)category)] = @(_bytes[category]);
+  }
+  return @{
+    @"name" : _name,
+    @"totalBytes" : @(_totalBytes),
+    @"categories" : categories,
+  };
+}
+
+- (NSString *)description
+{
+  NSMutableString *description = [NSMutableString stringWithFormat:@"<%@: %p; %@, %.1fKB", self.class, self, _name, _totalBytes / 1024.0];
+  for (NSUInteger category = 0; category < ASMemoryCategoryCount; category++) {
+    if (_bytes[category] > 0) {
+      [description appendFormat:@", %@ = %.1fKB", ASMemoryCategoryGetName((ASMemoryCategory)category), _bytes[category] / 1024.0];
+    }
+  }
+  [description appendString:@">"];
+  return description;
+}
+
+@end
+
+#pragma mark - ASMemorySnapshot
+
+@interface ASMemorySnapshot ()
+- (instancetype)initWithCacheUsage:(ASMemoryUsage *)cacheUsage rangeControllerUsages:(NSArray<ASMemoryUsage *> *)rangeControllerUsages;
+@end
+
+@implementation ASMemorySnapshot
+
+- (instancetype)initWithCacheUsage:(ASMemoryUsage *)cacheUsage rangeControllerUsages:(NSArray<ASMemoryUsage *> *)rangeControllerUsages
+{
+  if (self = [super init]) {
+    _cacheUsage = cacheUsage;
+    _rangeControllerUsages = [rangeControllerUsages copy];
+    _totalUsage = [[ASMemoryUsage alloc] initWithName:@"total"];
+    for (NSUInteger category = 0; category < ASMemoryCategoryCount; category++) {
+      if (category != ASMemoryCategoryImageContentsCache) {
+        [_totalUsage addBytes:[cacheUsage bytesForCategory:(ASMemoryCategory)category] forCategory:(ASMemoryCategory)category];
+      }
+    }
+    for (ASMemoryUsage *usage in rangeControllerUsages) {
+      [_totalUsage addUsage:usage];
+    }
+  }
+  return self;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  NSMutableArray<NSDictionary *> *rangeControllerUsages = [NSMutableArray arrayWithCapacity:_rangeControllerUsages.count];
+  for (ASMemoryUsage *usage in _rangeControllerUsages) {
+    [rangeControllerUsages addObject:[usage dictionaryRepresentation]];
+  }
+  return @{
+    @"total" : [_totalUsage dictionaryRepresentation],
+    @"caches" : [_cacheUsage dictionaryRepresentation],
+    @"rangeControllers" : rangeControllerUsages,
+  };
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; total = %@, caches = %@, rangeControllers = %@>",
+          self.class, self, _totalUsage, _cacheUsage, _rangeControllerUsages];
+}
+
+@end
+
+#pragma mark - ASMemoryAccounting
+
+@implementation ASMemoryAccounting
+
++ (ASMemorySnapshot *)snapshot
+{
+  ASDisplayNodeAssertMainThread();
+  return [[ASMemorySnapshot alloc] initWithCacheUsage:[self cacheUsage]
+                                rangeControllerUsages:[ASRangeController rangeControllerUsagesByDescendingBytes]];
+}
+
++ (ASMemoryUsage *)cacheUsage
+{
+  ASMemoryUsage *usage = [[ASMemoryUsage alloc] initWithName:@"caches"];
+  [usage addBytes:ASImageNodeContentsCacheEstimatedBytes() forCategory:ASMemoryCategoryImageContentsCache];
+  [usage addBytes:ASTextNodeRendererCacheEstimatedBytes() forCategory:ASMemoryCategoryTextRendererCache];
+  [usage addBytes:[ASTextKitRasterCache sharedCache].metrics.byteCount forCategory:ASMemoryCategoryRasterizedTextCache];
+  return usage;
+}
+
+@end
+
+#pragma mark - ASDisplayNode
+
+@implementation ASDisplayNode (ASMemoryAccounting)
+
+- (NSUInteger)estimatedBytesForMemoryCategory:(ASMemoryCategory)category
+{
+  switch (category) {
+    case ASMemoryCategoryBackingStore:
+      // Reads the layer's contents when loaded, and the pending contents otherwise.
+      return ASMemoryEstimatedBytesOfContents(self.contents);
+    case ASMemoryCategoryPendingState: {
+      ASDN::MutexLocker l(__instanceLock__);
+      return (_pendingViewState != nil ? class_getInstanceSize([_ASPendingState class]) : 0);
+    }
+    default:
+      return 0;
+  }
+}
+
+- (ASMemoryUsage *)estimatedMemoryUsage
+{
+  ASMemoryUsage *usage = [[ASMemoryUsage alloc] initWithName:NSStringFromClass(self.class)];
+  ASDisplayNodePerformBlockOnEveryNode(nil, self, NO, ^(ASDisplayNode *node) {
+    for (NSUInteger category = 0; category < ASMemoryCategoryCount; category++) {
+      [usage addBytes:[node estimatedBytesForMemoryCategory:(ASMemoryCategory)category] forCategory:(ASMemoryCategory)category];
+    }
+  });
+  return usage;
+}
+
+@end
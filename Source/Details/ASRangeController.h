@@ -21,10 +21,24 @@
 NS_ASSUME_NONNULL_BEGIN
 
 @class _ASHierarchyChangeSet;
+@class ASAdaptiveRangePolicy;
+@class ASMemoryUsage;
 @protocol ASRangeControllerDataSource;
 @protocol ASRangeControllerDelegate;
 @protocol ASLayoutController;
 
+/**
+ * Counters for @c ASRangeController.
+ */
+typedef struct {
+  /// Range updates performed.
+  NSUInteger updateCount;
+  /// Items whose interface state was computed, across all updates.
+  NSUInteger visitedItemCount;
+  /// Items whose node's interface state was changed, across all updates.
+  NSUInteger modifiedItemCount;
+} ASRangeControllerMetrics;
+
 /**
  * Working range controller.
  *
@@ -93,6 +107,35 @@ AS_SUBCLASSING_RESTRICTED
  */
 @property (nonatomic, weak) id<ASRangeControllerDelegate> delegate;
 
+/**
+ * A policy that scales the display and preload ranges of the full range mode with scroll speed and measured latency.
+ * Defaults to nil, which uses the tuning parameters of the layout controller unchanged.
+ *
+ * The range controller records display latencies into the policy, and asks its data source for the scroll speed.
+ */
+@property (nonatomic, strong, nullable) ASAdaptiveRangePolicy *adaptiveRangePolicy;
+
+/**
+ * Nodes leaving the display and preload ranges are updated over the following run loop turns, a few at a time.
+ * This applies those updates right away.
+ */
+- (void)flushDeferredInterfaceStates;
+
+- (ASRangeControllerMetrics)metrics;
+
+- (void)resetMetrics;
+
+/**
+ * Returns the estimated memory held by the elements of the element map and by the allocated cell nodes, including
+ * their subnodes. Named by the data source. Must be called on the main thread.
+ */
+- (ASMemoryUsage *)estimatedMemoryUsage;
+
+/**
+ * Returns the estimated memory usages of all live range controllers, by descending total bytes.
+ */
++ (NSArray<ASMemoryUsage *> *)rangeControllerUsagesByDescendingBytes;
+
 @end
 
 
@@ -131,6 +174,16 @@ AS_SUBCLASSING_RESTRICTED
 
 - (NSString *)nameForRangeControllerDataSource;
 
+@optional
+
+/**
+ * @param rangeController Sender.
+ *
+ * @return the current scroll speed along the scrollable axis, in screenfuls per second. Only used with an
+ * adaptive range policy; the speed is assumed to be zero if this isn't implemented.
+ */
+- (CGFloat)scrollSpeedForRangeController:(ASRangeController *)rangeController;
+
 @end
 
 /**
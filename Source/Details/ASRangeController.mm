@@ -10,36 +10,125 @@
 
 #import <AsyncDisplayKit/ASRangeController.h>
 
+#import <objc/runtime.h>
+
 #import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
+#import <AsyncDisplayKit/ASAdaptiveRangePolicy.h>
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASCellNode+Internal.h>
 #import <AsyncDisplayKit/ASCollectionElement.h>
 #import <AsyncDisplayKit/ASDisplayNodeExtras.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h> // Required for interfaceState and hierarchyState setter methods.
 #import <AsyncDisplayKit/ASElementMap.h>
+#import <AsyncDisplayKit/ASInterfaceStateBatch.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASMemoryAccountingInternal.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
 #import <AsyncDisplayKit/ASTwoDimensionalArrayUtils.h>
 #import <AsyncDisplayKit/ASWeakSet.h>
 
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import <AsyncDisplayKit/AsyncDisplayKit+Debug.h>
 
+#include <algorithm>
+#include <vector>
+
 #define AS_RANGECONTROLLER_LOG_UPDATE_FREQ 0
 
 #ifndef ASRangeControllerAutomaticLowMemoryHandling
 #define ASRangeControllerAutomaticLowMemoryHandling 1
 #endif
 
+#pragma mark - Item Index Helpers
+
+// Items are numbered in element map order, so that ranges can be stored and diffed as sorted intervals.
+struct ASRangeSectionOffsets {
+  // The index of the first item of each section.
+  std::vector<NSInteger> offsets;
+  NSUInteger itemCount = 0;
+};
+
+static void ASRangeSectionOffsetsForMap(ASElementMap *map, ASRangeSectionOffsets &sectionOffsets)
+{
+  NSInteger numberOfSections = map.numberOfSections;
+  sectionOffsets.offsets.resize(numberOfSections);
+  NSInteger itemCount = 0;
+  for (NSInteger section = 0; section < numberOfSections; section++) {
+    sectionOffsets.offsets[section] = itemCount;
+    itemCount += [map numberOfItemsInSection:section];
+  }
+  sectionOffsets.itemCount = itemCount;
+}
+
+static NSIndexSet *ASRangeIndexesForElements(id<NSFastEnumeration> elements, ASElementMap *map, const ASRangeSectionOffsets &sectionOffsets)
+{
+  NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+  for (ASCollectionElement *element in elements) {
+    NSIndexPath *indexPath = [map indexPathForElementIfCell:element];
+    if (indexPath != nil) {
+      [indexes addIndex:sectionOffsets.offsets[indexPath.section] + indexPath.item];
+    }
+  }
+  return indexes;
+}
+
+static NSIndexPath *ASRangeIndexPathForIndex(NSUInteger index, const ASRangeSectionOffsets &sectionOffsets)
+{
+  // The last section starting at or before the index. Empty sections share their offset with the next section.
+  const std::vector<NSInteger> &offsets = sectionOffsets.offsets;
+  NSInteger section = (std::upper_bound(offsets.begin(), offsets.end(), (NSInteger)index) - offsets.begin()) - 1;
+  return [NSIndexPath indexPathForItem:(index - offsets[section]) inSection:section];
+}
+
+// Both of these cost time proportional to the number of intervals, not the number of items.
+static NSIndexSet *ASRangeIntersection(NSIndexSet *lhs, NSIndexSet *rhs)
+{
+  NSMutableIndexSet *intersection = [NSMutableIndexSet indexSet];
+  [rhs enumerateRangesUsingBlock:^(NSRange range, BOOL *stop) {
+    [lhs enumerateRangesInRange:range options:kNilOptions usingBlock:^(NSRange overlap, BOOL *innerStop) {
+      [intersection addIndexesInRange:overlap];
+    }];
+  }];
+  return intersection;
+}
+
+static NSMutableIndexSet *ASRangeSymmetricDifference(NSIndexSet *lhs, NSIndexSet *rhs)
+{
+  NSMutableIndexSet *difference = [lhs mutableCopy];
+  if (rhs != nil) {
+    [difference addIndexes:rhs];
+    [difference removeIndexes:ASRangeIntersection(lhs, rhs)];
+  }
+  return difference;
+}
+
 @interface ASRangeController ()
 {
   BOOL _rangeIsValid;
   BOOL _needsRangeUpdate;
-  NSSet<NSIndexPath *> *_allPreviousIndexPaths;
+  // The ranges applied in the last update, as indexes of items in _previousMap, with the state they were applied in.
+  ASElementMap *_previousMap;
+  NSIndexSet *_previousVisibleIndexes;
+  NSIndexSet *_previousDisplayIndexes;
+  NSIndexSet *_previousPreloadIndexes;
+  BOOL _previousSelfIsVisible;
+  BOOL _previousRangeModeIsLowMemory;
+  // Set when interface states were changed behind our back, so every item in range must be visited again.
+  BOOL _needsFullRangeVisit;
+  // Items in range whose nodes weren't allocated when last visited.
+  NSIndexSet *_unallocatedIndexes;
+  ASRangeSectionOffsets _sectionOffsets;
+  ASRangeControllerMetrics _metrics;
+  ASInterfaceStateBatch *_interfaceStateBatch;
   ASWeakSet<ASCellNode *> *_visibleNodes;
   ASLayoutRangeMode _currentRangeMode;
   BOOL _preserveCurrentRangeMode;
   BOOL _didRegisterForNodeDisplayNotifications;
   CFTimeInterval _pendingDisplayNodesTimestamp;
+  // When the oldest display scheduled since the rendering engine last drained its queue was scheduled,
+  // or 0 if there is none. Only tracked with an adaptive range policy.
+  CFTimeInterval _adaptiveRangeDisplayScheduledTimestamp;
+  id _adaptiveRangeDisplayObserver;
 
   // If the user is not currently scrolling, we will keep our ranges
   // configured to match their previous scroll direction. Defaults
@@ -71,6 +160,11 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   _currentRangeMode = ASLayoutRangeModeUnspecified;
   _preserveCurrentRangeMode = NO;
   _previousScrollDirection = ASScrollDirectionDown | ASScrollDirectionRight;
+  _previousVisibleIndexes = [NSIndexSet indexSet];
+  _previousDisplayIndexes = [NSIndexSet indexSet];
+  _previousPreloadIndexes = [NSIndexSet indexSet];
+  _unallocatedIndexes = [NSIndexSet indexSet];
+  _interfaceStateBatch = [[ASInterfaceStateBatch alloc] init];
   
   [[[self class] allRangeControllersWeakSet] addObject:self];
   
@@ -95,6 +189,13 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   if (_didRegisterForNodeDisplayNotifications) {
     [[NSNotificationCenter defaultCenter] removeObserver:self name:ASRenderingEngineDidDisplayScheduledNodesNotification object:nil];
   }
+  if (_adaptiveRangeDisplayObserver != nil) {
+    [[NSNotificationCenter defaultCenter] removeObserver:_adaptiveRangeDisplayObserver];
+  }
+  if (ASDisplayNodeThreadIsMain()) {
+    // Nodes that were leaving a range should still hear about it.
+    [_interfaceStateBatch flushDeferredInterfaceStates];
+  }
 }
 
 #pragma mark - Core visible node range management API
@@ -176,6 +277,35 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   }
 }
 
+- (void)setAdaptiveRangePolicy:(ASAdaptiveRangePolicy *)adaptiveRangePolicy
+{
+  ASDisplayNodeAssertMainThread();
+  if (_adaptiveRangePolicy == adaptiveRangePolicy) {
+    return;
+  }
+
+  _adaptiveRangePolicy = adaptiveRangePolicy;
+  _adaptiveRangeDisplayScheduledTimestamp = 0;
+
+  // Observed separately from the range mode transition in -registerForNodeDisplayNotificationsForInterfaceStateIfNeeded:,
+  // which comes and goes on its own schedule.
+  NSNotificationCenter *center = [NSNotificationCenter defaultCenter];
+  if (adaptiveRangePolicy != nil && _adaptiveRangeDisplayObserver == nil) {
+    __weak __typeof__(self) weakSelf = self;
+    _adaptiveRangeDisplayObserver = [center addObserverForName:ASRenderingEngineDidDisplayScheduledNodesNotification
+                                                        object:nil
+                                                         queue:nil
+                                                    usingBlock:^(NSNotification * _Nonnull notification) {
+      [weakSelf scheduledNodesDidDisplayForAdaptiveRangePolicy:notification];
+    }];
+  } else if (adaptiveRangePolicy == nil && _adaptiveRangeDisplayObserver != nil) {
+    [center removeObserver:_adaptiveRangeDisplayObserver];
+    _adaptiveRangeDisplayObserver = nil;
+  }
+
+  [self setNeedsUpdate];
+}
+
 // Clear the visible bit from any nodes that disappeared since last update.
 // Currently we guarantee that nodes will not be marked visible when deallocated,
 // but it's OK to be in e.g. the preload range. So for the visible bit specifically,
@@ -217,6 +347,7 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
     return; // don't do anything for this update, but leave _rangeIsValid == NO to make sure we update it later
   }
   ASProfilingSignpostStart(1, self);
+  ASDN::TraceScope traceScope(ASTraceSpanRangeUpdate, Nil);
 
   // Get the scroll direction. Default to using the previous one, if they're not scrolling.
   ASScrollDirection scrollDirection = [_dataSource scrollDirectionForRangeController:self];
@@ -238,6 +369,31 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   ASRangeTuningParameters parametersDisplay = [_layoutController tuningParametersForRangeMode:rangeMode
                                                                                     rangeType:ASLayoutRangeTypeDisplay];
 
+  // The adaptive range policy only applies to the full range mode; the other modes exist to limit work.
+  BOOL adaptsRanges = (_adaptiveRangePolicy != nil && rangeMode == ASLayoutRangeModeFull
+                       && [_layoutController respondsToSelector:@selector(elementsForScrolling:tuningParameters:map:)]
+                       && [_layoutController respondsToSelector:@selector(allElementsForScrolling:displayTuningParameters:preloadTuningParameters:displaySet:preloadSet:map:)]);
+  if (adaptsRanges) {
+    CGFloat scrollSpeed = 0;
+    if ([_dataSource respondsToSelector:@selector(scrollSpeedForRangeController:)]) {
+      scrollSpeed = [_dataSource scrollSpeedForRangeController:self];
+    }
+    CFTimeInterval timestamp = CACurrentMediaTime();
+    parametersPreload = [_adaptiveRangePolicy tuningParametersForRangeType:ASLayoutRangeTypePreload
+                                                    staticTuningParameters:parametersPreload
+                                                               scrollSpeed:scrollSpeed
+                                                                 timestamp:timestamp];
+    parametersDisplay = [_adaptiveRangePolicy tuningParametersForRangeType:ASLayoutRangeTypeDisplay
+                                                    staticTuningParameters:parametersDisplay
+                                                               scrollSpeed:scrollSpeed
+                                                                 timestamp:timestamp];
+#if ASRangeControllerLoggingEnabled
+    NSLog(@"Adapted ranges for scroll speed %.2f: display %.2f/%.2f, preload %.2f/%.2f", scrollSpeed,
+          parametersDisplay.leadingBufferScreenfuls, parametersDisplay.trailingBufferScreenfuls,
+          parametersPreload.leadingBufferScreenfuls, parametersPreload.trailingBufferScreenfuls);
+#endif
+  }
+
   // Preload can express the ultra-low-memory state with 0, 0 returned for its tuningParameters above, and will match Visible.
   // However, in this rangeMode, Display is not supposed to contain *any* paths -- not even the visible bounds. TuningParameters can't express this.
   BOOL emptyDisplayRange = (rangeMode == ASLayoutRangeModeLowMemory);
@@ -251,7 +407,14 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   NSSet<ASCollectionElement *> *displayElements = nil;
   NSSet<ASCollectionElement *> *preloadElements = nil;
   
-  if (optimizedLoadingOfBothRanges) {
+  if (optimizedLoadingOfBothRanges && adaptsRanges) {
+    [_layoutController allElementsForScrolling:scrollDirection
+                       displayTuningParameters:parametersDisplay
+                       preloadTuningParameters:parametersPreload
+                                    displaySet:&displayElements
+                                    preloadSet:&preloadElements
+                                           map:map];
+  } else if (optimizedLoadingOfBothRanges) {
     [_layoutController allElementsForScrolling:scrollDirection rangeMode:rangeMode displaySet:&displayElements preloadSet:&preloadElements map:map];
   } else {
     if (emptyDisplayRange == YES) {
@@ -260,7 +423,9 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
       displayElements = visibleElements;
     } else {
       // Calculating only the Display range means the Preload range is either the same as Display or Visible.
-      displayElements = [_layoutController elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay map:map];
+      displayElements = (adaptsRanges
+                         ? [_layoutController elementsForScrolling:scrollDirection tuningParameters:parametersDisplay map:map]
+                         : [_layoutController elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay map:map]);
     }
     
     BOOL equalPreloadVisible = ASRangeTuningParametersEqualToRangeTuningParameters(parametersPreload, ASRangeTuningParametersZero);
@@ -269,106 +434,160 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
     } else if (equalPreloadVisible == YES) {
       preloadElements = visibleElements;
     } else {
-      preloadElements = [_layoutController elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypePreload map:map];
+      preloadElements = (adaptsRanges
+                         ? [_layoutController elementsForScrolling:scrollDirection tuningParameters:parametersPreload map:map]
+                         : [_layoutController elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypePreload map:map]);
     }
   }
   
-  // For now we are only interested in items. Filter-map out from element to item-index-path.
-  NSSet<NSIndexPath *> *visibleIndexPaths = ASSetByFlatMapping(visibleElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-  NSSet<NSIndexPath *> *displayIndexPaths = ASSetByFlatMapping(displayElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-  NSSet<NSIndexPath *> *preloadIndexPaths = ASSetByFlatMapping(preloadElements, ASCollectionElement *element, [map indexPathForElementIfCell:element]);
-
-  // Prioritize the order in which we visit each.  Visible nodes should be updated first so they are enqueued on
-  // the network or display queues before preloading (offscreen) nodes are enqueued.
-  NSMutableOrderedSet<NSIndexPath *> *allIndexPaths = [[NSMutableOrderedSet alloc] initWithSet:visibleIndexPaths];
-  
-  // Typically the preloadIndexPaths will be the largest, and be a superset of the others, though it may be disjoint.
-  // Because allIndexPaths is an NSMutableOrderedSet, this adds the non-duplicate items /after/ the existing items.
-  // This means that during iteration, we will first visit visible, then display, then preload nodes.
-  [allIndexPaths unionSet:displayIndexPaths];
-  [allIndexPaths unionSet:preloadIndexPaths];
-  
-  // Add anything we had applied interfaceState to in the last update, but is no longer in range, so we can clear any
-  // range flags it still has enabled.  Most of the time, all but a few elements are equal; a large programmatic
-  // scroll or major main thread stall could cause entirely disjoint sets.  In either case we must visit all.
-  // Calling "-set" on NSMutableOrderedSet just references the underlying mutable data store, so we must copy it.
-  NSSet<NSIndexPath *> *allCurrentIndexPaths = [[allIndexPaths set] copy];
-  [allIndexPaths unionSet:_allPreviousIndexPaths];
-  _allPreviousIndexPaths = allCurrentIndexPaths;
+  // For now we are only interested in items. Ranges are kept as sorted intervals of item indexes, in element map order.
+  if (map != _previousMap) {
+    ASRangeSectionOffsetsForMap(map, _sectionOffsets);
+  }
+  NSIndexSet *visibleIndexes = ASRangeIndexesForElements(visibleElements, map, _sectionOffsets);
+  NSIndexSet *displayIndexes = (displayElements == visibleElements ? visibleIndexes : ASRangeIndexesForElements(displayElements, map, _sectionOffsets));
+  NSIndexSet *preloadIndexes = (preloadElements == displayElements ? displayIndexes
+                                : (preloadElements == visibleElements ? visibleIndexes : ASRangeIndexesForElements(preloadElements, map, _sectionOffsets)));
+
+  NSMutableIndexSet *currentIndexes = [visibleIndexes mutableCopy];
+  [currentIndexes addIndexes:displayIndexes];
+  [currentIndexes addIndexes:preloadIndexes];
+
+  BOOL selfIsVisible = ASInterfaceStateIncludesVisible(selfInterfaceState);
+  BOOL isLowMemory = (rangeMode == ASLayoutRangeModeLowMemory);
+
+  // Only visit the items whose membership in a range changed since the last update, unless something changed that
+  // affects the interface state of every item in range. Most of the time, all but a few items are the same; a large
+  // programmatic scroll or major main thread stall could cause entirely disjoint ranges.
+  NSMutableIndexSet *changedIndexes;
+  if (!_rangeIsValid || map != _previousMap) {
+    changedIndexes = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, _sectionOffsets.itemCount)];
+  } else if (_needsFullRangeVisit || selfIsVisible != _previousSelfIsVisible || isLowMemory != _previousRangeModeIsLowMemory) {
+    changedIndexes = [currentIndexes mutableCopy];
+    [changedIndexes addIndexes:_previousVisibleIndexes];
+    [changedIndexes addIndexes:_previousDisplayIndexes];
+    [changedIndexes addIndexes:_previousPreloadIndexes];
+  } else {
+    changedIndexes = ASRangeSymmetricDifference(visibleIndexes, _previousVisibleIndexes);
+    [changedIndexes addIndexes:ASRangeSymmetricDifference(displayIndexes, _previousDisplayIndexes)];
+    [changedIndexes addIndexes:ASRangeSymmetricDifference(preloadIndexes, _previousPreloadIndexes)];
+    // Items in range whose nodes hadn't been allocated yet at the last visit.
+    [changedIndexes addIndexes:_unallocatedIndexes];
+  }
+
+  _previousMap = map;
+  _previousVisibleIndexes = visibleIndexes;
+  _previousDisplayIndexes = displayIndexes;
+  _previousPreloadIndexes = preloadIndexes;
+  _previousSelfIsVisible = selfIsVisible;
+  _previousRangeModeIsLowMemory = isLowMemory;
+  _needsFullRangeVisit = NO;
   
   _currentRangeMode = rangeMode;
   _preserveCurrentRangeMode = NO;
   
-  if (!_rangeIsValid) {
-    [allIndexPaths addObjectsFromArray:map.itemIndexPaths];
-  }
-  
 #if ASRangeControllerLoggingEnabled
-  ASDisplayNodeAssertTrue([visibleIndexPaths isSubsetOfSet:displayIndexPaths]);
+  ASDisplayNodeAssertTrue([displayIndexes containsIndexes:visibleIndexes]);
   NSMutableArray<NSIndexPath *> *modifiedIndexPaths = (ASRangeControllerLoggingEnabled ? [NSMutableArray array] : nil);
 #endif
 
-  for (NSIndexPath *indexPath in allIndexPaths) {
-    // Before a node / indexPath is exposed to ASRangeController, ASDataController should have already measured it.
-    // For consistency, make sure each node knows that it should measure itself if something changes.
-    ASInterfaceState interfaceState = ASInterfaceStateMeasureLayout;
-    
-    if (ASInterfaceStateIncludesVisible(selfInterfaceState)) {
-      if ([visibleIndexPaths containsObject:indexPath]) {
-        interfaceState |= (ASInterfaceStateVisible | ASInterfaceStateDisplay | ASInterfaceStatePreload);
+  // Prioritize the order in which we visit each.  Visible nodes should be updated first so they are enqueued on
+  // the network or display queues before preloading (offscreen) nodes are enqueued.
+  NSIndexSet *changedVisibleIndexes = ASRangeIntersection(changedIndexes, visibleIndexes);
+  [changedIndexes removeIndexes:changedVisibleIndexes];
+  NSIndexSet *changedDisplayIndexes = ASRangeIntersection(changedIndexes, displayIndexes);
+  [changedIndexes removeIndexes:changedDisplayIndexes];
+
+  _metrics.updateCount += 1;
+  _metrics.visitedItemCount += changedVisibleIndexes.count + changedDisplayIndexes.count + changedIndexes.count;
+
+  NSMutableIndexSet *unallocatedIndexes = [NSMutableIndexSet indexSet];
+  for (NSIndexSet *indexes in @[changedVisibleIndexes, changedDisplayIndexes, changedIndexes]) {
+    for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index]) {
+      // Before a node / indexPath is exposed to ASRangeController, ASDataController should have already measured it.
+      // For consistency, make sure each node knows that it should measure itself if something changes.
+      ASInterfaceState interfaceState = ASInterfaceStateMeasureLayout;
+      
+      if (selfIsVisible) {
+        if ([visibleIndexes containsIndex:index]) {
+          interfaceState |= (ASInterfaceStateVisible | ASInterfaceStateDisplay | ASInterfaceStatePreload);
+        } else {
+          if ([preloadIndexes containsIndex:index]) {
+            interfaceState |= ASInterfaceStatePreload;
+          }
+          if ([displayIndexes containsIndex:index]) {
+            interfaceState |= ASInterfaceStateDisplay;
+          }
+        }
       } else {
-        if ([preloadIndexPaths containsObject:indexPath]) {
+        // If selfInterfaceState isn't visible, then visibleIndexes represents what /will/ be immediately visible at the
+        // instant we come onscreen.  So, preload and display all of those things, but don't waste resources preloading yet.
+        
+        if ([currentIndexes containsIndex:index]) {
+          // DO NOT set Visible: even though these elements are in the visible range / "viewport",
+          // our overall container object is itself not visible yet.  The moment it becomes visible, we will run the condition above
+          
+          // Set Layout, Preload
           interfaceState |= ASInterfaceStatePreload;
-        }
-        if ([displayIndexPaths containsObject:indexPath]) {
-          interfaceState |= ASInterfaceStateDisplay;
+          
+          if (isLowMemory == NO) {
+            // Add Display.
+            // We might be looking at an indexPath that was previously in-range, but now we need to clear it.
+            // In that case we'll just set it back to MeasureLayout.  Only set Display | Preload if in currentIndexes.
+            interfaceState |= ASInterfaceStateDisplay;
+          }
         }
       }
-    } else {
-      // If selfInterfaceState isn't visible, then visibleIndexPaths represents what /will/ be immediately visible at the
-      // instant we come onscreen.  So, preload and display all of those things, but don't waste resources preloading yet.
-      // We handle this as a separate case to minimize set operations for offscreen preloading, including containsObject:.
-      
-      if ([allCurrentIndexPaths containsObject:indexPath]) {
-        // DO NOT set Visible: even though these elements are in the visible range / "viewport",
-        // our overall container object is itself not visible yet.  The moment it becomes visible, we will run the condition above
-        
-        // Set Layout, Preload
-        interfaceState |= ASInterfaceStatePreload;
-        
-        if (rangeMode != ASLayoutRangeModeLowMemory) {
-          // Add Display.
-          // We might be looking at an indexPath that was previously in-range, but now we need to clear it.
-          // In that case we'll just set it back to MeasureLayout.  Only set Display | Preload if in allCurrentIndexPaths.
-          interfaceState |= ASInterfaceStateDisplay;
+
+      NSIndexPath *indexPath = ASRangeIndexPathForIndex(index, _sectionOffsets);
+      ASCellNode *node = [map elementForItemAtIndexPath:indexPath].nodeIfAllocated;
+      if (node == nil) {
+        if (interfaceState != ASInterfaceStateMeasureLayout) {
+          [unallocatedIndexes addIndex:index];
         }
+        continue;
       }
-    }
 
-    ASCellNode *node = [map elementForItemAtIndexPath:indexPath].nodeIfAllocated;
-    if (node != nil) {
       ASDisplayNodeAssert(node.hierarchyState & ASHierarchyStateRangeManaged, @"All nodes reaching this point should be range-managed, or interfaceState may be incorrectly reset.");
-      if (ASInterfaceStateIncludesVisible(interfaceState)) {
-        [newVisibleNodes addObject:node];
-      }
+      // Whatever a previous update deferred for this node is superseded by this one.
+      [_interfaceStateBatch cancelDeferredInterfaceStateForNode:node];
       // Skip the many method calls of the recursive operation if the top level cell node already has the right interfaceState.
       if (node.interfaceState != interfaceState) {
+        _metrics.modifiedItemCount += 1;
 #if ASRangeControllerLoggingEnabled
         [modifiedIndexPaths addObject:indexPath];
 #endif
 
         BOOL nodeShouldScheduleDisplay = [node shouldScheduleDisplayWithNewInterfaceState:interfaceState];
-        [node recursivelySetInterfaceState:interfaceState];
+        [_interfaceStateBatch setInterfaceState:interfaceState forNode:node];
 
         if (nodeShouldScheduleDisplay) {
           [self registerForNodeDisplayNotificationsForInterfaceStateIfNeeded:selfInterfaceState];
           if (_didRegisterForNodeDisplayNotifications) {
             _pendingDisplayNodesTimestamp = CACurrentMediaTime();
           }
+          if (_adaptiveRangePolicy != nil && _adaptiveRangeDisplayScheduledTimestamp == 0) {
+            _adaptiveRangeDisplayScheduledTimestamp = CACurrentMediaTime();
+          }
         }
       }
     }
   }
+  _unallocatedIndexes = unallocatedIndexes;
+
+  // Apply the update's changes in one pass. Leaving the display and preload ranges can wait for later run loop
+  // turns, unless this update is meant to free memory.
+  BOOL freesMemory = (rangeMode == ASLayoutRangeModeVisibleOnly || rangeMode == ASLayoutRangeModeLowMemory);
+  [_interfaceStateBatch commitDeferringExits:!freesMemory];
+
+  if (selfIsVisible) {
+    for (NSUInteger index = visibleIndexes.firstIndex; index != NSNotFound; index = [visibleIndexes indexGreaterThanIndex:index]) {
+      ASCellNode *node = [map elementForItemAtIndexPath:ASRangeIndexPathForIndex(index, _sectionOffsets)].nodeIfAllocated;
+      if (node != nil) {
+        [newVisibleNodes addObject:node];
+      }
+    }
+  }
 
   [self _setVisibleNodes:newVisibleNodes];
   
@@ -408,6 +627,24 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   ASProfilingSignpostEnd(1, self);
 }
 
+- (void)flushDeferredInterfaceStates
+{
+  ASDisplayNodeAssertMainThread();
+  [_interfaceStateBatch flushDeferredInterfaceStates];
+}
+
+- (ASRangeControllerMetrics)metrics
+{
+  ASDisplayNodeAssertMainThread();
+  return _metrics;
+}
+
+- (void)resetMetrics
+{
+  ASDisplayNodeAssertMainThread();
+  _metrics = {};
+}
+
 #pragma mark - Notification observers
 
 /**
@@ -444,6 +681,23 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   }
 }
 
+/**
+ * Records how long the display work scheduled since the rendering engine last drained its queue took to get through
+ * it, as the display latency of the adaptive range policy.
+ */
+- (void)scheduledNodesDidDisplayForAdaptiveRangePolicy:(NSNotification *)notification
+{
+  if (_adaptiveRangeDisplayScheduledTimestamp == 0) {
+    return;
+  }
+  CFTimeInterval notificationTimestamp = ((NSNumber *) notification.userInfo[ASRenderingEngineDidDisplayNodesScheduledBeforeTimestamp]).doubleValue;
+  if (_adaptiveRangeDisplayScheduledTimestamp < notificationTimestamp) {
+    [_adaptiveRangePolicy recordLatency:(notificationTimestamp - _adaptiveRangeDisplayScheduledTimestamp)
+                           forRangeType:ASLayoutRangeTypeDisplay];
+    _adaptiveRangeDisplayScheduledTimestamp = 0;
+  }
+}
+
 #pragma mark - Cell node view handling
 
 - (void)configureContentView:(UIView *)contentView forCellNode:(ASCellNode *)node
@@ -504,6 +758,7 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
 // Skip the many method calls of the recursive operation if the top level cell node already has the right interfaceState.
 - (void)clearContents
 {
+  _needsFullRangeVisit = YES;
   for (ASCollectionElement *element in [_dataSource elementMapForRangeController:self]) {
     ASCellNode *node = element.nodeIfAllocated;
     if (ASInterfaceStateIncludesDisplay(node.interfaceState)) {
@@ -514,6 +769,7 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
 
 - (void)clearPreloadedData
 {
+  _needsFullRangeVisit = YES;
   for (ASCollectionElement *element in [_dataSource elementMapForRangeController:self]) {
     ASCellNode *node = element.nodeIfAllocated;
     if (ASInterfaceStateIncludesPreload(node.interfaceState)) {
@@ -522,6 +778,37 @@ static UIApplicationState __ApplicationState = UIApplicationStateActive;
   }
 }
 
+#pragma mark - Memory Accounting
+
+- (ASMemoryUsage *)estimatedMemoryUsage
+{
+  ASDisplayNodeAssertMainThread();
+  // Each element also takes an index path and slots in the map's tables.
+  static const NSUInteger elementBytes = class_getInstanceSize([ASCollectionElement class]) + class_getInstanceSize([NSIndexPath class]) + 4 * sizeof(void *);
+  ASMemoryUsage *usage = [[ASMemoryUsage alloc] initWithName:[_dataSource nameForRangeControllerDataSource] ?: NSStringFromClass(self.class)];
+  for (ASCollectionElement *element in [_dataSource elementMapForRangeController:self]) {
+    [usage addBytes:elementBytes forCategory:ASMemoryCategoryElementMap];
+    ASCellNode *node = element.nodeIfAllocated;
+    if (node != nil) {
+      [usage addUsage:[node estimatedMemoryUsage]];
+    }
+  }
+  return usage;
+}
+
++ (NSArray<ASMemoryUsage *> *)rangeControllerUsagesByDescendingBytes
+{
+  ASDisplayNodeAssertMainThread();
+  NSMutableArray<ASMemoryUsage *> *usages = [NSMutableArray array];
+  for (ASRangeController *rangeController in [[self allRangeControllersWeakSet] allObjects]) {
+    [usages addObject:[rangeController estimatedMemoryUsage]];
+  }
+  [usages sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(ASMemoryUsage *a, ASMemoryUsage *b) {
+    return (a.totalBytes > b.totalBytes ? NSOrderedAscending : (a.totalBytes < b.totalBytes ? NSOrderedDescending : NSOrderedSame));
+  }];
+  return usages;
+}
+
 #pragma mark - Class Methods (Application Notification Handlers)
 
 + (ASWeakSet *)allRangeControllersWeakSet
@@ -634,7 +921,13 @@ static ASLayoutRangeMode __rangeModeForMemoryWarnings = ASLayoutRangeModeLowMemo
 
 - (NSString *)description
 {
-  NSArray<NSIndexPath *> *indexPaths = [[_allPreviousIndexPaths allObjects] sortedArrayUsingSelector:@selector(compare:)];
+  NSMutableIndexSet *indexes = [_previousVisibleIndexes mutableCopy];
+  [indexes addIndexes:_previousDisplayIndexes];
+  [indexes addIndexes:_previousPreloadIndexes];
+  NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:indexes.count];
+  for (NSUInteger index = indexes.firstIndex; index != NSNotFound; index = [indexes indexGreaterThanIndex:index]) {
+    [indexPaths addObject:ASRangeIndexPathForIndex(index, _sectionOffsets)];
+  }
   return [self descriptionWithIndexPaths:indexPaths];
 }
 
@@ -0,0 +1,98 @@
+//
+//  ASSnapshot.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * An immutable description of the contents of a table or collection: the identifier of each section and item, and
+ * optionally a hash of each item's content.
+ *
+ * Identifiers are compared with -isEqual: and -hash, and must be unique among the sections and among the items of
+ * a snapshot. An item keeps its identifier for as long as it's the same item, e.g. a model object's ID, while its
+ * content hash changes whenever its cell should be measured again.
+ *
+ * @see -[ASTableNode applySnapshot:animated:updates:completion:]
+ * @see -[ASCollectionNode applySnapshot:animated:updates:completion:]
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASSnapshot : NSObject
+
+/**
+ * @param sectionIdentifiers The identifier of each section.
+ * @param itemIdentifiers The identifiers of the items of each section, one array per section.
+ * @param contentHashes The content hashes of the items of each section, shaped like itemIdentifiers, or nil if items
+ *   never need reloading.
+ */
+- (instancetype)initWithSectionIdentifiers:(NSArray<id<NSObject>> *)sectionIdentifiers
+                           itemIdentifiers:(NSArray<NSArray<id<NSObject>> *> *)itemIdentifiers
+                             contentHashes:(nullable NSArray<NSArray<NSNumber *> *> *)contentHashes NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, copy, readonly) NSArray<id<NSObject>> *sectionIdentifiers;
+
+@property (nonatomic, copy, readonly) NSArray<NSArray<id<NSObject>> *> *itemIdentifiers;
+
+@property (nonatomic, copy, readonly, nullable) NSArray<NSArray<NSNumber *> *> *contentHashes;
+
+@property (nonatomic, readonly) NSInteger numberOfSections;
+
+@property (nonatomic, readonly) NSInteger numberOfItems;
+
+- (NSInteger)numberOfItemsInSection:(NSInteger)section AS_WARN_UNUSED_RESULT;
+
+@end
+
+/**
+ * The changes that turn one snapshot into another, in the terms of a batch update: deletions, reloads and the
+ * sources of moves are index paths before the update, insertions and the destinations of moves are index paths after.
+ *
+ * Computed in O(n log n) time in the size of the snapshots. Items inside deleted, inserted or moved sections are covered
+ * by the section change and aren't listed. Items are matched by identifier across sections, and an item whose content
+ * hash changed without moving is reloaded. The longest run of sections, and of items within each section, that keep
+ * their relative order stay put, so moving one item or section reports exactly one move.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASSnapshotDiff : NSObject
+
++ (ASSnapshotDiff *)diffFromSnapshot:(ASSnapshot *)fromSnapshot toSnapshot:(ASSnapshot *)toSnapshot AS_WARN_UNUSED_RESULT;
+
+/**
+ * Computes the diff on a background queue and calls the completion on the main thread. Diffs requested from the main
+ * thread complete in the order they were requested.
+ */
++ (void)diffFromSnapshot:(ASSnapshot *)fromSnapshot toSnapshot:(ASSnapshot *)toSnapshot completion:(void (^)(ASSnapshotDiff *diff))completion;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+@property (nonatomic, strong, readonly) NSIndexSet *deletedSections;
+
+@property (nonatomic, strong, readonly) NSIndexSet *insertedSections;
+
+/// Old section index to new section index.
+@property (nonatomic, strong, readonly) NSDictionary<NSNumber *, NSNumber *> *movedSections;
+
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *deletedItems;
+
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *insertedItems;
+
+@property (nonatomic, strong, readonly) NSArray<NSIndexPath *> *reloadedItems;
+
+/// Old index path to new index path.
+@property (nonatomic, strong, readonly) NSDictionary<NSIndexPath *, NSIndexPath *> *movedItems;
+
+@property (nonatomic, readonly) BOOL isEmpty;
+
+@end
+
+NS_ASSUME_NONNULL_END
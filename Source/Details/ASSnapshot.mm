@@ -0,0 +1,322 @@
+//
+//  ASSnapshot.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASSnapshot.h>
+
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+
+#import <algorithm>
+#import <unordered_map>
+#import <vector>
+
+@implementation ASSnapshot
+
+- (instancetype)initWithSectionIdentifiers:(NSArray<id<NSObject>> *)sectionIdentifiers
+                           itemIdentifiers:(NSArray<NSArray<id<NSObject>> *> *)itemIdentifiers
+                             contentHashes:(NSArray<NSArray<NSNumber *> *> *)contentHashes
+{
+  if (!(self = [super init])) {
+    return nil;
+  }
+  ASDisplayNodeAssert(sectionIdentifiers.count == itemIdentifiers.count, @"Expected item identifiers for each of the %tu sections, got %tu", sectionIdentifiers.count, itemIdentifiers.count);
+  _sectionIdentifiers = [sectionIdentifiers copy];
+  _itemIdentifiers = [itemIdentifiers copy];
+  _contentHashes = [contentHashes copy];
+#if ASDISPLAYNODE_ASSERTIONS_ENABLED
+  if (contentHashes != nil) {
+    ASDisplayNodeAssert(contentHashes.count == itemIdentifiers.count, @"Expected content hashes for each of the %tu sections, got %tu", itemIdentifiers.count, contentHashes.count);
+    [itemIdentifiers enumerateObjectsUsingBlock:^(NSArray *items, NSUInteger section, BOOL * _Nonnull stop) {
+      ASDisplayNodeAssert(items.count == contentHashes[section].count, @"Expected a content hash for each of the %tu items in section %tu, got %tu", items.count, section, contentHashes[section].count);
+    }];
+  }
+#endif
+  for (NSArray *items in _itemIdentifiers) {
+    _numberOfItems += items.count;
+  }
+  return self;
+}
+
+- (NSInteger)numberOfSections
+{
+  return _sectionIdentifiers.count;
+}
+
+- (NSInteger)numberOfItemsInSection:(NSInteger)section
+{
+  return _itemIdentifiers[section].count;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; sections = %tu; items = %tu>", self.class, self, _sectionIdentifiers.count, _numberOfItems];
+}
+
+@end
+
+#pragma mark - Diffing
+
+struct ASSnapshotIdentifierHash {
+  size_t operator()(id<NSObject> identifier) const {
+    return [identifier hash];
+  }
+};
+
+struct ASSnapshotIdentifierEqual {
+  bool operator()(id<NSObject> lhs, id<NSObject> rhs) const {
+    return [lhs isEqual:rhs];
+  }
+};
+
+typedef std::unordered_map<id<NSObject>, NSInteger, ASSnapshotIdentifierHash, ASSnapshotIdentifierEqual> ASSnapshotIndexMap;
+
+/**
+ * Matches identifiers between the old and new lists. On return, oldToNew and newToOld hold the index of each
+ * identifier in the other list, or NSNotFound. Duplicate identifiers only match once.
+ */
+static void ASSnapshotMatchIdentifiers(NSArray<id<NSObject>> *oldIdentifiers, NSArray<id<NSObject>> *newIdentifiers, std::vector<NSInteger> &oldToNew, std::vector<NSInteger> &newToOld)
+{
+  oldToNew.assign(oldIdentifiers.count, NSNotFound);
+  newToOld.assign(newIdentifiers.count, NSNotFound);
+
+  ASSnapshotIndexMap oldIndexes;
+  oldIndexes.reserve(oldIdentifiers.count);
+  NSInteger oldIndex = 0;
+  for (id<NSObject> identifier in oldIdentifiers) {
+    __unused BOOL inserted = oldIndexes.emplace(identifier, oldIndex).second;
+    ASDisplayNodeCAssert(inserted, @"Duplicate identifier %@ in snapshot", identifier);
+    oldIndex++;
+  }
+
+  NSInteger newIndex = 0;
+  for (id<NSObject> identifier in newIdentifiers) {
+    auto it = oldIndexes.find(identifier);
+    if (it != oldIndexes.end() && oldToNew[it->second] == NSNotFound) {
+      oldToNew[it->second] = newIndex;
+      newToOld[newIndex] = it->second;
+    }
+    newIndex++;
+  }
+}
+
+/**
+ * Returns which of the values are part of a longest strictly increasing subsequence. Patience sorting, O(n log n).
+ */
+static std::vector<bool> ASSnapshotLongestIncreasingSubsequence(const std::vector<NSInteger> &values)
+{
+  NSInteger count = (NSInteger)values.size();
+  // tails[length - 1] is the index of the smallest value ending an increasing subsequence of that length so far.
+  std::vector<NSInteger> tails;
+  std::vector<NSInteger> predecessors(count, NSNotFound);
+  for (NSInteger index = 0; index < count; index++) {
+    auto position = std::lower_bound(tails.begin(), tails.end(), values[index], [&values](NSInteger tail, NSInteger value) {
+      return values[tail] < value;
+    });
+    if (position != tails.begin()) {
+      predecessors[index] = *(position - 1);
+    }
+    if (position == tails.end()) {
+      tails.push_back(index);
+    } else {
+      *position = index;
+    }
+  }
+
+  std::vector<bool> inSubsequence(count, false);
+  for (NSInteger index = tails.empty() ? NSNotFound : tails.back(); index != NSNotFound; index = predecessors[index]) {
+    inSubsequence[index] = true;
+  }
+  return inSubsequence;
+}
+
+@implementation ASSnapshotDiff
+
++ (ASSnapshotDiff *)diffFromSnapshot:(ASSnapshot *)fromSnapshot toSnapshot:(ASSnapshot *)toSnapshot
+{
+  return [[ASSnapshotDiff alloc] initWithFromSnapshot:fromSnapshot toSnapshot:toSnapshot];
+}
+
++ (void)diffFromSnapshot:(ASSnapshot *)fromSnapshot toSnapshot:(ASSnapshot *)toSnapshot completion:(void (^)(ASSnapshotDiff *))completion
+{
+  static dispatch_queue_t queue;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    dispatch_queue_attr_t attributes = dispatch_queue_attr_make_with_qos_class(DISPATCH_QUEUE_SERIAL, QOS_CLASS_USER_INITIATED, 0);
+    queue = dispatch_queue_create("org.AsyncDisplayKit.ASSnapshotDiff.diffQueue", attributes);
+  });
+
+  // The queue is serial and the main queue is FIFO, so completions arrive in order.
+  dispatch_async(queue, ^{
+    ASSnapshotDiff *diff = [self diffFromSnapshot:fromSnapshot toSnapshot:toSnapshot];
+    dispatch_async(dispatch_get_main_queue(), ^{
+      completion(diff);
+    });
+  });
+}
+
+- (instancetype)initWithFromSnapshot:(ASSnapshot *)fromSnapshot toSnapshot:(ASSnapshot *)toSnapshot
+{
+  if (!(self = [super init])) {
+    return nil;
+  }
+
+  // Sections. The largest set of matched sections that keep their relative order stays put; the others are moved.
+  // Moves are deletes and inserts of the whole section, so only the sections that stay put are diffed further.
+  std::vector<NSInteger> oldSectionToNew, newSectionToOld;
+  ASSnapshotMatchIdentifiers(fromSnapshot.sectionIdentifiers, toSnapshot.sectionIdentifiers, oldSectionToNew, newSectionToOld);
+
+  NSMutableIndexSet *deletedSections = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *insertedSections = [NSMutableIndexSet indexSet];
+  NSMutableDictionary<NSNumber *, NSNumber *> *movedSections = [NSMutableDictionary dictionary];
+  for (NSInteger section = 0; section < (NSInteger)oldSectionToNew.size(); section++) {
+    if (oldSectionToNew[section] == NSNotFound) {
+      [deletedSections addIndex:section];
+    }
+  }
+  std::vector<NSInteger> matchedOldSections;
+  for (NSInteger section = 0; section < (NSInteger)newSectionToOld.size(); section++) {
+    if (newSectionToOld[section] == NSNotFound) {
+      [insertedSections addIndex:section];
+    } else {
+      matchedOldSections.push_back(newSectionToOld[section]);
+    }
+  }
+
+  std::vector<bool> oldSectionIsDiffed(oldSectionToNew.size(), false);
+  std::vector<bool> sectionStays = ASSnapshotLongestIncreasingSubsequence(matchedOldSections);
+  for (NSInteger index = 0; index < (NSInteger)matchedOldSections.size(); index++) {
+    NSInteger oldSection = matchedOldSections[index];
+    if (sectionStays[index]) {
+      oldSectionIsDiffed[oldSection] = true;
+    } else {
+      movedSections[@(oldSection)] = @(oldSectionToNew[oldSection]);
+    }
+  }
+
+  // Items. Match them across all the diffed sections, so that items moving between sections are moves.
+  NSArray<NSArray<id<NSObject>> *> *oldItems = fromSnapshot.itemIdentifiers;
+  NSArray<NSArray<id<NSObject>> *> *newItems = toSnapshot.itemIdentifiers;
+
+  struct Location {
+    NSInteger section;
+    NSInteger item;
+  };
+  ASSnapshotIndexMap oldItemIndexes;
+  oldItemIndexes.reserve(fromSnapshot.numberOfItems);
+  std::vector<Location> oldLocations;
+  oldLocations.reserve(fromSnapshot.numberOfItems);
+  for (NSInteger section = 0; section < (NSInteger)oldSectionToNew.size(); section++) {
+    if (!oldSectionIsDiffed[section]) {
+      continue;
+    }
+    NSInteger item = 0;
+    for (id<NSObject> identifier in oldItems[section]) {
+      __unused BOOL inserted = oldItemIndexes.emplace(identifier, oldLocations.size()).second;
+      ASDisplayNodeAssert(inserted, @"Duplicate item identifier %@ in snapshot", identifier);
+      oldLocations.push_back({ section, item });
+      item++;
+    }
+  }
+
+  // The new location of each old item, and the old index of each new item, in flat old item order.
+  std::vector<Location> oldToNewLocations(oldLocations.size(), { NSNotFound, NSNotFound });
+  std::vector<std::vector<NSInteger>> newToOldIndexes(newSectionToOld.size());
+  for (NSInteger section = 0; section < (NSInteger)newSectionToOld.size(); section++) {
+    NSInteger oldSection = newSectionToOld[section];
+    if (oldSection == NSNotFound || !oldSectionIsDiffed[oldSection]) {
+      continue;
+    }
+    std::vector<NSInteger> &newToOld = newToOldIndexes[section];
+    newToOld.assign(newItems[section].count, NSNotFound);
+    NSInteger item = 0;
+    for (id<NSObject> identifier in newItems[section]) {
+      auto it = oldItemIndexes.find(identifier);
+      if (it != oldItemIndexes.end() && oldToNewLocations[it->second].section == NSNotFound) {
+        oldToNewLocations[it->second] = { section, item };
+        newToOld[item] = it->second;
+      }
+      item++;
+    }
+  }
+
+  // Within each section, the largest set of items from the same old section that keep their relative order stays
+  // put. The rest are moves, and the stayed items' positions follow from the deletes, inserts and moves around them.
+  NSMutableArray<NSIndexPath *> *insertedItems = [NSMutableArray array];
+  NSMutableDictionary<NSIndexPath *, NSIndexPath *> *movedItems = [NSMutableDictionary dictionary];
+  std::vector<bool> oldItemStays(oldLocations.size(), false);
+  for (NSInteger section = 0; section < (NSInteger)newSectionToOld.size(); section++) {
+    const std::vector<NSInteger> &newToOld = newToOldIndexes[section];
+    std::vector<NSInteger> sameSectionItems, sameSectionOldIndexes;
+    for (NSInteger item = 0; item < (NSInteger)newToOld.size(); item++) {
+      NSInteger oldIndex = newToOld[item];
+      if (oldIndex == NSNotFound) {
+        [insertedItems addObject:[NSIndexPath indexPathForItem:item inSection:section]];
+        continue;
+      }
+      const Location &old = oldLocations[oldIndex];
+      if (old.section == newSectionToOld[section]) {
+        sameSectionItems.push_back(item);
+        sameSectionOldIndexes.push_back(oldIndex);
+      } else {
+        movedItems[[NSIndexPath indexPathForItem:old.item inSection:old.section]] = [NSIndexPath indexPathForItem:item inSection:section];
+      }
+    }
+
+    // Flat old indexes increase with the item index within a section.
+    std::vector<bool> itemStays = ASSnapshotLongestIncreasingSubsequence(sameSectionOldIndexes);
+    for (NSInteger index = 0; index < (NSInteger)sameSectionItems.size(); index++) {
+      NSInteger oldIndex = sameSectionOldIndexes[index];
+      if (itemStays[index]) {
+        oldItemStays[oldIndex] = true;
+      } else {
+        const Location &old = oldLocations[oldIndex];
+        movedItems[[NSIndexPath indexPathForItem:old.item inSection:old.section]] = [NSIndexPath indexPathForItem:sameSectionItems[index] inSection:section];
+      }
+    }
+  }
+
+  NSArray<NSArray<NSNumber *> *> *oldHashes = fromSnapshot.contentHashes;
+  NSArray<NSArray<NSNumber *> *> *newHashes = toSnapshot.contentHashes;
+  NSMutableArray<NSIndexPath *> *deletedItems = [NSMutableArray array];
+  NSMutableArray<NSIndexPath *> *reloadedItems = [NSMutableArray array];
+  for (NSInteger index = 0; index < (NSInteger)oldLocations.size(); index++) {
+    const Location &old = oldLocations[index];
+    const Location &location = oldToNewLocations[index];
+    if (location.section == NSNotFound) {
+      [deletedItems addObject:[NSIndexPath indexPathForItem:old.item inSection:old.section]];
+    } else if (oldItemStays[index] && oldHashes != nil && newHashes != nil
+               && ![oldHashes[old.section][old.item] isEqualToNumber:newHashes[location.section][location.item]]) {
+      [reloadedItems addObject:[NSIndexPath indexPathForItem:old.item inSection:old.section]];
+    }
+  }
+
+  _deletedSections = deletedSections;
+  _insertedSections = insertedSections;
+  _movedSections = movedSections;
+  _deletedItems = deletedItems;
+  _insertedItems = insertedItems;
+  _reloadedItems = reloadedItems;
+  _movedItems = movedItems;
+  return self;
+}
+
+- (BOOL)isEmpty
+{
+  return _deletedSections.count == 0 && _insertedSections.count == 0 && _movedSections.count == 0
+    && _deletedItems.count == 0 && _insertedItems.count == 0 && _reloadedItems.count == 0 && _movedItems.count == 0;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; deletedSections = %tu; insertedSections = %tu; movedSections = %tu; deletedItems = %tu; insertedItems = %tu; reloadedItems = %tu; movedItems = %tu>", self.class, self, _deletedSections.count, _insertedSections.count, _movedSections.count, _deletedItems.count, _insertedItems.count, _reloadedItems.count, _movedItems.count];
+}
+
+@end
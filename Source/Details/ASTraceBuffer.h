@@ -0,0 +1,130 @@
+//
+//  ASTraceBuffer.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * The kinds of work ASTraceBuffer records spans of. Each kind is exported as a trace-event category.
+ */
+typedef NS_ENUM(uint8_t, ASTraceSpan) {
+  /// -calculateLayoutThatFits: of a node, named after the node class.
+  ASTraceSpanLayout,
+  /// A display block of a node, named after the node class.
+  ASTraceSpanDisplay,
+  /// ASDataController updating its pending element map to match the data source.
+  ASTraceSpanDataControllerUpdateElements,
+  /// ASDataController allocating and laying out a batch of cell nodes.
+  ASTraceSpanDataControllerAllocateNodes,
+  /// ASDataController handing an update to its delegate on the main thread.
+  ASTraceSpanDataControllerDeployUpdate,
+  /// ASRangeController updating the interface states of the nodes in its ranges.
+  ASTraceSpanRangeUpdate,
+  /// ASPendingStateController applying pending view state to the nodes that changed.
+  ASTraceSpanPendingStateFlush,
+  /// ASMainSerialQueue running the blocks queued for the main thread, such as the updates of an ASDataController.
+  ASTraceSpanMainSerialQueueDrain,
+  /// ASDataController laying out all of its nodes again, for example after the size of its view changed.
+  ASTraceSpanDataControllerRelayout,
+  /// -recursivelyEnsureDisplaySynchronously: of a node, named after the node class.
+  ASTraceSpanEnsureDisplay,
+};
+
+/**
+ * @abstract Records begin and end events of the main units of work of the framework, for viewing in trace tools.
+ *
+ * @discussion Each thread writes fixed-size binary events into a ring buffer of its own, without locks or allocations,
+ * so that tracing can stay on while reproducing a hitch. Each thread keeps its latest 4096 events; older events are
+ * overwritten. Buffers of threads that exit are kept until they are cleared, for the 32 threads that exited last.
+ *
+ * Export the buffers with +chromeTraceData and open the result in chrome://tracing or any tool that reads the Chrome
+ * trace-event format.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASTraceBuffer : NSObject
+
+/**
+ * Whether spans are recorded. Defaults to NO, in which case recording a span costs a function call and an atomic load.
+ * Running hitch detectors also record spans, see ASHitchDetector.
+ */
+@property (class, atomic, assign, getter=isEnabled) BOOL enabled;
+
+/**
+ * Returns the buffered events of all threads as Chrome trace-event JSON, in the object format with a "traceEvents"
+ * array. Spans are named after their class, or after their kind if they have none, and their category is their kind.
+ * Ends whose beginnings were overwritten are left out, spans still in progress have no end.
+ */
++ (NSData *)chromeTraceData AS_WARN_UNUSED_RESULT;
+
+/**
+ * Discards the buffered events of all threads.
+ */
++ (void)clear;
+
+@end
+
+ASDISPLAYNODE_EXTERN_C_BEGIN
+
+/**
+ * Whether spans are recorded, because ASTraceBuffer.enabled is YES or because an ASHitchDetector is running.
+ */
+extern BOOL ASTraceBufferIsEnabled(void);
+
+/**
+ * Records the beginning of a span on the current thread, if tracing is enabled. Lock-free, may be called on any thread.
+ * The class names the span in exports, pass Nil for spans that aren't about a class.
+ */
+extern void ASTraceBufferBeginSpan(ASTraceSpan span, Class _Nullable cls);
+
+/**
+ * Records the end of the span that was begun last on the current thread. Ends are recorded on threads that have
+ * recorded events even after tracing is disabled, so that spans in progress when it was disabled still end.
+ */
+extern void ASTraceBufferEndSpan(ASTraceSpan span, Class _Nullable cls);
+
+ASDISPLAYNODE_EXTERN_C_END
+
+NS_ASSUME_NONNULL_END
+
+#ifdef __cplusplus
+
+namespace ASDN {
+
+/**
+ * Records a span covering the enclosing scope. Whether tracing is enabled is only checked on entry, so that the scope
+ * never records an end without its beginning.
+ */
+struct TraceScope {
+  TraceScope(ASTraceSpan span, Class _Nullable cls) : _span(span), _cls(cls), _enabled(ASTraceBufferIsEnabled()) {
+    if (_enabled) {
+      ASTraceBufferBeginSpan(_span, _cls);
+    }
+  }
+
+  ~TraceScope() {
+    if (_enabled) {
+      ASTraceBufferEndSpan(_span, _cls);
+    }
+  }
+
+  TraceScope(const TraceScope&) = delete;
+  TraceScope &operator=(const TraceScope&) = delete;
+
+private:
+  ASTraceSpan _span;
+  __unsafe_unretained Class _Nullable _cls;
+  BOOL _enabled;
+};
+
+} // namespace ASDN
+
+#endif
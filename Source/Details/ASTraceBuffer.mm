@@ -0,0 +1,366 @@
+//
+//  ASTraceBuffer.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+#import <AsyncDisplayKit/ASTraceBufferInternal.h>
+
+#import <algorithm>
+#import <atomic>
+#import <deque>
+#import <mach/mach_time.h>
+#import <pthread.h>
+#import <string>
+#import <unistd.h>
+#import <vector>
+
+#import <AsyncDisplayKit/ASThread.h>
+
+// A power of two, so that event indexes map to slots with a mask.
+static const uint64_t ASTraceBufferEventCount = 4096;
+static const size_t ASTraceBufferRetiredBufferCount = 32;
+
+static std::atomic<bool> __enabled(false);
+// The number of reasons to record: ASTraceBuffer.enabled, and each running hitch detector.
+static std::atomic<int32_t> __recordingCount(0);
+
+#pragma mark - Buffers
+
+namespace {
+  enum ASTracePhase : uint8_t {
+    ASTracePhaseBegin,
+    ASTracePhaseEnd,
+  };
+
+  /**
+   * One event. Exports may read a slot while its thread overwrites it, so the fields are atomic; exports detect that it
+   * happened afterwards and drop the event.
+   */
+  struct ASTraceEventSlot {
+    std::atomic<uint64_t> timestamp;
+    std::atomic<uintptr_t> cls;
+    std::atomic<uint16_t> spanAndPhase;   // The span in the high byte.
+  };
+
+  struct ASTraceThreadBuffer {
+    ASTraceEventSlot slots[ASTraceBufferEventCount];
+    /// The index of the next event. Only the thread owning the buffer writes events and advances it.
+    std::atomic<uint64_t> head;
+    /// Events before this index were cleared.
+    std::atomic<uint64_t> tail;
+    uint64_t threadID;
+    char threadName[64];
+  };
+
+  /// An event copied out of a buffer, for exporting.
+  struct ASTraceEventCopy {
+    uint64_t timestamp;
+    uintptr_t cls;
+    ASTraceSpan span;
+    ASTracePhase phase;
+  };
+
+  struct ASTraceThreadEvents {
+    uint64_t threadID;
+    std::string threadName;
+    std::vector<ASTraceEventCopy> events;
+  };
+}
+
+// Guards the lists of buffers, so that exports don't read buffers as they are deleted.
+static ASDN::StaticMutex __buffersLock = ASDISPLAYNODE_MUTEX_INITIALIZER;
+static std::vector<ASTraceThreadBuffer *> *__liveBuffers;
+// The buffers of the threads that exited last, oldest first.
+static std::deque<ASTraceThreadBuffer *> *__retiredBuffers;
+
+/**
+ * Called when a thread with a buffer exits. Keeps its events for exports.
+ */
+static void ASTraceRetireBuffer(void *context)
+{
+  ASTraceThreadBuffer *buffer = (ASTraceThreadBuffer *)context;
+  ASDN::StaticMutexLocker l(__buffersLock);
+  __liveBuffers->erase(std::remove(__liveBuffers->begin(), __liveBuffers->end(), buffer), __liveBuffers->end());
+  if (buffer->head.load(std::memory_order_relaxed) == buffer->tail.load(std::memory_order_relaxed)) {
+    delete buffer;
+    return;
+  }
+  __retiredBuffers->push_back(buffer);
+  if (__retiredBuffers->size() > ASTraceBufferRetiredBufferCount) {
+    delete __retiredBuffers->front();
+    __retiredBuffers->pop_front();
+  }
+}
+
+static pthread_key_t ASTraceBufferKey()
+{
+  static pthread_key_t key;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    __liveBuffers = new std::vector<ASTraceThreadBuffer *>();
+    __retiredBuffers = new std::deque<ASTraceThreadBuffer *>();
+    pthread_key_create(&key, ASTraceRetireBuffer);
+  });
+  return key;
+}
+
+static ASTraceThreadBuffer &ASTraceCurrentBuffer()
+{
+  pthread_key_t key = ASTraceBufferKey();
+  ASTraceThreadBuffer *buffer = (ASTraceThreadBuffer *)pthread_getspecific(key);
+  if (buffer == NULL) {
+    // Value-initialized, so the buffer starts out empty.
+    buffer = new ASTraceThreadBuffer();
+    pthread_threadid_np(NULL, &buffer->threadID);
+    if (pthread_main_np()) {
+      strlcpy(buffer->threadName, "Main Thread", sizeof(buffer->threadName));
+    } else {
+      pthread_getname_np(pthread_self(), buffer->threadName, sizeof(buffer->threadName));
+    }
+    {
+      ASDN::StaticMutexLocker l(__buffersLock);
+      __liveBuffers->push_back(buffer);
+    }
+    pthread_setspecific(key, buffer);
+  }
+  return *buffer;
+}
+
+static void ASTraceRecordEvent(ASTraceThreadBuffer &buffer, ASTraceSpan span, Class cls, ASTracePhase phase)
+{
+  uint64_t index = buffer.head.load(std::memory_order_relaxed);
+  // Order the slot writes after the previous advance of the head, so that exports reading any of them also see that
+  // the event they overwrite is gone.
+  std::atomic_thread_fence(std::memory_order_release);
+  ASTraceEventSlot &slot = buffer.slots[index & (ASTraceBufferEventCount - 1)];
+  slot.timestamp.store(mach_absolute_time(), std::memory_order_relaxed);
+  slot.cls.store((uintptr_t)(__bridge void *)cls, std::memory_order_relaxed);
+  slot.spanAndPhase.store((uint16_t)(span << 8 | phase), std::memory_order_relaxed);
+  buffer.head.store(index + 1, std::memory_order_release);
+}
+
+/**
+ * Copies the events of the buffer that weren't cleared, leaving out the ones its thread overwrote while copying.
+ */
+static void ASTraceCopyEvents(ASTraceThreadBuffer &buffer, std::vector<ASTraceEventCopy> &events)
+{
+  uint64_t end = buffer.head.load(std::memory_order_acquire);
+  uint64_t start = std::max(buffer.tail.load(std::memory_order_relaxed), end > ASTraceBufferEventCount ? end - ASTraceBufferEventCount : 0);
+  if (start >= end) {
+    return;
+  }
+  events.reserve(end - start);
+  for (uint64_t i = start; i < end; i++) {
+    ASTraceEventSlot &slot = buffer.slots[i & (ASTraceBufferEventCount - 1)];
+    uint16_t spanAndPhase = slot.spanAndPhase.load(std::memory_order_relaxed);
+    events.push_back({
+      slot.timestamp.load(std::memory_order_relaxed),
+      slot.cls.load(std::memory_order_relaxed),
+      (ASTraceSpan)(spanAndPhase >> 8),
+      (ASTracePhase)(spanAndPhase & 0xff),
+    });
+  }
+  // The event at index i was being overwritten if the head had reached i + ASTraceBufferEventCount by now.
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t firstIntactIndex = buffer.head.load(std::memory_order_relaxed) + 1;
+  firstIntactIndex = (firstIntactIndex > ASTraceBufferEventCount ? firstIntactIndex - ASTraceBufferEventCount : 0);
+  if (firstIntactIndex > start) {
+    size_t overwrittenCount = (size_t)std::min<uint64_t>(firstIntactIndex - start, events.size());
+    events.erase(events.begin(), events.begin() + overwrittenCount);
+  }
+}
+
+#pragma mark - Recording
+
+BOOL ASTraceBufferIsEnabled(void)
+{
+  return __recordingCount.load(std::memory_order_relaxed) > 0;
+}
+
+void ASTraceBufferRetainRecording(void)
+{
+  __recordingCount.fetch_add(1);
+}
+
+void ASTraceBufferReleaseRecording(void)
+{
+  __recordingCount.fetch_sub(1);
+}
+
+void ASTraceBufferBeginSpan(ASTraceSpan span, Class cls)
+{
+  if (!ASTraceBufferIsEnabled()) {
+    return;
+  }
+  ASTraceRecordEvent(ASTraceCurrentBuffer(), span, cls, ASTracePhaseBegin);
+}
+
+void ASTraceBufferEndSpan(ASTraceSpan span, Class cls)
+{
+  ASTraceThreadBuffer *buffer;
+  if (ASTraceBufferIsEnabled()) {
+    buffer = &ASTraceCurrentBuffer();
+  } else {
+    buffer = (ASTraceThreadBuffer *)pthread_getspecific(ASTraceBufferKey());
+  }
+  if (buffer != NULL) {
+    ASTraceRecordEvent(*buffer, span, cls, ASTracePhaseEnd);
+  }
+}
+
+uint64_t ASTraceBufferCurrentThreadPosition()
+{
+  ASTraceThreadBuffer *buffer = (ASTraceThreadBuffer *)pthread_getspecific(ASTraceBufferKey());
+  return buffer != NULL ? buffer->head.load(std::memory_order_relaxed) : 0;
+}
+
+std::vector<ASTraceSpanInterval> ASTraceBufferCurrentThreadSpans(uint64_t position, uint64_t endTime)
+{
+  std::vector<ASTraceSpanInterval> spans;
+  ASTraceThreadBuffer *buffer = (ASTraceThreadBuffer *)pthread_getspecific(ASTraceBufferKey());
+  if (buffer == NULL) {
+    return spans;
+  }
+  // No other thread writes this buffer, so its events can be read as they are.
+  uint64_t end = buffer->head.load(std::memory_order_relaxed);
+  uint64_t start = std::max(position, end > ASTraceBufferEventCount ? end - ASTraceBufferEventCount : 0);
+  std::vector<size_t> openSpanIndexes;
+  for (uint64_t i = start; i < end; i++) {
+    ASTraceEventSlot &slot = buffer->slots[i & (ASTraceBufferEventCount - 1)];
+    uint16_t spanAndPhase = slot.spanAndPhase.load(std::memory_order_relaxed);
+    uint64_t timestamp = slot.timestamp.load(std::memory_order_relaxed);
+    if ((spanAndPhase & 0xff) == ASTracePhaseBegin) {
+      openSpanIndexes.push_back(spans.size());
+      spans.push_back({
+        (ASTraceSpan)(spanAndPhase >> 8),
+        slot.cls.load(std::memory_order_relaxed),
+        timestamp,
+        endTime,
+        openSpanIndexes.size() - 1,
+      });
+    } else if (!openSpanIndexes.empty()) {
+      spans[openSpanIndexes.back()].endTime = timestamp;
+      openSpanIndexes.pop_back();
+    }
+  }
+  return spans;
+}
+
+#pragma mark - Exporting
+
+NSString *ASTraceSpanGetName(ASTraceSpan span)
+{
+  switch (span) {
+    case ASTraceSpanLayout:
+      return @"layout";
+    case ASTraceSpanDisplay:
+      return @"display";
+    case ASTraceSpanDataControllerUpdateElements:
+      return @"updateElements";
+    case ASTraceSpanDataControllerAllocateNodes:
+      return @"allocateNodes";
+    case ASTraceSpanDataControllerDeployUpdate:
+      return @"deployUpdate";
+    case ASTraceSpanRangeUpdate:
+      return @"rangeUpdate";
+    case ASTraceSpanPendingStateFlush:
+      return @"pendingStateFlush";
+    case ASTraceSpanMainSerialQueueDrain:
+      return @"mainSerialQueueDrain";
+    case ASTraceSpanDataControllerRelayout:
+      return @"relayoutAllNodes";
+    case ASTraceSpanEnsureDisplay:
+      return @"ensureDisplay";
+  }
+  return @"unknown";
+}
+
+@implementation ASTraceBuffer
+
++ (BOOL)isEnabled
+{
+  return __enabled.load();
+}
+
++ (void)setEnabled:(BOOL)enabled
+{
+  if (__enabled.exchange(enabled) != enabled) {
+    enabled ? ASTraceBufferRetainRecording() : ASTraceBufferReleaseRecording();
+  }
+}
+
++ (NSData *)chromeTraceData
+{
+  ASTraceBufferKey();
+  std::vector<ASTraceThreadEvents> threads;
+  {
+    ASDN::StaticMutexLocker l(__buffersLock);
+    auto copyBuffer = [&threads](ASTraceThreadBuffer *buffer) {
+      threads.push_back({ buffer->threadID, buffer->threadName, {} });
+      ASTraceCopyEvents(*buffer, threads.back().events);
+    };
+    std::for_each(__retiredBuffers->begin(), __retiredBuffers->end(), copyBuffer);
+    std::for_each(__liveBuffers->begin(), __liveBuffers->end(), copyBuffer);
+  }
+
+  mach_timebase_info_data_t timebase;
+  mach_timebase_info(&timebase);
+  double microsecondsPerTick = (double)timebase.numer / timebase.denom / NSEC_PER_USEC;
+  NSNumber *pid = @(getpid());
+
+  NSMutableArray<NSDictionary *> *traceEvents = [NSMutableArray array];
+  for (const ASTraceThreadEvents &thread : threads) {
+    if (thread.events.empty()) {
+      continue;
+    }
+    NSNumber *tid = @(thread.threadID);
+    if (!thread.threadName.empty()) {
+      [traceEvents addObject:@{ @"name" : @"thread_name", @"ph" : @"M", @"pid" : pid, @"tid" : tid,
+                                @"args" : @{ @"name" : @(thread.threadName.c_str()) } }];
+    }
+    NSUInteger depth = 0;
+    for (const ASTraceEventCopy &event : thread.events) {
+      if (event.phase == ASTracePhaseEnd) {
+        if (depth == 0) {
+          // Its beginning was overwritten or cleared.
+          continue;
+        }
+        depth--;
+      } else {
+        depth++;
+      }
+      NSString *category = ASTraceSpanGetName(event.span);
+      Class cls = (__bridge Class)(void *)event.cls;
+      [traceEvents addObject:@{
+        @"name" : (cls != Nil ? NSStringFromClass(cls) : category),
+        @"cat" : category,
+        @"ph" : (event.phase == ASTracePhaseBegin ? @"B" : @"E"),
+        @"ts" : @(event.timestamp * microsecondsPerTick),
+        @"pid" : pid,
+        @"tid" : tid,
+      }];
+    }
+  }
+  return [NSJSONSerialization dataWithJSONObject:@{ @"traceEvents" : traceEvents, @"displayTimeUnit" : @"ms" } options:0 error:NULL];
+}
+
++ (void)clear
+{
+  ASTraceBufferKey();
+  ASDN::StaticMutexLocker l(__buffersLock);
+  for (ASTraceThreadBuffer *buffer : *__liveBuffers) {
+    buffer->tail.store(buffer->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+  }
+  for (ASTraceThreadBuffer *buffer : *__retiredBuffers) {
+    delete buffer;
+  }
+  __retiredBuffers->clear();
+}
+
+@end
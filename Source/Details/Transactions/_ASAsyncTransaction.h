@@ -36,6 +36,31 @@ typedef NS_ENUM(NSUInteger, ASAsyncTransactionState) {
 
 extern NSInteger const ASDefaultTransactionPriority;
 
+/**
+ Identifies an operation while it waits to be executed, see +cancelOperationWithHandle:. Handles are never reused.
+ */
+typedef NSUInteger ASAsyncTransactionOperationHandle;
+
+extern ASAsyncTransactionOperationHandle const ASAsyncTransactionOperationHandleNone;
+
+/**
+ Counters for the queue that executes the operations of all transactions.
+ */
+typedef struct {
+  /// Operations waiting to be executed.
+  NSUInteger queuedOperationCount;
+  /// The largest number of operations that were waiting at once.
+  NSUInteger maximumQueuedOperationCount;
+  /// Operations that were executed.
+  NSUInteger executedOperationCount;
+  /// Operations that were removed from the queue before being executed, because they were canceled.
+  NSUInteger purgedOperationCount;
+  /// Operations that were executed, but whose results were thrown away. Reported by the owners of the operations.
+  NSUInteger wastedOperationCount;
+  /// The time spent executing the wasted operations.
+  NSTimeInterval wastedDuration;
+} ASAsyncTransactionQueueMetrics;
+
 /**
  @summary ASAsyncTransaction provides lightweight transaction semantics for asynchronous operations.
 
@@ -113,11 +138,12 @@ extern NSInteger const ASDefaultTransactionPriority;
  @param queue The dispatch queue on which to execute the block.
  @param completion The completion block that will be executed with the output of the execution block when all of the
  operations in the transaction are completed. Executed and released on callbackQueue.
+ @return A handle to reprioritize or cancel the operation with until it starts executing.
  */
-- (void)addOperationWithBlock:(asyncdisplaykit_async_transaction_operation_block_t)block
-                     priority:(NSInteger)priority
-                        queue:(dispatch_queue_t)queue
-                   completion:(nullable asyncdisplaykit_async_transaction_operation_completion_block_t)completion;
+- (ASAsyncTransactionOperationHandle)addOperationWithBlock:(asyncdisplaykit_async_transaction_operation_block_t)block
+                                                  priority:(NSInteger)priority
+                                                     queue:(dispatch_queue_t)queue
+                                                completion:(nullable asyncdisplaykit_async_transaction_operation_completion_block_t)completion;
 
 
 /**
@@ -152,11 +178,12 @@ extern NSInteger const ASDefaultTransactionPriority;
  @param queue The dispatch queue on which to execute the block.
  @param completion The completion block that will be executed with the output of the execution block when all of the
  operations in the transaction are completed. Executed and released on callbackQueue.
+ @return A handle to reprioritize or cancel the operation with until it starts executing.
  */
-- (void)addAsyncOperationWithBlock:(asyncdisplaykit_async_transaction_async_operation_block_t)block
-                          priority:(NSInteger)priority
-                             queue:(dispatch_queue_t)queue
-                        completion:(nullable asyncdisplaykit_async_transaction_operation_completion_block_t)completion;
+- (ASAsyncTransactionOperationHandle)addAsyncOperationWithBlock:(asyncdisplaykit_async_transaction_async_operation_block_t)block
+                                                       priority:(NSInteger)priority
+                                                          queue:(dispatch_queue_t)queue
+                                                     completion:(nullable asyncdisplaykit_async_transaction_operation_completion_block_t)completion;
 
 
 
@@ -175,6 +202,7 @@ extern NSInteger const ASDefaultTransactionPriority;
  @desc You can only cancel a committed transaction.
 
  All completion blocks are always called, regardless of cancelation. Execution blocks may be skipped if canceled.
+ Operations that haven't started executing are removed from the queue right away.
  */
 - (void)cancel;
 
@@ -190,6 +218,44 @@ extern NSInteger const ASDefaultTransactionPriority;
  */
 - (void)commit;
 
+/**
+ @summary Removes an operation from the queue if it hasn't started executing.
+
+ @desc The operation's completion block is still called when its transaction completes, with a nil value. Use this
+ when the result of an operation is known to be stale, so that it doesn't hold up the operations queued behind it.
+ May be called on any thread.
+
+ @return YES if the operation was waiting and has been removed.
+ */
++ (BOOL)cancelOperationWithHandle:(ASAsyncTransactionOperationHandle)handle;
+
+/**
+ @summary Changes the priority of an operation that hasn't started executing.
+
+ @desc The operation goes behind the other waiting operations of the new priority. May be called on any thread.
+
+ @return YES if the operation was waiting and has been moved.
+ */
++ (BOOL)setPriority:(NSInteger)priority ofOperationWithHandle:(ASAsyncTransactionOperationHandle)handle;
+
+/**
+ @summary Moves an operation that hasn't started executing ahead of the other waiting operations of its priority.
+
+ @desc May be called on any thread.
+
+ @return YES if the operation was waiting and has been moved.
+ */
++ (BOOL)prioritizeOperationWithHandle:(ASAsyncTransactionOperationHandle)handle;
+
+/**
+ Records that an executed operation's result was thrown away, e.g. because its node started displaying again.
+ */
++ (void)recordWastedOperationWithDuration:(NSTimeInterval)duration;
+
++ (ASAsyncTransactionQueueMetrics)queueMetrics;
+
++ (void)resetQueueMetrics;
+
 @end
 
 NS_ASSUME_NONNULL_END
@@ -20,15 +20,18 @@
 #import <map>
 #import <mutex>
 #import <stdatomic.h>
+#import <unordered_map>
 
 #define ASAsyncTransactionAssertMainThread() NSAssert(0 != pthread_main_np(), @"This method must be called on the main thread");
 
 NSInteger const ASDefaultTransactionPriority = 0;
+ASAsyncTransactionOperationHandle const ASAsyncTransactionOperationHandleNone = 0;
 
 @interface ASAsyncTransactionOperation : NSObject
 - (instancetype)initWithOperationCompletionBlock:(asyncdisplaykit_async_transaction_operation_completion_block_t)operationCompletionBlock;
 @property (nonatomic, copy) asyncdisplaykit_async_transaction_operation_completion_block_t operationCompletionBlock;
 @property (nonatomic, strong) id<NSObject> value; // set on bg queue by the operation block
+@property (nonatomic, assign) ASAsyncTransactionOperationHandle handle;
 @end
 
 @implementation ASAsyncTransactionOperation
@@ -74,8 +77,8 @@ public:
     // call when group is no longer needed; after last scheduled operation the group will delete itself
     virtual void release() = 0;
     
-    // schedule block on given queue
-    virtual void schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block) = 0;
+    // schedule block on given queue, returns a handle to cancel or reprioritize the block with until it runs
+    virtual ASAsyncTransactionOperationHandle schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block) = 0;
     
     // dispatch block on given queue when all previously scheduled blocks finished executing
     virtual void notify(dispatch_queue_t queue, dispatch_block_t block) = 0;
@@ -94,6 +97,19 @@ public:
   // Create new group
   Group *createGroup();
   
+  // remove a scheduled block that hasn't started running; its group is left as if the block had run
+  bool cancel(ASAsyncTransactionOperationHandle handle);
+  
+  // move a scheduled block that hasn't started running behind the other blocks of the given priority
+  bool setPriority(ASAsyncTransactionOperationHandle handle, NSInteger priority);
+  
+  // move a scheduled block that hasn't started running ahead of the other blocks of its priority
+  bool prioritize(ASAsyncTransactionOperationHandle handle);
+  
+  void recordWastedOperation(NSTimeInterval duration);
+  ASAsyncTransactionQueueMetrics metrics();
+  void resetMetrics();
+  
   static ASAsyncTransactionQueue &instance();
   
 private:
@@ -115,7 +131,7 @@ private:
     }
     
     virtual void release();
-    virtual void schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block);
+    virtual ASAsyncTransactionOperationHandle schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block);
     virtual void notify(dispatch_queue_t queue, dispatch_block_t block);
     virtual void enter();
     virtual void leave();
@@ -133,7 +149,10 @@ private:
     dispatch_block_t _block;
     GroupImpl *_group;
     NSInteger _priority;
+    ASAsyncTransactionOperationHandle _handle;
   };
+  
+  struct ScheduledOperation;
     
   struct DispatchEntry // entry for each dispatch queue
   {
@@ -146,10 +165,23 @@ private:
     int _threadCount;
       
     Operation popNextOperation(bool respectPriority);  // assumes locked mutex
-    void pushOperation(Operation operation);           // assumes locked mutex
+    ScheduledOperation pushOperation(Operation operation); // assumes locked mutex
+    Operation removeOperation(const ScheduledOperation &scheduled); // assumes locked mutex
+    void moveOperation(ScheduledOperation &scheduled, NSInteger priority, bool toFront); // assumes locked mutex
+  };
+  
+  // where a scheduled operation is, so that it can be found without walking the queues
+  struct ScheduledOperation
+  {
+    DispatchEntry *_entry;
+    DispatchEntry::OperationQueue::iterator _queueIterator;
+    DispatchEntry::OperationIteratorList::iterator _priorityIterator;
   };
   
   std::map<dispatch_queue_t, DispatchEntry> _entries;
+  std::unordered_map<ASAsyncTransactionOperationHandle, ScheduledOperation> _scheduledOperations;
+  ASAsyncTransactionOperationHandle _lastHandle = ASAsyncTransactionOperationHandleNone;
+  ASAsyncTransactionQueueMetrics _metrics = {};
   std::mutex _mutex;
 };
 
@@ -199,15 +231,48 @@ ASAsyncTransactionQueue::Operation ASAsyncTransactionQueue::DispatchEntry::popNe
   return res;
 }
 
-void ASAsyncTransactionQueue::DispatchEntry::pushOperation(ASAsyncTransactionQueue::Operation operation)
+ASAsyncTransactionQueue::ScheduledOperation ASAsyncTransactionQueue::DispatchEntry::pushOperation(ASAsyncTransactionQueue::Operation operation)
 {
   _operationQueue.push_back(operation);
 
   OperationIteratorList &list = _operationPriorityMap[operation._priority];
   list.push_back(--_operationQueue.end());
+  return {this, --_operationQueue.end(), --list.end()};
+}
+
+ASAsyncTransactionQueue::Operation ASAsyncTransactionQueue::DispatchEntry::removeOperation(const ASAsyncTransactionQueue::ScheduledOperation &scheduled)
+{
+  OperationPriorityMap::iterator mapIterator = _operationPriorityMap.find(scheduled._queueIterator->_priority);
+  NSCAssert(mapIterator != _operationPriorityMap.end(), @"Queue inconsistency");
+  mapIterator->second.erase(scheduled._priorityIterator);
+  if (mapIterator->second.empty()) {
+    _operationPriorityMap.erase(mapIterator);
+  }
+
+  Operation res = *scheduled._queueIterator;
+  _operationQueue.erase(scheduled._queueIterator);
+  return res;
+}
+
+void ASAsyncTransactionQueue::DispatchEntry::moveOperation(ASAsyncTransactionQueue::ScheduledOperation &scheduled, NSInteger priority, bool toFront)
+{
+  OperationQueue::iterator queueIterator = scheduled._queueIterator;
+  OperationPriorityMap::iterator mapIterator = _operationPriorityMap.find(queueIterator->_priority);
+  NSCAssert(mapIterator != _operationPriorityMap.end(), @"Queue inconsistency");
+  mapIterator->second.erase(scheduled._priorityIterator);
+  if (mapIterator->second.empty()) {
+    _operationPriorityMap.erase(mapIterator);
+  }
+
+  // The first thread takes operations in queue order and expects them to come first in their buckets, so move the
+  // operation to the same end of both. Splicing keeps the iterator valid.
+  _operationQueue.splice(toFront ? _operationQueue.begin() : _operationQueue.end(), _operationQueue, queueIterator);
+  queueIterator->_priority = priority;
+  OperationIteratorList &list = _operationPriorityMap[priority];
+  scheduled._priorityIterator = list.insert(toFront ? list.begin() : list.end(), queueIterator);
 }
 
-void ASAsyncTransactionQueue::GroupImpl::schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block)
+ASAsyncTransactionOperationHandle ASAsyncTransactionQueue::GroupImpl::schedule(NSInteger priority, dispatch_queue_t queue, dispatch_block_t block)
 {
   ASAsyncTransactionQueue &q = _queue;
   std::lock_guard<std::mutex> l(q._mutex);
@@ -218,7 +283,10 @@ void ASAsyncTransactionQueue::GroupImpl::schedule(NSInteger priority, dispatch_q
   operation._block = block;
   operation._group = this;
   operation._priority = priority;
-  entry.pushOperation(operation);
+  operation._handle = ++q._lastHandle;
+  q._scheduledOperations.emplace(operation._handle, entry.pushOperation(operation));
+  q._metrics.queuedOperationCount = q._scheduledOperations.size();
+  q._metrics.maximumQueuedOperationCount = MAX(q._metrics.maximumQueuedOperationCount, q._metrics.queuedOperationCount);
   
   ++_pendingOperations; // enter group
   
@@ -244,6 +312,9 @@ void ASAsyncTransactionQueue::GroupImpl::schedule(NSInteger priority, dispatch_q
       // go until there are no more pending operations
       while (!entry._operationQueue.empty()) {
         Operation operation = entry.popNextOperation(respectPriority);
+        q._scheduledOperations.erase(operation._handle);
+        q._metrics.queuedOperationCount = q._scheduledOperations.size();
+        q._metrics.executedOperationCount++;
         lock.unlock();
         if (operation._block) {
           ASProfilingSignpostStart(3, operation._block);
@@ -262,6 +333,8 @@ void ASAsyncTransactionQueue::GroupImpl::schedule(NSInteger priority, dispatch_q
       }
     });
   }
+  
+  return operation._handle;
 }
 
 void ASAsyncTransactionQueue::GroupImpl::notify(dispatch_queue_t queue, dispatch_block_t block)
@@ -315,6 +388,68 @@ void ASAsyncTransactionQueue::GroupImpl::wait()
   }
 }
 
+bool ASAsyncTransactionQueue::cancel(ASAsyncTransactionOperationHandle handle)
+{
+  Operation operation;
+  {
+    std::lock_guard<std::mutex> l(_mutex);
+    auto it = _scheduledOperations.find(handle);
+    if (it == _scheduledOperations.end()) {
+      return false; // already running or done
+    }
+    operation = it->second._entry->removeOperation(it->second);
+    _scheduledOperations.erase(it);
+    _metrics.queuedOperationCount = _scheduledOperations.size();
+    _metrics.purgedOperationCount++;
+  }
+  // The worker threads of the entry stop on their own once it is empty.
+  operation._group->leave();
+  operation._block = nil; // the block must be freed while mutex is unlocked
+  return true;
+}
+
+bool ASAsyncTransactionQueue::setPriority(ASAsyncTransactionOperationHandle handle, NSInteger priority)
+{
+  std::lock_guard<std::mutex> l(_mutex);
+  auto it = _scheduledOperations.find(handle);
+  if (it == _scheduledOperations.end()) {
+    return false;
+  }
+  it->second._entry->moveOperation(it->second, priority, false);
+  return true;
+}
+
+bool ASAsyncTransactionQueue::prioritize(ASAsyncTransactionOperationHandle handle)
+{
+  std::lock_guard<std::mutex> l(_mutex);
+  auto it = _scheduledOperations.find(handle);
+  if (it == _scheduledOperations.end()) {
+    return false;
+  }
+  it->second._entry->moveOperation(it->second, it->second._queueIterator->_priority, true);
+  return true;
+}
+
+void ASAsyncTransactionQueue::recordWastedOperation(NSTimeInterval duration)
+{
+  std::lock_guard<std::mutex> l(_mutex);
+  _metrics.wastedOperationCount++;
+  _metrics.wastedDuration += duration;
+}
+
+ASAsyncTransactionQueueMetrics ASAsyncTransactionQueue::metrics()
+{
+  std::lock_guard<std::mutex> l(_mutex);
+  return _metrics;
+}
+
+void ASAsyncTransactionQueue::resetMetrics()
+{
+  std::lock_guard<std::mutex> l(_mutex);
+  _metrics = {};
+  _metrics.queuedOperationCount = _scheduledOperations.size();
+}
+
 ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
 {
   static ASAsyncTransactionQueue *instance = new ASAsyncTransactionQueue();
@@ -379,10 +514,10 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
                         completion:completion];
 }
 
-- (void)addAsyncOperationWithBlock:(asyncdisplaykit_async_transaction_async_operation_block_t)block
-                          priority:(NSInteger)priority
-                             queue:(dispatch_queue_t)queue
-                        completion:(asyncdisplaykit_async_transaction_operation_completion_block_t)completion
+- (ASAsyncTransactionOperationHandle)addAsyncOperationWithBlock:(asyncdisplaykit_async_transaction_async_operation_block_t)block
+                                                       priority:(NSInteger)priority
+                                                          queue:(dispatch_queue_t)queue
+                                                     completion:(asyncdisplaykit_async_transaction_operation_completion_block_t)completion
 {
   ASAsyncTransactionAssertMainThread();
   NSAssert(self.state == ASAsyncTransactionStateOpen, @"You can only add operations to open transactions");
@@ -391,7 +526,7 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
 
   ASAsyncTransactionOperation *operation = [[ASAsyncTransactionOperation alloc] initWithOperationCompletionBlock:completion];
   [_operations addObject:operation];
-  _group->schedule(priority, queue, ^{
+  operation.handle = _group->schedule(priority, queue, ^{
     @autoreleasepool {
       if (self.state != ASAsyncTransactionStateCanceled) {
         _group->enter();
@@ -402,6 +537,7 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
       }
     }
   });
+  return operation.handle;
 }
 
 - (void)addOperationWithBlock:(asyncdisplaykit_async_transaction_operation_block_t)block
@@ -414,10 +550,10 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
                      completion:completion];
 }
 
-- (void)addOperationWithBlock:(asyncdisplaykit_async_transaction_operation_block_t)block
-                     priority:(NSInteger)priority
-                        queue:(dispatch_queue_t)queue
-                   completion:(asyncdisplaykit_async_transaction_operation_completion_block_t)completion
+- (ASAsyncTransactionOperationHandle)addOperationWithBlock:(asyncdisplaykit_async_transaction_operation_block_t)block
+                                                  priority:(NSInteger)priority
+                                                     queue:(dispatch_queue_t)queue
+                                                completion:(asyncdisplaykit_async_transaction_operation_completion_block_t)completion
 {
   ASAsyncTransactionAssertMainThread();
   NSAssert(self.state == ASAsyncTransactionStateOpen, @"You can only add operations to open transactions");
@@ -426,13 +562,14 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
 
   ASAsyncTransactionOperation *operation = [[ASAsyncTransactionOperation alloc] initWithOperationCompletionBlock:completion];
   [_operations addObject:operation];
-  _group->schedule(priority, queue, ^{
+  operation.handle = _group->schedule(priority, queue, ^{
     @autoreleasepool {
       if (self.state != ASAsyncTransactionStateCanceled) {
         operation.value = block();
       }
     }
   });
+  return operation.handle;
 }
 
 - (void)addCompletionBlock:(asyncdisplaykit_async_transaction_completion_block_t)completion
@@ -449,6 +586,12 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
   ASAsyncTransactionAssertMainThread();
   NSAssert(self.state != ASAsyncTransactionStateOpen, @"You can only cancel a committed or already-canceled transaction");
   self.state = ASAsyncTransactionStateCanceled;
+
+  // Don't leave the operations that haven't started in line ahead of live ones, they would only be skipped.
+  ASAsyncTransactionQueue &queue = ASAsyncTransactionQueue::instance();
+  for (ASAsyncTransactionOperation *operation in _operations) {
+    queue.cancel(operation.handle);
+  }
 }
 
 - (void)commit
@@ -518,6 +661,38 @@ ASAsyncTransactionQueue & ASAsyncTransactionQueue::instance()
   }
 }
 
+#pragma mark - Queued Operations
+
++ (BOOL)cancelOperationWithHandle:(ASAsyncTransactionOperationHandle)handle
+{
+  return ASAsyncTransactionQueue::instance().cancel(handle);
+}
+
++ (BOOL)setPriority:(NSInteger)priority ofOperationWithHandle:(ASAsyncTransactionOperationHandle)handle
+{
+  return ASAsyncTransactionQueue::instance().setPriority(handle, priority);
+}
+
++ (BOOL)prioritizeOperationWithHandle:(ASAsyncTransactionOperationHandle)handle
+{
+  return ASAsyncTransactionQueue::instance().prioritize(handle);
+}
+
++ (void)recordWastedOperationWithDuration:(NSTimeInterval)duration
+{
+  ASAsyncTransactionQueue::instance().recordWastedOperation(duration);
+}
+
++ (ASAsyncTransactionQueueMetrics)queueMetrics
+{
+  return ASAsyncTransactionQueue::instance().metrics();
+}
+
++ (void)resetQueueMetrics
+{
+  ASAsyncTransactionQueue::instance().resetMetrics();
+}
+
 #pragma mark -
 #pragma mark Helper Methods
 
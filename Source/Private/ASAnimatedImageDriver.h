@@ -0,0 +1,67 @@
+//
+//  ASAnimatedImageDriver.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <QuartzCore/QuartzCore.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASImageNode.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSUInteger, ASAnimatedImageDriverTickResult) {
+  /// The client put a new frame on screen.
+  ASAnimatedImageDriverTickResultUpdated,
+  /// The client's frame didn't change.
+  ASAnimatedImageDriverTickResultUnchanged,
+  /// The client chose not to do any work this frame.
+  ASAnimatedImageDriverTickResultThrottled,
+};
+
+@protocol ASAnimatedImageDriverClient <NSObject>
+
+/**
+ * Called once per frame on the main thread while the client is registered.
+ *
+ * @param timestamp The display link timestamp, shared by every client ticked in the same pass.
+ */
+- (ASAnimatedImageDriverTickResult)animatedImageDriverTickWithTimestamp:(CFTimeInterval)timestamp;
+
+@end
+
+/**
+ * A single animation clock for animated images.
+ *
+ * Each run loop mode in use gets one display link, and every registered client is ticked from it in one pass inside
+ * a single CATransaction, instead of every node running its own display link and transaction. The display links run
+ * at half rate while Low Power Mode is enabled and are torn down when their last client is removed.
+ *
+ * Clients are held weakly. Registration may happen on any thread; ticks always happen on the main thread.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASAnimatedImageDriver : NSObject
+
++ (ASAnimatedImageDriver *)sharedDriver;
+
+- (void)addClient:(id <ASAnimatedImageDriverClient>)client runLoopMode:(NSString *)runLoopMode;
+
+- (void)removeClient:(id <ASAnimatedImageDriverClient>)client;
+
+/**
+ * The number of registered clients. Main thread only.
+ */
+- (NSUInteger)clientCount;
+
+- (ASAnimatedImagePlaybackMetrics)metrics;
+
+- (void)resetMetrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
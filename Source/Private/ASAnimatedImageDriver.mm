@@ -0,0 +1,200 @@
+//
+//  ASAnimatedImageDriver.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASAnimatedImageDriver.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASThread.h>
+#import <AsyncDisplayKit/ASWeakProxy.h>
+
+/**
+ * The display link and clients of one run loop mode.
+ */
+@interface ASAnimatedImageDriverRunLoopMode : NSObject
+@property (nonatomic, strong) CADisplayLink *displayLink;
+@property (nonatomic, strong) NSHashTable<id <ASAnimatedImageDriverClient>> *clients;
+@end
+
+@implementation ASAnimatedImageDriverRunLoopMode
+@end
+
+@implementation ASAnimatedImageDriver {
+  // Everything below is only accessed on the main thread.
+  NSMutableDictionary<NSString *, ASAnimatedImageDriverRunLoopMode *> *_runLoopModes;
+  // Clients are usually registered in a single mode, but nothing stops a node from changing its mode while animating.
+  NSMapTable<id, NSString *> *_clientRunLoopModes;
+  BOOL _lowPowerModeEnabled;
+
+  ASDN::Mutex _metricsLock;
+  ASAnimatedImagePlaybackMetrics _metrics;
+}
+
++ (ASAnimatedImageDriver *)sharedDriver
+{
+  static ASAnimatedImageDriver *sharedDriver = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedDriver = [[ASAnimatedImageDriver alloc] init];
+  });
+  return sharedDriver;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _runLoopModes = [NSMutableDictionary dictionary];
+    _clientRunLoopModes = [NSMapTable weakToStrongObjectsMapTable];
+
+    NSProcessInfo *processInfo = [NSProcessInfo processInfo];
+    if ([processInfo respondsToSelector:@selector(isLowPowerModeEnabled)]) {
+      _lowPowerModeEnabled = processInfo.lowPowerModeEnabled;
+      [[NSNotificationCenter defaultCenter] addObserver:self
+                                               selector:@selector(powerStateDidChange:)
+                                                   name:NSProcessInfoPowerStateDidChangeNotification
+                                                 object:nil];
+    }
+  }
+  return self;
+}
+
+- (void)powerStateDidChange:(NSNotification *)notification
+{
+  // Posted on an arbitrary thread.
+  ASPerformBlockOnMainThread(^{
+    _lowPowerModeEnabled = [NSProcessInfo processInfo].lowPowerModeEnabled;
+    for (ASAnimatedImageDriverRunLoopMode *runLoopMode in _runLoopModes.allValues) {
+      runLoopMode.displayLink.frameInterval = [self _displayLinkFrameInterval];
+    }
+  });
+}
+
+- (NSInteger)_displayLinkFrameInterval
+{
+  return _lowPowerModeEnabled ? 2 : 1;
+}
+
+#pragma mark Registration
+
+- (void)addClient:(id<ASAnimatedImageDriverClient>)client runLoopMode:(NSString *)runLoopMode
+{
+  ASPerformBlockOnMainThread(^{
+    [self _removeClient:client];
+
+    ASAnimatedImageDriverRunLoopMode *mode = _runLoopModes[runLoopMode];
+    if (mode == nil) {
+      mode = [[ASAnimatedImageDriverRunLoopMode alloc] init];
+      mode.clients = [NSHashTable weakObjectsHashTable];
+      mode.displayLink = [CADisplayLink displayLinkWithTarget:[ASWeakProxy weakProxyWithTarget:self] selector:@selector(displayLinkFired:)];
+      mode.displayLink.frameInterval = [self _displayLinkFrameInterval];
+      [mode.displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:runLoopMode];
+      _runLoopModes[runLoopMode] = mode;
+    }
+    [mode.clients addObject:client];
+    [_clientRunLoopModes setObject:runLoopMode forKey:client];
+  });
+}
+
+- (void)removeClient:(id<ASAnimatedImageDriverClient>)client
+{
+  ASPerformBlockOnMainThread(^{
+    [self _removeClient:client];
+  });
+}
+
+- (void)_removeClient:(id<ASAnimatedImageDriverClient>)client
+{
+  ASDisplayNodeAssertMainThread();
+  NSString *runLoopMode = [_clientRunLoopModes objectForKey:client];
+  if (runLoopMode == nil) {
+    return;
+  }
+  [_clientRunLoopModes removeObjectForKey:client];
+  ASAnimatedImageDriverRunLoopMode *mode = _runLoopModes[runLoopMode];
+  [mode.clients removeObject:client];
+  [self _invalidateRunLoopModeIfUnused:runLoopMode];
+}
+
+- (void)_invalidateRunLoopModeIfUnused:(NSString *)runLoopMode
+{
+  ASAnimatedImageDriverRunLoopMode *mode = _runLoopModes[runLoopMode];
+  // Weak entries of deallocated clients still count towards NSHashTable's count, so check the live objects.
+  if (mode != nil && mode.clients.anyObject == nil) {
+    [mode.displayLink invalidate];
+    [_runLoopModes removeObjectForKey:runLoopMode];
+  }
+}
+
+- (NSUInteger)clientCount
+{
+  ASDisplayNodeAssertMainThread();
+  NSUInteger clientCount = 0;
+  for (ASAnimatedImageDriverRunLoopMode *mode in _runLoopModes.allValues) {
+    clientCount += mode.clients.allObjects.count;
+  }
+  return clientCount;
+}
+
+#pragma mark Ticking
+
+- (void)displayLinkFired:(CADisplayLink *)displayLink
+{
+  ASDisplayNodeAssertMainThread();
+  CFTimeInterval start = CACurrentMediaTime();
+
+  NSString *runLoopMode = nil;
+  for (NSString *mode in _runLoopModes) {
+    if (_runLoopModes[mode].displayLink == displayLink) {
+      runLoopMode = mode;
+      break;
+    }
+  }
+  NSArray<id <ASAnimatedImageDriverClient>> *clients = _runLoopModes[runLoopMode].clients.allObjects;
+  if (clients.count == 0) {
+    // Every client was deallocated without being removed.
+    [self _invalidateRunLoopModeIfUnused:runLoopMode];
+    return;
+  }
+
+  NSUInteger results[3] = {};
+
+  // One transaction for every node's new frame, without implicit animations.
+  [CATransaction begin];
+  [CATransaction setDisableActions:YES];
+  for (id <ASAnimatedImageDriverClient> client in clients) {
+    results[[client animatedImageDriverTickWithTimestamp:displayLink.timestamp]] += 1;
+  }
+  [CATransaction commit];
+
+  CFTimeInterval duration = CACurrentMediaTime() - start;
+  ASDN::MutexLocker l(_metricsLock);
+  _metrics.updatedNodeCount += results[ASAnimatedImageDriverTickResultUpdated];
+  _metrics.unchangedNodeCount += results[ASAnimatedImageDriverTickResultUnchanged];
+  _metrics.throttledNodeCount += results[ASAnimatedImageDriverTickResultThrottled];
+  _metrics.frameCount += 1;
+  _metrics.totalFrameDuration += duration;
+  _metrics.maxFrameDuration = MAX(_metrics.maxFrameDuration, duration);
+}
+
+#pragma mark Metrics
+
+- (ASAnimatedImagePlaybackMetrics)metrics
+{
+  ASDN::MutexLocker l(_metricsLock);
+  return _metrics;
+}
+
+- (void)resetMetrics
+{
+  ASDN::MutexLocker l(_metricsLock);
+  _metrics = {};
+}
+
+@end
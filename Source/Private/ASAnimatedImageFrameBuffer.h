@@ -0,0 +1,84 @@
+//
+//  ASAnimatedImageFrameBuffer.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <QuartzCore/QuartzCore.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASImageProtocols.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Frame lookup and background predecoding for the playback of an animated image.
+ *
+ * The frame shown at a play head position is found with a binary search over the running sum of the frame
+ * durations, rather than by walking every frame on every display link tick.
+ *
+ * Each consumer (an image node) has a window of frames starting at its current frame. A serial background queue
+ * decodes the frames in every window into bitmaps ahead of time, and frames that fall out of all windows are released.
+ * The total size of the windows is bounded by +maximumBufferedByteCount, and shrinks to a single frame for a while
+ * after a memory warning.
+ *
+ * Nodes showing the same animated image object share one buffer, and so one decoder, through
+ * +frameBufferForAnimatedImage:. This class is thread-safe.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASAnimatedImageFrameBuffer : NSObject
+
+/**
+ * Returns the buffer shared by everything currently playing the animated image, creating one if needed.
+ */
++ (ASAnimatedImageFrameBuffer *)frameBufferForAnimatedImage:(id <ASAnimatedImageProtocol>)animatedImage;
+
+- (instancetype)initWithAnimatedImage:(id <ASAnimatedImageProtocol>)animatedImage NS_DESIGNATED_INITIALIZER;
+
+- (instancetype)init NS_UNAVAILABLE;
+
+/**
+ * The maximum number of bytes of predecoded frames held by each buffer. Defaults to 8MB.
+ */
+@property (class, atomic, assign) NSUInteger maximumBufferedByteCount;
+
+@property (nonatomic, strong, readonly) id <ASAnimatedImageProtocol> animatedImage;
+
+/**
+ * The index of the frame shown at the play head position, which must be within [0, totalDuration]. Only valid once
+ * playback is ready.
+ */
+- (NSUInteger)frameIndexAtPlayHead:(CFTimeInterval)playHead;
+
+/**
+ * Moves the consumer's window to start at the frame and returns it. Predecoded frames are returned from the buffer;
+ * otherwise this falls back to asking the animated image, which may return NULL if the frame isn't ready.
+ */
+- (nullable CGImageRef)frameAtIndex:(NSUInteger)index forConsumer:(id)consumer CF_RETURNS_NOT_RETAINED;
+
+/**
+ * Sets the number of frames to keep predecoded for the consumer, starting at the given frame. Passing 0 removes the
+ * consumer and releases the frames only it needed. Consumers are held weakly.
+ */
+- (void)setLookaheadFrameCount:(NSUInteger)lookaheadFrameCount startingAtIndex:(NSUInteger)index forConsumer:(id)consumer;
+
+- (void)removeAllFrames;
+
+/**
+ * The number of predecoded frames currently held.
+ */
+- (NSUInteger)bufferedFrameCount;
+
+/**
+ * Calls to -frameAtIndex:forConsumer: served from the buffer, and calls that fell back to the animated image.
+ */
+- (NSUInteger)hitCount;
+- (NSUInteger)missCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,383 @@
+//
+//  ASAnimatedImageFrameBuffer.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASAnimatedImageFrameBuffer.h>
+
+#import <UIKit/UIKit.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#import <AsyncDisplayKit/ASInternalHelpers.h>
+#import <AsyncDisplayKit/ASThread.h>
+
+static const NSUInteger kASAnimatedImageFrameBufferDefaultMaximumByteCount = 8 * 1024 * 1024;
+
+/// How long buffers hold at most one frame per consumer after a memory warning.
+static const CFTimeInterval kASAnimatedImageFrameBufferMemoryWarningCooldown = 10;
+
+static std::atomic<NSUInteger> __maximumBufferedByteCount(kASAnimatedImageFrameBufferDefaultMaximumByteCount);
+static std::atomic<CFTimeInterval> __lastMemoryWarningTime(0);
+
+/**
+ * Draws the frame into a bitmap so that it is decoded here rather than when Core Animation first renders it.
+ */
+static CGImageRef ASAnimatedImageCreateDecodedFrame(CGImageRef frame)
+{
+  size_t width = CGImageGetWidth(frame);
+  size_t height = CGImageGetHeight(frame);
+  BOOL opaque = ASImageAlphaInfoIsOpaque(CGImageGetAlphaInfo(frame));
+  CGBitmapInfo bitmapInfo = kCGBitmapByteOrder32Host | (opaque ? kCGImageAlphaNoneSkipFirst : kCGImageAlphaPremultipliedFirst);
+
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context = CGBitmapContextCreate(NULL, width, height, 8, 0, colorSpace, bitmapInfo);
+  CGColorSpaceRelease(colorSpace);
+  if (context == NULL) {
+    return CGImageRetain(frame);
+  }
+
+  CGContextDrawImage(context, CGRectMake(0, 0, width, height), frame);
+  CGImageRef decodedFrame = CGBitmapContextCreateImage(context);
+  CGContextRelease(context);
+  return decodedFrame ? : CGImageRetain(frame);
+}
+
+@interface ASAnimatedImageFrameBufferCursor : NSObject
+{
+@package
+  NSUInteger _index;
+  NSUInteger _lookaheadFrameCount;
+}
+@end
+
+@implementation ASAnimatedImageFrameBufferCursor
+@end
+
+@implementation ASAnimatedImageFrameBuffer {
+  ASDN::Mutex _lock;
+  // _frameEndTimes[i] is the play head position at which frame i ends. Built once playback is ready.
+  std::vector<CFTimeInterval> _frameEndTimes;
+  // One slot per frame; only slots inside some consumer's window are non-NULL.
+  std::vector<CGImageRef> _frames;
+  NSUInteger _bufferedFrameCount;
+  // Bytes per decoded frame, known after the first one is decoded.
+  NSUInteger _frameByteCount;
+  NSMapTable<id, ASAnimatedImageFrameBufferCursor *> *_cursors;
+  dispatch_queue_t _decodeQueue;
+  BOOL _decoding;
+  NSUInteger _hitCount;
+  NSUInteger _missCount;
+}
+
+#pragma mark Sharing
+
+static NSMapTable<id, ASAnimatedImageFrameBuffer *> *__frameBuffers = nil;
+static ASDN::StaticMutex __frameBuffersLock = ASDISPLAYNODE_MUTEX_INITIALIZER;
+
++ (ASAnimatedImageFrameBuffer *)frameBufferForAnimatedImage:(id<ASAnimatedImageProtocol>)animatedImage
+{
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    // Buffers live as long as a node is using them; the table doesn't keep them alive.
+    __frameBuffers = [NSMapTable weakToWeakObjectsMapTable];
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(didReceiveMemoryWarning:)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+  });
+
+  ASDN::StaticMutexLocker l(__frameBuffersLock);
+  ASAnimatedImageFrameBuffer *frameBuffer = [__frameBuffers objectForKey:animatedImage];
+  if (frameBuffer == nil) {
+    frameBuffer = [[ASAnimatedImageFrameBuffer alloc] initWithAnimatedImage:animatedImage];
+    [__frameBuffers setObject:frameBuffer forKey:animatedImage];
+  }
+  return frameBuffer;
+}
+
++ (void)didReceiveMemoryWarning:(NSNotification *)notification
+{
+  __lastMemoryWarningTime = CACurrentMediaTime();
+
+  NSArray<ASAnimatedImageFrameBuffer *> *frameBuffers;
+  {
+    ASDN::StaticMutexLocker l(__frameBuffersLock);
+    frameBuffers = [[__frameBuffers objectEnumerator] allObjects];
+  }
+  for (ASAnimatedImageFrameBuffer *frameBuffer in frameBuffers) {
+    [frameBuffer removeAllFrames];
+  }
+}
+
++ (NSUInteger)maximumBufferedByteCount
+{
+  return __maximumBufferedByteCount;
+}
+
++ (void)setMaximumBufferedByteCount:(NSUInteger)maximumBufferedByteCount
+{
+  __maximumBufferedByteCount = maximumBufferedByteCount;
+}
+
+#pragma mark Lifecycle
+
+- (instancetype)initWithAnimatedImage:(id<ASAnimatedImageProtocol>)animatedImage
+{
+  if (self = [super init]) {
+    _animatedImage = animatedImage;
+    _cursors = [NSMapTable weakToStrongObjectsMapTable];
+    _decodeQueue = dispatch_queue_create("org.AsyncDisplayKit.ASAnimatedImageFrameBuffer.decodeQueue", DISPATCH_QUEUE_SERIAL);
+    dispatch_set_target_queue(_decodeQueue, dispatch_get_global_queue(QOS_CLASS_UTILITY, 0));
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  for (CGImageRef frame : _frames) {
+    CGImageRelease(frame);
+  }
+}
+
+#pragma mark Frame Lookup
+
+- (BOOL)_locked_prepareIfNeeded
+{
+  if (_frameEndTimes.empty() == NO) {
+    return YES;
+  }
+  if (_animatedImage.playbackReady == NO) {
+    return NO;
+  }
+
+  size_t frameCount = _animatedImage.frameCount;
+  if (frameCount == 0) {
+    return NO;
+  }
+  _frameEndTimes.reserve(frameCount);
+  CFTimeInterval endTime = 0;
+  for (size_t i = 0; i < frameCount; i++) {
+    endTime += [_animatedImage durationAtIndex:i];
+    _frameEndTimes.push_back(endTime);
+  }
+  _frames.assign(frameCount, NULL);
+  return YES;
+}
+
+- (NSUInteger)frameIndexAtPlayHead:(CFTimeInterval)playHead
+{
+  ASDN::MutexLocker l(_lock);
+  if ([self _locked_prepareIfNeeded] == NO) {
+    return 0;
+  }
+  // The first frame that ends after the play head.
+  auto it = std::upper_bound(_frameEndTimes.begin(), _frameEndTimes.end(), playHead);
+  return MIN((NSUInteger)(it - _frameEndTimes.begin()), _frameEndTimes.size() - 1);
+}
+
+- (CGImageRef)frameAtIndex:(NSUInteger)index forConsumer:(id)consumer
+{
+  {
+    ASDN::MutexLocker l(_lock);
+    if ([self _locked_prepareIfNeeded] && index < _frames.size()) {
+      ASAnimatedImageFrameBufferCursor *cursor = [self _locked_cursorForConsumer:consumer];
+      NSUInteger previousIndex = cursor->_index;
+      cursor->_index = index;
+      [self _locked_releaseUnneededFramesFromIndex:previousIndex toIndex:index];
+      [self _locked_decodeIfNeeded];
+
+      CGImageRef frame = _frames[index];
+      if (frame != NULL) {
+        _hitCount += 1;
+        // The decoder may release the slot as soon as the lock is dropped.
+        return (CGImageRef)CFAutorelease(CGImageRetain(frame));
+      }
+      _missCount += 1;
+    }
+  }
+
+  return [_animatedImage imageAtIndex:index];
+}
+
+#pragma mark Windows
+
+- (ASAnimatedImageFrameBufferCursor *)_locked_cursorForConsumer:(id)consumer
+{
+  ASAnimatedImageFrameBufferCursor *cursor = [_cursors objectForKey:consumer];
+  if (cursor == nil) {
+    cursor = [[ASAnimatedImageFrameBufferCursor alloc] init];
+    cursor->_lookaheadFrameCount = 1;
+    [_cursors setObject:cursor forKey:consumer];
+  }
+  return cursor;
+}
+
+- (void)setLookaheadFrameCount:(NSUInteger)lookaheadFrameCount startingAtIndex:(NSUInteger)index forConsumer:(id)consumer
+{
+  ASDN::MutexLocker l(_lock);
+  if (lookaheadFrameCount == 0) {
+    [_cursors removeObjectForKey:consumer];
+  } else {
+    ASAnimatedImageFrameBufferCursor *cursor = [self _locked_cursorForConsumer:consumer];
+    cursor->_index = index;
+    cursor->_lookaheadFrameCount = lookaheadFrameCount;
+  }
+
+  // Windows changed arbitrarily; this is rare enough to rescan every frame.
+  for (NSUInteger i = 0; i < _frames.size(); i++) {
+    [self _locked_releaseFrameAtIndexIfUnneeded:i];
+  }
+  if ([self _locked_prepareIfNeeded]) {
+    [self _locked_decodeIfNeeded];
+  }
+}
+
+- (NSUInteger)_locked_effectiveLookaheadForCursor:(ASAnimatedImageFrameBufferCursor *)cursor
+{
+  NSUInteger lookahead = MIN(cursor->_lookaheadFrameCount, _frames.size());
+  if (CACurrentMediaTime() - __lastMemoryWarningTime < kASAnimatedImageFrameBufferMemoryWarningCooldown) {
+    return MIN(lookahead, 1);
+  }
+  if (_frameByteCount > 0) {
+    NSUInteger framesPerCursor = __maximumBufferedByteCount / _frameByteCount / MAX(_cursors.count, 1);
+    lookahead = MIN(lookahead, MAX(framesPerCursor, 1));
+  }
+  return lookahead;
+}
+
+- (BOOL)_locked_isFrameNeeded:(NSUInteger)index
+{
+  NSUInteger frameCount = _frames.size();
+  for (ASAnimatedImageFrameBufferCursor *cursor in [_cursors objectEnumerator]) {
+    // Windows wrap around to the first frame, as playback does.
+    NSUInteger distance = (index + frameCount - cursor->_index % frameCount) % frameCount;
+    if (distance < [self _locked_effectiveLookaheadForCursor:cursor]) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+- (void)_locked_releaseFrameAtIndexIfUnneeded:(NSUInteger)index
+{
+  if (_frames[index] != NULL && [self _locked_isFrameNeeded:index] == NO) {
+    CGImageRelease(_frames[index]);
+    _frames[index] = NULL;
+    _bufferedFrameCount -= 1;
+  }
+}
+
+/**
+ * A cursor moving forward leaves behind only the frames it passed, so only those need checking.
+ */
+- (void)_locked_releaseUnneededFramesFromIndex:(NSUInteger)fromIndex toIndex:(NSUInteger)toIndex
+{
+  NSUInteger frameCount = _frames.size();
+  NSUInteger distance = (toIndex + frameCount - fromIndex % frameCount) % frameCount;
+  for (NSUInteger i = 0; i < distance; i++) {
+    [self _locked_releaseFrameAtIndexIfUnneeded:(fromIndex + i) % frameCount];
+  }
+}
+
+- (NSUInteger)_locked_nextFrameIndexToDecode
+{
+  NSUInteger frameCount = _frames.size();
+  for (ASAnimatedImageFrameBufferCursor *cursor in [_cursors objectEnumerator]) {
+    NSUInteger lookahead = [self _locked_effectiveLookaheadForCursor:cursor];
+    for (NSUInteger i = 0; i < lookahead; i++) {
+      NSUInteger index = (cursor->_index + i) % frameCount;
+      if (_frames[index] == NULL) {
+        return index;
+      }
+    }
+  }
+  return NSNotFound;
+}
+
+#pragma mark Decoding
+
+- (void)_locked_decodeIfNeeded
+{
+  if (_decoding || [self _locked_nextFrameIndexToDecode] == NSNotFound) {
+    return;
+  }
+  _decoding = YES;
+  dispatch_async(_decodeQueue, ^{
+    [self _decodeFrames];
+  });
+}
+
+- (void)_decodeFrames
+{
+  while (YES) {
+    NSUInteger index;
+    {
+      ASDN::MutexLocker l(_lock);
+      index = [self _locked_nextFrameIndexToDecode];
+      if (index == NSNotFound) {
+        _decoding = NO;
+        return;
+      }
+    }
+
+    CGImageRef frame = CGImageRetain([_animatedImage imageAtIndex:index]);
+    CGImageRef decodedFrame = frame ? ASAnimatedImageCreateDecodedFrame(frame) : NULL;
+    CGImageRelease(frame);
+
+    ASDN::MutexLocker l(_lock);
+    if (decodedFrame == NULL) {
+      // The animated image hasn't produced this frame yet. The next lookup will try again.
+      _decoding = NO;
+      return;
+    }
+    if (_frameByteCount == 0) {
+      _frameByteCount = CGImageGetBytesPerRow(decodedFrame) * CGImageGetHeight(decodedFrame);
+    }
+    if (_frames[index] == NULL && [self _locked_isFrameNeeded:index]) {
+      _frames[index] = decodedFrame;
+      _bufferedFrameCount += 1;
+    } else {
+      CGImageRelease(decodedFrame);
+    }
+  }
+}
+
+- (void)removeAllFrames
+{
+  ASDN::MutexLocker l(_lock);
+  for (CGImageRef &frame : _frames) {
+    CGImageRelease(frame);
+    frame = NULL;
+  }
+  _bufferedFrameCount = 0;
+}
+
+#pragma mark Metrics
+
+- (NSUInteger)bufferedFrameCount
+{
+  ASDN::MutexLocker l(_lock);
+  return _bufferedFrameCount;
+}
+
+- (NSUInteger)hitCount
+{
+  ASDN::MutexLocker l(_lock);
+  return _hitCount;
+}
+
+- (NSUInteger)missCount
+{
+  ASDN::MutexLocker l(_lock);
+  return _missCount;
+}
+
+@end
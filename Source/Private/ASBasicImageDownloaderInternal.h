@@ -8,14 +8,118 @@
 //  of patent rights can be found in the PATENTS file in the same directory.
 //
 
+#import <AsyncDisplayKit/ASBasicImageDownloader.h>
+
+@class ASBasicImageDownloaderContext;
+
+/**
+ * A single call to -downloadImageWithURL:..., returned as its download identifier. Concurrent requests for the same
+ * URL share a context, but each keeps its own callbacks, target size and priority.
+ */
+@interface ASBasicImageDownloaderRequest : NSObject
+
+- (instancetype)initWithCallbackQueue:(dispatch_queue_t)callbackQueue
+                      targetPixelSize:(CGSize)targetPixelSize
+                     downloadProgress:(ASImageDownloaderProgress)downloadProgress
+                           completion:(ASImageDownloaderCompletion)completion;
+
+@property (nonatomic, strong, readonly) dispatch_queue_t callbackQueue;
+@property (nonatomic, assign, readonly) CGSize targetPixelSize;
+@property (nonatomic, copy, readonly) ASImageDownloaderProgress downloadProgress;
+@property (nonatomic, copy, readonly) ASImageDownloaderCompletion completion;
+
+/**
+ * The priority last set for this request. Defaults to ASImageDownloaderPriorityImminent.
+ */
+@property (atomic, assign) ASImageDownloaderPriority priority;
+
+/**
+ * The context the request joined.
+ */
+@property (atomic, strong) ASBasicImageDownloaderContext *context;
+
+@end
+
 @interface ASBasicImageDownloaderContext : NSObject
 
 + (ASBasicImageDownloaderContext *)contextForURL:(NSURL *)URL;
 
+/**
+ * Adds the request to the in-flight context for the URL, creating one if there is none, and sets the request's
+ * context. Atomic with respect to contexts completing or being cancelled, which unregister themselves first.
+ */
++ (ASBasicImageDownloaderContext *)contextForURL:(NSURL *)URL joiningRequest:(ASBasicImageDownloaderRequest *)request createdContext:(BOOL *)createdContext;
++ (void)removeContext:(ASBasicImageDownloaderContext *)context;
+
 @property (nonatomic, strong, readonly) NSURL *URL;
 @property (nonatomic, weak) NSURLSessionTask *sessionTask;
 
+/**
+ * The size to decode the downloaded image at, covering every coalesced request still waiting. CGSizeZero if any of
+ * them wants the full size image.
+ */
+@property (nonatomic, assign, readonly) CGSize targetPixelSize;
+
+/**
+ * The priority the download is scheduled at. Defaults to ASImageDownloaderPriorityImminent. Only set by the download
+ * scheduler, to the highest priority of the context's requests.
+ */
+@property (atomic, assign) ASImageDownloaderPriority priority;
+
+/**
+ * The highest priority of the requests still attached.
+ */
+- (ASImageDownloaderPriority)highestRequestPriority;
+
+/**
+ * When the download was first given ASImageDownloaderPriorityVisible, in CACurrentMediaTime() units, or 0.
+ */
+@property (atomic, assign, readonly) CFTimeInterval visibleTime;
+
+/**
+ * Whether the context has been handed to the download scheduler. Only accessed with the scheduler's lock held.
+ */
+@property (nonatomic, assign) BOOL scheduled;
+
 - (BOOL)isCancelled;
 - (void)cancel;
 
+/**
+ * Adds a request. Returns NO if the context has already completed or was cancelled, in which case the request would
+ * never be called back and needs a new context.
+ */
+- (BOOL)addRequest:(ASBasicImageDownloaderRequest *)request AS_WARN_UNUSED_RESULT;
+
+/**
+ * Removes a request, e.g. because it was cancelled. Cancels the context and returns YES if it was the last one.
+ */
+- (BOOL)removeRequest:(ASBasicImageDownloaderRequest *)request;
+
+/**
+ * Calls the completion block of every request, and removes the context so later requests start over.
+ */
+- (void)completeWithImage:(UIImage *)image error:(NSError *)error;
+
+/**
+ * Calls the completion block of every request that the image, decoded at decodedPixelSize (CGSizeZero for full size),
+ * is large enough for. Returns NO if requests that need a larger image are left; they stay attached, and their
+ * -targetPixelSize is the size to decode at next. Otherwise removes the context like -completeWithImage:error:.
+ */
+- (BOOL)completeWithImage:(UIImage *)image decodedPixelSize:(CGSize)decodedPixelSize error:(NSError *)error AS_WARN_UNUSED_RESULT;
+
+@end
+
+@interface ASBasicImageDownloader (Internal)
+
+/**
+ * Creates a downloader that isn't the shared instance, e.g. to route requests through a custom NSURLProtocol in tests.
+ * It gets its own cache in a new temporary directory, so it never touches the shared downloader's files.
+ */
+- (instancetype)_initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration;
+
+/**
+ * Creates a downloader that isn't the shared instance and stores images in the given cache.
+ */
+- (instancetype)_initWithSessionConfiguration:(NSURLSessionConfiguration *)configuration cache:(ASBasicImageCache *)cache;
+
 @end
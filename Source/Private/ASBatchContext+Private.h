@@ -0,0 +1,26 @@
+//
+//  ASBatchContext+Private.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASBatchContext.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ASBatchContext (Private)
+
+/**
+ * Variants of -beginBatchFetching and -completeBatchFetching: that take the time of the event, so that fetch
+ * durations can be driven from a simulated clock.
+ */
+- (void)beginBatchFetchingAtTime:(CFTimeInterval)time;
+- (void)completeBatchFetching:(BOOL)didComplete atTime:(CFTimeInterval)time;
+
+@end
+
+NS_ASSUME_NONNULL_END
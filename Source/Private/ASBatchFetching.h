@@ -24,6 +24,22 @@ ASDISPLAYNODE_EXTERN_C_BEGIN
 
 @end
 
+/**
+ * A running estimate of how fast a scroll view's content offset is changing.
+ */
+typedef struct {
+  CGPoint contentOffset;
+  CFTimeInterval timestamp;
+  /// In points per second, in the direction the content offset is changing.
+  CGPoint velocity;
+} ASBatchFetchingVelocityEstimate;
+
+/**
+ @abstract Folds a content offset sample, e.g. from -scrollViewDidScroll:, into a velocity estimate.
+ @discussion Successive samples are smoothed so that a single uneven frame doesn't swing the estimate.
+ */
+extern void ASBatchFetchingVelocityEstimateAddSample(ASBatchFetchingVelocityEstimate *estimate, CGPoint contentOffset, CFTimeInterval timestamp);
+
 /**
  @abstract Determine if batch fetching should begin based on the state of the parameters.
  @discussion This method is broken into a category for unit testing purposes and should be used with the ASTableView and
@@ -32,9 +48,10 @@ ASDISPLAYNODE_EXTERN_C_BEGIN
  @param scrollDirection The current scrolling direction of the scroll view.
  @param scrollableDirections The possible scrolling directions of the scroll view.
  @param contentOffset The offset that the scrollview will scroll to.
+ @param velocity The velocity of the content offset in points per second, or CGPointZero if it isn't moving.
  @return Whether or not the current state should proceed with batch fetching.
  */
-BOOL ASDisplayShouldFetchBatchForScrollView(UIScrollView<ASBatchFetchingScrollView> *scrollView, ASScrollDirection scrollDirection, ASScrollDirection scrollableDirections, CGPoint contentOffset);
+BOOL ASDisplayShouldFetchBatchForScrollView(UIScrollView<ASBatchFetchingScrollView> *scrollView, ASScrollDirection scrollDirection, ASScrollDirection scrollableDirections, CGPoint contentOffset, CGPoint velocity);
 
 
 /**
@@ -60,4 +77,22 @@ extern BOOL ASDisplayShouldFetchBatchForContext(ASBatchContext *context,
                                                 CGFloat leadingScreens,
                                                 BOOL visible);
 
+/**
+ @abstract Determine if batch fetching should begin, taking into account how soon the end of content will be reached.
+ @param velocity The velocity of the content offset in points per second.
+ @discussion Takes the same parameters as ASDisplayShouldFetchBatchForContext, which only looks at the remaining distance.
+ * In addition, once the context has timed a completed fetch, a fetch begins when the end of content would be reached
+ * at the current velocity before a fetch started now is expected to complete, with some headroom for fetches that
+ * run long.
+ */
+extern BOOL ASDisplayShouldFetchBatchForContextWithVelocity(ASBatchContext *context,
+                                                            ASScrollDirection scrollDirection,
+                                                            ASScrollDirection scrollableDirections,
+                                                            CGRect bounds,
+                                                            CGSize contentSize,
+                                                            CGPoint targetOffset,
+                                                            CGFloat leadingScreens,
+                                                            BOOL visible,
+                                                            CGPoint velocity);
+
 ASDISPLAYNODE_EXTERN_C_END
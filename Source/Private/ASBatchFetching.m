@@ -11,7 +11,29 @@
 #import <AsyncDisplayKit/ASBatchFetching.h>
 #import <AsyncDisplayKit/ASBatchContext.h>
 
-BOOL ASDisplayShouldFetchBatchForScrollView(UIScrollView<ASBatchFetchingScrollView> *scrollView, ASScrollDirection scrollDirection, ASScrollDirection scrollableDirections, CGPoint contentOffset)
+/// Samples further apart than this don't describe one continuous movement, so they aren't averaged together.
+static const CFTimeInterval kASBatchFetchingMaxVelocitySampleInterval = 0.1;
+
+/// How much longer than the estimate a fetch is allowed to take before the end of content is reached.
+static const NSTimeInterval kASBatchFetchingFetchDurationHeadroom = 1.5;
+
+void ASBatchFetchingVelocityEstimateAddSample(ASBatchFetchingVelocityEstimate *estimate, CGPoint contentOffset, CFTimeInterval timestamp)
+{
+  CFTimeInterval elapsed = timestamp - estimate->timestamp;
+  if (estimate->timestamp > 0 && elapsed > 0) {
+    CGPoint velocity = CGPointMake((contentOffset.x - estimate->contentOffset.x) / elapsed,
+                                   (contentOffset.y - estimate->contentOffset.y) / elapsed);
+    if (elapsed > kASBatchFetchingMaxVelocitySampleInterval) {
+      estimate->velocity = velocity;
+    } else {
+      estimate->velocity = CGPointMake((estimate->velocity.x + velocity.x) / 2.0, (estimate->velocity.y + velocity.y) / 2.0);
+    }
+  }
+  estimate->contentOffset = contentOffset;
+  estimate->timestamp = timestamp;
+}
+
+BOOL ASDisplayShouldFetchBatchForScrollView(UIScrollView<ASBatchFetchingScrollView> *scrollView, ASScrollDirection scrollDirection, ASScrollDirection scrollableDirections, CGPoint contentOffset, CGPoint velocity)
 {
   // Don't fetch if the scroll view does not allow
   if (![scrollView canBatchFetch]) {
@@ -24,7 +46,7 @@ BOOL ASDisplayShouldFetchBatchForScrollView(UIScrollView<ASBatchFetchingScrollVi
   CGSize contentSize = scrollView.contentSize;
   CGFloat leadingScreens = scrollView.leadingScreensForBatching;
   BOOL visible = (scrollView.window != nil);
-  return ASDisplayShouldFetchBatchForContext(context, scrollDirection, scrollableDirections, bounds, contentSize, contentOffset, leadingScreens, visible);
+  return ASDisplayShouldFetchBatchForContextWithVelocity(context, scrollDirection, scrollableDirections, bounds, contentSize, contentOffset, leadingScreens, visible, velocity);
 }
 
 BOOL ASDisplayShouldFetchBatchForContext(ASBatchContext *context,
@@ -35,6 +57,19 @@ BOOL ASDisplayShouldFetchBatchForContext(ASBatchContext *context,
                                          CGPoint targetOffset,
                                          CGFloat leadingScreens,
                                          BOOL visible)
+{
+  return ASDisplayShouldFetchBatchForContextWithVelocity(context, scrollDirection, scrollableDirections, bounds, contentSize, targetOffset, leadingScreens, visible, CGPointZero);
+}
+
+BOOL ASDisplayShouldFetchBatchForContextWithVelocity(ASBatchContext *context,
+                                                     ASScrollDirection scrollDirection,
+                                                     ASScrollDirection scrollableDirections,
+                                                     CGRect bounds,
+                                                     CGSize contentSize,
+                                                     CGPoint targetOffset,
+                                                     CGFloat leadingScreens,
+                                                     BOOL visible,
+                                                     CGPoint velocity)
 {
   // Do not allow fetching if a batch is already in-flight and hasn't been completed or cancelled
   if ([context isFetching]) {
@@ -46,16 +81,18 @@ BOOL ASDisplayShouldFetchBatchForContext(ASBatchContext *context,
     return NO;
   }
 
-  CGFloat viewLength, offset, contentLength;
+  CGFloat viewLength, offset, contentLength, speed;
 
   if (ASScrollDirectionContainsVerticalDirection(scrollableDirections)) {
     viewLength = bounds.size.height;
     offset = targetOffset.y;
     contentLength = contentSize.height;
+    speed = velocity.y;
   } else { // horizontal / right
     viewLength = bounds.size.width;
     offset = targetOffset.x;
     contentLength = contentSize.width;
+    speed = velocity.x;
   }
 
   BOOL hasSmallContent = contentLength < viewLength;
@@ -78,5 +115,12 @@ BOOL ASDisplayShouldFetchBatchForContext(ASBatchContext *context,
   CGFloat triggerDistance = viewLength * leadingScreens;
   CGFloat remainingDistance = contentLength - viewLength - offset;
 
+  // If the user is moving fast enough to cover more than the leading screens while a fetch is in flight, trigger
+  // early enough that the fetch has completed by the time they get to the end.
+  NSTimeInterval estimatedFetchDuration = [context estimatedFetchDuration];
+  if (speed > 0 && estimatedFetchDuration > 0) {
+    triggerDistance = MAX(triggerDistance, speed * estimatedFetchDuration * kASBatchFetchingFetchDurationHeadroom);
+  }
+
   return remainingDistance <= triggerDistance;
 }
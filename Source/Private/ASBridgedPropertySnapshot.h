@@ -0,0 +1,147 @@
+//
+//  ASBridgedPropertySnapshot.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <CoreGraphics/CoreGraphics.h>
+#import <objc/objc.h>
+
+#import <atomic>
+
+/**
+ * The plain values of the bridged properties that layout and cell configuration read most.
+ */
+struct ASBridgedProperties {
+  CGFloat alpha;
+  CGRect bounds;
+  CGPoint position;
+  CGPoint anchorPoint;
+  CGFloat contentsScale;
+  BOOL hidden;
+};
+
+/**
+ * A copy of the bridged properties of an unloaded node, behind a sequence lock, so that getters can read them
+ * without taking the node's lock.
+ *
+ * Writers hold the node's lock, so there is only ever one. A writer makes the sequence odd, stores the values and
+ * makes the sequence even again. Readers copy the values between two reads of the sequence, and retry if the
+ * sequence was odd or changed in between, so that they never see the values of two different writes.
+ *
+ * The copy is only valid while the node isn't loaded: once it is, the view or layer is the source of truth.
+ */
+struct ASBridgedPropertySnapshot {
+  /**
+   * Stores the properties. Must be called with the node's lock held.
+   */
+  void publish(const ASBridgedProperties &properties)
+  {
+    beginWrite();
+    _values[AlphaIndex].store(properties.alpha, std::memory_order_relaxed);
+    _values[BoundsXIndex].store(properties.bounds.origin.x, std::memory_order_relaxed);
+    _values[BoundsYIndex].store(properties.bounds.origin.y, std::memory_order_relaxed);
+    _values[BoundsWidthIndex].store(properties.bounds.size.width, std::memory_order_relaxed);
+    _values[BoundsHeightIndex].store(properties.bounds.size.height, std::memory_order_relaxed);
+    _values[PositionXIndex].store(properties.position.x, std::memory_order_relaxed);
+    _values[PositionYIndex].store(properties.position.y, std::memory_order_relaxed);
+    _values[AnchorPointXIndex].store(properties.anchorPoint.x, std::memory_order_relaxed);
+    _values[AnchorPointYIndex].store(properties.anchorPoint.y, std::memory_order_relaxed);
+    _values[ContentsScaleIndex].store(properties.contentsScale, std::memory_order_relaxed);
+    _hidden.store(properties.hidden, std::memory_order_relaxed);
+    _valid.store(true, std::memory_order_relaxed);
+    endWrite();
+  }
+
+  /**
+   * Makes readers fall back to the node's lock, e.g. because the node was loaded. Must be called with the node's lock held.
+   */
+  void invalidate()
+  {
+    // Only writers change the flag, so reading it here doesn't race.
+    if (_valid.load(std::memory_order_relaxed)) {
+      beginWrite();
+      _valid.store(false, std::memory_order_relaxed);
+      endWrite();
+    }
+  }
+
+  /**
+   * Copies the properties if they are valid. Returns false if they aren't, if a write is in progress, or if writers
+   * kept changing them.
+   */
+  bool read(ASBridgedProperties &properties) const
+  {
+    // A thread in the middle of a bridged write may read what it just wrote, which isn't published yet.
+    if (writeDepth.load(std::memory_order_relaxed) != 0) {
+      return false;
+    }
+    for (int attempt = 0; attempt < MaximumReadAttempts; attempt++) {
+      uint32_t sequence = _sequence.load(std::memory_order_acquire);
+      if (sequence & 1) {
+        continue;
+      }
+      bool valid = _valid.load(std::memory_order_relaxed);
+      properties.alpha = _values[AlphaIndex].load(std::memory_order_relaxed);
+      properties.bounds = CGRectMake(_values[BoundsXIndex].load(std::memory_order_relaxed),
+                                     _values[BoundsYIndex].load(std::memory_order_relaxed),
+                                     _values[BoundsWidthIndex].load(std::memory_order_relaxed),
+                                     _values[BoundsHeightIndex].load(std::memory_order_relaxed));
+      properties.position = CGPointMake(_values[PositionXIndex].load(std::memory_order_relaxed),
+                                        _values[PositionYIndex].load(std::memory_order_relaxed));
+      properties.anchorPoint = CGPointMake(_values[AnchorPointXIndex].load(std::memory_order_relaxed),
+                                           _values[AnchorPointYIndex].load(std::memory_order_relaxed));
+      properties.contentsScale = _values[ContentsScaleIndex].load(std::memory_order_relaxed);
+      properties.hidden = _hidden.load(std::memory_order_relaxed);
+      // Keep the loads above from moving below the check of the sequence.
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (_sequence.load(std::memory_order_relaxed) == sequence) {
+        return valid;
+      }
+    }
+    return false;
+  }
+
+  /// Nested bridged writes on the same thread, e.g. -setFrame: setting bounds and position, publish once at the
+  /// end of the outermost one, so readers never see half of a frame. Only changed with the node's lock held;
+  /// readers fall back to the lock while a write is in progress.
+  std::atomic<unsigned> writeDepth{0};
+
+private:
+  enum : int {
+    AlphaIndex,
+    BoundsXIndex,
+    BoundsYIndex,
+    BoundsWidthIndex,
+    BoundsHeightIndex,
+    PositionXIndex,
+    PositionYIndex,
+    AnchorPointXIndex,
+    AnchorPointYIndex,
+    ContentsScaleIndex,
+    ValueCount,
+  };
+
+  static const int MaximumReadAttempts = 8;
+
+  void beginWrite()
+  {
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    // Keep the stores of the values from moving above the odd sequence.
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+
+  void endWrite()
+  {
+    _sequence.store(_sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  std::atomic<uint32_t> _sequence{0};
+  std::atomic<bool> _valid{false};
+  std::atomic<CGFloat> _values[ValueCount] = {};
+  std::atomic<BOOL> _hidden{NO};
+};
@@ -14,8 +14,129 @@
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkSubclasses.h>
+#import <AsyncDisplayKit/ASDisplayNodeExtras.h>
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+#import <AsyncDisplayKit/ASEqualityHelpers.h>
+#import <AsyncDisplayKit/ASGraphicsBufferPool.h>
 #import <AsyncDisplayKit/ASInternalHelpers.h>
 
+#import <vector>
+
+/**
+ * What a rasterized node drew into its container's backing store. Passes that only differ in the contents of some
+ * nodes only need to redraw the areas those nodes cover.
+ */
+struct ASRasterizedNodeRecord {
+  __weak ASDisplayNode *node;
+  CGRect frame;                   // The node's bounds in the container's coordinate space.
+  BOOL drawsContents;
+  NSUInteger contentsGeneration;  // Only meaningful if drawsContents.
+  UIColor *backgroundColor;
+  CGFloat cornerRadius;
+  BOOL clipsToBounds;
+};
+
+struct ASRasterizedComposite {
+  UIImage *image;
+  BOOL opaque;
+  std::vector<ASRasterizedNodeRecord> records;
+};
+
+/**
+ * Collects the records of an incremental rasterization pass, see -rasterizesDescendantsIncrementally.
+ */
+struct ASRasterizationPass {
+  CGFloat contentsScale;
+  std::vector<ASRasterizedNodeRecord> records;
+};
+
+/**
+ * Returns the area of the container that differs between two passes, CGRectNull if none, or CGRectInfinite if nodes
+ * were added, removed, moved or restyled, which isn't worth tracking.
+ */
+static CGRect ASRasterizedDirtyRect(const std::vector<ASRasterizedNodeRecord> &oldRecords, const std::vector<ASRasterizedNodeRecord> &newRecords)
+{
+  if (oldRecords.size() != newRecords.size()) {
+    return CGRectInfinite;
+  }
+  CGRect dirtyRect = CGRectNull;
+  for (size_t i = 0; i < newRecords.size(); i++) {
+    const ASRasterizedNodeRecord &oldRecord = oldRecords[i];
+    const ASRasterizedNodeRecord &newRecord = newRecords[i];
+    ASDisplayNode *node = newRecord.node;
+    if (node == nil || oldRecord.node != node
+        || !CGRectEqualToRect(oldRecord.frame, newRecord.frame)
+        || oldRecord.drawsContents != newRecord.drawsContents
+        || ASObjectIsEqual(oldRecord.backgroundColor, newRecord.backgroundColor) == NO
+        || oldRecord.cornerRadius != newRecord.cornerRadius
+        || oldRecord.clipsToBounds != newRecord.clipsToBounds) {
+      return CGRectInfinite;
+    }
+    if (newRecord.drawsContents && oldRecord.contentsGeneration != newRecord.contentsGeneration) {
+      dirtyRect = CGRectUnion(dirtyRect, newRecord.frame);
+    }
+  }
+  return dirtyRect;
+}
+
+/**
+ * Draws the contents of a rasterized node on its own, to be composited into its container.
+ */
+static UIImage *ASRasterizedTileWithDisplayBlock(asyncdisplaykit_async_transaction_operation_block_t displayBlock, BOOL usesImageDisplay, CGRect bounds, CGFloat contentsScale)
+{
+  // -display methods return an image rather than drawing into the current context.
+  if (usesImageDisplay) {
+    return (UIImage *)displayBlock();
+  }
+  ASGraphicsBeginImageContextWithOptions(bounds.size, NO, contentsScale);
+  CGContextTranslateCTM(UIGraphicsGetCurrentContext(), -bounds.origin.x, -bounds.origin.y);
+  displayBlock();
+  return ASGraphicsGetImageAndEndCurrentContext();
+}
+
+/**
+ * The corner radius, background and border that a node using ASCornerRoundingTypePrecomposited draws itself.
+ */
+struct ASPrecompositedCorners {
+  CGFloat radius;
+  UIColor *backgroundColor;
+  CGFloat borderWidth;
+  UIColor *borderColor;
+};
+
+/**
+ * Fills the background within the rounded bounds and clips what is drawn next to them. Must be balanced by
+ * ASPrecompositedCornersEnd.
+ */
+static void ASPrecompositedCornersBegin(CGContextRef context, const ASPrecompositedCorners &corners, CGRect bounds)
+{
+  CGContextSaveGState(context);
+  CGContextAddPath(context, [UIBezierPath bezierPathWithRoundedRect:bounds cornerRadius:corners.radius].CGPath);
+  CGContextClip(context);
+  if (corners.backgroundColor) {
+    CGContextSetFillColorWithColor(context, corners.backgroundColor.CGColor);
+    CGContextFillRect(context, bounds);
+  }
+}
+
+/**
+ * Removes the clip and strokes the border, inside of the bounds like layer borders.
+ */
+static void ASPrecompositedCornersEnd(CGContextRef context, const ASPrecompositedCorners &corners, CGRect bounds)
+{
+  CGContextRestoreGState(context);
+  if (corners.borderWidth > 0 && corners.borderColor) {
+    CGFloat inset = corners.borderWidth / 2;
+    UIBezierPath *path = [UIBezierPath bezierPathWithRoundedRect:CGRectInset(bounds, inset, inset)
+                                                    cornerRadius:MAX(0, corners.radius - inset)];
+    CGContextAddPath(context, path.CGPath);
+    CGContextSetLineWidth(context, corners.borderWidth);
+    CGContextSetStrokeColorWithColor(context, corners.borderColor.CGColor);
+    CGContextStrokePath(context);
+  }
+}
+
 @interface ASDisplayNode () <_ASDisplayLayerDelegate>
 @end
 
@@ -45,7 +166,14 @@
   }
 }
 
-- (void)_recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:(asdisplaynode_iscancelled_block_t)isCancelledBlock displayBlocks:(NSMutableArray *)displayBlocks
+/**
+ * @param pass Non-NULL when rasterizing incrementally; records what each node draws and draws cached tiles.
+ * @param containerOrigin The origin of the supernode's coordinate space in the container's.
+ */
+- (void)_recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:(asdisplaynode_iscancelled_block_t)isCancelledBlock
+                                                    displayBlocks:(NSMutableArray *)displayBlocks
+                                                             pass:(ASRasterizationPass *)pass
+                                                  containerOrigin:(CGPoint)containerOrigin
 {
   // Skip subtrees that are hidden or zero alpha.
   if (self.isHidden || self.alpha <= 0.0) {
@@ -66,6 +194,10 @@
   CGRect bounds = self.bounds;
   CGFloat cornerRadius = self.cornerRadius;
   BOOL clipsToBounds = self.clipsToBounds;
+  __instanceLock__.lock();
+  // Nodes drawing their corners are clipped to them, without a border.
+  clipsToBounds = clipsToBounds || [self _locked_precompositesCorners];
+  __instanceLock__.unlock();
 
   CGRect frame;
   
@@ -90,6 +222,28 @@
   // We'll display something if there is a display block, clipping, translation and/or a background color.
   BOOL shouldDisplay = displayBlock || backgroundColor || CGPointEqualToPoint(CGPointZero, frame.origin) == NO || clipsToBounds;
 
+  // When rasterizing incrementally, the contents are drawn into a tile that is kept until the node needs display.
+  UIImage *tile = nil;
+  NSUInteger contentsGeneration = 0;
+  BOOL usesImageDisplay = NO;
+  BOOL incremental = (pass != NULL);
+  CGFloat contentsScale = (pass ? pass->contentsScale : 0);
+  if (incremental && shouldDisplay) {
+    __instanceLock__.lock();
+    contentsGeneration = _rasterizedContentsGeneration;
+    usesImageDisplay = (_flags.implementsImageDisplay || _flags.implementsInstanceImageDisplay);
+    if (_rasterizedTileGeneration == contentsGeneration && _rasterizedTileScale == contentsScale
+        && CGSizeEqualToSize(_rasterizedTileSize, bounds.size)) {
+      tile = _rasterizedTile;
+    }
+    __instanceLock__.unlock();
+
+    CGPoint origin = CGPointMake(containerOrigin.x + frame.origin.x, containerOrigin.y + frame.origin.y);
+    pass->records.push_back({self, CGRectOffset(bounds, origin.x, origin.y), (displayBlock != nil), contentsGeneration,
+                             backgroundColor, cornerRadius, clipsToBounds});
+  }
+  __weak ASDisplayNode *weakSelf = self;
+
   // If we should display, then push a transform, draw the background color, and draw the contents.
   // The transform is popped in a block added after the recursion into subnodes.
   if (shouldDisplay) {
@@ -116,8 +270,18 @@
         CGContextFillRect(context, bounds);
       }
 
-      // If there is a display block, call it to get the image, then copy the image into the current context (which is the rasterized container's backing store).
-      if (displayBlock) {
+      if (incremental && displayBlock) {
+        // Only the dirty area of the container is redrawn, skip tiles outside of it.
+        if (CGRectIntersectsRect(CGContextGetClipBoundingBox(context), bounds) == NO) {
+          return;
+        }
+        UIImage *image = tile ?: ASRasterizedTileWithDisplayBlock(displayBlock, usesImageDisplay, bounds, contentsScale);
+        if (image && tile == nil) {
+          [weakSelf _setRasterizedTile:image generation:contentsGeneration size:bounds.size scale:contentsScale];
+        }
+        [image drawInRect:bounds blendMode:kCGBlendModeNormal alpha:1];
+      } else if (displayBlock) {
+        // If there is a display block, call it to get the image, then copy the image into the current context (which is the rasterized container's backing store).
         UIImage *image = (UIImage *)displayBlock();
         if (image) {
           BOOL opaque = ASImageAlphaInfoIsOpaque(CGImageGetAlphaInfo(image.CGImage));
@@ -130,8 +294,12 @@
   }
 
   // Recursively capture displayBlocks for all descendants.
+  CGPoint subnodeContainerOrigin = CGPointMake(containerOrigin.x + frame.origin.x, containerOrigin.y + frame.origin.y);
   for (ASDisplayNode *subnode in self.subnodes) {
-    [subnode _recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:isCancelledBlock displayBlocks:displayBlocks];
+    [subnode _recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:isCancelledBlock
+                                                         displayBlocks:displayBlocks
+                                                                  pass:pass
+                                                       containerOrigin:subnodeContainerOrigin];
   }
 
   // If we pushed a transform, pop it by adding a display block that does nothing other than that.
@@ -149,6 +317,37 @@
   }
 }
 
+- (void)_setRasterizedTile:(UIImage *)tile generation:(NSUInteger)generation size:(CGSize)size scale:(CGFloat)scale
+{
+  ASDN::MutexLocker l(__instanceLock__);
+  // Drop tiles of contents that changed while they were drawn.
+  if (generation == _rasterizedContentsGeneration) {
+    _rasterizedTile = tile;
+    _rasterizedTileGeneration = generation;
+    _rasterizedTileSize = size;
+    _rasterizedTileScale = scale;
+  }
+}
+
+- (void)_clearRasterizationCaches
+{
+  ASDisplayNodeAssertMainThread();
+  BOOL shouldRasterizeDescendants;
+  {
+    ASDN::MutexLocker l(__instanceLock__);
+    _rasterizedComposite = nullptr;
+    _rasterizedTile = nil;
+    shouldRasterizeDescendants = _flags.shouldRasterizeDescendants;
+  }
+  // Only the descendants of rasterizing containers have tiles.
+  if (shouldRasterizeDescendants) {
+    ASDisplayNodePerformBlockOnEverySubnode(self, NO, ^(ASDisplayNode * _Nonnull node) {
+      ASDN::MutexLocker l(node->__instanceLock__);
+      node->_rasterizedTile = nil;
+    });
+  }
+}
+
 - (asyncdisplaykit_async_transaction_operation_block_t)_displayBlockWithAsynchronous:(BOOL)asynchronous
                                                                     isCancelledBlock:(asdisplaynode_iscancelled_block_t)isCancelledBlock
                                                                          rasterizing:(BOOL)rasterizing
@@ -176,6 +375,15 @@
   BOOL opaque = self.opaque;
   CGRect bounds = self.bounds;
   CGFloat contentsScaleForDisplay = _contentsScaleForDisplay;
+
+  // Rasterized nodes are clipped by their container instead.
+  BOOL precomposites = (rasterizing == NO && [self _locked_precompositesCorners]);
+  ASPrecompositedCorners corners = {};
+  if (precomposites) {
+    corners = {_cornerRadius, _precompositedBackgroundColor, _precompositedBorderWidth, _precompositedBorderColor};
+    // The corners are left transparent.
+    opaque = opaque && corners.radius <= 0;
+  }
     
   __instanceLock__.unlock();
 
@@ -194,27 +402,89 @@
                       @"Rasterized descendants should never display unless being drawn into the rasterized container.");
 
   if (shouldBeginRasterizing) {
+    std::unique_ptr<ASRasterizationPass> pass;
+    std::shared_ptr<ASRasterizedComposite> previousComposite;
+    if (flags.rasterizesDescendantsIncrementally) {
+      pass.reset(new ASRasterizationPass{contentsScaleForDisplay});
+      ASDN::MutexLocker l(__instanceLock__);
+      previousComposite = _rasterizedComposite;
+    }
+
     // Collect displayBlocks for all descendants.
     NSMutableArray *displayBlocks = [NSMutableArray array];
-    [self _recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:isCancelledBlock displayBlocks:displayBlocks];
+    [self _recursivelyRasterizeSelfAndSublayersWithIsCancelledBlock:isCancelledBlock
+                                                      displayBlocks:displayBlocks
+                                                               pass:pass.get()
+                                                    containerOrigin:CGPointZero];
     CHECK_CANCELLED_AND_RETURN_NIL();
     
     // If [UIColor clearColor] or another semitransparent background color is used, include alpha channel when rasterizing.
     // Unlike CALayer drawing, we include the backgroundColor as a base during rasterization.
     opaque = opaque && CGColorGetAlpha(self.backgroundColor.CGColor) == 1.0f;
 
+    // When rasterizing incrementally, find the area that changed since the previous backing store was drawn.
+    CGRect containerRect = CGRectMake(0, 0, bounds.size.width, bounds.size.height);
+    CGRect dirtyRect = CGRectInfinite;
+    UIImage *previousImage = nil;
+    std::shared_ptr<ASRasterizedComposite> composite;
+    if (pass) {
+      if (previousComposite && previousComposite->opaque == opaque && previousComposite->image.scale == contentsScaleForDisplay
+          && CGSizeEqualToSize(previousComposite->image.size, bounds.size)) {
+        previousImage = previousComposite->image;
+        dirtyRect = ASRasterizedDirtyRect(previousComposite->records, pass->records);
+      }
+      if (!CGRectIsNull(dirtyRect) && !CGRectIsInfinite(dirtyRect)) {
+        // Align to pixels so that the kept and redrawn areas don't blend at their edges.
+        CGAffineTransform toPixels = CGAffineTransformMakeScale(contentsScaleForDisplay, contentsScaleForDisplay);
+        CGRect pixelRect = CGRectIntegral(CGRectApplyAffineTransform(dirtyRect, toPixels));
+        dirtyRect = CGRectIntersection(CGRectApplyAffineTransform(pixelRect, CGAffineTransformInvert(toPixels)), containerRect);
+        // Past half of the container, copying the previous backing store costs more than it saves.
+        if (dirtyRect.size.width * dirtyRect.size.height > containerRect.size.width * containerRect.size.height / 2) {
+          dirtyRect = CGRectInfinite;
+        }
+      }
+      composite = std::make_shared<ASRasterizedComposite>();
+      composite->opaque = opaque;
+      composite->records = std::move(pass->records);
+    }
+
     displayBlock = ^id{
       CHECK_CANCELLED_AND_RETURN_NIL();
+
+      // Nothing changed since the previous backing store was drawn.
+      if (CGRectIsNull(dirtyRect)) {
+        return previousImage;
+      }
       
-      UIGraphicsBeginImageContextWithOptions(bounds.size, opaque, contentsScaleForDisplay);
+      ASGraphicsBeginImageContextWithOptions(bounds.size, opaque, contentsScaleForDisplay);
+
+      // Start from the previous backing store and only draw over the dirty area; the display blocks of descendants
+      // outside of it skip drawing.
+      BOOL drawsDirtyRectOnly = !CGRectIsInfinite(dirtyRect);
+      CGContextRef context = UIGraphicsGetCurrentContext();
+      if (drawsDirtyRectOnly) {
+        [previousImage drawInRect:containerRect blendMode:kCGBlendModeCopy alpha:1];
+        CGContextSaveGState(context);
+        CGContextClipToRect(context, dirtyRect);
+        CGContextClearRect(context, dirtyRect);
+      }
 
       for (dispatch_block_t block in displayBlocks) {
-        CHECK_CANCELLED_AND_RETURN_NIL(UIGraphicsEndImageContext());
+        CHECK_CANCELLED_AND_RETURN_NIL(ASGraphicsEndImageContext());
         block();
       }
+
+      if (drawsDirtyRectOnly) {
+        CGContextRestoreGState(context);
+      }
       
-      UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
-      UIGraphicsEndImageContext();
+      UIImage *image = ASGraphicsGetImageAndEndCurrentContext();
+
+      if (composite && image) {
+        composite->image = image;
+        ASDN::MutexLocker l(__instanceLock__);
+        _rasterizedComposite = composite;
+      }
 
       ASDN_DELAY_FOR_DISPLAY();
       return image;
@@ -224,8 +494,8 @@
       CHECK_CANCELLED_AND_RETURN_NIL();
 
       if (shouldCreateGraphicsContext) {
-        UIGraphicsBeginImageContextWithOptions(bounds.size, opaque, contentsScaleForDisplay);
-        CHECK_CANCELLED_AND_RETURN_NIL( UIGraphicsEndImageContext(); );
+        ASGraphicsBeginImageContextWithOptions(bounds.size, opaque, contentsScaleForDisplay);
+        CHECK_CANCELLED_AND_RETURN_NIL( ASGraphicsEndImageContext(); );
       }
 
       CGContextRef currentContext = UIGraphicsGetCurrentContext();
@@ -243,6 +513,10 @@
 
       // For -display methods, we don't have a context, and thus will not call the _willDisplayNodeContentWithRenderingContext or
       // _didDisplayNodeContentWithRenderingContext blocks. It's up to the implementation of -display... to do what it needs.
+      if (precomposites && currentContext) {
+        ASPrecompositedCornersBegin(currentContext, corners, bounds);
+      }
+
       if (willDisplayNodeContentWithRenderingContext != nil) {
         willDisplayNodeContentWithRenderingContext(currentContext);
       }
@@ -261,11 +535,23 @@
       if (didDisplayNodeContentWithRenderingContext != nil) {
         didDisplayNodeContentWithRenderingContext(currentContext);
       }
+
+      if (precomposites && currentContext) {
+        ASPrecompositedCornersEnd(currentContext, corners, bounds);
+      }
       
       if (shouldCreateGraphicsContext) {
-        CHECK_CANCELLED_AND_RETURN_NIL( UIGraphicsEndImageContext(); );
-        image = UIGraphicsGetImageFromCurrentImageContext();
-        UIGraphicsEndImageContext();
+        CHECK_CANCELLED_AND_RETURN_NIL( ASGraphicsEndImageContext(); );
+        image = ASGraphicsGetImageAndEndCurrentContext();
+      } else if (precomposites && image && !CGRectIsEmpty(bounds)) {
+        // Images returned by -display methods fill the bounds, round them in a context of their own.
+        CHECK_CANCELLED_AND_RETURN_NIL();
+        ASGraphicsBeginImageContextWithOptions(bounds.size, opaque, contentsScaleForDisplay);
+        CGContextRef imageContext = UIGraphicsGetCurrentContext();
+        ASPrecompositedCornersBegin(imageContext, corners, bounds);
+        [image drawInRect:bounds];
+        ASPrecompositedCornersEnd(imageContext, corners, bounds);
+        image = ASGraphicsGetImageAndEndCurrentContext();
       }
 
       ASDN_DELAY_FOR_DISPLAY();
@@ -295,11 +581,12 @@
   // enqueued
   // for sync display, do not support cancellation
   
-  // FIXME: what about the degenerate case where we are calling setNeedsDisplay faster than the jobs are dequeuing
-  // from the displayQueue?  Need to not cancel early fails from displaySentinel changes.
+  // If the previous display is still waiting in the display queue, it would only bail out once dequeued, so take it
+  // out now. This keeps calling setNeedsDisplay faster than jobs are dequeued from growing the queue.
   asdisplaynode_iscancelled_block_t isCancelledBlock = nil;
   if (asynchronously) {
     uint displaySentinelValue = ++_displaySentinel;
+    [_ASAsyncTransaction cancelOperationWithHandle:_pendingDisplayOperation.exchange(ASAsyncTransactionOperationHandleNone)];
     __weak ASDisplayNode *weakSelf = self;
     isCancelledBlock = ^BOOL{
       __strong ASDisplayNode *self = weakSelf;
@@ -320,10 +607,40 @@
   
   ASDisplayNodeAssert(_layer, @"Expect _layer to be not nil");
 
+  // Measure how long display takes, to report the work thrown away when it finishes after being cancelled, and how
+  // long it waited in the display queue.
+  Class nodeClass = [self class];
+  __block CFTimeInterval displayDuration = 0;
+  {
+    asyncdisplaykit_async_transaction_operation_block_t untimedDisplayBlock = displayBlock;
+    CFTimeInterval enqueueTime = CACurrentMediaTime();
+    displayBlock = ^id<NSObject>{
+      ASDN::TraceScope traceScope(ASTraceSpanDisplay, nodeClass);
+      CFTimeInterval startTime = CACurrentMediaTime();
+      if (asynchronously) {
+        ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricQueueWaitTime, startTime - enqueueTime);
+      }
+      id<NSObject> value = untimedDisplayBlock();
+      displayDuration = CACurrentMediaTime() - startTime;
+      // Displays that bail out early return nil, don't let them skew the draw times.
+      if (value != nil) {
+        ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, displayDuration);
+      }
+      return value;
+    };
+  }
+
   // This block is called back on the main thread after rendering at the completion of the current async transaction, or immediately if !asynchronously
   asyncdisplaykit_async_transaction_operation_completion_block_t completionBlock = ^(id<NSObject> value, BOOL canceled){
     ASDisplayNodeCAssertMainThread();
-    if (!canceled && !isCancelledBlock()) {
+    BOOL cancelled = (canceled || isCancelledBlock());
+    ASDisplayTelemetryRecordDisplay(nodeClass, cancelled);
+    if (cancelled) {
+      // Displays purged from the queue never ran, so only count the ones that did.
+      if (displayDuration > 0) {
+        [_ASAsyncTransaction recordWastedOperationWithDuration:displayDuration];
+      }
+    } else {
       UIImage *image = (UIImage *)value;
       BOOL stretchable = (NO == UIEdgeInsetsEqualToEdgeInsets(image.capInsets, UIEdgeInsetsZero));
       if (stretchable) {
@@ -353,7 +670,7 @@
     
     // Adding this displayBlock operation to the transaction will start it IMMEDIATELY.
     // The only function of the transaction commit is to gate the calling of the completionBlock.
-    [transaction addOperationWithBlock:displayBlock priority:self.drawingPriority queue:[_ASDisplayLayer displayQueue] completion:completionBlock];
+    _pendingDisplayOperation = [transaction addOperationWithBlock:displayBlock priority:self.drawingPriority queue:[_ASDisplayLayer displayQueue] completion:completionBlock];
   } else {
     UIImage *contents = (UIImage *)displayBlock();
     completionBlock(contents, NO);
@@ -363,6 +680,8 @@
 - (void)cancelDisplayAsyncLayer:(_ASDisplayLayer *)asyncLayer
 {
   _displaySentinel.fetch_add(1);
+  // Don't leave the display in line ahead of nodes that are still on screen; it would bail out once dequeued anyway.
+  [_ASAsyncTransaction cancelOperationWithHandle:_pendingDisplayOperation.exchange(ASAsyncTransactionOperationHandleNone)];
 }
 
 - (ASDisplayNodeContextModifier)willDisplayNodeContentWithRenderingContext
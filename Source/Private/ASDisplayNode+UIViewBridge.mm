@@ -15,6 +15,7 @@
 #import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkSubclasses.h>
+#import <AsyncDisplayKit/ASEqualityHelpers.h>
 #import <AsyncDisplayKit/ASPendingStateController.h>
 
 /**
@@ -31,20 +32,75 @@
  *
  *  _bridge_prologue_write is defined to take the node's property lock. Add it at the beginning of any bridged property setters.
  *  _bridge_prologue_read is defined to take the node's property lock and enforce thread affinity. Add it at the beginning of any bridged property getters.
+ *
+ *  The getters of the properties in ASBridgedProperties start with _bridge_read_unlocked instead, which returns without
+ *  the lock when it can: from the view or layer on the main thread, and from the node's bridged property snapshot when
+ *  the node isn't loaded. Every bridged write republishes the snapshot before it unlocks.
  */
 
 #define DISPLAYNODE_USE_LOCKS 1
 
 #define __loaded(node) (node->_view != nil || (node->_layer != nil && node->_flags.layerBacked))
 
+/// Copies the pending values of the snapshotted properties into the node's snapshot, or invalidates the snapshot if the
+/// node is loaded. Must be called with the node's lock held.
+ASDISPLAYNODE_INLINE void ASDisplayNodePublishBridgedProperties(ASDisplayNode *node) {
+  if (__loaded(node)) {
+    node->_bridgedPropertySnapshot.invalidate();
+    return;
+  }
+  _ASPendingState *pendingState = ASDisplayNodeGetPendingState(node);
+  ASBridgedProperties properties;
+  properties.alpha = pendingState.alpha;
+  properties.bounds = pendingState.bounds;
+  properties.position = pendingState.position;
+  properties.anchorPoint = pendingState.anchorPoint;
+  properties.contentsScale = pendingState.contentsScale;
+  properties.hidden = pendingState.hidden;
+  node->_bridgedPropertySnapshot.publish(properties);
+}
+
+namespace {
+  /// Republishes the snapshot at the end of the outermost bridged write, before the lock is released.
+  struct ASBridgedWriteScope {
+    __unsafe_unretained ASDisplayNode *node;
+    ASBridgedWriteScope(ASDisplayNode *node) : node(node) {
+      node->_bridgedPropertySnapshot.writeDepth.fetch_add(1, std::memory_order_relaxed);
+    }
+    ~ASBridgedWriteScope() {
+      // Publish before leaving the write, so readers that see no write in progress see its values.
+      if (node->_bridgedPropertySnapshot.writeDepth.load(std::memory_order_relaxed) == 1) {
+        ASDisplayNodePublishBridgedProperties(node);
+      }
+      node->_bridgedPropertySnapshot.writeDepth.fetch_sub(1, std::memory_order_release);
+    }
+    ASBridgedWriteScope(const ASBridgedWriteScope&) = delete;
+    ASBridgedWriteScope &operator=(const ASBridgedWriteScope&) = delete;
+  };
+}
+
 #if DISPLAYNODE_USE_LOCKS
 #define _bridge_prologue_read ASDN::MutexLocker l(__instanceLock__); ASDisplayNodeAssertThreadAffinity(self)
-#define _bridge_prologue_write ASDN::MutexLocker l(__instanceLock__)
+#define _bridge_prologue_write ASDN::MutexLocker l(__instanceLock__); ASBridgedWriteScope __bridgedWriteScope(self)
 #else
 #define _bridge_prologue_read ASDisplayNodeAssertThreadAffinity(self)
 #define _bridge_prologue_write
 #endif
 
+/// Returns the property without taking the lock if possible. Views and layers are only loaded and unloaded on the
+/// main thread, so there a loaded node can be read from directly. Unloaded nodes are read from the snapshot, which
+/// is invalid until the first locked read or write of an unloaded node publishes it. Thread affinity is asserted up front
+/// like _bridge_prologue_read, checking __loaded directly because -isNodeLoaded takes the lock off the main thread.
+#define _bridge_read_unlocked(snapshotProperty, loadedExpr) \
+  ASDisplayNodeAssert(ASDisplayNodeThreadIsMain() || !__loaded(self), @"Incorrect display node thread affinity - this method should not be called off the main thread after the ASDisplayNode's view or layer have been created"); \
+  if (ASDisplayNodeThreadIsMain() && __loaded(self)) { return (loadedExpr); } \
+  { ASBridgedProperties __properties; if (_bridgedPropertySnapshot.read(__properties)) { return __properties.snapshotProperty; } }
+
+/// Takes the lock like _bridge_prologue_read, and publishes the snapshot so that the next read doesn't have to. Reads
+/// from within a write leave publishing to the end of the write.
+#define _bridge_prologue_read_publishing _bridge_prologue_read; \
+  if (_bridgedPropertySnapshot.writeDepth.load(std::memory_order_relaxed) == 0) { ASDisplayNodePublishBridgedProperties(self); }
+
 /// Returns YES if the property set should be applied to view/layer immediately.
 /// Side Effect: Registers the node with the shared ASPendingStateController if
 /// the property cannot be immediately applied and the node does not already have pending changes.
@@ -78,6 +134,13 @@ if (shouldApply) { _view.viewAndPendingViewStateProperty = (viewAndPendingViewSt
 #define _setToLayer(layerProperty, layerValueExpr) BOOL shouldApply = ASDisplayNodeShouldApplyBridgedWriteToView(self); \
 if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNodeGetPendingState(self).layerProperty = (layerValueExpr); }
 
+/// Returns YES if the layer rounds the node's corners, rather than the node drawing or covering them.
+/// This function must be called with the node's lock already held.
+ASDISPLAYNODE_INLINE BOOL ASDisplayNodeLayerRoundsCorners(ASDisplayNode *node) {
+  return node->_cornerRoundingType == ASCornerRoundingTypeDefaultSlowCALayer
+      || (node->_cornerRoundingType == ASCornerRoundingTypePrecomposited && ![node _locked_precompositesCorners]);
+}
+
 /**
  * This category implements certain frequently-used properties and methods of UIView and CALayer so that ASDisplayNode clients can just call the view/layer methods on the node,
  * with minimal loss in performance.  Unlike UIView and CALayer methods, these can be called from a non-main thread until the view or layer is created.
@@ -163,7 +226,8 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (CGFloat)alpha
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(alpha, _view ? _view.alpha : _layer.opacity);
+  _bridge_prologue_read_publishing;
   return _getFromViewOrLayer(opacity, alpha);
 }
 
@@ -176,18 +240,41 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 - (CGFloat)cornerRadius
 {
   _bridge_prologue_read;
+  if (!ASDisplayNodeLayerRoundsCorners(self)) {
+    return _cornerRadius;
+  }
   return _getFromLayer(cornerRadius);
 }
 
 - (void)setCornerRadius:(CGFloat)newCornerRadius
 {
-  _bridge_prologue_write;
-  _setToLayer(cornerRadius, newCornerRadius);
+  BOOL precomposites;
+  {
+    _bridge_prologue_write;
+    if (ASDisplayNodeLayerRoundsCorners(self)) {
+      _setToLayer(cornerRadius, newCornerRadius);
+      return;
+    }
+    if (_cornerRadius == newCornerRadius) {
+      return;
+    }
+    _cornerRadius = newCornerRadius;
+    precomposites = [self _locked_precompositesCorners];
+  }
+
+  if (precomposites) {
+    [self setNeedsDisplay];
+  } else {
+    ASPerformBlockOnMainThread(^{
+      [self _updateClipCornerLayers];
+    });
+  }
 }
 
 - (CGFloat)contentsScale
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(contentsScale, _layer.contentsScale);
+  _bridge_prologue_read_publishing;
   return _getFromLayer(contentsScale);
 }
 
@@ -199,7 +286,8 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (CGRect)bounds
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(bounds, _view ? _view.bounds : _layer.bounds);
+  _bridge_prologue_read_publishing;
   return _getFromViewOrLayer(bounds, bounds);
 }
 
@@ -212,17 +300,32 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (CGRect)frame
 {
-  _bridge_prologue_read;
-
   // Frame is only defined when transform is identity.
 //#if DEBUG
 //  // Checking if the transform is identity is expensive, so disable when unnecessary. We have assertions on in Release, so DEBUG is the only way I know of.
 //  ASDisplayNodeAssert(CATransform3DIsIdentity(self.transform), @"-[ASDisplayNode frame] - self.transform must be identity in order to use the frame property.  (From Apple's UIView documentation: If the transform property is not the identity transform, the value of this property is undefined and therefore should be ignored.)");
 //#endif
 
-  CGPoint position = self.position;
-  CGRect bounds = self.bounds;
-  CGPoint anchorPoint = self.anchorPoint;
+  // Position, bounds and anchor point must come from the same write, so read them in one go, from the snapshot or
+  // under the lock. On the main thread, a loaded node doesn't change between the reads.
+  CGPoint position;
+  CGRect bounds;
+  CGPoint anchorPoint;
+  ASBridgedProperties properties;
+  if (ASDisplayNodeThreadIsMain() && __loaded(self)) {
+    position = _layer.position;
+    bounds = (_view ? _view.bounds : _layer.bounds);
+    anchorPoint = _layer.anchorPoint;
+  } else if (_bridgedPropertySnapshot.read(properties)) {
+    position = properties.position;
+    bounds = properties.bounds;
+    anchorPoint = properties.anchorPoint;
+  } else {
+    _bridge_prologue_read_publishing;
+    position = _getFromLayer(position);
+    bounds = _getFromViewOrLayer(bounds, bounds);
+    anchorPoint = _getFromLayer(anchorPoint);
+  }
   CGPoint origin = CGPointMake(position.x - bounds.size.width * anchorPoint.x,
                                position.y - bounds.size.height * anchorPoint.y);
   return CGRectMake(origin.x, origin.y, bounds.size.width, bounds.size.height);
@@ -299,13 +402,10 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 - (void)setNeedsDisplay
 {
   BOOL isRasterized = NO;
-  BOOL shouldApply = NO;
-  id viewOrLayer = nil;
   {
     _bridge_prologue_write;
     isRasterized = _hierarchyState & ASHierarchyStateRasterized;
-    shouldApply = ASDisplayNodeShouldApplyBridgedWriteToView(self);
-    viewOrLayer = _view ?: _layer;
+    _rasterizedContentsGeneration++;
   }
   
   if (isRasterized) {
@@ -322,22 +422,40 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
         }
         rasterizedContainerNode = rasterizedContainerNode.supernode;
       }
-      [rasterizedContainerNode setNeedsDisplay];
+      if (rasterizedContainerNode.rasterizesDescendantsIncrementally) {
+        // The container's own contents didn't change, which lets it redraw only this node.
+        [rasterizedContainerNode _setNeedsDisplayOfBackingStore];
+      } else {
+        [rasterizedContainerNode setNeedsDisplay];
+      }
     });
   } else {
-    if (shouldApply) {
-      // If not rasterized, and the node is loaded (meaning we certainly have a view or layer), send a
-      // message to the view/layer first. This is because __setNeedsDisplay calls as scheduleNodeForDisplay,
-      // which may call -displayIfNeeded. We want to ensure the needsDisplay flag is set now, and then cleared.
-      [viewOrLayer setNeedsDisplay];
-    } else {
-      _bridge_prologue_write;
-      [ASDisplayNodeGetPendingState(self) setNeedsDisplay];
-    }
-    [self __setNeedsDisplay];
+    [self _setNeedsDisplayOfBackingStore];
   }
 }
 
+- (void)_setNeedsDisplayOfBackingStore
+{
+  BOOL shouldApply = NO;
+  id viewOrLayer = nil;
+  {
+    _bridge_prologue_write;
+    shouldApply = ASDisplayNodeShouldApplyBridgedWriteToView(self);
+    viewOrLayer = _view ?: _layer;
+  }
+
+  if (shouldApply) {
+    // If not rasterized, and the node is loaded (meaning we certainly have a view or layer), send a
+    // message to the view/layer first. This is because __setNeedsDisplay calls as scheduleNodeForDisplay,
+    // which may call -displayIfNeeded. We want to ensure the needsDisplay flag is set now, and then cleared.
+    [viewOrLayer setNeedsDisplay];
+  } else {
+    _bridge_prologue_write;
+    [ASDisplayNodeGetPendingState(self) setNeedsDisplay];
+  }
+  [self __setNeedsDisplay];
+}
+
 - (void)setNeedsLayout
 {
   BOOL shouldApply = NO;
@@ -461,7 +579,8 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (CGPoint)anchorPoint
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(anchorPoint, _layer.anchorPoint);
+  _bridge_prologue_read_publishing;
   return _getFromLayer(anchorPoint);
 }
 
@@ -473,7 +592,8 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (CGPoint)position
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(position, _layer.position);
+  _bridge_prologue_read_publishing;
   return _getFromLayer(position);
 }
 
@@ -533,7 +653,8 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 
 - (BOOL)isHidden
 {
-  _bridge_prologue_read;
+  _bridge_read_unlocked(hidden, _view ? _view.hidden : _layer.hidden);
+  _bridge_prologue_read_publishing;
   return _getFromViewOrLayer(hidden, hidden);
 }
 
@@ -615,34 +736,50 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 - (UIColor *)backgroundColor
 {
   _bridge_prologue_read;
+  if ([self _locked_precompositesCorners]) {
+    return _precompositedBackgroundColor;
+  }
   return [UIColor colorWithCGColor:_getFromLayer(backgroundColor)];
 }
 
 - (void)setBackgroundColor:(UIColor *)newBackgroundColor
 {
-  _bridge_prologue_write;
-  
-  CGColorRef newBackgroundCGColor = [newBackgroundColor CGColor];
-  BOOL shouldApply = ASDisplayNodeShouldApplyBridgedWriteToView(self);
-  
-  if (shouldApply) {
-    CGColorRef oldBackgroundCGColor = _layer.backgroundColor;
-    
-    BOOL specialPropertiesHandling = ASDisplayNodeNeedsSpecialPropertiesHandlingForFlags(_flags);
-    if (specialPropertiesHandling) {
-        _view.backgroundColor = newBackgroundColor;
+  BOOL needsDisplay = NO;
+  {
+    _bridge_prologue_write;
+
+    if ([self _locked_precompositesCorners]) {
+      if (!ASObjectIsEqual(_precompositedBackgroundColor, newBackgroundColor)) {
+        _precompositedBackgroundColor = newBackgroundColor;
+        needsDisplay = YES;
+      }
     } else {
-        _layer.backgroundColor = newBackgroundCGColor;
-    }
-      
-    if (!CGColorEqualToColor(oldBackgroundCGColor, newBackgroundCGColor)) {
-      [self setNeedsDisplay];
+      CGColorRef newBackgroundCGColor = [newBackgroundColor CGColor];
+      BOOL shouldApply = ASDisplayNodeShouldApplyBridgedWriteToView(self);
+
+      if (shouldApply) {
+        CGColorRef oldBackgroundCGColor = _layer.backgroundColor;
+
+        BOOL specialPropertiesHandling = ASDisplayNodeNeedsSpecialPropertiesHandlingForFlags(_flags);
+        if (specialPropertiesHandling) {
+            _view.backgroundColor = newBackgroundColor;
+        } else {
+            _layer.backgroundColor = newBackgroundCGColor;
+        }
+
+        needsDisplay = !CGColorEqualToColor(oldBackgroundCGColor, newBackgroundCGColor);
+      } else {
+        // NOTE: If we're in the background, we cannot read the current value of bgcolor (if loaded).
+        // When the pending state is applied to the view on main, we will call `setNeedsDisplay` if
+        // the new background color doesn't match the one on the layer.
+        ASDisplayNodeGetPendingState(self).backgroundColor = newBackgroundCGColor;
+      }
     }
-  } else {
-    // NOTE: If we're in the background, we cannot read the current value of bgcolor (if loaded).
-    // When the pending state is applied to the view on main, we will call `setNeedsDisplay` if
-    // the new background color doesn't match the one on the layer.
-    ASDisplayNodeGetPendingState(self).backgroundColor = newBackgroundCGColor;
+  }
+
+  // Like -setCornerRadius:, redisplay only once the lock is released.
+  if (needsDisplay) {
+    [self setNeedsDisplay];
   }
 }
 
@@ -716,25 +853,52 @@ if (shouldApply) { _layer.layerProperty = (layerValueExpr); } else { ASDisplayNo
 - (CGFloat)borderWidth
 {
   _bridge_prologue_read;
+  if ([self _locked_precompositesCorners]) {
+    return _precompositedBorderWidth;
+  }
   return _getFromLayer(borderWidth);
 }
 
 - (void)setBorderWidth:(CGFloat)width
 {
-  _bridge_prologue_write;
-  _setToLayer(borderWidth, width);
+  {
+    _bridge_prologue_write;
+    if (![self _locked_precompositesCorners]) {
+      _setToLayer(borderWidth, width);
+      return;
+    }
+    if (_precompositedBorderWidth == width) {
+      return;
+    }
+    _precompositedBorderWidth = width;
+  }
+  [self setNeedsDisplay];
 }
 
 - (CGColorRef)borderColor
 {
   _bridge_prologue_read;
+  if ([self _locked_precompositesCorners]) {
+    return _precompositedBorderColor.CGColor;
+  }
   return _getFromLayer(borderColor);
 }
 
 - (void)setBorderColor:(CGColorRef)colorValue
 {
-  _bridge_prologue_write;
-  _setToLayer(borderColor, colorValue);
+  {
+    _bridge_prologue_write;
+    if (![self _locked_precompositesCorners]) {
+      _setToLayer(borderColor, colorValue);
+      return;
+    }
+    UIColor *borderColor = colorValue ? [UIColor colorWithCGColor:colorValue] : nil;
+    if (ASObjectIsEqual(_precompositedBorderColor, borderColor)) {
+      return;
+    }
+    _precompositedBorderColor = borderColor;
+  }
+  [self setNeedsDisplay];
 }
 
 - (BOOL)allowsGroupOpacity
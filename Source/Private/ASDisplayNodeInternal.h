@@ -14,13 +14,16 @@
 //
 
 #import <atomic>
+#import <memory>
 #import <AsyncDisplayKit/ASDisplayNode.h>
 #import <AsyncDisplayKit/ASDisplayNode+Beta.h>
+#import <AsyncDisplayKit/ASBridgedPropertySnapshot.h>
 #import <AsyncDisplayKit/ASLayoutElement.h>
 #import <AsyncDisplayKit/ASLayoutTransition.h>
 #import <AsyncDisplayKit/ASThread.h>
 #import <AsyncDisplayKit/_ASTransitionContext.h>
 #import <AsyncDisplayKit/ASWeakSet.h>
+#import <AsyncDisplayKit/_ASAsyncTransaction.h>
 
 NS_ASSUME_NONNULL_BEGIN
 
@@ -29,6 +32,7 @@ NS_ASSUME_NONNULL_BEGIN
 @class _ASPendingState;
 @class ASSentinel;
 struct ASDisplayNodeFlags;
+struct ASRasterizedComposite;
 
 BOOL ASDisplayNodeSubclassOverridesSelector(Class subclass, SEL selector);
 BOOL ASDisplayNodeNeedsSpecialPropertiesHandlingForFlags(ASDisplayNodeFlags flags);
@@ -60,6 +64,8 @@ FOUNDATION_EXPORT NSString * const ASRenderingEngineDidDisplayNodesScheduledBefo
 {
 @package
   _ASPendingState *_pendingViewState;
+  // The pending values of the most-read bridged properties, for getters that don't take the lock.
+  ASBridgedPropertySnapshot _bridgedPropertySnapshot;
 
   UIView *_view;
   CALayer *_layer;
@@ -70,6 +76,7 @@ FOUNDATION_EXPORT NSString * const ASRenderingEngineDidDisplayNodesScheduledBefo
     unsigned layerBacked:1;
     unsigned displaysAsynchronously:1;
     unsigned shouldRasterizeDescendants:1;
+    unsigned rasterizesDescendantsIncrementally:1;
     unsigned shouldBypassEnsureDisplay:1;
     unsigned displaySuspended:1;
     unsigned shouldAnimateSizeChanges:1;
@@ -112,6 +119,8 @@ FOUNDATION_EXPORT NSString * const ASRenderingEngineDidDisplayNodesScheduledBefo
   ASPrimitiveTraitCollection _primitiveTraitCollection;
 
   std::atomic_uint _displaySentinel;
+  // The display operation most recently added to the display queue. Stale once it starts executing.
+  std::atomic<ASAsyncTransactionOperationHandle> _pendingDisplayOperation;
 
   // This is the desired contentsScale, not the scale at which the layer's contents should be displayed
   CGFloat _contentsScaleForDisplay;
@@ -146,6 +155,27 @@ FOUNDATION_EXPORT NSString * const ASRenderingEngineDidDisplayNodesScheduledBefo
   UIImage *_placeholderImage;
   CALayer *_placeholderLayer;
 
+  // Incremental rasterization. Bumped by -setNeedsDisplay, to tell which rasterized descendants changed.
+  NSUInteger _rasterizedContentsGeneration;
+  // What a rasterized descendant last drew, and for which generation, bounds size and scale.
+  UIImage *_rasterizedTile;
+  NSUInteger _rasterizedTileGeneration;
+  CGSize _rasterizedTileSize;
+  CGFloat _rasterizedTileScale;
+  // The last backing store drawn by a rasterizing container, and what went into it.
+  std::shared_ptr<ASRasterizedComposite> _rasterizedComposite;
+
+  // Corner rounding, see ASCornerRoundingType. Unless the layer rounds the corners, the radius is kept here, and so are
+  // the background color and border that precompositing nodes draw.
+  ASCornerRoundingType _cornerRoundingType;
+  CGFloat _cornerRadius;
+  UIColor *_precompositedBackgroundColor;
+  CGFloat _precompositedBorderWidth;
+  UIColor *_precompositedBorderColor;
+  UIColor *_clipCornerColor;
+  // Only used on the main thread, but set with the lock held so that layout can check for them.
+  CALayer *_clipCornerLayers[4];
+
   // keeps track of nodes/subnodes that have not finished display, used with placeholders
   ASWeakSet *_pendingDisplayNodes;
 
@@ -210,6 +240,34 @@ FOUNDATION_EXPORT NSString * const ASRenderingEngineDidDisplayNodesScheduledBefo
  */
 - (void)__setNeedsDisplay;
 
+/**
+ * Marks the backing store as needing display without marking the node's own contents as changed, e.g. when a
+ * rasterized descendant changed.
+ */
+- (void)_setNeedsDisplayOfBackingStore;
+
+/**
+ * Releases the tiles of rasterized descendants and the last rasterized backing store.
+ */
+- (void)_clearRasterizationCaches;
+
+/**
+ * Whether the node draws its corners, background color and border, see ASCornerRoundingTypePrecomposited. Must be
+ * called with the instance lock held.
+ */
+- (BOOL)_locked_precompositesCorners;
+
+/**
+ * Whether the node uses ASCornerRoundingTypeClipping or still has corner layers to remove. Nodes that don't skip
+ * -_updateClipCornerLayers on load and layout. Must be called with the instance lock held.
+ */
+- (BOOL)_locked_needsClipCornerLayerUpdate;
+
+/**
+ * Adds, updates or removes the corner overlay of ASCornerRoundingTypeClipping to match the node's bounds.
+ */
+- (void)_updateClipCornerLayers;
+
 /**
  * Called from [CALayer layoutSublayers:]. Executes the layout pass for the node
  */
@@ -0,0 +1,102 @@
+//
+//  ASGraphicsBufferPool.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Counters for @c ASGraphicsBufferPool.
+ */
+typedef struct {
+  /// Buffers allocated because the pool had none of the right size.
+  NSUInteger allocatedBufferCount;
+  /// Buffers handed out from the pool instead of being allocated.
+  NSUInteger reusedBufferCount;
+  /// Bytes of the buffers that were allocated.
+  unsigned long long allocatedByteCount;
+  /// Bytes of the buffers that were reused.
+  unsigned long long reusedByteCount;
+  /// Buffers freed instead of being pooled because the pool was at its byte limit.
+  NSUInteger discardedBufferCount;
+  /// Bytes currently held by the pool.
+  NSUInteger pooledByteCount;
+} ASGraphicsBufferPoolMetrics;
+
+/**
+ * @abstract A pool of bitmap buffers for the render queues, bucketed by size.
+ *
+ * @discussion Drawing into a new bitmap context means allocating and zero-filling its backing store, and getting an
+ * image out of it means copying or faulting that memory again. Contexts begun with
+ * ASGraphicsBeginImageContextWithOptions draw into a buffer from the pool instead, and the image ending the context
+ * wraps the buffer without a copy. The buffer goes back to the pool once the image is released, typically when the
+ * layer showing it has its contents cleared.
+ *
+ * Sizes are rounded up to eight size classes per power of two, so a buffer serves any bitmap up to 12.5% smaller.
+ * The pool keeps at most byteLimit bytes of unused buffers and is emptied on memory warnings. This class is
+ * thread-safe.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASGraphicsBufferPool : NSObject
+
++ (ASGraphicsBufferPool *)sharedPool;
+
+/**
+ * @param byteLimit The maximum number of bytes of unused buffers held by the pool.
+ */
+- (instancetype)initWithByteLimit:(NSUInteger)byteLimit NS_DESIGNATED_INITIALIZER;
+
+/**
+ * Creates a pool holding up to 16MB of unused buffers.
+ */
+- (instancetype)init;
+
+@property (atomic, assign) NSUInteger byteLimit;
+
+/**
+ * Whether the images of contexts begun with ASGraphicsBeginImageContextWithOptions use pooled buffers. Defaults to
+ * YES; when NO, contexts are begun with UIGraphicsBeginImageContextWithOptions.
+ */
+@property (class, atomic, assign, getter=isEnabled) BOOL enabled;
+
+- (void)removeAllBuffers;
+
+- (ASGraphicsBufferPoolMetrics)metrics;
+
+- (void)resetMetrics;
+
+@end
+
+ASDISPLAYNODE_EXTERN_C_BEGIN
+
+/**
+ * Like UIGraphicsBeginImageContextWithOptions, but draws into a cleared buffer from the shared pool. The context must
+ * be ended with ASGraphicsGetImageAndEndCurrentContext or ASGraphicsEndImageContext on the same thread.
+ *
+ * @param scale The scale of the context. Unlike UIKit, 0 is not allowed.
+ */
+extern void ASGraphicsBeginImageContextWithOptions(CGSize size, BOOL opaque, CGFloat scale);
+
+/**
+ * Returns an image of what was drawn into the current context and ends it. The image shares the context's buffer,
+ * which goes back to the pool when the image is released.
+ */
+extern UIImage * _Nullable ASGraphicsGetImageAndEndCurrentContext(void) AS_WARN_UNUSED_RESULT;
+
+/**
+ * Ends the current context without making an image, e.g. when drawing was cancelled. The buffer goes back to the pool.
+ */
+extern void ASGraphicsEndImageContext(void);
+
+ASDISPLAYNODE_EXTERN_C_END
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,353 @@
+//
+//  ASGraphicsBufferPool.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASGraphicsBufferPool.h>
+
+#import <atomic>
+#import <map>
+#import <pthread.h>
+#import <vector>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASThread.h>
+
+static const NSUInteger ASGraphicsBufferPoolDefaultByteLimit = 16 * 1024 * 1024;
+static const size_t ASGraphicsBufferMinimumCapacity = 4096;
+// Core Animation can use bitmaps whose rows are aligned to 64 bytes without copying them.
+static const size_t ASGraphicsBufferRowAlignment = 64;
+
+static std::atomic<bool> __enabled(true);
+
+/**
+ * Rounds the byte count up to one of eight size classes per power of two, so that similar sizes share buffers while
+ * wasting at most an eighth of a buffer.
+ */
+static size_t ASGraphicsBufferCapacityForByteCount(size_t byteCount)
+{
+  if (byteCount <= ASGraphicsBufferMinimumCapacity) {
+    return ASGraphicsBufferMinimumCapacity;
+  }
+  size_t step = 1;
+  while ((step << 4) <= byteCount) {
+    step <<= 1;
+  }
+  return (byteCount + step - 1) / step * step;
+}
+
+static CGColorSpaceRef ASGraphicsBufferColorSpace()
+{
+  static CGColorSpaceRef colorSpace;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    colorSpace = CGColorSpaceCreateDeviceRGB();
+  });
+  return colorSpace;
+}
+
+@interface ASGraphicsBufferPool ()
+- (void *)_dequeueBufferWithCapacity:(size_t)capacity reused:(BOOL *)reused;
+- (void)_enqueueBuffer:(void *)bytes capacity:(size_t)capacity;
+@end
+
+#pragma mark - Pool
+
+@implementation ASGraphicsBufferPool {
+  ASDN::Mutex _lock;
+  std::map<size_t, std::vector<void *>> _buffersByCapacity;
+  NSUInteger _byteLimit;
+  ASGraphicsBufferPoolMetrics _metrics;
+}
+
++ (ASGraphicsBufferPool *)sharedPool
+{
+  static ASGraphicsBufferPool *sharedPool;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedPool = [[ASGraphicsBufferPool alloc] init];
+  });
+  return sharedPool;
+}
+
++ (BOOL)isEnabled
+{
+  return __enabled.load();
+}
+
++ (void)setEnabled:(BOOL)enabled
+{
+  __enabled.store(enabled);
+}
+
+- (instancetype)init
+{
+  return [self initWithByteLimit:ASGraphicsBufferPoolDefaultByteLimit];
+}
+
+- (instancetype)initWithByteLimit:(NSUInteger)byteLimit
+{
+  if (self = [super init]) {
+    _byteLimit = byteLimit;
+
+    [[NSNotificationCenter defaultCenter] addObserver:self
+                                             selector:@selector(didReceiveMemoryWarning:)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+  [self removeAllBuffers];
+}
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification
+{
+  [self removeAllBuffers];
+}
+
+- (NSUInteger)byteLimit
+{
+  ASDN::MutexLocker l(_lock);
+  return _byteLimit;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit
+{
+  ASDN::MutexLocker l(_lock);
+  _byteLimit = byteLimit;
+  // Free the largest buffers first, they're the least likely to be asked for again.
+  while (_metrics.pooledByteCount > byteLimit) {
+    auto largest = std::prev(_buffersByCapacity.end());
+    free(largest->second.back());
+    largest->second.pop_back();
+    _metrics.pooledByteCount -= largest->first;
+    if (largest->second.empty()) {
+      _buffersByCapacity.erase(largest);
+    }
+  }
+}
+
+- (void *)_dequeueBufferWithCapacity:(size_t)capacity reused:(BOOL *)reused
+{
+  {
+    ASDN::MutexLocker l(_lock);
+    auto it = _buffersByCapacity.find(capacity);
+    if (it != _buffersByCapacity.end()) {
+      void *bytes = it->second.back();
+      it->second.pop_back();
+      if (it->second.empty()) {
+        _buffersByCapacity.erase(it);
+      }
+      _metrics.pooledByteCount -= capacity;
+      _metrics.reusedBufferCount++;
+      _metrics.reusedByteCount += capacity;
+      *reused = YES;
+      return bytes;
+    }
+    _metrics.allocatedBufferCount++;
+    _metrics.allocatedByteCount += capacity;
+  }
+  // Fresh pages from calloc are zero without being touched.
+  *reused = NO;
+  return calloc(1, capacity);
+}
+
+- (void)_enqueueBuffer:(void *)bytes capacity:(size_t)capacity
+{
+  {
+    ASDN::MutexLocker l(_lock);
+    if (_metrics.pooledByteCount + capacity <= _byteLimit) {
+      _buffersByCapacity[capacity].push_back(bytes);
+      _metrics.pooledByteCount += capacity;
+      return;
+    }
+    _metrics.discardedBufferCount++;
+  }
+  free(bytes);
+}
+
+- (void)removeAllBuffers
+{
+  std::map<size_t, std::vector<void *>> buffersByCapacity;
+  {
+    ASDN::MutexLocker l(_lock);
+    std::swap(buffersByCapacity, _buffersByCapacity);
+    _metrics.pooledByteCount = 0;
+  }
+  for (auto &entry : buffersByCapacity) {
+    for (void *bytes : entry.second) {
+      free(bytes);
+    }
+  }
+}
+
+- (ASGraphicsBufferPoolMetrics)metrics
+{
+  ASDN::MutexLocker l(_lock);
+  return _metrics;
+}
+
+- (void)resetMetrics
+{
+  ASDN::MutexLocker l(_lock);
+  NSUInteger pooledByteCount = _metrics.pooledByteCount;
+  _metrics = {};
+  _metrics.pooledByteCount = pooledByteCount;
+}
+
+@end
+
+#pragma mark - Contexts
+
+namespace {
+  /// Owned by the data provider of an image, returns the buffer to the pool when the image goes away.
+  struct ASGraphicsBufferInfo {
+    ASGraphicsBufferPool *pool;
+    size_t capacity;
+  };
+
+  struct ASGraphicsContextEntry {
+    CGContextRef context;         // NULL if the context was begun with UIKit.
+    ASGraphicsBufferInfo *info;
+    void *bytes;
+    size_t width;
+    size_t height;
+    size_t bytesPerRow;
+    CGBitmapInfo bitmapInfo;
+    CGFloat scale;
+  };
+
+  typedef std::vector<ASGraphicsContextEntry> ASGraphicsContextStack;
+}
+
+static void ASGraphicsBufferRelease(void *info, const void *data, size_t size)
+{
+  ASGraphicsBufferInfo *bufferInfo = (ASGraphicsBufferInfo *)info;
+  [bufferInfo->pool _enqueueBuffer:(void *)data capacity:bufferInfo->capacity];
+  delete bufferInfo;
+}
+
+static ASGraphicsContextStack &ASGraphicsCurrentContextStack()
+{
+  static pthread_key_t key;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    pthread_key_create(&key, [](void *stack) {
+      delete (ASGraphicsContextStack *)stack;
+    });
+  });
+  ASGraphicsContextStack *stack = (ASGraphicsContextStack *)pthread_getspecific(key);
+  if (stack == NULL) {
+    stack = new ASGraphicsContextStack();
+    pthread_setspecific(key, stack);
+  }
+  return *stack;
+}
+
+void ASGraphicsBeginImageContextWithOptions(CGSize size, BOOL opaque, CGFloat scale)
+{
+  ASDisplayNodeCAssert(scale > 0, @"Graphics contexts need an explicit scale, got %f", scale);
+  ASGraphicsContextStack &stack = ASGraphicsCurrentContextStack();
+  ASGraphicsContextEntry entry = {};
+
+  size_t width = (size_t)ceil(size.width * scale);
+  size_t height = (size_t)ceil(size.height * scale);
+  if (ASGraphicsBufferPool.isEnabled && width > 0 && height > 0) {
+    ASGraphicsBufferPool *pool = [ASGraphicsBufferPool sharedPool];
+    size_t bytesPerRow = (width * 4 + ASGraphicsBufferRowAlignment - 1) / ASGraphicsBufferRowAlignment * ASGraphicsBufferRowAlignment;
+    size_t byteCount = bytesPerRow * height;
+    size_t capacity = ASGraphicsBufferCapacityForByteCount(byteCount);
+
+    BOOL reused;
+    void *bytes = [pool _dequeueBufferWithCapacity:capacity reused:&reused];
+    if (bytes != NULL) {
+      if (reused) {
+        memset(bytes, 0, byteCount);
+      }
+      CGBitmapInfo bitmapInfo = kCGBitmapByteOrder32Host | (opaque ? kCGImageAlphaNoneSkipFirst : kCGImageAlphaPremultipliedFirst);
+      CGContextRef context = CGBitmapContextCreate(bytes, width, height, 8, bytesPerRow, ASGraphicsBufferColorSpace(), bitmapInfo);
+      if (context != NULL) {
+        // Match UIKit's coordinate space: points, with the origin at the top left.
+        CGContextTranslateCTM(context, 0, height);
+        CGContextScaleCTM(context, scale, -scale);
+        UIGraphicsPushContext(context);
+
+        entry.context = context;
+        entry.info = new ASGraphicsBufferInfo{pool, capacity};
+        entry.bytes = bytes;
+        entry.width = width;
+        entry.height = height;
+        entry.bytesPerRow = bytesPerRow;
+        entry.bitmapInfo = bitmapInfo;
+        entry.scale = scale;
+        stack.push_back(entry);
+        return;
+      }
+      [pool _enqueueBuffer:bytes capacity:capacity];
+    }
+  }
+
+  UIGraphicsBeginImageContextWithOptions(size, opaque, scale);
+  stack.push_back(entry);
+}
+
+/**
+ * Pops the current context. If it drew into a pooled buffer, the caller takes over the buffer.
+ */
+static ASGraphicsContextEntry ASGraphicsPopContext()
+{
+  ASGraphicsContextStack &stack = ASGraphicsCurrentContextStack();
+  ASDisplayNodeCAssertFalse(stack.empty());
+  if (stack.empty()) {
+    return {};
+  }
+  ASGraphicsContextEntry entry = stack.back();
+  stack.pop_back();
+  if (entry.context != NULL) {
+    ASDisplayNodeCAssert(UIGraphicsGetCurrentContext() == entry.context, @"Unbalanced graphics context");
+    UIGraphicsPopContext();
+    CGContextRelease(entry.context);
+  }
+  return entry;
+}
+
+UIImage *ASGraphicsGetImageAndEndCurrentContext(void)
+{
+  ASGraphicsContextEntry entry = ASGraphicsPopContext();
+  if (entry.context == NULL) {
+    UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+    UIGraphicsEndImageContext();
+    return image;
+  }
+
+  // The provider owns the buffer from here on, and returns it to the pool when the image is released.
+  CGDataProviderRef provider = CGDataProviderCreateWithData(entry.info, entry.bytes, entry.bytesPerRow * entry.height, ASGraphicsBufferRelease);
+  CGImageRef imageRef = CGImageCreate(entry.width, entry.height, 8, 32, entry.bytesPerRow, ASGraphicsBufferColorSpace(),
+                                      entry.bitmapInfo, provider, NULL, false, kCGRenderingIntentDefault);
+  CGDataProviderRelease(provider);
+  if (imageRef == NULL) {
+    return nil;
+  }
+  UIImage *image = [UIImage imageWithCGImage:imageRef scale:entry.scale orientation:UIImageOrientationUp];
+  CGImageRelease(imageRef);
+  return image;
+}
+
+void ASGraphicsEndImageContext(void)
+{
+  ASGraphicsContextEntry entry = ASGraphicsPopContext();
+  if (entry.context == NULL) {
+    UIGraphicsEndImageContext();
+    return;
+  }
+  ASGraphicsBufferRelease(entry.info, entry.bytes, entry.bytesPerRow * entry.height);
+}
@@ -0,0 +1,35 @@
+//
+//  ASImageDecoding.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+ASDISPLAYNODE_EXTERN_C_BEGIN
+
+/**
+ * Decodes compressed image data into a bitmap-backed image, so that the first draw of the result doesn't pay for
+ * JPEG/PNG decompression on whatever thread it happens to run on.
+ *
+ * @param data Compressed image data. Memory-mapped data is fine and avoids copying the file.
+ * @param targetPixelSize If not CGSizeZero, the image is downsampled as far as possible while still covering this size
+ * in pixels (i.e. aspect-fill). Images that are already small enough are decoded at full size.
+ * @param bytesSavedByDownsampling If not NULL, receives the difference in decoded bytes between a full size decode and
+ * the returned image.
+ *
+ * @return The decoded image with EXIF orientation applied and a scale of 1, or nil if the data can't be decoded.
+ */
+UIImage * _Nullable ASDecodedImageWithData(NSData *data, CGSize targetPixelSize, NSUInteger * _Nullable bytesSavedByDownsampling);
+
+ASDISPLAYNODE_EXTERN_C_END
+
+NS_ASSUME_NONNULL_END
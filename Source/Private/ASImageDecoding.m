@@ -0,0 +1,76 @@
+//
+//  ASImageDecoding.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASImageDecoding.h>
+
+#import <ImageIO/ImageIO.h>
+#import <tgmath.h>
+
+static const NSUInteger ASImageDecodingBytesPerPixel = 4;
+
+UIImage *ASDecodedImageWithData(NSData *data, CGSize targetPixelSize, NSUInteger *bytesSavedByDownsampling)
+{
+  if (bytesSavedByDownsampling != NULL) {
+    *bytesSavedByDownsampling = 0;
+  }
+  if (data.length == 0) {
+    return nil;
+  }
+
+  // Don't let ImageIO cache the full size decode on the source; we only want the thumbnail below.
+  NSDictionary *sourceOptions = @{ (__bridge NSString *)kCGImageSourceShouldCache : @NO };
+  CGImageSourceRef source = CGImageSourceCreateWithData((__bridge CFDataRef)data, (__bridge CFDictionaryRef)sourceOptions);
+  if (source == NULL) {
+    return nil;
+  }
+
+  NSDictionary *properties = (__bridge_transfer NSDictionary *)CGImageSourceCopyPropertiesAtIndex(source, 0, NULL);
+  CGFloat pixelWidth = [properties[(__bridge NSString *)kCGImagePropertyPixelWidth] doubleValue];
+  CGFloat pixelHeight = [properties[(__bridge NSString *)kCGImagePropertyPixelHeight] doubleValue];
+  if (pixelWidth <= 0 || pixelHeight <= 0) {
+    CFRelease(source);
+    return nil;
+  }
+
+  // EXIF orientations 5 through 8 are rotated by 90 degrees, so compare against the target with axes swapped.
+  NSInteger orientation = [properties[(__bridge NSString *)kCGImagePropertyOrientation] integerValue];
+  CGSize orientedPixelSize = (orientation >= 5) ? CGSizeMake(pixelHeight, pixelWidth) : CGSizeMake(pixelWidth, pixelHeight);
+
+  CGFloat scale = 1.0;
+  if (targetPixelSize.width > 0 && targetPixelSize.height > 0) {
+    scale = MIN(1.0, MAX(targetPixelSize.width / orientedPixelSize.width, targetPixelSize.height / orientedPixelSize.height));
+  }
+  // Tolerate floating point error so that an exact fit doesn't round up by a pixel.
+  CGFloat maxPixelSize = ceil(MAX(pixelWidth, pixelHeight) * scale - 0.01);
+
+  // The thumbnail path both downsamples and applies the orientation. kCGImageSourceShouldCacheImmediately forces the
+  // decode to happen here rather than at first draw.
+  NSDictionary *thumbnailOptions = @{
+    (__bridge NSString *)kCGImageSourceCreateThumbnailFromImageAlways : @YES,
+    (__bridge NSString *)kCGImageSourceCreateThumbnailWithTransform : @YES,
+    (__bridge NSString *)kCGImageSourceShouldCacheImmediately : @YES,
+    (__bridge NSString *)kCGImageSourceThumbnailMaxPixelSize : @(maxPixelSize),
+  };
+  CGImageRef imageRef = CGImageSourceCreateThumbnailAtIndex(source, 0, (__bridge CFDictionaryRef)thumbnailOptions);
+  CFRelease(source);
+  if (imageRef == NULL) {
+    return nil;
+  }
+
+  if (bytesSavedByDownsampling != NULL) {
+    NSUInteger fullBytes = (NSUInteger)(pixelWidth * pixelHeight) * ASImageDecodingBytesPerPixel;
+    NSUInteger decodedBytes = CGImageGetWidth(imageRef) * CGImageGetHeight(imageRef) * ASImageDecodingBytesPerPixel;
+    *bytesSavedByDownsampling = (fullBytes > decodedBytes) ? fullBytes - decodedBytes : 0;
+  }
+
+  UIImage *image = [UIImage imageWithCGImage:imageRef scale:1.0 orientation:UIImageOrientationUp];
+  CGImageRelease(imageRef);
+  return image;
+}
@@ -12,6 +12,8 @@
 
 #import <AsyncDisplayKit/ASThread.h>
 
+@class ASAnimatedImageFrameBuffer;
+
 extern NSString *const ASAnimatedImageDefaultRunLoopMode;
 
 @interface ASImageNode ()
@@ -19,13 +21,20 @@ extern NSString *const ASAnimatedImageDefaultRunLoopMode;
   ASDN::RecursiveMutex _animatedImageLock;
   ASDN::Mutex _displayLinkLock;
   id <ASAnimatedImageProtocol> _animatedImage;
+  ASAnimatedImageFrameBuffer *_frameBuffer;
   BOOL _animatedImagePaused;
   NSString *_animatedImageRunLoopMode;
-  CADisplayLink *_displayLink;
+  // Whether the node is registered with the shared ASAnimatedImageDriver, and whether it ever was.
+  BOOL _animating;
+  BOOL _animationStarted;
   
   //accessed on main thread only
   CFTimeInterval _playHead;
   NSUInteger _playedLoops;
+  NSUInteger _ticksSinceFrameUpdate;
+  // The frame currently in the layer's contents, so that unchanged frames aren't set again.
+  __weak ASAnimatedImageFrameBuffer *_displayedFrameBuffer;
+  NSUInteger _displayedFrameIndex;
 }
 
 @property (nonatomic, assign) CFTimeInterval lastDisplayLinkFire;
@@ -0,0 +1,169 @@
+//
+//  ASIndexRangeSet.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+
+#import <algorithm>
+#import <vector>
+
+namespace AS {
+  /**
+   * A set of indexes stored as sorted, disjoint ranges along with the number of indexes below each range, so that
+   * counting and translating indexes is a binary search rather than a walk over every index like with NSIndexSet.
+   *
+   * Ranges can be added in any order. Adding them in ascending order, the common case for change sets, is
+   * amortized O(1); otherwise the ranges are sorted and merged on the next query.
+   */
+  class IndexRangeSet {
+  public:
+    void add(NSUInteger index)
+    {
+      add(NSMakeRange(index, 1));
+    }
+
+    void add(NSRange range)
+    {
+      if (range.length == 0) {
+        return;
+      }
+      _prepared = false;
+      if (_ranges.empty() || range.location > NSMaxRange(_ranges.back())) {
+        _ranges.push_back(range);
+      } else if (range.location >= _ranges.back().location) {
+        NSRange &last = _ranges.back();
+        last.length = MAX(NSMaxRange(last), NSMaxRange(range)) - last.location;
+      } else {
+        _ranges.push_back(range);
+        _sorted = false;
+      }
+    }
+
+    bool empty() const
+    {
+      return _ranges.empty();
+    }
+
+    NSUInteger count()
+    {
+      prepare();
+      return _ranges.empty() ? 0 : _below.back() + _ranges.back().length;
+    }
+
+    const std::vector<NSRange> &ranges()
+    {
+      prepare();
+      return _ranges;
+    }
+
+    bool contains(NSUInteger index)
+    {
+      prepare();
+      size_t i = rangesStartingAtOrBelow(index);
+      return i > 0 && index < NSMaxRange(_ranges[i - 1]);
+    }
+
+    /// The number of indexes in the set that are less than the given index.
+    NSUInteger countOfIndexesBelow(NSUInteger index)
+    {
+      prepare();
+      size_t i = rangesStartingAtOrBelow(index);
+      if (i == 0) {
+        return 0;
+      }
+      const NSRange &range = _ranges[i - 1];
+      return _below[i - 1] + MIN(range.length, index - range.location);
+    }
+
+    /**
+     * Treating the set as indexes being inserted, returns where the item at the given index ends up, i.e. the index
+     * plus the number of insertions at or below it. Same as -[NSIndexSet as_indexChangeByInsertingItemsBelowIndex:].
+     */
+    NSUInteger indexByInsertingItemsBelowIndex(NSUInteger index)
+    {
+      prepare();
+      // The number of untouched indexes before each range never decreases, so find the last range that starts at or
+      // before the index's position among them.
+      size_t low = 0, high = _ranges.size();
+      while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (_ranges[mid].location - _below[mid] <= index) {
+          low = mid + 1;
+        } else {
+          high = mid;
+        }
+      }
+      return (low == 0) ? index : index + _below[low - 1] + _ranges[low - 1].length;
+    }
+
+    /// The smallest index in both sets, or NSNotFound.
+    NSUInteger firstIndexInCommonWith(IndexRangeSet &other)
+    {
+      prepare();
+      other.prepare();
+      auto a = _ranges.cbegin();
+      auto b = other._ranges.cbegin();
+      while (a != _ranges.cend() && b != other._ranges.cend()) {
+        NSUInteger start = MAX(a->location, b->location);
+        if (start < MIN(NSMaxRange(*a), NSMaxRange(*b))) {
+          return start;
+        }
+        if (NSMaxRange(*a) < NSMaxRange(*b)) {
+          ++a;
+        } else {
+          ++b;
+        }
+      }
+      return NSNotFound;
+    }
+
+  private:
+    std::vector<NSRange> _ranges;
+    std::vector<NSUInteger> _below;
+    bool _sorted = true;
+    bool _prepared = true;
+
+    size_t rangesStartingAtOrBelow(NSUInteger index) const
+    {
+      return std::upper_bound(_ranges.cbegin(), _ranges.cend(), index, [](NSUInteger index, const NSRange &range) {
+        return index < range.location;
+      }) - _ranges.cbegin();
+    }
+
+    void prepare()
+    {
+      if (_prepared) {
+        return;
+      }
+      _prepared = true;
+      if (!_sorted) {
+        _sorted = true;
+        std::sort(_ranges.begin(), _ranges.end(), [](const NSRange &a, const NSRange &b) {
+          return a.location < b.location;
+        });
+        size_t merged = 0;
+        for (size_t i = 1; i < _ranges.size(); i++) {
+          NSRange &last = _ranges[merged];
+          if (_ranges[i].location <= NSMaxRange(last)) {
+            last.length = MAX(NSMaxRange(last), NSMaxRange(_ranges[i])) - last.location;
+          } else {
+            _ranges[++merged] = _ranges[i];
+          }
+        }
+        _ranges.resize(merged + 1);
+      }
+      _below.resize(_ranges.size());
+      NSUInteger below = 0;
+      for (size_t i = 0; i < _ranges.size(); i++) {
+        _below[i] = below;
+        below += _ranges[i].length;
+      }
+    }
+  };
+};
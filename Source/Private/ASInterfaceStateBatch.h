@@ -0,0 +1,76 @@
+//
+//  ASInterfaceStateBatch.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <QuartzCore/QuartzCore.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASDisplayNode.h>
+
+@class ASCellNode;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Collects the interface state changes a range controller makes to its cell nodes during one update, and applies
+ * them together once the whole update has been computed.
+ *
+ * Changes that enter a state, or leave the visible state, are urgent. -commitDeferringExits: applies them in one pass,
+ * in the order they were added, so the network and display queues see all of the update's work at once with visible
+ * nodes first. Changes that only leave the display or preload states are deferred to later run loop turns, spending at
+ * most deferredTimeBudget per turn, so that a big jump doesn't tear down thousands of nodes in the same frame that
+ * builds up thousands of others.
+ *
+ * A deferred change is dropped when a new change is set, or the deferred change is cancelled, for the same node.
+ * Nodes are held weakly while deferred. Main thread only.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASInterfaceStateBatch : NSObject
+
+/**
+ * The time spent applying deferred changes per run loop turn. At least one change is applied per turn.
+ * Defaults to 2ms.
+ */
+@property (nonatomic, assign) CFTimeInterval deferredTimeBudget;
+
+/**
+ * Sets the interface state to apply to the node and its subnodes at the next commit.
+ */
+- (void)setInterfaceState:(ASInterfaceState)interfaceState forNode:(ASCellNode *)node;
+
+/**
+ * Drops the deferred change for the node, if there is one.
+ */
+- (void)cancelDeferredInterfaceStateForNode:(ASCellNode *)node;
+
+/**
+ * Applies the urgent changes set since the last commit, and schedules the others.
+ *
+ * @param deferExits Pass NO to apply every change right away, e.g. when the changes are meant to free memory.
+ */
+- (void)commitDeferringExits:(BOOL)deferExits;
+
+/**
+ * Applies deferred changes until the time budget is spent, and returns whether any are left.
+ */
+- (BOOL)applyDeferredInterfaceStatesWithTimeBudget:(CFTimeInterval)timeBudget;
+
+/**
+ * Applies every deferred change right away.
+ */
+- (void)flushDeferredInterfaceStates;
+
+/**
+ * The number of deferred changes waiting to be applied.
+ */
+@property (nonatomic, readonly) NSUInteger deferredCount;
+
+@end
+
+NS_ASSUME_NONNULL_END
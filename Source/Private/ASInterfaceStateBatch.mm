@@ -0,0 +1,146 @@
+//
+//  ASInterfaceStateBatch.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASInterfaceStateBatch.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+
+#include <deque>
+#include <vector>
+
+struct ASInterfaceStateChange {
+  ASCellNode *node;
+  ASInterfaceState interfaceState;
+};
+
+@implementation ASInterfaceStateBatch
+{
+  // Changes to apply at the next commit, in the order they were set.
+  std::vector<ASInterfaceStateChange> _changes;
+
+  // The deferred state of each node, and the order they were deferred in. Cancelled or replaced changes are left in
+  // the order and skipped when reached.
+  NSMapTable<ASCellNode *, NSNumber *> *_deferredStates;
+  std::deque<__weak ASCellNode *> _deferredOrder;
+  BOOL _deferredApplicationScheduled;
+}
+
+- (instancetype)init
+{
+  if (!(self = [super init])) {
+    return nil;
+  }
+  _deferredTimeBudget = 0.002;
+  _deferredStates = [NSMapTable weakToStrongObjectsMapTable];
+  return self;
+}
+
+#pragma mark - Changes
+
+- (void)setInterfaceState:(ASInterfaceState)interfaceState forNode:(ASCellNode *)node
+{
+  ASDisplayNodeAssertMainThread();
+  [self cancelDeferredInterfaceStateForNode:node];
+  _changes.push_back({ node, interfaceState });
+}
+
+- (void)cancelDeferredInterfaceStateForNode:(ASCellNode *)node
+{
+  ASDisplayNodeAssertMainThread();
+  if (_deferredStates.count > 0) {
+    [_deferredStates removeObjectForKey:node];
+  }
+}
+
+- (void)commitDeferringExits:(BOOL)deferExits
+{
+  ASDisplayNodeAssertMainThread();
+  // Swap out the changes first; applying them calls into arbitrary subclass code, which may cause another update.
+  std::vector<ASInterfaceStateChange> changes;
+  changes.swap(_changes);
+
+  for (const ASInterfaceStateChange &change : changes) {
+    ASInterfaceState currentState = change.node.interfaceState;
+    if (currentState == change.interfaceState) {
+      continue;
+    }
+    BOOL entersState = (change.interfaceState & ~currentState) != 0;
+    BOOL changesVisibility = ASInterfaceStateIncludesVisible(change.interfaceState) != ASInterfaceStateIncludesVisible(currentState);
+    if (deferExits && !entersState && !changesVisibility) {
+      [_deferredStates setObject:@(change.interfaceState) forKey:change.node];
+      _deferredOrder.push_back(change.node);
+    } else {
+      [change.node recursivelySetInterfaceState:change.interfaceState];
+    }
+  }
+
+  if (!deferExits) {
+    [self flushDeferredInterfaceStates];
+  } else {
+    [self _scheduleDeferredApplicationIfNeeded];
+  }
+}
+
+#pragma mark - Deferred Changes
+
+- (NSUInteger)deferredCount
+{
+  ASDisplayNodeAssertMainThread();
+  return _deferredStates.count;
+}
+
+- (BOOL)applyDeferredInterfaceStatesWithTimeBudget:(CFTimeInterval)timeBudget
+{
+  ASDisplayNodeAssertMainThread();
+  CFTimeInterval deadline = CACurrentMediaTime() + timeBudget;
+  BOOL appliedChange = NO;
+  while (!_deferredOrder.empty() && (!appliedChange || CACurrentMediaTime() < deadline)) {
+    ASCellNode *node = _deferredOrder.front();
+    _deferredOrder.pop_front();
+    NSNumber *interfaceState = (node != nil ? [_deferredStates objectForKey:node] : nil);
+    if (interfaceState == nil) {
+      continue;
+    }
+    [_deferredStates removeObjectForKey:node];
+    if (node.interfaceState != interfaceState.unsignedIntegerValue) {
+      [node recursivelySetInterfaceState:(ASInterfaceState)interfaceState.unsignedIntegerValue];
+    }
+    appliedChange = YES;
+  }
+  return !_deferredOrder.empty();
+}
+
+- (void)flushDeferredInterfaceStates
+{
+  [self applyDeferredInterfaceStatesWithTimeBudget:DBL_MAX];
+}
+
+- (void)_scheduleDeferredApplicationIfNeeded
+{
+  if (_deferredApplicationScheduled || _deferredOrder.empty()) {
+    return;
+  }
+  _deferredApplicationScheduled = YES;
+
+  __weak __typeof__(self) weakSelf = self;
+  dispatch_async(dispatch_get_main_queue(), ^{
+    __typeof__(self) strongSelf = weakSelf;
+    if (strongSelf == nil) {
+      return;
+    }
+    strongSelf->_deferredApplicationScheduled = NO;
+    [strongSelf applyDeferredInterfaceStatesWithTimeBudget:strongSelf->_deferredTimeBudget];
+    [strongSelf _scheduleDeferredApplicationIfNeeded];
+  });
+}
+
+@end
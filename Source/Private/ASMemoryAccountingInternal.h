@@ -0,0 +1,40 @@
+//
+//  ASMemoryAccountingInternal.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASMemoryAccounting.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+@interface ASMemoryUsage ()
+
+- (instancetype)initWithName:(NSString *)name;
+
+- (void)addBytes:(NSUInteger)bytes forCategory:(ASMemoryCategory)category;
+
+- (void)addUsage:(ASMemoryUsage *)usage;
+
+@end
+
+/**
+ * The bytes of a bitmap, which may be a CGImageRef, as set on layer.contents, or a UIImage.
+ */
+extern NSUInteger ASMemoryEstimatedBytesOfContents(id _Nullable contents);
+
+/**
+ * The bytes of the decoded images in the ASImageNode contents cache. Implemented in ASImageNode.mm.
+ */
+extern NSUInteger ASImageNodeContentsCacheEstimatedBytes(void);
+
+/**
+ * The bytes of the renderers kept by ASTextNode. Implemented in ASTextNode.mm.
+ */
+extern NSUInteger ASTextNodeRendererCacheEstimatedBytes(void);
+
+NS_ASSUME_NONNULL_END
@@ -12,6 +12,7 @@
 
 #import <AsyncDisplayKit/ASPendingStateController.h>
 #import <AsyncDisplayKit/ASThread.h>
+#import <AsyncDisplayKit/ASTraceBuffer.h>
 #import <AsyncDisplayKit/ASWeakSet.h>
 #import <AsyncDisplayKit/ASDisplayNodeInternal.h> // Required for -applyPendingViewState; consider moving this to +FrameworkPrivate
 
@@ -64,6 +65,7 @@
 - (void)flush
 {
   ASDisplayNodeAssertMainThread();
+  ASDN::TraceScope traceScope(ASTraceSpanPendingStateFlush, Nil);
   _lock.lock();
     ASWeakSet *dirtyNodes = _dirtyNodes;
     _dirtyNodes = [[ASWeakSet alloc] init];
@@ -0,0 +1,52 @@
+//
+//  ASTraceBufferInternal.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+
+#import <vector>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * A span read back from the buffer of the current thread. Times are in mach absolute time units.
+ */
+struct ASTraceSpanInterval {
+  ASTraceSpan span;
+  uintptr_t cls;
+  uint64_t beginTime;
+  uint64_t endTime;
+  /// The number of spans this one is nested in.
+  size_t depth;
+};
+
+/**
+ * Makes spans record whether ASTraceBuffer.enabled is set or not, until a balancing call to
+ * ASTraceBufferReleaseRecording().
+ */
+extern void ASTraceBufferRetainRecording(void);
+extern void ASTraceBufferReleaseRecording(void);
+
+/**
+ * The name of the kind of span, as used for the categories of exports.
+ */
+extern NSString *ASTraceSpanGetName(ASTraceSpan span);
+
+/**
+ * Returns the position of the next event recorded on the current thread.
+ */
+extern uint64_t ASTraceBufferCurrentThreadPosition();
+
+/**
+ * Returns the spans that the current thread began since the position, in the order they began. Spans still in progress
+ * end at endTime. Spans that were overwritten are left out.
+ */
+extern std::vector<ASTraceSpanInterval> ASTraceBufferCurrentThreadSpans(uint64_t position, uint64_t endTime);
+
+NS_ASSUME_NONNULL_END
@@ -30,7 +30,7 @@ AS_SUBCLASSING_RESTRICTED
 
 /**
  * This is not a full-featured map.  It does not support features like `count` and FastEnumeration because there
- * is not currently a need.
+ * is not currently a need; -allValues is enough for memory accounting.
  *
  * This is a map that does not retain keys or values added to it.  When both getting and setting, the caller is
  * returned a ASWeakMapEntry and must retain it for as long as it wishes the key/value to remain in the map.
@@ -56,6 +56,11 @@ AS_SUBCLASSING_RESTRICTED
  */
 - (ASWeakMapEntry<Value> *)setObject:(Value)value forKey:(Key)key AS_WARN_UNUSED_RESULT;
 
+/**
+ * The values of the entries that are still retained by callers.
+ */
+- (NSArray<Value> *)allValues AS_WARN_UNUSED_RESULT;
+
 @end
 
 
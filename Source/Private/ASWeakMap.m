@@ -82,4 +82,15 @@
   return entry;
 }
 
+- (NSArray *)allValues
+{
+  NSMutableArray *values = [NSMutableArray arrayWithCapacity:self.hashTable.count];
+  for (ASWeakMapEntry *entry in self.hashTable.objectEnumerator) {
+    if (entry.value != nil) {
+      [values addObject:entry.value];
+    }
+  }
+  return values;
+}
+
 @end
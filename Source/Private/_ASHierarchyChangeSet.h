@@ -160,6 +160,15 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType);
 - (void)insertItems:(NSArray<NSIndexPath *> *)indexPaths animationOptions:(ASDataControllerAnimationOptions)options;
 - (void)deleteItems:(NSArray<NSIndexPath *> *)indexPaths animationOptions:(ASDataControllerAnimationOptions)options;
 - (void)reloadItems:(NSArray<NSIndexPath *> *)indexPaths animationOptions:(ASDataControllerAnimationOptions)options;
+
+/**
+ * Bulk variants of the item changes above, for large edits. The indexes are already sorted, so these skip sorting
+ * an array of index paths up front.
+ */
+- (void)insertItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options;
+- (void)deleteItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options;
+- (void)reloadItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options;
+
 - (void)moveSection:(NSInteger)section toSection:(NSInteger)newSection animationOptions:(ASDataControllerAnimationOptions)options;
 - (void)moveItemAtIndexPath:(NSIndexPath *)indexPath toIndexPath:(NSIndexPath *)newIndexPath animationOptions:(ASDataControllerAnimationOptions)options;
 
@@ -16,6 +16,7 @@
 #import <AsyncDisplayKit/ASAssert.h>
 #import <AsyncDisplayKit/ASDisplayNode+Beta.h>
 #import <AsyncDisplayKit/ASObjectDescriptionHelpers.h>
+#import <AsyncDisplayKit/ASIndexRangeSet.h>
 #import <unordered_map>
 #import <AsyncDisplayKit/ASDataController.h>
 #import <AsyncDisplayKit/ASBaseDefines.h>
@@ -65,6 +66,46 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   }
 }
 
+/// Item indexes by section.
+typedef std::unordered_map<NSUInteger, AS::IndexRangeSet> ASSectionIndexRangeSets;
+
+static ASSectionIndexRangeSets ASSectionIndexRangeSetsFromItemChanges(NSArray<_ASHierarchyItemChange *> *changes)
+{
+  ASSectionIndexRangeSets result;
+  // Index paths are sorted, so remember the last section's set rather than hashing for every item.
+  NSUInteger lastSection = NSNotFound;
+  AS::IndexRangeSet *lastSet = nullptr;
+  for (_ASHierarchyItemChange *change in changes) {
+    for (NSIndexPath *indexPath in change.indexPaths) {
+      NSUInteger section = indexPath.section;
+      if (section != lastSection) {
+        lastSection = section;
+        lastSet = &result[section];
+      }
+      lastSet->add(indexPath.item);
+    }
+  }
+  return result;
+}
+
+static AS::IndexRangeSet *ASIndexRangeSetForSection(ASSectionIndexRangeSets &sets, NSUInteger section)
+{
+  auto it = sets.find(section);
+  return (it != sets.end()) ? &it->second : nullptr;
+}
+
+/// Returns the index paths of the given items in ascending order.
+static NSArray<NSIndexPath *> *ASIndexPathsForItemIndexes(NSIndexSet *indexes, NSUInteger section)
+{
+  NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:indexes.count];
+  [indexes enumerateRangesUsingBlock:^(NSRange range, BOOL * _Nonnull stop) {
+    for (NSUInteger item = range.location; item < NSMaxRange(range); item++) {
+      [indexPaths addObject:[NSIndexPath indexPathForItem:item inSection:section]];
+    }
+  }];
+  return indexPaths;
+}
+
 @interface _ASHierarchySectionChange ()
 - (instancetype)initWithChangeType:(_ASHierarchyChangeType)changeType indexSet:(NSIndexSet *)indexSet animationOptions:(ASDataControllerAnimationOptions)animationOptions;
 
@@ -300,6 +341,36 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   [_reloadSectionChanges addObject:change];
 }
 
+- (void)deleteItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options
+{
+  [self _ensureNotCompleted];
+  if (indexes.count == 0) {
+    return;
+  }
+  _ASHierarchyItemChange *change = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeOriginalDelete indexPaths:ASIndexPathsForItemIndexes(indexes, section) animationOptions:options presorted:YES];
+  [_originalDeleteItemChanges addObject:change];
+}
+
+- (void)insertItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options
+{
+  [self _ensureNotCompleted];
+  if (indexes.count == 0) {
+    return;
+  }
+  _ASHierarchyItemChange *change = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeOriginalInsert indexPaths:ASIndexPathsForItemIndexes(indexes, section) animationOptions:options presorted:YES];
+  [_originalInsertItemChanges addObject:change];
+}
+
+- (void)reloadItemsAtIndexes:(NSIndexSet *)indexes inSection:(NSUInteger)section animationOptions:(ASDataControllerAnimationOptions)options
+{
+  [self _ensureNotCompleted];
+  if (indexes.count == 0) {
+    return;
+  }
+  _ASHierarchyItemChange *change = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeReload indexPaths:ASIndexPathsForItemIndexes(indexes, section) animationOptions:options presorted:YES];
+  [_reloadItemChanges addObject:change];
+}
+
 - (void)moveItemAtIndexPath:(NSIndexPath *)indexPath toIndexPath:(NSIndexPath *)newIndexPath animationOptions:(ASDataControllerAnimationOptions)options
 {
   /**
@@ -380,10 +451,10 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
     }
     
     [_ASHierarchyItemChange ensureItemChanges:_insertItemChanges ofSameType:_ASHierarchyChangeTypeInsert];
-    NSDictionary *insertedIndexPathsMap = [_ASHierarchyItemChange sectionToIndexSetMapFromChanges:_insertItemChanges];
+    ASSectionIndexRangeSets insertedIndexesMap = ASSectionIndexRangeSetsFromItemChanges(_insertItemChanges);
     
     [_ASHierarchyItemChange ensureItemChanges:_deleteItemChanges ofSameType:_ASHierarchyChangeTypeDelete];
-    NSDictionary *deletedIndexPathsMap = [_ASHierarchyItemChange sectionToIndexSetMapFromChanges:_deleteItemChanges];
+    ASSectionIndexRangeSets deletedIndexesMap = ASSectionIndexRangeSetsFromItemChanges(_deleteItemChanges);
     
     for (_ASHierarchyItemChange *change in _reloadItemChanges) {
       NSAssert(change.changeType == _ASHierarchyChangeTypeReload, @"It must be a reload change to be in here");
@@ -394,16 +465,28 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
       // For reference, when batching reloads/deletes/inserts:
       // - delete/reload indexPaths that are passed in should all be their current indexPaths
       // - insert indexPaths that are passed in should all be their future indexPaths after deletions
+      NSUInteger oldSection = NSNotFound;
+      NSUInteger section = NSNotFound;
+      AS::IndexRangeSet *indexesDeletedInSection = nullptr;
+      AS::IndexRangeSet *indexesInsertedInSection = nullptr;
       for (NSIndexPath *indexPath in change.indexPaths) {
-        NSUInteger section = [self newSectionForOldSection:indexPath.section];
+        // Index paths are sorted, so only look up the section when it changes.
+        if (indexPath.section != oldSection) {
+          oldSection = indexPath.section;
+          section = [self newSectionForOldSection:oldSection];
+          indexesDeletedInSection = ASIndexRangeSetForSection(deletedIndexesMap, oldSection);
+          indexesInsertedInSection = ASIndexRangeSetForSection(insertedIndexesMap, section);
+        }
         NSUInteger item = indexPath.item;
         
         // Update row number based on deletions that are above the current row in the current section
-        NSIndexSet *indicesDeletedInSection = deletedIndexPathsMap[@(indexPath.section)];
-        item -= [indicesDeletedInSection countOfIndexesInRange:NSMakeRange(0, item)];
+        if (indexesDeletedInSection != nullptr) {
+          item -= indexesDeletedInSection->countOfIndexesBelow(item);
+        }
         // Update row number based on insertions that are above the current row in the future section
-        NSIndexSet *indicesInsertedInSection = insertedIndexPathsMap[@(section)];
-        item += [indicesInsertedInSection as_indexChangeByInsertingItemsBelowIndex:item];
+        if (indexesInsertedInSection != nullptr) {
+          item = indexesInsertedInSection->indexByInsertingItemsBelowIndex(item);
+        }
         
         NSIndexPath *newIndexPath = [NSIndexPath indexPathForItem:item inSection:section];
         [newIndexPaths addObject:newIndexPath];
@@ -411,10 +494,10 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
       
       // All reload changes are translated into deletes and inserts
       // We delete the items that needs reload together with other deleted items, at their original index
-      _ASHierarchyItemChange *deleteItemChangeFromReloadChange = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeDelete indexPaths:change.indexPaths animationOptions:change.animationOptions presorted:NO];
+      _ASHierarchyItemChange *deleteItemChangeFromReloadChange = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeDelete indexPaths:change.indexPaths animationOptions:change.animationOptions presorted:YES];
       [_deleteItemChanges addObject:deleteItemChangeFromReloadChange];
       // We insert the items that needs reload together with other inserted items, at their future index
-      _ASHierarchyItemChange *insertItemChangeFromReloadChange = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeInsert indexPaths:newIndexPaths animationOptions:change.animationOptions presorted:NO];
+      _ASHierarchyItemChange *insertItemChangeFromReloadChange = [[_ASHierarchyItemChange alloc] initWithChangeType:_ASHierarchyChangeTypeInsert indexPaths:newIndexPaths animationOptions:change.animationOptions presorted:YES];
       [_insertItemChanges addObject:insertItemChangeFromReloadChange];
     }
     
@@ -511,6 +594,11 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
     return;
   }
   
+  // Collect the item changes by section once, rather than scanning every change for every section.
+  ASSectionIndexRangeSets originalInsertedItemsMap = ASSectionIndexRangeSetsFromItemChanges(_originalInsertItemChanges);
+  ASSectionIndexRangeSets originalDeletedItemsMap = ASSectionIndexRangeSetsFromItemChanges(_originalDeleteItemChanges);
+  ASSectionIndexRangeSets reloadedItemsMap = ASSectionIndexRangeSetsFromItemChanges(_reloadItemChanges);
+  
   for (NSUInteger oldSection = 0; oldSection < oldSectionCount; oldSection++) {
     NSInteger oldItemCount = _oldItemCounts[oldSection];
     // If section was reloaded, ignore.
@@ -524,21 +612,23 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
       continue;
     }
     
-    NSIndexSet *originalInsertedItems = [self indexesForItemChangesOfType:_ASHierarchyChangeTypeOriginalInsert inSection:newSection];
-    NSIndexSet *originalDeletedItems = [self indexesForItemChangesOfType:_ASHierarchyChangeTypeOriginalDelete inSection:oldSection];
-    NSIndexSet *reloadedItems = [self indexesForItemChangesOfType:_ASHierarchyChangeTypeReload inSection:oldSection];
+    AS::IndexRangeSet *originalInsertedItems = ASIndexRangeSetForSection(originalInsertedItemsMap, newSection);
+    AS::IndexRangeSet *originalDeletedItems = ASIndexRangeSetForSection(originalDeletedItemsMap, oldSection);
+    AS::IndexRangeSet *reloadedItems = ASIndexRangeSetForSection(reloadedItemsMap, oldSection);
     
     // Assert that no reloaded items were deleted.
-    NSInteger deletedReloadedItem = [originalDeletedItems as_intersectionWithIndexes:reloadedItems].firstIndex;
-    if (deletedReloadedItem != NSNotFound) {
-      ASFailUpdateValidation(@"Attempt to delete and reload the same item at index path %@", [NSIndexPath indexPathForItem:deletedReloadedItem inSection:oldSection]);
-      return;
+    if (originalDeletedItems != nullptr && reloadedItems != nullptr) {
+      NSInteger deletedReloadedItem = originalDeletedItems->firstIndexInCommonWith(*reloadedItems);
+      if (deletedReloadedItem != NSNotFound) {
+        ASFailUpdateValidation(@"Attempt to delete and reload the same item at index path %@", [NSIndexPath indexPathForItem:deletedReloadedItem inSection:oldSection]);
+        return;
+      }
     }
     
     // Assert that the new item count is correct.
     NSInteger newItemCount = _newItemCounts[newSection];
-    NSInteger insertedItemCount = originalInsertedItems.count;
-    NSInteger deletedItemCount = originalDeletedItems.count;
+    NSInteger insertedItemCount = (originalInsertedItems != nullptr) ? originalInsertedItems->count() : 0;
+    NSInteger deletedItemCount = (originalDeletedItems != nullptr) ? originalDeletedItems->count() : 0;
     if (newItemCount != oldItemCount + insertedItemCount - deletedItemCount) {
       ASFailUpdateValidation(@"Invalid number of items in section %zd. The number of items after the update (%zd) must be equal to the number of items before the update (%zd) plus or minus the number of items inserted or deleted (%zd inserted, %zd deleted).", oldSection, newItemCount, oldItemCount, insertedItemCount, deletedItemCount);
       return;
@@ -824,23 +914,39 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   _ASHierarchyChangeType type = [changes.firstObject changeType];
   ASDisplayNodeAssert(ASHierarchyChangeTypeIsFinal(type), @"Attempt to sort and coalesce item changes of intermediary type %@. Why?", NSStringFromASHierarchyChangeType(type));
     
-  // Lookup table [NSIndexPath: AnimationOptions]
-  NSMutableDictionary *animationOptions = [NSMutableDictionary new];
-  
-  // All changed index paths, sorted
-  NSMutableArray *allIndexPaths = [[NSMutableArray alloc] init];
+  // All changed index paths, with the section and item unpacked so sorting doesn't message them.
+  struct Entry {
+    NSUInteger section;
+    NSUInteger item;
+    ASDataControllerAnimationOptions options;
+    NSIndexPath *indexPath;
+  };
+  std::vector<Entry> entries;
   
+  NSUInteger lastSection = NSNotFound;
+  BOOL lastSectionIgnored = NO;
   for (_ASHierarchyItemChange *change in changes) {
+    ASDataControllerAnimationOptions options = change.animationOptions;
     for (NSIndexPath *indexPath in change.indexPaths) {
-      if (![ignoredSections containsIndex:indexPath.section]) {
-        animationOptions[indexPath] = @(change.animationOptions);
-        [allIndexPaths addObject:indexPath];
+      NSUInteger section = indexPath.section;
+      if (section != lastSection) {
+        lastSection = section;
+        lastSectionIgnored = [ignoredSections containsIndex:section];
+      }
+      if (!lastSectionIgnored) {
+        entries.push_back({ section, (NSUInteger)indexPath.item, options, indexPath });
       }
     }
   }
   
-  SEL sorting = type == _ASHierarchyChangeTypeDelete ? @selector(asdk_inverseCompare:) : @selector(compare:);
-  [allIndexPaths sortUsingSelector:sorting];
+  // Sort stably, so that the last change to an index path comes last among its duplicates.
+  BOOL descending = (type == _ASHierarchyChangeTypeDelete);
+  std::stable_sort(entries.begin(), entries.end(), [descending](const Entry &a, const Entry &b) {
+    if (a.section != b.section) {
+      return descending ? a.section > b.section : a.section < b.section;
+    }
+    return descending ? a.item > b.item : a.item < b.item;
+  });
 
   // Create new changes by grouping sorted changes by animation option
   NSMutableArray *result = [[NSMutableArray alloc] init];
@@ -848,8 +954,14 @@ NSString *NSStringFromASHierarchyChangeType(_ASHierarchyChangeType changeType)
   ASDataControllerAnimationOptions currentOptions = 0;
   NSMutableArray *currentIndexPaths = [NSMutableArray array];
 
-  for (NSIndexPath *indexPath in allIndexPaths) {
-    ASDataControllerAnimationOptions options = [animationOptions[indexPath] integerValue];
+  for (size_t i = 0; i < entries.size(); i++) {
+    NSIndexPath *indexPath = entries[i].indexPath;
+    // An index path changed more than once takes the animation options of its last change.
+    size_t last = i;
+    while (last + 1 < entries.size() && entries[last + 1].section == entries[i].section && entries[last + 1].item == entries[i].item) {
+      last++;
+    }
+    ASDataControllerAnimationOptions options = entries[last].options;
 
     // End the previous group if needed.
     if (options != currentOptions && currentIndexPaths.count > 0) {
@@ -0,0 +1,73 @@
+//
+//  ASTextKitRasterCache.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASTextKitAttributes.h>
+#import <AsyncDisplayKit/ASTextNodeTypes.h>
+
+@class ASTextKitRenderer;
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ A byte-bounded LRU cache of rasterized text, keyed by renderer attributes (which include the shadow parameters),
+ constrained size and contents scale.
+
+ Text nodes that have had their contents cleared by the range controller and later re-enter the display range can
+ reuse a previously rasterized bitmap instead of re-running TextKit layout and glyph drawing.
+
+ The cached images contain only the text and its shadow on a transparent background. Background fills and text
+ container insets are left to the caller.
+
+ This class is thread-safe. The shared instance purges itself when a memory warning is received.
+ */
+AS_SUBCLASSING_RESTRICTED
+@interface ASTextKitRasterCache : NSObject
+
++ (ASTextKitRasterCache *)sharedCache;
+
+- (instancetype)initWithByteLimit:(NSUInteger)byteLimit NS_DESIGNATED_INITIALIZER;
+
+/**
+ The maximum number of bytes of decoded bitmap data held by the cache.  Lowering the limit evicts immediately.
+ */
+@property (atomic, assign) NSUInteger byteLimit;
+
+/**
+ Returns the cached rasterization, if any.
+ */
+- (nullable UIImage *)imageForAttributes:(const ASTextKitAttributes &)attributes
+                         constrainedSize:(CGSize)constrainedSize
+                           contentsScale:(CGFloat)contentsScale;
+
+/**
+ Returns the cached rasterization, rasterizing the renderer provided by rendererBlock on a miss.
+
+ @param rendererBlock Called only on a cache miss.  Deferring renderer creation lets a hit skip TextKit layout.
+ */
+- (nullable UIImage *)imageForAttributes:(const ASTextKitAttributes &)attributes
+                         constrainedSize:(CGSize)constrainedSize
+                           contentsScale:(CGFloat)contentsScale
+                           rendererBlock:(AS_NOESCAPE ASTextKitRenderer *(^)())rendererBlock;
+
+- (void)removeAllImages;
+
+/**
+ A snapshot of the cache counters.
+ */
+- (ASTextNodeRasterCacheMetrics)metrics;
+
+- (void)resetMetrics;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,260 @@
+//
+//  ASTextKitRasterCache.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <AsyncDisplayKit/ASTextKitRasterCache.h>
+
+#include <functional>
+#include <list>
+#import <tgmath.h>
+
+#import <AsyncDisplayKit/ASTextKitRenderer.h>
+#import <AsyncDisplayKit/ASEqualityHashHelpers.h>
+#import <AsyncDisplayKit/ASThread.h>
+
+static const NSUInteger ASTextKitRasterCacheDefaultByteLimit = 8 * 1024 * 1024;
+
+#pragma mark - Key
+
+@interface ASTextKitRasterCacheKey : NSObject
+@property (assign, nonatomic) ASTextKitAttributes attributes;
+@property (assign, nonatomic) CGSize constrainedSize;
+@property (assign, nonatomic) CGFloat contentsScale;
+@end
+
+@implementation ASTextKitRasterCacheKey
+
+- (NSUInteger)hash
+{
+  NSUInteger subhashes[] = {
+    _attributes.hash(),
+    ASHashFromCGSize(_constrainedSize),
+    std::hash<CGFloat>()(_contentsScale),
+  };
+  return ASIntegerArrayHash(subhashes, sizeof(subhashes) / sizeof(subhashes[0]));
+}
+
+- (BOOL)isEqual:(ASTextKitRasterCacheKey *)object
+{
+  if (self == object) {
+    return YES;
+  }
+
+  return _attributes == object.attributes
+    && CGSizeEqualToSize(_constrainedSize, object.constrainedSize)
+    && _contentsScale == object.contentsScale;
+}
+
+- (id)copyWithZone:(NSZone *)zone
+{
+  // Keys are immutable once handed to the cache.
+  return self;
+}
+
+@end
+
+#pragma mark - Entry
+
+typedef std::list<ASTextKitRasterCacheKey *> ASTextKitRasterCacheLRUList;
+
+@interface ASTextKitRasterCacheEntry : NSObject
+{
+@package
+  UIImage *_image;
+  NSUInteger _cost;
+  ASTextKitRasterCacheLRUList::iterator _lruPosition;
+}
+@end
+
+@implementation ASTextKitRasterCacheEntry
+@end
+
+#pragma mark - Cache
+
+@implementation ASTextKitRasterCache {
+  ASDN::Mutex _lock;
+  NSMutableDictionary<ASTextKitRasterCacheKey *, ASTextKitRasterCacheEntry *> *_entries;
+  // Front is least recently used.
+  ASTextKitRasterCacheLRUList _lruList;
+  NSUInteger _byteLimit;
+  ASTextNodeRasterCacheMetrics _metrics;
+}
+
++ (ASTextKitRasterCache *)sharedCache
+{
+  static ASTextKitRasterCache *sharedCache = nil;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    sharedCache = [[ASTextKitRasterCache alloc] initWithByteLimit:ASTextKitRasterCacheDefaultByteLimit];
+    [[NSNotificationCenter defaultCenter] addObserver:sharedCache
+                                             selector:@selector(didReceiveMemoryWarning:)
+                                                 name:UIApplicationDidReceiveMemoryWarningNotification
+                                               object:nil];
+  });
+  return sharedCache;
+}
+
+- (instancetype)init
+{
+  return [self initWithByteLimit:ASTextKitRasterCacheDefaultByteLimit];
+}
+
+- (instancetype)initWithByteLimit:(NSUInteger)byteLimit
+{
+  if (self = [super init]) {
+    _byteLimit = byteLimit;
+    _entries = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+- (void)didReceiveMemoryWarning:(NSNotification *)notification
+{
+  [self removeAllImages];
+}
+
+#pragma mark Limits
+
+- (NSUInteger)byteLimit
+{
+  ASDN::MutexLocker l(_lock);
+  return _byteLimit;
+}
+
+- (void)setByteLimit:(NSUInteger)byteLimit
+{
+  ASDN::MutexLocker l(_lock);
+  _byteLimit = byteLimit;
+  [self _locked_evictToByteLimit:byteLimit];
+}
+
+- (void)_locked_evictToByteLimit:(NSUInteger)byteLimit
+{
+  while (_metrics.byteCount > byteLimit && _lruList.empty() == NO) {
+    ASTextKitRasterCacheKey *key = _lruList.front();
+    ASTextKitRasterCacheEntry *entry = _entries[key];
+    _metrics.byteCount -= entry->_cost;
+    _metrics.evictionCount += 1;
+    _lruList.pop_front();
+    [_entries removeObjectForKey:key];
+  }
+  _metrics.imageCount = _entries.count;
+}
+
+- (void)removeAllImages
+{
+  ASDN::MutexLocker l(_lock);
+  [_entries removeAllObjects];
+  _lruList.clear();
+  _metrics.byteCount = 0;
+  _metrics.imageCount = 0;
+}
+
+#pragma mark Lookup
+
+static ASTextKitRasterCacheKey *keyFor(const ASTextKitAttributes &attributes, CGSize constrainedSize, CGFloat contentsScale)
+{
+  ASTextKitRasterCacheKey *key = [[ASTextKitRasterCacheKey alloc] init];
+  key.attributes = attributes;
+  key.constrainedSize = constrainedSize;
+  key.contentsScale = contentsScale;
+  return key;
+}
+
+- (UIImage *)_imageForKey:(ASTextKitRasterCacheKey *)key
+{
+  ASDN::MutexLocker l(_lock);
+  ASTextKitRasterCacheEntry *entry = _entries[key];
+  if (entry == nil) {
+    _metrics.missCount += 1;
+    return nil;
+  }
+  _metrics.hitCount += 1;
+  // Move to the most recently used position.
+  _lruList.splice(_lruList.end(), _lruList, entry->_lruPosition);
+  return entry->_image;
+}
+
+- (UIImage *)imageForAttributes:(const ASTextKitAttributes &)attributes
+                constrainedSize:(CGSize)constrainedSize
+                  contentsScale:(CGFloat)contentsScale
+{
+  return [self _imageForKey:keyFor(attributes, constrainedSize, contentsScale)];
+}
+
+- (UIImage *)imageForAttributes:(const ASTextKitAttributes &)attributes
+                constrainedSize:(CGSize)constrainedSize
+                  contentsScale:(CGFloat)contentsScale
+                  rendererBlock:(ASTextKitRenderer *(^)())rendererBlock
+{
+  if (contentsScale <= 0 || isfinite(constrainedSize.width) == NO || isfinite(constrainedSize.height) == NO
+      || constrainedSize.width < 1 || constrainedSize.height < 1) {
+    return nil;
+  }
+
+  ASTextKitRasterCacheKey *key = keyFor(attributes, constrainedSize, contentsScale);
+  UIImage *image = [self _imageForKey:key];
+  if (image != nil) {
+    return image;
+  }
+
+  // Rasterize outside of the lock; concurrent misses for the same key simply race to insert equal bitmaps.
+  ASTextKitRenderer *renderer = rendererBlock();
+  if (renderer == nil) {
+    return nil;
+  }
+
+  UIGraphicsBeginImageContextWithOptions(constrainedSize, NO, contentsScale);
+  [renderer drawInContext:UIGraphicsGetCurrentContext() bounds:{ .size = constrainedSize }];
+  image = UIGraphicsGetImageFromCurrentImageContext();
+  UIGraphicsEndImageContext();
+
+  if (image != nil) {
+    CGImageRef cgImage = image.CGImage;
+    NSUInteger cost = CGImageGetBytesPerRow(cgImage) * CGImageGetHeight(cgImage);
+    [self _setImage:image cost:cost forKey:key];
+  }
+  return image;
+}
+
+- (void)_setImage:(UIImage *)image cost:(NSUInteger)cost forKey:(ASTextKitRasterCacheKey *)key
+{
+  ASDN::MutexLocker l(_lock);
+  if (cost > _byteLimit || _entries[key] != nil) {
+    return;
+  }
+
+  [self _locked_evictToByteLimit:_byteLimit - cost];
+
+  ASTextKitRasterCacheEntry *entry = [[ASTextKitRasterCacheEntry alloc] init];
+  entry->_image = image;
+  entry->_cost = cost;
+  entry->_lruPosition = _lruList.insert(_lruList.end(), key);
+  _entries[key] = entry;
+  _metrics.byteCount += cost;
+  _metrics.imageCount = _entries.count;
+}
+
+#pragma mark Metrics
+
+- (ASTextNodeRasterCacheMetrics)metrics
+{
+  ASDN::MutexLocker l(_lock);
+  return _metrics;
+}
+
+- (void)resetMetrics
+{
+  ASDN::MutexLocker l(_lock);
+  _metrics.hitCount = 0;
+  _metrics.missCount = 0;
+  _metrics.evictionCount = 0;
+}
+
+@end
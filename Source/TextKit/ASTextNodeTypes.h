@@ -12,3 +12,20 @@
 
 // Use this attribute name to add "word kerning"
 static NSString *const ASTextNodeWordKerningAttributeName = @"ASAttributedStringWordKerning";
+
+/**
+ Counters reported by the rasterized text cache.
+ @see +[ASTextNode rasterizedTextCacheMetrics]
+ */
+typedef struct {
+  /// Draws served from a cached bitmap.
+  NSUInteger hitCount;
+  /// Draws that had to rasterize through TextKit.
+  NSUInteger missCount;
+  /// Bitmaps dropped to stay within the byte limit.
+  NSUInteger evictionCount;
+  /// Bitmaps currently held.
+  NSUInteger imageCount;
+  /// Bytes of bitmap data currently held.
+  NSUInteger byteCount;
+} ASTextNodeRasterCacheMetrics;
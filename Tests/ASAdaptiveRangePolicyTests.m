@@ -0,0 +1,144 @@
+//
+//  ASAdaptiveRangePolicyTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASAdaptiveRangePolicy.h>
+
+static ASRangeTuningParameters const kDisplayParameters = { .leadingBufferScreenfuls = 1.0, .trailingBufferScreenfuls = 0.5 };
+static ASRangeTuningParameters const kPreloadParameters = { .leadingBufferScreenfuls = 2.5, .trailingBufferScreenfuls = 1.5 };
+
+#define ASXCTAssertTuningParametersEqual(parameters, leading, trailing) \
+  XCTAssertEqualWithAccuracy(parameters.leadingBufferScreenfuls, leading, 0.001); \
+  XCTAssertEqualWithAccuracy(parameters.trailingBufferScreenfuls, trailing, 0.001)
+
+@interface ASAdaptiveRangePolicyTests : XCTestCase
+@end
+
+@implementation ASAdaptiveRangePolicyTests
+
+- (void)testThatStaticTuningParametersAreUsedAtRest
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:0.5 forRangeType:ASLayoutRangeTypeDisplay];
+  [policy recordLatency:4 forRangeType:ASLayoutRangeTypePreload];
+
+  ASRangeTuningParameters display = [policy tuningParametersForRangeType:ASLayoutRangeTypeDisplay staticTuningParameters:kDisplayParameters scrollSpeed:0 timestamp:0];
+  ASRangeTuningParameters preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0 timestamp:0];
+  ASXCTAssertTuningParametersEqual(display, 1.0, 0.5);
+  ASXCTAssertTuningParametersEqual(preload, 2.5, 1.5);
+}
+
+- (void)testThatStaticTuningParametersOutsideTheBoundsAreUsedAtRest
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  ASRangeTuningParameters large = { .leadingBufferScreenfuls = 8, .trailingBufferScreenfuls = 3 };
+  ASRangeTuningParameters preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:large scrollSpeed:0 timestamp:0];
+  ASXCTAssertTuningParametersEqual(preload, 8, 3);
+}
+
+- (void)testThatLatencyIsAveraged
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  XCTAssertEqual([policy estimatedLatencyForRangeType:ASLayoutRangeTypePreload], 0);
+  [policy recordLatency:2 forRangeType:ASLayoutRangeTypePreload];
+  XCTAssertEqualWithAccuracy([policy estimatedLatencyForRangeType:ASLayoutRangeTypePreload], 2, 0.001);
+  [policy recordLatency:6 forRangeType:ASLayoutRangeTypePreload];
+  XCTAssertEqualWithAccuracy([policy estimatedLatencyForRangeType:ASLayoutRangeTypePreload], 3, 0.001);
+  [policy recordLatency:-1 forRangeType:ASLayoutRangeTypePreload];
+  XCTAssertEqualWithAccuracy([policy estimatedLatencyForRangeType:ASLayoutRangeTypePreload], 3, 0.001);
+  XCTAssertEqual([policy estimatedLatencyForRangeType:ASLayoutRangeTypeDisplay], 0);
+}
+
+- (void)testThatSlowPreloadExtendsTheLeadingBuffer
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:4 forRangeType:ASLayoutRangeTypePreload];
+
+  // Half a screen per second for four seconds, plus headroom.
+  ASRangeTuningParameters preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0.5 timestamp:0];
+  ASXCTAssertTuningParametersEqual(preload, 3.0, 1.0);
+}
+
+- (void)testThatAdaptedTuningParametersStayWithinTheBounds
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:20 forRangeType:ASLayoutRangeTypePreload];
+  ASRangeTuningParameters preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:10 timestamp:0];
+  ASXCTAssertTuningParametersEqual(preload, 6, 0.25);
+
+  ASRangeTuningParameters minimum = { .leadingBufferScreenfuls = 1, .trailingBufferScreenfuls = 1 };
+  ASRangeTuningParameters maximum = { .leadingBufferScreenfuls = 4, .trailingBufferScreenfuls = 1.5 };
+  [policy setMinimumTuningParameters:minimum maximumTuningParameters:maximum forRangeType:ASLayoutRangeTypePreload];
+  preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:10 timestamp:0];
+  ASXCTAssertTuningParametersEqual(preload, 4, 1);
+}
+
+- (void)testThatDisplayRangeShrinksWhenCellsFlyBy
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:0.1 forRangeType:ASLayoutRangeTypeDisplay];
+
+  // Cells stay in range for 0.4s at 5 screens per second, long enough to display.
+  ASRangeTuningParameters display = [policy tuningParametersForRangeType:ASLayoutRangeTypeDisplay staticTuningParameters:kDisplayParameters scrollSpeed:5 timestamp:0];
+  ASXCTAssertTuningParametersEqual(display, 1.0, 0.25);
+
+  // At 25 screens per second they are gone before they are displayed.
+  display = [policy tuningParametersForRangeType:ASLayoutRangeTypeDisplay staticTuningParameters:kDisplayParameters scrollSpeed:25 timestamp:0];
+  ASXCTAssertTuningParametersEqual(display, 0.25, 0.25);
+
+  // Back to normal once the fling slows down.
+  display = [policy tuningParametersForRangeType:ASLayoutRangeTypeDisplay staticTuningParameters:kDisplayParameters scrollSpeed:0 timestamp:1];
+  ASXCTAssertTuningParametersEqual(display, 1.0, 0.5);
+}
+
+- (void)testThatLeadingBufferShrinksGradually
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:4 forRangeType:ASLayoutRangeTypePreload];
+
+  ASRangeTuningParameters preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:1 timestamp:100];
+  XCTAssertEqualWithAccuracy(preload.leadingBufferScreenfuls, 6, 0.001);
+
+  preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0 timestamp:101];
+  XCTAssertEqualWithAccuracy(preload.leadingBufferScreenfuls, 5, 0.001);
+
+  preload = [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0 timestamp:110];
+  XCTAssertEqualWithAccuracy(preload.leadingBufferScreenfuls, 2.5, 0.001);
+}
+
+- (void)testThatDecisionsAreReportedWhenTheyChange
+{
+  ASAdaptiveRangePolicy *policy = [[ASAdaptiveRangePolicy alloc] init];
+  [policy recordLatency:4 forRangeType:ASLayoutRangeTypePreload];
+
+  NSMutableArray<NSValue *> *decisions = [NSMutableArray array];
+  policy.decisionHandler = ^(ASRangeTuningDecision decision) {
+    [decisions addObject:[NSValue valueWithBytes:&decision objCType:@encode(ASRangeTuningDecision)]];
+  };
+
+  [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0 timestamp:0];
+  [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0 timestamp:0.1];
+  XCTAssertEqual(decisions.count, 1);
+
+  [policy tuningParametersForRangeType:ASLayoutRangeTypePreload staticTuningParameters:kPreloadParameters scrollSpeed:0.5 timestamp:0.2];
+  XCTAssertEqual(decisions.count, 2);
+
+  ASRangeTuningDecision decision;
+  [decisions.lastObject getValue:&decision];
+  XCTAssertEqual(decision.rangeType, ASLayoutRangeTypePreload);
+  XCTAssertEqualWithAccuracy(decision.timestamp, 0.2, 0.001);
+  XCTAssertEqualWithAccuracy(decision.scrollSpeed, 0.5, 0.001);
+  XCTAssertEqualWithAccuracy(decision.latency, 4, 0.001);
+  ASXCTAssertTuningParametersEqual(decision.staticTuningParameters, 2.5, 1.5);
+  ASXCTAssertTuningParametersEqual(decision.adaptedTuningParameters, 3.0, 1.0);
+}
+
+@end
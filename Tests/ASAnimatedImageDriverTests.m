@@ -0,0 +1,111 @@
+//
+//  ASAnimatedImageDriverTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASAnimatedImageDriver.h>
+
+@interface ASTestAnimatedImageDriverClient : NSObject <ASAnimatedImageDriverClient>
+@property (nonatomic, assign) ASAnimatedImageDriverTickResult result;
+@property (nonatomic, strong) NSMutableArray<NSNumber *> *timestamps;
+@end
+
+@implementation ASTestAnimatedImageDriverClient
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _timestamps = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (ASAnimatedImageDriverTickResult)animatedImageDriverTickWithTimestamp:(CFTimeInterval)timestamp
+{
+  [_timestamps addObject:@(timestamp)];
+  return _result;
+}
+
+@end
+
+@interface ASAnimatedImageDriverTests : XCTestCase
+@end
+
+@implementation ASAnimatedImageDriverTests
+
+- (void)runFor:(NSTimeInterval)duration
+{
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:duration]];
+}
+
+- (void)testClientsAreTickedTogetherFromOneDisplayLink
+{
+  ASAnimatedImageDriver *driver = [ASAnimatedImageDriver sharedDriver];
+  [driver resetMetrics];
+
+  ASTestAnimatedImageDriverClient *updating = [[ASTestAnimatedImageDriverClient alloc] init];
+  updating.result = ASAnimatedImageDriverTickResultUpdated;
+  ASTestAnimatedImageDriverClient *unchanged = [[ASTestAnimatedImageDriverClient alloc] init];
+  unchanged.result = ASAnimatedImageDriverTickResultUnchanged;
+  [driver addClient:updating runLoopMode:NSRunLoopCommonModes];
+  [driver addClient:unchanged runLoopMode:NSRunLoopCommonModes];
+  XCTAssertEqual([driver clientCount], 2);
+
+  [self runFor:0.2];
+  [driver removeClient:updating];
+  [driver removeClient:unchanged];
+  XCTAssertEqual([driver clientCount], 0);
+
+  XCTAssertGreaterThan(updating.timestamps.count, 0);
+  // Both clients see every frame with the same timestamp.
+  XCTAssertEqualObjects(updating.timestamps, unchanged.timestamps);
+
+  ASAnimatedImagePlaybackMetrics metrics = [driver metrics];
+  XCTAssertEqual(metrics.frameCount, updating.timestamps.count);
+  XCTAssertEqual(metrics.updatedNodeCount, metrics.frameCount);
+  XCTAssertEqual(metrics.unchangedNodeCount, metrics.frameCount);
+  XCTAssertEqual(metrics.throttledNodeCount, 0);
+  XCTAssertGreaterThan(metrics.totalFrameDuration, 0);
+  XCTAssertGreaterThanOrEqual(metrics.totalFrameDuration, metrics.maxFrameDuration);
+}
+
+- (void)testRemovedAndDeallocatedClientsAreNotTicked
+{
+  ASAnimatedImageDriver *driver = [ASAnimatedImageDriver sharedDriver];
+  ASTestAnimatedImageDriverClient *removed = [[ASTestAnimatedImageDriverClient alloc] init];
+  [driver addClient:removed runLoopMode:NSDefaultRunLoopMode];
+  [driver removeClient:removed];
+
+  @autoreleasepool {
+    ASTestAnimatedImageDriverClient *deallocated = [[ASTestAnimatedImageDriverClient alloc] init];
+    [driver addClient:deallocated runLoopMode:NSDefaultRunLoopMode];
+    deallocated = nil;
+  }
+
+  [self runFor:0.1];
+  XCTAssertEqual(removed.timestamps.count, 0);
+  XCTAssertEqual([driver clientCount], 0);
+}
+
+- (void)testChangingRunLoopModeMovesTheClient
+{
+  ASAnimatedImageDriver *driver = [ASAnimatedImageDriver sharedDriver];
+  ASTestAnimatedImageDriverClient *client = [[ASTestAnimatedImageDriverClient alloc] init];
+  [driver addClient:client runLoopMode:NSRunLoopCommonModes];
+  [driver addClient:client runLoopMode:NSDefaultRunLoopMode];
+  XCTAssertEqual([driver clientCount], 1);
+
+  [self runFor:0.1];
+  XCTAssertGreaterThan(client.timestamps.count, 0);
+  [driver removeClient:client];
+  XCTAssertEqual([driver clientCount], 0);
+}
+
+@end
@@ -0,0 +1,156 @@
+//
+//  ASAnimatedImageFrameBufferTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASAnimatedImageFrameBuffer.h>
+
+/**
+ * An animated image with solid color frames whose durations are 0.1, 0.2, 0.3... seconds.
+ */
+@interface ASTestAnimatedImage : NSObject <ASAnimatedImageProtocol>
+- (instancetype)initWithFrameCount:(size_t)frameCount;
+@property (atomic, assign) NSUInteger imageRequestCount;
+@end
+
+@implementation ASTestAnimatedImage {
+  NSArray *_frames;
+}
+@synthesize playbackReadyCallback;
+
+- (instancetype)initWithFrameCount:(size_t)frameCount
+{
+  if (self = [super init]) {
+    NSMutableArray *frames = [NSMutableArray array];
+    for (size_t i = 0; i < frameCount; i++) {
+      UIGraphicsBeginImageContextWithOptions(CGSizeMake(8, 8), YES, 1);
+      [[UIColor colorWithWhite:(CGFloat)i / frameCount alpha:1] setFill];
+      UIRectFill(CGRectMake(0, 0, 8, 8));
+      [frames addObject:(__bridge id)UIGraphicsGetImageFromCurrentImageContext().CGImage];
+      UIGraphicsEndImageContext();
+    }
+    _frames = frames;
+  }
+  return self;
+}
+
+- (UIImage *)coverImage { return [UIImage imageWithCGImage:(__bridge CGImageRef)_frames[0]]; }
+- (BOOL)coverImageReady { return YES; }
+- (CFTimeInterval)totalDuration { return 0.1 * _frames.count * (_frames.count + 1) / 2; }
+- (NSUInteger)frameInterval { return 1; }
+- (size_t)loopCount { return 0; }
+- (size_t)frameCount { return _frames.count; }
+- (BOOL)playbackReady { return YES; }
+- (NSError *)error { return nil; }
+- (void)clearAnimatedImageCache {}
+
+- (CGImageRef)imageAtIndex:(NSUInteger)index
+{
+  self.imageRequestCount += 1;
+  return (__bridge CGImageRef)_frames[index];
+}
+
+- (CFTimeInterval)durationAtIndex:(NSUInteger)index
+{
+  return 0.1 * (index + 1);
+}
+
+@end
+
+@interface ASAnimatedImageFrameBufferTests : XCTestCase
+@end
+
+@implementation ASAnimatedImageFrameBufferTests
+
+- (void)waitForBufferedFrameCount:(NSUInteger)count frameBuffer:(ASAnimatedImageFrameBuffer *)frameBuffer
+{
+  NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:3];
+  while ([frameBuffer bufferedFrameCount] != count && [timeout timeIntervalSinceNow] > 0) {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertEqual([frameBuffer bufferedFrameCount], count);
+}
+
+- (void)testFrameIndexAtPlayHead
+{
+  // Frames end at 0.1, 0.3, 0.6, 1.0.
+  ASAnimatedImageFrameBuffer *frameBuffer = [[ASAnimatedImageFrameBuffer alloc] initWithAnimatedImage:[[ASTestAnimatedImage alloc] initWithFrameCount:4]];
+
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:0], 0);
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:0.05], 0);
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:0.2], 1);
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:0.45], 2);
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:0.99], 3);
+  // The end of the last frame still shows the last frame.
+  XCTAssertEqual([frameBuffer frameIndexAtPlayHead:1.0], 3);
+}
+
+- (void)testFramesAreDecodedAheadOfTheConsumer
+{
+  ASTestAnimatedImage *animatedImage = [[ASTestAnimatedImage alloc] initWithFrameCount:10];
+  ASAnimatedImageFrameBuffer *frameBuffer = [[ASAnimatedImageFrameBuffer alloc] initWithAnimatedImage:animatedImage];
+  NSObject *consumer = [[NSObject alloc] init];
+
+  [frameBuffer setLookaheadFrameCount:4 startingAtIndex:8 forConsumer:consumer];
+  // Frames 8, 9, 0 and 1; the window wraps around like playback does.
+  [self waitForBufferedFrameCount:4 frameBuffer:frameBuffer];
+
+  XCTAssertTrue([frameBuffer frameAtIndex:8 forConsumer:consumer] != NULL);
+  XCTAssertTrue([frameBuffer frameAtIndex:0 forConsumer:consumer] != NULL);
+  XCTAssertEqual([frameBuffer hitCount], 2);
+  XCTAssertEqual([frameBuffer missCount], 0);
+
+  // Moving to frame 0 drops 8 and 9 and decodes 2 and 3.
+  [self waitForBufferedFrameCount:4 frameBuffer:frameBuffer];
+  XCTAssertEqual(animatedImage.imageRequestCount, 6);
+
+  [frameBuffer setLookaheadFrameCount:0 startingAtIndex:0 forConsumer:consumer];
+  XCTAssertEqual([frameBuffer bufferedFrameCount], 0);
+}
+
+- (void)testConsumersShareOneBuffer
+{
+  ASTestAnimatedImage *animatedImage = [[ASTestAnimatedImage alloc] initWithFrameCount:10];
+  ASAnimatedImageFrameBuffer *frameBuffer = [ASAnimatedImageFrameBuffer frameBufferForAnimatedImage:animatedImage];
+  XCTAssertEqual(frameBuffer, [ASAnimatedImageFrameBuffer frameBufferForAnimatedImage:animatedImage]);
+  XCTAssertNotEqual(frameBuffer, [ASAnimatedImageFrameBuffer frameBufferForAnimatedImage:[[ASTestAnimatedImage alloc] initWithFrameCount:10]]);
+
+  NSObject *first = [[NSObject alloc] init];
+  NSObject *second = [[NSObject alloc] init];
+  [frameBuffer setLookaheadFrameCount:2 startingAtIndex:0 forConsumer:first];
+  [frameBuffer setLookaheadFrameCount:2 startingAtIndex:1 forConsumer:second];
+  // Frames 0, 1 and 2; frame 1 is decoded once for both.
+  [self waitForBufferedFrameCount:3 frameBuffer:frameBuffer];
+  XCTAssertEqual(animatedImage.imageRequestCount, 3);
+
+  [frameBuffer setLookaheadFrameCount:0 startingAtIndex:0 forConsumer:first];
+  XCTAssertEqual([frameBuffer bufferedFrameCount], 2);
+}
+
+- (void)testByteLimitCapsLookahead
+{
+  NSUInteger maximumBufferedByteCount = [ASAnimatedImageFrameBuffer maximumBufferedByteCount];
+  ASAnimatedImageFrameBuffer *frameBuffer = [[ASAnimatedImageFrameBuffer alloc] initWithAnimatedImage:[[ASTestAnimatedImage alloc] initWithFrameCount:10]];
+  NSObject *consumer = [[NSObject alloc] init];
+
+  // Learn the frame size, then allow room for two frames.
+  [frameBuffer setLookaheadFrameCount:1 startingAtIndex:0 forConsumer:consumer];
+  [self waitForBufferedFrameCount:1 frameBuffer:frameBuffer];
+  CGImageRef frame = [frameBuffer frameAtIndex:0 forConsumer:consumer];
+  [ASAnimatedImageFrameBuffer setMaximumBufferedByteCount:2 * CGImageGetBytesPerRow(frame) * CGImageGetHeight(frame)];
+
+  [frameBuffer setLookaheadFrameCount:8 startingAtIndex:0 forConsumer:consumer];
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+  XCTAssertEqual([frameBuffer bufferedFrameCount], 2);
+
+  [ASAnimatedImageFrameBuffer setMaximumBufferedByteCount:maximumBufferedByteCount];
+}
+
+@end
@@ -0,0 +1,137 @@
+//
+//  ASAsyncTransactionTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/_ASAsyncTransaction.h>
+
+@interface ASAsyncTransactionTests : XCTestCase
+@end
+
+@implementation ASAsyncTransactionTests {
+  // Operations on a serial queue run one at a time, in queue order, so they wait behind a blocked one.
+  dispatch_queue_t _serialQueue;
+  dispatch_semaphore_t _blockingSemaphore;
+  NSMutableArray<NSString *> *_executedOperations;
+}
+
+- (void)setUp
+{
+  [super setUp];
+  _serialQueue = dispatch_queue_create("org.AsyncDisplayKit.ASAsyncTransactionTests", DISPATCH_QUEUE_SERIAL);
+  _blockingSemaphore = dispatch_semaphore_create(0);
+  _executedOperations = [NSMutableArray array];
+  [_ASAsyncTransaction resetQueueMetrics];
+}
+
+- (_ASAsyncTransaction *)transactionBlockedOnSemaphore
+{
+  _ASAsyncTransaction *transaction = [[_ASAsyncTransaction alloc] initWithCallbackQueue:nil completionBlock:nil];
+  dispatch_semaphore_t semaphore = _blockingSemaphore;
+  dispatch_semaphore_t startedSemaphore = dispatch_semaphore_create(0);
+  [transaction addOperationWithBlock:^id<NSObject>{
+    dispatch_semaphore_signal(startedSemaphore);
+    dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+    return nil;
+  } priority:ASDefaultTransactionPriority queue:_serialQueue completion:nil];
+  // Once the blocking operation has left the queue, everything added after it waits.
+  dispatch_semaphore_wait(startedSemaphore, DISPATCH_TIME_FOREVER);
+  return transaction;
+}
+
+- (ASAsyncTransactionOperationHandle)addOperationNamed:(NSString *)name toTransaction:(_ASAsyncTransaction *)transaction completion:(asyncdisplaykit_async_transaction_operation_completion_block_t)completion
+{
+  NSMutableArray<NSString *> *executedOperations = _executedOperations;
+  return [transaction addOperationWithBlock:^id<NSObject>{
+    @synchronized (executedOperations) {
+      [executedOperations addObject:name];
+    }
+    return name;
+  } priority:ASDefaultTransactionPriority queue:_serialQueue completion:completion];
+}
+
+- (void)finishTransaction:(_ASAsyncTransaction *)transaction
+{
+  [transaction commit];
+  dispatch_semaphore_signal(_blockingSemaphore);
+  [transaction waitUntilComplete];
+}
+
+- (void)testThatCancelledOperationsAreRemovedFromTheQueue
+{
+  _ASAsyncTransaction *transaction = [self transactionBlockedOnSemaphore];
+  __block BOOL completionCalled = NO;
+  ASAsyncTransactionOperationHandle handle = [self addOperationNamed:@"A" toTransaction:transaction completion:^(id<NSObject> value, BOOL canceled) {
+    XCTAssertNil(value);
+    completionCalled = YES;
+  }];
+  [self addOperationNamed:@"B" toTransaction:transaction completion:nil];
+
+  XCTAssertTrue([_ASAsyncTransaction cancelOperationWithHandle:handle]);
+  XCTAssertFalse([_ASAsyncTransaction cancelOperationWithHandle:handle]);
+  [self finishTransaction:transaction];
+
+  XCTAssertEqualObjects(_executedOperations, @[ @"B" ]);
+  XCTAssertTrue(completionCalled, @"Completion blocks of purged operations must still be called");
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].purgedOperationCount, 1);
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].executedOperationCount, 2);
+}
+
+- (void)testThatCancellingATransactionPurgesItsWaitingOperations
+{
+  _ASAsyncTransaction *transaction = [self transactionBlockedOnSemaphore];
+  [self addOperationNamed:@"A" toTransaction:transaction completion:nil];
+  [self addOperationNamed:@"B" toTransaction:transaction completion:nil];
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].queuedOperationCount, 2);
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].maximumQueuedOperationCount, 2);
+
+  [transaction commit];
+  [transaction cancel];
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].queuedOperationCount, 0);
+  dispatch_semaphore_signal(_blockingSemaphore);
+  [transaction waitUntilComplete];
+
+  XCTAssertEqual(_executedOperations.count, 0);
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].purgedOperationCount, 2);
+}
+
+- (void)testThatOperationsCanBeMovedAheadOfOthers
+{
+  _ASAsyncTransaction *transaction = [self transactionBlockedOnSemaphore];
+  [self addOperationNamed:@"A" toTransaction:transaction completion:nil];
+  [self addOperationNamed:@"B" toTransaction:transaction completion:nil];
+  ASAsyncTransactionOperationHandle handle = [self addOperationNamed:@"C" toTransaction:transaction completion:nil];
+
+  XCTAssertTrue([_ASAsyncTransaction prioritizeOperationWithHandle:handle]);
+  [self finishTransaction:transaction];
+  XCTAssertEqualObjects(_executedOperations, (@[ @"C", @"A", @"B" ]));
+}
+
+- (void)testThatChangingThePriorityRequeuesOperations
+{
+  _ASAsyncTransaction *transaction = [self transactionBlockedOnSemaphore];
+  ASAsyncTransactionOperationHandle handle = [self addOperationNamed:@"A" toTransaction:transaction completion:nil];
+  [self addOperationNamed:@"B" toTransaction:transaction completion:nil];
+
+  XCTAssertTrue([_ASAsyncTransaction setPriority:1 ofOperationWithHandle:handle]);
+  [self finishTransaction:transaction];
+  XCTAssertEqualObjects(_executedOperations, (@[ @"B", @"A" ]));
+  XCTAssertFalse([_ASAsyncTransaction setPriority:0 ofOperationWithHandle:handle], @"Executed operations can't be moved");
+}
+
+- (void)testThatWastedOperationsAreRecorded
+{
+  [_ASAsyncTransaction recordWastedOperationWithDuration:0.25];
+  [_ASAsyncTransaction recordWastedOperationWithDuration:0.5];
+  XCTAssertEqual([_ASAsyncTransaction queueMetrics].wastedOperationCount, 2);
+  XCTAssertEqualWithAccuracy([_ASAsyncTransaction queueMetrics].wastedDuration, 0.75, DBL_EPSILON);
+}
+
+@end
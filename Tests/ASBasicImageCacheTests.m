@@ -0,0 +1,184 @@
+//
+//  ASBasicImageCacheTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASBasicImageCache.h>
+
+@interface ASBasicImageCacheTests : XCTestCase
+@property (nonatomic, strong) NSURL *directoryURL;
+@end
+
+static UIImage *testImage(CGSize size)
+{
+  UIGraphicsBeginImageContextWithOptions(size, YES, 1);
+  [[UIColor redColor] setFill];
+  UIRectFill((CGRect){ .size = size });
+  UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+  UIGraphicsEndImageContext();
+  return image;
+}
+
+static NSUInteger costOfImage(UIImage *image)
+{
+  return CGImageGetBytesPerRow(image.CGImage) * CGImageGetHeight(image.CGImage);
+}
+
+@implementation ASBasicImageCacheTests
+
+- (void)setUp
+{
+  [super setUp];
+  NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[NSUUID UUID].UUIDString];
+  self.directoryURL = [NSURL fileURLWithPath:path isDirectory:YES];
+}
+
+- (void)tearDown
+{
+  [[NSFileManager defaultManager] removeItemAtURL:self.directoryURL error:NULL];
+  [super tearDown];
+}
+
+- (ASBasicImageCache *)cacheWithDiskByteLimit:(unsigned long long)diskByteLimit
+{
+  return [[ASBasicImageCache alloc] initWithDirectoryURL:self.directoryURL memoryByteLimit:1024 * 1024 diskByteLimit:diskByteLimit];
+}
+
+- (void)testFullSizeImageIsServedSynchronouslyFromMemory
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  NSURL *URL = [NSURL URLWithString:@"http://example.com/a.png"];
+  UIImage *image = testImage(CGSizeMake(10, 10));
+
+  [cache setImage:image data:nil downsampled:NO forURL:URL];
+
+  XCTAssertEqual([cache synchronouslyFetchedCachedImageWithURL:URL], image);
+  XCTAssertEqual([cache metrics].memoryHitCount, 1);
+  XCTAssertEqual([cache metrics].memoryByteCount, costOfImage(image));
+
+  [cache removeImageFromMemoryForURL:URL];
+  XCTAssertNil([cache synchronouslyFetchedCachedImageWithURL:URL]);
+  XCTAssertEqual([cache metrics].memoryByteCount, 0);
+}
+
+- (void)testDownsampledImageIsOnlyCachedOnDisk
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  NSURL *URL = [NSURL URLWithString:@"http://example.com/a.png"];
+  UIImage *image = testImage(CGSizeMake(10, 10));
+
+  [cache setImage:image data:UIImagePNGRepresentation(image) downsampled:YES forURL:URL];
+
+  XCTAssertNil([cache synchronouslyFetchedCachedImageWithURL:URL]);
+  XCTAssertTrue([cache containsDataOnDiskForURL:URL]);
+}
+
+- (void)testImageIsReadBackFromDiskAfterMemoryIsCleared
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  NSURL *URL = [NSURL URLWithString:@"http://example.com/a.png"];
+  UIImage *image = testImage(CGSizeMake(10, 20));
+
+  [cache setImage:image data:UIImagePNGRepresentation(image) downsampled:NO forURL:URL];
+  [cache removeAllImagesFromMemory];
+  XCTAssertNil([cache synchronouslyFetchedCachedImageWithURL:URL]);
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Disk lookup completes"];
+  [cache cachedImageWithURL:URL callbackQueue:dispatch_get_main_queue() completion:^(id<ASImageContainerProtocol>  _Nullable cachedImage) {
+    XCTAssertEqual(CGImageGetWidth([cachedImage asdk_image].CGImage), 10);
+    XCTAssertEqual(CGImageGetHeight([cachedImage asdk_image].CGImage), 20);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:3 handler:nil];
+
+  XCTAssertEqual([cache metrics].diskHitCount, 1);
+  // The decoded image is put back in memory.
+  XCTAssertNotNil([cache synchronouslyFetchedCachedImageWithURL:URL]);
+}
+
+- (void)testMissCallsBackWithNil
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Lookup completes"];
+  [cache cachedImageWithURL:[NSURL URLWithString:@"http://example.com/missing.png"] callbackQueue:dispatch_get_main_queue() completion:^(id<ASImageContainerProtocol>  _Nullable cachedImage) {
+    XCTAssertNil(cachedImage);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:3 handler:nil];
+  XCTAssertEqual([cache metrics].missCount, 1);
+}
+
+- (void)testLeastRecentlyUsedFileIsEvictedAtDiskByteLimit
+{
+  UIImage *image = testImage(CGSizeMake(10, 10));
+  NSData *data = UIImagePNGRepresentation(image);
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:2 * data.length];
+  NSURL *a = [NSURL URLWithString:@"http://example.com/a.png"];
+  NSURL *b = [NSURL URLWithString:@"http://example.com/b.png"];
+  NSURL *c = [NSURL URLWithString:@"http://example.com/c.png"];
+
+  [cache setImage:nil data:data downsampled:NO forURL:a];
+  [cache setImage:nil data:data downsampled:NO forURL:b];
+  [cache setImage:nil data:data downsampled:NO forURL:c];
+
+  XCTAssertFalse([cache containsDataOnDiskForURL:a]);
+  XCTAssertTrue([cache containsDataOnDiskForURL:b]);
+  XCTAssertTrue([cache containsDataOnDiskForURL:c]);
+  XCTAssertEqual([cache metrics].diskEvictionCount, 1);
+  XCTAssertEqual([cache metrics].diskByteCount, 2 * data.length);
+}
+
+- (void)testLoweringMemoryByteLimitEvicts
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  [cache setImage:testImage(CGSizeMake(10, 10)) data:nil downsampled:NO forURL:[NSURL URLWithString:@"http://example.com/a.png"]];
+  [cache setImage:testImage(CGSizeMake(10, 10)) data:nil downsampled:NO forURL:[NSURL URLWithString:@"http://example.com/b.png"]];
+
+  cache.memoryByteLimit = 0;
+
+  XCTAssertEqual([cache metrics].memoryByteCount, 0);
+  XCTAssertEqual([cache metrics].memoryEvictionCount, 2);
+}
+
+- (void)testImageLargerThanAShardsShareOfTheLimitIsCachedInMemory
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  NSURL *URL = [NSURL URLWithString:@"http://example.com/a.png"];
+  UIImage *image = testImage(CGSizeMake(400, 400));
+  XCTAssertGreaterThan(costOfImage(image), cache.memoryByteLimit / 8);
+
+  [cache setImage:image data:nil downsampled:NO forURL:URL];
+
+  XCTAssertEqual([cache synchronouslyFetchedCachedImageWithURL:URL], image);
+  XCTAssertEqual([cache metrics].memoryByteCount, costOfImage(image));
+}
+
+- (void)testMemoryByteLimitAppliesToAllShardsTogether
+{
+  ASBasicImageCache *cache = [self cacheWithDiskByteLimit:1024 * 1024];
+  NSArray<NSURL *> *URLs = @[ [NSURL URLWithString:@"http://example.com/a.png"],
+                              [NSURL URLWithString:@"http://example.com/b.png"],
+                              [NSURL URLWithString:@"http://example.com/c.png"] ];
+  UIImage *lastImage = nil;
+  for (NSURL *URL in URLs) {
+    lastImage = testImage(CGSizeMake(300, 300));
+    XCTAssertLessThan(costOfImage(lastImage) * 2, cache.memoryByteLimit);
+    XCTAssertGreaterThan(costOfImage(lastImage) * 3, cache.memoryByteLimit);
+    [cache setImage:lastImage data:nil downsampled:NO forURL:URL];
+  }
+
+  ASBasicImageCacheMetrics metrics = [cache metrics];
+  XCTAssertLessThanOrEqual(metrics.memoryByteCount, cache.memoryByteLimit);
+  XCTAssertEqual(metrics.memoryByteCount, costOfImage(lastImage) * 2);
+  XCTAssertEqual(metrics.memoryEvictionCount, 1);
+  XCTAssertEqual([cache synchronouslyFetchedCachedImageWithURL:URLs.lastObject], lastImage, @"The image just added shouldn't make room for itself");
+}
+
+@end
@@ -28,6 +28,25 @@
   return [NSURL URLWithString:[NSUUID UUID].UUIDString];
 }
 
+- (ASBasicImageDownloaderRequest *)request
+{
+  return [[ASBasicImageDownloaderRequest alloc] initWithCallbackQueue:dispatch_get_main_queue() targetPixelSize:CGSizeZero downloadProgress:nil completion:nil];
+}
+
+- (void)testRemovingTheLastRequestCancelsTheContext
+{
+  ASBasicImageDownloaderContext *context = [ASBasicImageDownloaderContext contextForURL:[self randomURL]];
+  ASBasicImageDownloaderRequest *first = [self request];
+  ASBasicImageDownloaderRequest *second = [self request];
+  XCTAssertTrue([context addRequest:first]);
+  XCTAssertTrue([context addRequest:second]);
+
+  XCTAssertFalse([context removeRequest:first]);
+  XCTAssertFalse([context isCancelled]);
+  XCTAssertTrue([context removeRequest:second]);
+  XCTAssertTrue([context isCancelled]);
+}
+
 - (void)testContextCreation
 {
   NSURL *url = [self randomURL];
@@ -61,6 +80,45 @@
 }
 */
 
+- (void)testCompletedContextIsNotJoined
+{
+  NSURL *url = [self randomURL];
+  ASBasicImageDownloaderContext *context = [ASBasicImageDownloaderContext contextForURL:url];
+  XCTAssertTrue([context addRequest:[self request]]);
+  [context completeWithImage:nil error:nil];
+
+  XCTAssertFalse([context addRequest:[self request]], @"Requests added after completion would never be called back");
+  XCTAssert([ASBasicImageDownloaderContext contextForURL:url] != context, @"Later requests should get a new context");
+}
+
+- (void)testRequestsNeedingALargerImageThanWasDecodedAreLeftWaiting
+{
+  NSURL *url = [self randomURL];
+  ASBasicImageDownloaderContext *context = [ASBasicImageDownloaderContext contextForURL:url];
+  __block BOOL smallCompleted = NO, fullSizeCompleted = NO;
+  ASBasicImageDownloaderRequest *small = [[ASBasicImageDownloaderRequest alloc] initWithCallbackQueue:dispatch_get_main_queue() targetPixelSize:CGSizeMake(2, 2) downloadProgress:nil completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+    smallCompleted = YES;
+  }];
+  ASBasicImageDownloaderRequest *fullSize = [[ASBasicImageDownloaderRequest alloc] initWithCallbackQueue:dispatch_get_main_queue() targetPixelSize:CGSizeZero downloadProgress:nil completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+    fullSizeCompleted = YES;
+  }];
+  XCTAssertTrue([context addRequest:small]);
+  CGSize decodedPixelSize = context.targetPixelSize;
+  XCTAssertTrue(CGSizeEqualToSize(decodedPixelSize, CGSizeMake(2, 2)));
+  // Joins while the image is being decoded for the first request.
+  XCTAssertTrue([context addRequest:fullSize]);
+
+  UIImage *image = [[UIImage alloc] init];
+  XCTAssertFalse([context completeWithImage:image decodedPixelSize:decodedPixelSize error:nil]);
+  XCTAssertTrue(CGSizeEqualToSize(context.targetPixelSize, CGSizeZero), @"The full size request is left to decode for");
+  XCTAssert([ASBasicImageDownloaderContext contextForURL:url] == context, @"The context is still in flight");
+
+  XCTAssertTrue([context completeWithImage:image decodedPixelSize:CGSizeZero error:nil]);
+  [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.1]];
+  XCTAssertTrue(smallCompleted);
+  XCTAssertTrue(fullSizeCompleted);
+}
+
 - (void)testContextSessionCanceled
 {
   NSURL *url = [self randomURL];
@@ -13,6 +13,72 @@
 #import <XCTest/XCTest.h>
 
 #import <AsyncDisplayKit/ASBasicImageDownloader.h>
+#import <AsyncDisplayKit/ASBasicImageCache.h>
+#import <AsyncDisplayKit/ASBasicImageDownloaderInternal.h>
+
+/**
+ * Simulates a slow image server: every asdk-slow:// request is answered with a small PNG after a fixed delay.
+ */
+@interface ASSlowImageURLProtocol : NSURLProtocol
+@property (atomic, assign) BOOL stopped;
+@end
+
+static const NSTimeInterval kSlowImageServerDelay = 0.2;
+static NSMutableArray<NSString *> *startedRequestPaths;
+
+@implementation ASSlowImageURLProtocol
+
++ (BOOL)canInitWithRequest:(NSURLRequest *)request
+{
+  return [request.URL.scheme isEqualToString:@"asdk-slow"];
+}
+
++ (NSURLRequest *)canonicalRequestForRequest:(NSURLRequest *)request
+{
+  return request;
+}
+
++ (NSArray<NSString *> *)startedRequestPaths
+{
+  @synchronized (self) {
+    return [startedRequestPaths copy];
+  }
+}
+
++ (void)resetStartedRequestPaths
+{
+  @synchronized (self) {
+    startedRequestPaths = [NSMutableArray array];
+  }
+}
+
+- (void)startLoading
+{
+  @synchronized (self.class) {
+    [startedRequestPaths addObject:self.request.URL.path];
+  }
+
+  dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(kSlowImageServerDelay * NSEC_PER_SEC)), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    if (self.stopped) {
+      return;
+    }
+    UIGraphicsBeginImageContextWithOptions(CGSizeMake(4, 4), YES, 1);
+    NSData *data = UIImagePNGRepresentation(UIGraphicsGetImageFromCurrentImageContext());
+    UIGraphicsEndImageContext();
+
+    NSURLResponse *response = [[NSHTTPURLResponse alloc] initWithURL:self.request.URL statusCode:200 HTTPVersion:@"HTTP/1.1" headerFields:nil];
+    [self.client URLProtocol:self didReceiveResponse:response cacheStoragePolicy:NSURLCacheStorageNotAllowed];
+    [self.client URLProtocol:self didLoadData:data];
+    [self.client URLProtocolDidFinishLoading:self];
+  });
+}
+
+- (void)stopLoading
+{
+  self.stopped = YES;
+}
+
+@end
 
 @interface ASBasicImageDownloaderTests : XCTestCase
 
@@ -20,6 +86,13 @@
 
 @implementation ASBasicImageDownloaderTests
 
+- (void)setUp
+{
+  [super setUp];
+  // Make every test hit the network (or file system) and decoder.
+  [[ASBasicImageDownloader sharedImageDownloader].cache removeAllImages];
+}
+
 - (void)testAsynchronouslyDownloadTheSameURLTwice
 {
   XCTestExpectation *firstExpectation = [self expectationWithDescription:@"First ASBasicImageDownloader completion handler should be called within 3 seconds"];
@@ -45,4 +118,259 @@
   [self waitForExpectationsWithTimeout:30 handler:nil];
 }
 
+- (NSURL *)testImageURL
+{
+  return [[NSBundle bundleForClass:[self class]] URLForResource:@"logo-square"
+                                                  withExtension:@"png"
+                                                   subdirectory:@"TestResources"];
+}
+
+- (ASBasicImageDownloader *)slowServerDownloader
+{
+  [ASSlowImageURLProtocol resetStartedRequestPaths];
+  NSURLSessionConfiguration *configuration = [NSURLSessionConfiguration ephemeralSessionConfiguration];
+  configuration.protocolClasses = @[ [ASSlowImageURLProtocol class] ];
+  return [[ASBasicImageDownloader alloc] _initWithSessionConfiguration:configuration];
+}
+
+- (NSURL *)slowServerURLWithPath:(NSString *)path
+{
+  // Unique per test run so that neither the cache nor a previous context gets in the way.
+  return [NSURL URLWithString:[NSString stringWithFormat:@"asdk-slow://%@%@", [NSUUID UUID].UUIDString, path]];
+}
+
+- (void)waitForPendingDownloadCount:(NSUInteger)count downloader:(ASBasicImageDownloader *)downloader
+{
+  NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:3];
+  while ([downloader schedulerMetrics].pendingDownloadCount != count && [timeout timeIntervalSinceNow] > 0) {
+    [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertEqual([downloader schedulerMetrics].pendingDownloadCount, count);
+}
+
+- (void)testQueuedDownloadsStartInPriorityOrder
+{
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  downloader.maxConcurrentDownloads = 0;
+
+  NSDictionary<NSString *, NSNumber *> *priorities = @{
+    @"/preload" : @(ASImageDownloaderPriorityPreload),
+    @"/imminent" : @(ASImageDownloaderPriorityImminent),
+    @"/visible" : @(ASImageDownloaderPriorityVisible),
+  };
+  for (NSString *path in @[ @"/preload", @"/imminent", @"/visible" ]) {
+    XCTestExpectation *expectation = [self expectationWithDescription:path];
+    id identifier = [downloader downloadImageWithURL:[self slowServerURLWithPath:path]
+                                       callbackQueue:dispatch_get_main_queue()
+                                    downloadProgress:nil
+                                          completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                            XCTAssertNotNil(image);
+                                            [expectation fulfill];
+                                          }];
+    [downloader setPriority:(ASImageDownloaderPriority)priorities[path].unsignedIntegerValue withDownloadIdentifier:identifier];
+  }
+  [self waitForPendingDownloadCount:3 downloader:downloader];
+
+  downloader.maxConcurrentDownloads = 1;
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  NSArray *expectedOrder = @[ @"/visible", @"/imminent", @"/preload" ];
+  XCTAssertEqualObjects([ASSlowImageURLProtocol startedRequestPaths], expectedOrder);
+  XCTAssertEqual([downloader schedulerMetrics].startedDownloadCount, 3);
+}
+
+- (void)testDownloadCancelledWhileQueuedNeverStarts
+{
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  downloader.maxConcurrentDownloads = 0;
+
+  id identifier = [downloader downloadImageWithURL:[self slowServerURLWithPath:@"/cancelled"]
+                                     callbackQueue:dispatch_get_main_queue()
+                                  downloadProgress:nil
+                                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                          XCTFail(@"Cancelled downloads should not complete");
+                                        }];
+  [self waitForPendingDownloadCount:1 downloader:downloader];
+  [downloader cancelImageDownloadForIdentifier:identifier];
+
+  downloader.maxConcurrentDownloads = 4;
+  [[NSRunLoop currentRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:kSlowImageServerDelay * 2]];
+
+  XCTAssertEqual([ASSlowImageURLProtocol startedRequestPaths].count, 0);
+  ASBasicImageDownloaderSchedulerMetrics metrics = [downloader schedulerMetrics];
+  XCTAssertEqual(metrics.cancelledBeforeStartCount, 1);
+  XCTAssertEqual(metrics.pendingDownloadCount, 0);
+  XCTAssertEqual(metrics.startedDownloadCount, 0);
+}
+
+- (void)testSharedDownloadKeepsTheHighestPriorityOfItsRequests
+{
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  downloader.maxConcurrentDownloads = 0;
+  NSURL *URL = [self slowServerURLWithPath:@"/shared"];
+
+  XCTestExpectation *expectation = [self expectationWithDescription:@"The remaining request completes"];
+  ASBasicImageDownloaderRequest *offscreenRequest = [downloader downloadImageWithURL:URL
+                                                                      callbackQueue:dispatch_get_main_queue()
+                                                                   downloadProgress:nil
+                                                                         completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                                                           XCTAssertNotNil(image);
+                                                                           [expectation fulfill];
+                                                                         }];
+  ASBasicImageDownloaderRequest *visibleRequest = [downloader downloadImageWithURL:URL
+                                                                     callbackQueue:dispatch_get_main_queue()
+                                                                  downloadProgress:nil
+                                                                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                                                          XCTFail(@"Cancelled requests should not complete");
+                                                                        }];
+  XCTAssertEqual(offscreenRequest.context, visibleRequest.context);
+  ASBasicImageDownloaderContext *context = visibleRequest.context;
+  [self waitForPendingDownloadCount:1 downloader:downloader];
+
+  [downloader setPriority:ASImageDownloaderPriorityVisible withDownloadIdentifier:visibleRequest];
+  [downloader setPriority:ASImageDownloaderPriorityPreload withDownloadIdentifier:offscreenRequest];
+  XCTAssertEqual(context.priority, ASImageDownloaderPriorityVisible, @"Going offscreen shouldn't demote a download a visible node waits for");
+
+  [downloader cancelImageDownloadForIdentifier:visibleRequest];
+  XCTAssertFalse([context isCancelled], @"The download is still needed by the other request");
+  XCTAssertEqual(context.priority, ASImageDownloaderPriorityPreload);
+
+  downloader.maxConcurrentDownloads = 1;
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testRequestsForAURLWhoseDownloadIsCompletingAreCompleted
+{
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  NSURL *URL = [self slowServerURLWithPath:@"/completing"];
+  // Downsampled images aren't put in the memory cache, so every request has to join or start a download.
+  CGSize targetPixelSize = CGSizeMake(2, 2);
+  dispatch_queue_t callbackQueue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+
+  XCTestExpectation *repeatedExpectation = [self expectationWithDescription:@"Request made from a completion block completes"];
+  XCTestExpectation *firstExpectation = [self expectationWithDescription:@"First request completes"];
+  [downloader downloadImageWithURL:URL
+                   targetPixelSize:targetPixelSize
+                     callbackQueue:callbackQueue
+                  downloadProgress:nil
+                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                          [downloader downloadImageWithURL:URL
+                                           targetPixelSize:targetPixelSize
+                                             callbackQueue:callbackQueue
+                                          downloadProgress:nil
+                                                completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                                  XCTAssertNotNil(image);
+                                                  [repeatedExpectation fulfill];
+                                                }];
+                          [firstExpectation fulfill];
+                        }];
+
+  // Keep requesting the URL throughout the first download, including while it completes.
+  for (NSUInteger i = 0; i < 40; i++) {
+    XCTestExpectation *expectation = [self expectationWithDescription:[NSString stringWithFormat:@"Request %lu completes", (unsigned long)i]];
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(i * kSlowImageServerDelay / 20 * NSEC_PER_SEC)), callbackQueue, ^{
+      [downloader downloadImageWithURL:URL
+                       targetPixelSize:targetPixelSize
+                         callbackQueue:callbackQueue
+                      downloadProgress:nil
+                            completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                              XCTAssertNotNil(image);
+                              [expectation fulfill];
+                            }];
+    });
+  }
+
+  [self waitForExpectationsWithTimeout:10 handler:nil];
+}
+
+- (void)testTimeToVisibleImageIsReported
+{
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  downloader.maxConcurrentDownloads = 0;
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Visible download completes"];
+
+  id identifier = [downloader downloadImageWithURL:[self slowServerURLWithPath:@"/visible"]
+                                     callbackQueue:dispatch_get_main_queue()
+                                  downloadProgress:nil
+                                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                                          [expectation fulfill];
+                                        }];
+  [self waitForPendingDownloadCount:1 downloader:downloader];
+  [downloader setPriority:ASImageDownloaderPriorityVisible withDownloadIdentifier:identifier];
+  downloader.maxConcurrentDownloads = 1;
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+
+  ASBasicImageDownloaderSchedulerMetrics metrics = [downloader schedulerMetrics];
+  XCTAssertEqual(metrics.visibleImageCount, 1);
+  XCTAssertGreaterThanOrEqual(metrics.totalTimeToVisibleImage, kSlowImageServerDelay);
+  XCTAssertEqual(metrics.maxTimeToVisibleImage, metrics.totalTimeToVisibleImage);
+}
+
+- (void)testDownloadedImageIsDownsampledToTargetPixelSize
+{
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Downsampled download completes"];
+  ASBasicImageDownloader *downloader = [ASBasicImageDownloader sharedImageDownloader];
+  [downloader resetDecodeMetrics];
+
+  // logo-square.png is 1175px square.
+  [downloader downloadImageWithURL:[self testImageURL]
+                   targetPixelSize:CGSizeMake(100, 50)
+                     callbackQueue:dispatch_get_main_queue()
+                  downloadProgress:nil
+                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                          CGImageRef imageRef = [image asdk_image].CGImage;
+                          XCTAssertEqual(CGImageGetWidth(imageRef), 100);
+                          XCTAssertEqual(CGImageGetHeight(imageRef), 100);
+
+                          ASBasicImageDownloaderDecodeMetrics metrics = [downloader decodeMetrics];
+                          XCTAssertEqual(metrics.decodedImageCount, 1);
+                          XCTAssertEqual(metrics.downsampledImageCount, 1);
+                          XCTAssertEqual(metrics.bytesSavedByDownsampling, (1175 * 1175 - 100 * 100) * 4);
+                          XCTAssertGreaterThan(metrics.totalDecodeDuration, 0);
+                          // Downsampled images are not.
+                          XCTAssertNil([downloader synchronouslyFetchedCachedImageWithURL:[self testImageURL]]);
+                          [expectation fulfill];
+                        }];
+
+  [self waitForExpectationsWithTimeout:30 handler:nil];
+}
+
+- (void)testDownloadedImageIsDecodedAtFullSizeWithoutTargetPixelSize
+{
+  XCTestExpectation *expectation = [self expectationWithDescription:@"Full size download completes"];
+  ASBasicImageDownloader *downloader = [ASBasicImageDownloader sharedImageDownloader];
+  [downloader resetDecodeMetrics];
+
+  [downloader downloadImageWithURL:[self testImageURL]
+                     callbackQueue:dispatch_get_main_queue()
+                  downloadProgress:nil
+                        completion:^(id<ASImageContainerProtocol>  _Nullable image, NSError * _Nullable error, id  _Nullable downloadIdentifier) {
+                          XCTAssertEqual(CGImageGetWidth([image asdk_image].CGImage), 1175);
+                          XCTAssertEqual([downloader decodeMetrics].downsampledImageCount, 0);
+                          XCTAssertEqual([downloader decodeMetrics].bytesSavedByDownsampling, 0);
+                          // Full size images are kept in the memory cache.
+                          XCTAssertNotNil([downloader synchronouslyFetchedCachedImageWithURL:[self testImageURL]]);
+                          [expectation fulfill];
+                        }];
+
+  [self waitForExpectationsWithTimeout:30 handler:nil];
+}
+
+- (void)testDownloadersOtherThanTheSharedOneDontTouchItsDiskCache
+{
+  ASBasicImageCache *sharedCache = [ASBasicImageDownloader sharedImageDownloader].cache;
+  ASBasicImageDownloader *downloader = [self slowServerDownloader];
+  XCTAssertNotEqualObjects(downloader.cache.directoryURL, sharedCache.directoryURL);
+
+  NSURL *URL = [self slowServerURLWithPath:@"/shared.png"];
+  UIImage *image = [UIImage imageWithContentsOfFile:[self testImageURL].path];
+  [sharedCache setImage:image data:[NSData dataWithContentsOfURL:[self testImageURL]] downsampled:NO forURL:URL];
+  XCTAssertTrue([sharedCache containsDataOnDiskForURL:URL]);
+
+  [downloader.cache removeAllImages];
+  XCTAssertFalse([downloader.cache containsDataOnDiskForURL:URL]);
+  XCTAssertTrue([sharedCache containsDataOnDiskForURL:URL]);
+  XCTAssertNotNil([sharedCache memoryCachedImageForURL:URL]);
+}
+
 @end
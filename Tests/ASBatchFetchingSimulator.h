@@ -0,0 +1,60 @@
+//
+//  ASBatchFetchingSimulator.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <UIKit/UIKit.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef struct {
+  /// Batch fetches begun during the trace.
+  NSUInteger fetchCount;
+  /// Times scrolling ran into the end of content.
+  NSUInteger stallCount;
+  /// Total time spent held at the end of content.
+  NSTimeInterval stallDuration;
+} ASBatchFetchingSimulationResult;
+
+/**
+ * Replays a vertical scroll trace against the batch fetching policy on a simulated clock.
+ *
+ * A trace is the velocity, in points per second, that the user is scrolling at on each frame. Content grows by
+ * batchContentLength each time a batch fetch completes, fetchDuration after it began. When the trace would scroll past
+ * the end of content, the offset is held there and the frames are counted as a stall.
+ */
+@interface ASBatchFetchingSimulator : NSObject
+
+/**
+ * A trace of the given number of flings, each decelerating from the initial velocity at the normal UIScrollView rate,
+ * followed by a short pause before the next one.
+ */
++ (NSArray<NSNumber *> *)flingTraceWithInitialVelocity:(CGFloat)initialVelocity flingCount:(NSUInteger)flingCount;
+
+/**
+ * A trace scrolling at constant velocity for the given duration.
+ */
++ (NSArray<NSNumber *> *)constantTraceWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration;
+
+@property (nonatomic, assign) CGFloat viewportLength;
+@property (nonatomic, assign) CGFloat initialContentLength;
+@property (nonatomic, assign) CGFloat batchContentLength;
+@property (nonatomic, assign) NSTimeInterval fetchDuration;
+@property (nonatomic, assign) CGFloat leadingScreens;
+
+/**
+ * Whether the policy is given the scroll velocity and, while a fling decelerates, the offset it will come to rest at,
+ * as ASTableView and ASCollectionView do. If NO, only the leading screens past the current offset are taken into account.
+ */
+@property (nonatomic, assign) BOOL usesPrediction;
+
+- (ASBatchFetchingSimulationResult)replayTrace:(NSArray<NSNumber *> *)trace;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,142 @@
+//
+//  ASBatchFetchingSimulator.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import "ASBatchFetchingSimulator.h"
+
+#import <AsyncDisplayKit/ASBatchContext.h>
+#import <AsyncDisplayKit/ASBatchContext+Private.h>
+#import <AsyncDisplayKit/ASBatchFetching.h>
+
+static const NSTimeInterval kFrameInterval = 1.0 / 60.0;
+
+@implementation ASBatchFetchingSimulator
+
++ (NSArray<NSNumber *> *)flingTraceWithInitialVelocity:(CGFloat)initialVelocity flingCount:(NSUInteger)flingCount
+{
+  // UIScrollViewDecelerationRateNormal is the fraction of velocity kept per millisecond.
+  CGFloat decayPerFrame = pow(UIScrollViewDecelerationRateNormal, kFrameInterval * 1000.0);
+  NSUInteger pauseFrameCount = (NSUInteger)(0.25 / kFrameInterval);
+
+  NSMutableArray<NSNumber *> *trace = [NSMutableArray array];
+  for (NSUInteger i = 0; i < flingCount; i++) {
+    for (CGFloat velocity = initialVelocity; velocity > 10.0; velocity *= decayPerFrame) {
+      [trace addObject:@(velocity)];
+    }
+    for (NSUInteger j = 0; j < pauseFrameCount; j++) {
+      [trace addObject:@0];
+    }
+  }
+  return trace;
+}
+
++ (NSArray<NSNumber *> *)constantTraceWithVelocity:(CGFloat)velocity duration:(NSTimeInterval)duration
+{
+  NSUInteger frameCount = (NSUInteger)(duration / kFrameInterval);
+  NSMutableArray<NSNumber *> *trace = [NSMutableArray arrayWithCapacity:frameCount];
+  for (NSUInteger i = 0; i < frameCount; i++) {
+    [trace addObject:@(velocity)];
+  }
+  return trace;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _viewportLength = 600.0;
+    _initialContentLength = 3000.0;
+    _batchContentLength = 3000.0;
+    _fetchDuration = 1.0;
+    _leadingScreens = 2.0;
+    _usesPrediction = YES;
+  }
+  return self;
+}
+
+- (ASBatchFetchingSimulationResult)replayTrace:(NSArray<NSNumber *> *)trace
+{
+  ASBatchFetchingSimulationResult result = {0};
+  ASBatchContext *context = [[ASBatchContext alloc] init];
+  ASBatchFetchingVelocityEstimate velocityEstimate = {};
+
+  CFTimeInterval time = 0;
+  CFTimeInterval fetchCompletionTime = 0;
+  CGFloat offset = 0;
+  CGFloat contentLength = _initialContentLength;
+  BOOL stalled = NO;
+
+  NSUInteger frameCount = trace.count;
+  for (NSUInteger frame = 0; frame < frameCount; frame++) {
+    time += kFrameInterval;
+
+    if ([context isFetching] && time >= fetchCompletionTime) {
+      contentLength += _batchContentLength;
+      [context completeBatchFetching:YES atTime:fetchCompletionTime];
+    }
+
+    CGFloat velocity = trace[frame].doubleValue;
+    CGFloat maxOffset = MAX(0, contentLength - _viewportLength);
+    CGFloat requestedOffset = offset + velocity * kFrameInterval;
+    if (velocity > 0 && requestedOffset > maxOffset) {
+      offset = maxOffset;
+      if (!stalled) {
+        result.stallCount++;
+        stalled = YES;
+      }
+      result.stallDuration += kFrameInterval;
+    } else {
+      offset = requestedOffset;
+      stalled = NO;
+    }
+
+    ASBatchFetchingVelocityEstimateAddSample(&velocityEstimate, CGPointMake(0, offset), time);
+    CGFloat estimatedVelocity = velocityEstimate.velocity.y;
+    ASScrollDirection direction = ASScrollDirectionNone;
+    if (estimatedVelocity > 0) {
+      direction = ASScrollDirectionDown;
+    } else if (estimatedVelocity < 0) {
+      direction = ASScrollDirectionUp;
+    }
+
+    // While the following frames keep slowing down, the scroll is a fling decelerating toward where it comes to rest,
+    // which is the target content offset UIScrollView reports when dragging ends.
+    CGFloat targetOffset = offset;
+    if (_usesPrediction && velocity > 0) {
+      CGFloat previousVelocity = velocity;
+      for (NSUInteger next = frame + 1; next < frameCount; next++) {
+        CGFloat nextVelocity = trace[next].doubleValue;
+        if (nextVelocity <= 0 || nextVelocity >= previousVelocity) {
+          break;
+        }
+        targetOffset += nextVelocity * kFrameInterval;
+        previousVelocity = nextVelocity;
+      }
+      targetOffset = MIN(targetOffset, maxOffset);
+    }
+
+    BOOL shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context,
+                                                                       direction,
+                                                                       ASScrollDirectionVerticalDirections,
+                                                                       CGRectMake(0, 0, 320, _viewportLength),
+                                                                       CGSizeMake(320, contentLength),
+                                                                       CGPointMake(0, targetOffset),
+                                                                       _leadingScreens,
+                                                                       YES,
+                                                                       _usesPrediction ? velocityEstimate.velocity : CGPointZero);
+    if (shouldFetch) {
+      [context beginBatchFetchingAtTime:time];
+      fetchCompletionTime = time + _fetchDuration;
+      result.fetchCount++;
+    }
+  }
+
+  return result;
+}
+
+@end
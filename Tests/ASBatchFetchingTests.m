@@ -12,6 +12,9 @@
 
 #import <AsyncDisplayKit/AsyncDisplayKit.h>
 #import <AsyncDisplayKit/ASBatchFetching.h>
+#import <AsyncDisplayKit/ASBatchContext+Private.h>
+
+#import "ASBatchFetchingSimulator.h"
 
 @interface ASBatchFetchingTests : XCTestCase
 
@@ -118,4 +121,97 @@
   XCTAssert(shouldFetch == YES, @"Fetch should begin when the target is 0 and the content size is smaller than the scree");
 }
 
+- (void)testFetchDurationEstimate {
+  ASBatchContext *context = [[ASBatchContext alloc] init];
+  XCTAssertEqual([context estimatedFetchDuration], 0);
+
+  [context beginBatchFetchingAtTime:10.0];
+  [context completeBatchFetching:YES atTime:11.0];
+  XCTAssertEqualWithAccuracy([context estimatedFetchDuration], 1.0, 0.0001, @"The first fetch should set the estimate");
+
+  [context beginBatchFetchingAtTime:20.0];
+  [context completeBatchFetching:YES atTime:22.0];
+  XCTAssertEqualWithAccuracy([context estimatedFetchDuration], 1.25, 0.0001, @"Later fetches should move the estimate toward their duration");
+
+  [context beginBatchFetchingAtTime:30.0];
+  [context cancelBatchFetching];
+  [context completeBatchFetching:YES atTime:40.0];
+  XCTAssertEqualWithAccuracy([context estimatedFetchDuration], 1.25, 0.0001, @"Cancelled fetches should not be timed");
+}
+
+- (void)testVelocityEstimate {
+  ASBatchFetchingVelocityEstimate estimate = {};
+  for (NSUInteger frame = 1; frame <= 10; frame++) {
+    ASBatchFetchingVelocityEstimateAddSample(&estimate, VERTICAL_OFFSET(frame * 50.0), frame / 60.0);
+  }
+  XCTAssertEqualWithAccuracy(estimate.velocity.y, 3000.0, 1.0, @"Moving 50 points per frame at 60fps is 3000 points per second");
+  XCTAssertEqual(estimate.velocity.x, 0);
+}
+
+- (void)testVerticalVelocityTriggersFetchBeforeLeadingScreens {
+  CGFloat screen = 500.0;
+  ASBatchContext *context = [[ASBatchContext alloc] init];
+  // 10 screens of content, 4 screens remaining past the viewport, so 2 leading screens isn't enough to fetch.
+  CGRect bounds = VERTICAL_RECT(screen);
+  CGSize contentSize = VERTICAL_SIZE(screen * 10.0);
+  CGPoint offset = VERTICAL_OFFSET(screen * 5.0);
+  CGPoint fastVelocity = VERTICAL_OFFSET(screen * 3.0);
+
+  BOOL shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionDown, ASScrollDirectionVerticalDirections, bounds, contentSize, offset, 2.0, YES, fastVelocity);
+  XCTAssert(shouldFetch == NO, @"Fetch should not be predicted before any fetch has been timed");
+
+  [context beginBatchFetchingAtTime:0];
+  [context completeBatchFetching:YES atTime:1.0];
+
+  shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionDown, ASScrollDirectionVerticalDirections, bounds, contentSize, offset, 2.0, YES, CGPointZero);
+  XCTAssert(shouldFetch == NO, @"Fetch should not begin at rest more than the leading distance away");
+
+  shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionDown, ASScrollDirectionVerticalDirections, bounds, contentSize, offset, 2.0, YES, fastVelocity);
+  XCTAssert(shouldFetch == YES, @"Fetch should begin when the end of content would be reached before a fetch completes");
+
+  shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionDown, ASScrollDirectionVerticalDirections, bounds, contentSize, offset, 2.0, YES, VERTICAL_OFFSET(screen));
+  XCTAssert(shouldFetch == NO, @"Fetch should not begin when a fetch would complete well before the end of content is reached");
+
+  shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionUp, ASScrollDirectionVerticalDirections, bounds, contentSize, offset, 2.0, YES, VERTICAL_OFFSET(-screen * 3.0));
+  XCTAssert(shouldFetch == NO, @"Fetch should not begin when scrolling toward the head of content");
+}
+
+- (void)testHorizontalVelocityTriggersFetchBeforeLeadingScreens {
+  CGFloat screen = 500.0;
+  ASBatchContext *context = [[ASBatchContext alloc] init];
+  [context beginBatchFetchingAtTime:0];
+  [context completeBatchFetching:YES atTime:1.0];
+
+  BOOL shouldFetch = ASDisplayShouldFetchBatchForContextWithVelocity(context, ASScrollDirectionRight, ASScrollDirectionHorizontalDirections, HORIZONTAL_RECT(screen), HORIZONTAL_SIZE(screen * 10.0), HORIZONTAL_OFFSET(screen * 5.0), 2.0, YES, HORIZONTAL_OFFSET(screen * 3.0));
+  XCTAssert(shouldFetch == YES, @"Fetch should begin when the end of content would be reached before a fetch completes");
+}
+
+- (void)testSimulatedFlingsStallLessWithPrediction {
+  NSArray<NSNumber *> *trace = [ASBatchFetchingSimulator flingTraceWithInitialVelocity:4000.0 flingCount:12];
+
+  ASBatchFetchingSimulator *simulator = [[ASBatchFetchingSimulator alloc] init];
+  simulator.usesPrediction = NO;
+  ASBatchFetchingSimulationResult leadingScreensResult = [simulator replayTrace:trace];
+  simulator.usesPrediction = YES;
+  ASBatchFetchingSimulationResult predictionResult = [simulator replayTrace:trace];
+
+  XCTAssertGreaterThan(leadingScreensResult.stallCount, 0, @"Fetching on leading screens alone should fall behind these flings");
+  XCTAssertLessThan(predictionResult.stallCount, leadingScreensResult.stallCount);
+  XCTAssertLessThan(predictionResult.stallDuration, leadingScreensResult.stallDuration);
+}
+
+- (void)testSimulatedSlowScrollingDoesNotStall {
+  NSArray<NSNumber *> *trace = [ASBatchFetchingSimulator constantTraceWithVelocity:300.0 duration:10.0];
+
+  ASBatchFetchingSimulator *simulator = [[ASBatchFetchingSimulator alloc] init];
+  simulator.usesPrediction = NO;
+  ASBatchFetchingSimulationResult leadingScreensResult = [simulator replayTrace:trace];
+  simulator.usesPrediction = YES;
+  ASBatchFetchingSimulationResult predictionResult = [simulator replayTrace:trace];
+
+  XCTAssertEqual(leadingScreensResult.stallCount, 0);
+  XCTAssertEqual(predictionResult.stallCount, 0);
+  XCTAssertEqual(predictionResult.fetchCount, leadingScreensResult.fetchCount, @"Slow scrolling shouldn't fetch any earlier than the leading screens");
+}
+
 @end
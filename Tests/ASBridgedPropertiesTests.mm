@@ -18,6 +18,8 @@
 #import <AsyncDisplayKit/_ASPendingState.h>
 #import <AsyncDisplayKit/ASCellNode.h>
 
+#import <atomic>
+
 @interface ASPendingStateController (Testing)
 - (BOOL)test_isFlushScheduled;
 @end
@@ -141,6 +143,17 @@ static inline void ASDispatchSyncOnOtherThread(dispatch_block_t block) {
   });
 }
 
+- (void)testThatReadingASnapshottedPropertyOfALoadedNodeInBackgroundThrowsAnException
+{
+  ASDisplayNode *node = [ASDisplayNode new];
+  // Publish the snapshot while unloaded, so the getter goes through the unlocked path first.
+  node.bounds = CGRectMake(0, 0, 10, 10);
+  [node view];
+  ASDispatchSyncOnOtherThread(^{
+    XCTAssertThrows(node.bounds);
+  });
+}
+
 - (void)testThatManuallyFlushingTheSyncControllerImmediatelyAppliesChanges
 {
   ASPendingStateController *ctrl = [ASPendingStateController sharedInstance];
@@ -217,6 +230,107 @@ static inline void ASDispatchSyncOnOtherThread(dispatch_block_t block) {
   XCTAssertTrue(node.layer.needsDisplay);
 }
 
+- (void)testThatReadingBridgedPropertiesOfAnUnloadedNodeReturnsWhatWasSet
+{
+  ASDisplayNode *node = [ASDisplayNode new];
+  ASDispatchSyncOnOtherThread(^{
+    node.alpha = 0.5;
+    node.frame = CGRectMake(10, 20, 30, 40);
+    node.hidden = YES;
+    node.contentsScale = 3;
+    XCTAssertEqual(node.alpha, 0.5);
+    XCTAssertTrue(CGRectEqualToRect(node.frame, CGRectMake(10, 20, 30, 40)));
+    XCTAssertTrue(CGRectEqualToRect(node.bounds, CGRectMake(0, 0, 30, 40)));
+    XCTAssertTrue(CGPointEqualToPoint(node.position, CGPointMake(25, 40)));
+    XCTAssertTrue(node.isHidden);
+    XCTAssertEqual(node.contentsScale, 3);
+  });
+  XCTAssertEqual(node.alpha, 0.5);
+  XCTAssertTrue(CGRectEqualToRect(node.frame, CGRectMake(10, 20, 30, 40)));
+  XCTAssertTrue(CGPointEqualToPoint(node.anchorPoint, CGPointMake(0.5, 0.5)));
+
+  node.anchorPoint = CGPointZero;
+  XCTAssertTrue(CGPointEqualToPoint(node.anchorPoint, CGPointZero));
+  XCTAssertTrue(CGRectEqualToRect(node.frame, CGRectMake(25, 40, 30, 40)));
+
+  [node view];
+  XCTAssertTrue(CGRectEqualToRect(node.frame, CGRectMake(25, 40, 30, 40)));
+  node.alpha = 1;
+  XCTAssertEqual(node.alpha, 1);
+  XCTAssertEqual(node.view.alpha, 1);
+}
+
+- (void)testThatFramesReadWhileAnotherThreadSetsThemAreNeverTorn
+{
+  ASDisplayNode *node = [ASDisplayNode new];
+  node.frame = CGRectZero;
+  // Blocks can't copy atomics, so they capture pointers to these, which outlive them.
+  std::atomic<bool> done(false), *donePointer = &done;
+  std::atomic<NSUInteger> tornReads(0), *tornReadsPointer = &tornReads;
+  dispatch_group_t group = dispatch_group_create();
+  dispatch_queue_t queue = dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0);
+  for (NSUInteger i = 0; i < 3; i++) {
+    dispatch_group_async(group, queue, ^{
+      while (!donePointer->load()) {
+        CGRect frame = node.frame;
+        if (frame.size.width != frame.origin.x * 2 || frame.size.height != frame.origin.y * 2 || frame.origin.x != frame.origin.y) {
+          (*tornReadsPointer)++;
+        }
+      }
+    });
+  }
+  ASDispatchSyncOnOtherThread(^{
+    for (NSUInteger i = 1; i <= 100000; i++) {
+      node.frame = CGRectMake(i, i, i * 2, i * 2);
+    }
+  });
+  done = true;
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  XCTAssertEqual(tornReads.load(), 0);
+  XCTAssertTrue(CGRectEqualToRect(node.frame, CGRectMake(100000, 100000, 200000, 200000)));
+}
+
+- (void)testThatFramesReadOnMainWhileTheNodeLoadsAreNeverTorn
+{
+  ASDisplayNode *node = [ASDisplayNode new];
+  node.frame = CGRectZero;
+  std::atomic<bool> done(false), *donePointer = &done;
+  dispatch_group_t group = dispatch_group_create();
+  dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+    for (NSUInteger i = 1; !donePointer->load(); i++) {
+      node.frame = CGRectMake(i, i, i * 2, i * 2);
+    }
+  });
+  NSUInteger tornReads = 0;
+  for (NSUInteger i = 0; i < 20000; i++) {
+    if (i == 10000) {
+      [node view];
+    } else if (i > 10000 && i % 100 == 0) {
+      [[ASPendingStateController sharedInstance] flush];
+    }
+    CGRect frame = node.frame;
+    if (frame.size.width != frame.origin.x * 2 || frame.size.height != frame.origin.y * 2 || frame.origin.x != frame.origin.y) {
+      tornReads++;
+    }
+  }
+  done = true;
+  dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+  XCTAssertEqual(tornReads, 0);
+}
+
+- (void)testPerformanceOfReadingTheFrameOfAnUnloadedNode
+{
+  ASDisplayNode *node = [ASDisplayNode new];
+  node.frame = CGRectMake(0, 0, 100, 100);
+  [self measureBlock:^{
+    CGFloat width = 0;
+    for (NSUInteger i = 0; i < 100000; i++) {
+      width += node.frame.size.width;
+    }
+    XCTAssertEqual(width, 100 * 100000);
+  }];
+}
+
 /// [XCTExpectation expectationWithPredicate:] should handle this
 /// but under Xcode 7.2.1 its polling interval is 1 second
 /// which makes the tests really slow and I'm impatient.
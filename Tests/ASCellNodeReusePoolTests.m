@@ -0,0 +1,196 @@
+//
+//  ASCellNodeReusePoolTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASCellNodeReusePool.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+#import <AsyncDisplayKit/ASLayoutSpec.h>
+#import <AsyncDisplayKit/ASTextNode.h>
+
+@interface ASReusePoolTestCellNode : ASCellNode
+@property (nonatomic, assign) NSUInteger prepareForReuseCount;
+@end
+
+@implementation ASReusePoolTestCellNode
+
+- (void)prepareForReuse
+{
+  [super prepareForReuse];
+  _prepareForReuseCount++;
+}
+
+@end
+
+@interface ASReusePoolTestTextCellNode : ASCellNode
+@property (nonatomic, strong, readonly) ASTextNode *textNode;
+@end
+
+@implementation ASReusePoolTestTextCellNode
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _textNode = [[ASTextNode alloc] init];
+    self.automaticallyManagesSubnodes = YES;
+  }
+  return self;
+}
+
+- (ASLayoutSpec *)layoutSpecThatFits:(ASSizeRange)constrainedSize
+{
+  return [ASWrapperLayoutSpec wrapperWithLayoutElement:_textNode];
+}
+
+@end
+
+@interface ASCellNodeReusePoolTests : XCTestCase
+@end
+
+@implementation ASCellNodeReusePoolTests
+
+- (void)testThatNodesAreAllocatedWhenThePoolIsEmpty
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  XCTAssertFalse(pool.isInUse);
+  ASCellNode *node = [pool nodeOfClass:[ASReusePoolTestCellNode class]];
+  XCTAssertEqualObjects([node class], [ASReusePoolTestCellNode class]);
+  XCTAssertTrue(pool.isInUse);
+  XCTAssertEqual(pool.metrics.allocatedNodeCount, 1);
+  XCTAssertEqual(pool.metrics.reusedNodeCount, 0);
+}
+
+- (void)testThatEnqueuedNodesAreReused
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  ASReusePoolTestCellNode *node = [pool nodeOfClass:[ASReusePoolTestCellNode class]];
+  node.selected = YES;
+  [node recursivelySetInterfaceState:(ASInterfaceState)(ASInterfaceStateMeasureLayout | ASInterfaceStatePreload)];
+
+  XCTAssertTrue([pool enqueueNode:node]);
+  XCTAssertEqual(node.prepareForReuseCount, 1);
+  XCTAssertFalse(node.selected);
+  XCTAssertEqual(node.interfaceState, ASInterfaceStateNone);
+  XCTAssertEqual([pool countOfNodesOfClass:[ASReusePoolTestCellNode class]], 1);
+
+  XCTAssertEqual([pool nodeOfClass:[ASReusePoolTestCellNode class]], node);
+  XCTAssertEqual([pool countOfNodesOfClass:[ASReusePoolTestCellNode class]], 0);
+  XCTAssertEqual(pool.metrics.reusedNodeCount, 1);
+}
+
+- (void)testThatNodesOfClassesNeverRequestedAreNotTaken
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  ASReusePoolTestCellNode *node = [[ASReusePoolTestCellNode alloc] init];
+  XCTAssertFalse([pool enqueueNode:node]);
+  XCTAssertEqual(node.prepareForReuseCount, 0);
+  XCTAssertEqual(pool.metrics.discardedNodeCount, 0);
+}
+
+- (void)testThatVisibleNodesAreNotTaken
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  ASReusePoolTestCellNode *node = [pool nodeOfClass:[ASReusePoolTestCellNode class]];
+  [node recursivelySetInterfaceState:(ASInterfaceState)(ASInterfaceStateMeasureLayout | ASInterfaceStateVisible)];
+  XCTAssertFalse([pool enqueueNode:node]);
+  XCTAssertEqual(node.prepareForReuseCount, 0);
+  XCTAssertEqual(pool.metrics.discardedNodeCount, 1);
+}
+
+- (void)testThatThePoolIsBoundedPerClass
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] initWithCapacityPerClass:2];
+  Class nodeClass = [ASReusePoolTestCellNode class];
+  NSArray *nodes = @[ [pool nodeOfClass:nodeClass], [pool nodeOfClass:nodeClass], [pool nodeOfClass:nodeClass] ];
+  XCTAssertTrue([pool enqueueNode:nodes[0]]);
+  XCTAssertTrue([pool enqueueNode:nodes[1]]);
+  XCTAssertFalse([pool enqueueNode:nodes[2]]);
+  XCTAssertEqual([pool countOfNodesOfClass:nodeClass], 2);
+
+  pool.capacityPerClass = 1;
+  XCTAssertEqual([pool countOfNodesOfClass:nodeClass], 1);
+  XCTAssertEqual(pool.metrics.discardedNodeCount, 1);
+  XCTAssertEqual(pool.metrics.drainedNodeCount, 1);
+}
+
+- (void)testThatThePoolIsDrainedOnMemoryWarnings
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  Class nodeClass = [ASReusePoolTestCellNode class];
+  XCTAssertTrue([pool enqueueNode:[pool nodeOfClass:nodeClass]]);
+
+  [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+  XCTAssertEqual([pool countOfNodesOfClass:nodeClass], 0);
+  XCTAssertEqual(pool.metrics.drainedNodeCount, 1);
+  // The class is still taken back afterwards.
+  XCTAssertTrue([pool enqueueNode:[pool nodeOfClass:nodeClass]]);
+}
+
+- (void)testThatReusedNodesAreLaidOutAgain
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  ASSizeRange sizeRange = ASSizeRangeMake(CGSizeZero, CGSizeMake(320, CGFLOAT_MAX));
+  ASReusePoolTestTextCellNode *node = [pool nodeOfClass:[ASReusePoolTestTextCellNode class]];
+  node.textNode.attributedText = [[NSAttributedString alloc] initWithString:@"Short"];
+  CGFloat shortHeight = [node layoutThatFits:sizeRange].size.height;
+  XCTAssertTrue([pool enqueueNode:node]);
+
+  node = [pool nodeOfClass:[ASReusePoolTestTextCellNode class]];
+  NSString *longText = [@"" stringByPaddingToLength:500 withString:@"Long text " startingAtIndex:0];
+  node.textNode.attributedText = [[NSAttributedString alloc] initWithString:longText];
+  XCTAssertGreaterThan([node layoutThatFits:sizeRange].size.height, shortHeight);
+}
+
+#pragma mark - Benchmarks
+
+/**
+ * Fills a page of 20 cells over and over, as when paging through a feed, and lays them out.
+ */
+- (void)measureFillingPagesReusingNodes:(BOOL)reuse
+{
+  ASCellNodeReusePool *pool = [[ASCellNodeReusePool alloc] init];
+  ASSizeRange sizeRange = ASSizeRangeMake(CGSizeZero, CGSizeMake(320, CGFLOAT_MAX));
+  NSAttributedString *text = [[NSAttributedString alloc] initWithString:@"A row in an infinite feed"];
+  [self measureBlock:^{
+    [pool resetMetrics];
+    for (NSInteger page = 0; page < 20; page++) {
+      CFTimeInterval startTime = CACurrentMediaTime();
+      NSMutableArray<ASReusePoolTestTextCellNode *> *nodes = [NSMutableArray array];
+      for (NSInteger row = 0; row < 20; row++) {
+        ASReusePoolTestTextCellNode *node = (reuse ? [pool nodeOfClass:[ASReusePoolTestTextCellNode class]]
+                                             : [[ASReusePoolTestTextCellNode alloc] init]);
+        node.textNode.attributedText = text;
+        [node layoutThatFits:sizeRange];
+        [nodes addObject:node];
+      }
+      [pool recordFillOfNodeCount:nodes.count duration:CACurrentMediaTime() - startTime];
+      if (reuse) {
+        for (ASCellNode *node in nodes) {
+          [pool enqueueNode:node];
+        }
+      }
+    }
+    ASCellNodeReusePoolMetrics metrics = pool.metrics;
+    NSLog(@"%@: allocated %tu nodes, reused %tu, last page of %tu filled in %.2fms", self.name, metrics.allocatedNodeCount, metrics.reusedNodeCount, metrics.lastFillNodeCount, metrics.lastFillDuration * 1000);
+  }];
+}
+
+- (void)testPerformanceOfFillingPagesWithNewNodes
+{
+  [self measureFillingPagesReusingNodes:NO];
+}
+
+- (void)testPerformanceOfFillingPagesWithReusedNodes
+{
+  [self measureFillingPagesReusingNodes:YES];
+}
+
+@end
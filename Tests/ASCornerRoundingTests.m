@@ -0,0 +1,202 @@
+//
+//  ASCornerRoundingTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASDisplayNode+Beta.h>
+#import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
+
+@interface ASCornerRoundingTestNode : ASDisplayNode
+@end
+
+@implementation ASCornerRoundingTestNode
+
++ (void)drawRect:(CGRect)bounds withParameters:(id)parameters isCancelled:(asdisplaynode_iscancelled_block_t)isCancelledBlock isRasterizing:(BOOL)isRasterizing
+{
+  [[UIColor redColor] setFill];
+  UIRectFill(bounds);
+}
+
+@end
+
+@interface ASCornerRoundingTests : XCTestCase
+@end
+
+@implementation ASCornerRoundingTests
+
+- (ASDisplayNode *)drawingNodeWithCornerRoundingType:(ASCornerRoundingType)cornerRoundingType
+{
+  ASDisplayNode *node = [[ASCornerRoundingTestNode alloc] init];
+  node.layerBacked = YES;
+  node.displaysAsynchronously = NO;
+  node.frame = CGRectMake(0, 0, 100, 100);
+  node.cornerRoundingType = cornerRoundingType;
+  node.cornerRadius = 20;
+  return node;
+}
+
+/**
+ * Renders the layer into a 100x100 RGBA bitmap at a scale of 1.
+ */
+- (NSData *)pixelsOfLayer:(CALayer *)layer
+{
+  NSMutableData *pixels = [NSMutableData dataWithLength:100 * 100 * 4];
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context = CGBitmapContextCreate(pixels.mutableBytes, 100, 100, 8, 100 * 4, colorSpace, kCGImageAlphaPremultipliedLast);
+  CGColorSpaceRelease(colorSpace);
+  CGContextTranslateCTM(context, 0, 100);
+  CGContextScaleCTM(context, 1, -1);
+  [layer renderInContext:context];
+  CGContextRelease(context);
+  return pixels;
+}
+
+- (NSData *)pixelsOfDisplayedNode:(ASDisplayNode *)node
+{
+  node.contentsScaleForDisplay = 1;
+  [node.layer setNeedsDisplay];
+  [node.layer displayIfNeeded];
+  return [self pixelsOfLayer:node.layer];
+}
+
+- (const uint8_t *)pixelAtX:(NSUInteger)x y:(NSUInteger)y inPixels:(NSData *)pixels
+{
+  return (const uint8_t *)pixels.bytes + (y * 100 + x) * 4;
+}
+
+- (void)testThatPrecompositedCornersAreDrawnIntoTheContents
+{
+  ASDisplayNode *node = [self drawingNodeWithCornerRoundingType:ASCornerRoundingTypePrecomposited];
+  NSData *pixels = [self pixelsOfDisplayedNode:node];
+
+  XCTAssertEqual(node.cornerRadius, 20);
+  XCTAssertEqual(node.layer.cornerRadius, 0);
+  XCTAssertFalse(node.layer.masksToBounds);
+  XCTAssertEqual([self pixelAtX:1 y:1 inPixels:pixels][3], 0);
+  XCTAssertEqual([self pixelAtX:98 y:98 inPixels:pixels][3], 0);
+  XCTAssertEqual([self pixelAtX:50 y:50 inPixels:pixels][0], 255);
+  XCTAssertEqual([self pixelAtX:50 y:50 inPixels:pixels][3], 255);
+}
+
+- (void)testThatPrecompositedBackgroundsAndBordersAreDrawnIntoTheContents
+{
+  ASDisplayNode *node = [self drawingNodeWithCornerRoundingType:ASCornerRoundingTypePrecomposited];
+  node.backgroundColor = [UIColor greenColor];
+  node.borderWidth = 4;
+  node.borderColor = [UIColor blueColor].CGColor;
+  NSData *pixels = [self pixelsOfDisplayedNode:node];
+
+  XCTAssertEqualObjects(node.backgroundColor, [UIColor greenColor]);
+  XCTAssertEqual(node.borderWidth, 4);
+  XCTAssertTrue(node.layer.backgroundColor == NULL);
+  XCTAssertEqual(node.layer.borderWidth, 0);
+  // The border is stroked inside the rounded bounds, on top of the contents.
+  const uint8_t *borderPixel = [self pixelAtX:50 y:1 inPixels:pixels];
+  XCTAssertEqual(borderPixel[0], 0);
+  XCTAssertEqual(borderPixel[2], 255);
+  XCTAssertEqual([self pixelAtX:1 y:1 inPixels:pixels][3], 0);
+}
+
+- (void)testThatPrecompositedCornersMatchLayerCorners
+{
+  ASDisplayNode *node = [self drawingNodeWithCornerRoundingType:ASCornerRoundingTypePrecomposited];
+  NSData *precomposited = [self pixelsOfDisplayedNode:node];
+
+  ASDisplayNode *layerNode = [self drawingNodeWithCornerRoundingType:ASCornerRoundingTypeDefaultSlowCALayer];
+  layerNode.clipsToBounds = YES;
+  NSData *masked = [self pixelsOfDisplayedNode:layerNode];
+  XCTAssertEqual(layerNode.layer.cornerRadius, 20);
+
+  // Antialiasing along the curves may differ slightly.
+  NSUInteger differentPixelCount = 0;
+  for (NSUInteger i = 0; i < precomposited.length; i += 4) {
+    if (abs([self pixelAtX:(i / 4) % 100 y:i / 400 inPixels:precomposited][3] - [self pixelAtX:(i / 4) % 100 y:i / 400 inPixels:masked][3]) > 32) {
+      differentPixelCount++;
+    }
+  }
+  XCTAssertLessThan(differentPixelCount, 100u);
+}
+
+- (void)testThatSwitchingBackRestoresLayerProperties
+{
+  ASDisplayNode *node = [self drawingNodeWithCornerRoundingType:ASCornerRoundingTypePrecomposited];
+  node.backgroundColor = [UIColor greenColor];
+  [node layer];
+  node.cornerRoundingType = ASCornerRoundingTypeDefaultSlowCALayer;
+  XCTAssertEqual(node.layer.cornerRadius, 20);
+  XCTAssertTrue(CGColorEqualToColor(node.layer.backgroundColor, [UIColor greenColor].CGColor));
+}
+
+- (void)testThatNodesThatDontDrawUseTheLayerWhenPrecompositing
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.cornerRoundingType = ASCornerRoundingTypePrecomposited;
+  node.cornerRadius = 20;
+  XCTAssertEqual(node.layer.cornerRadius, 20);
+}
+
+- (void)testThatClippingCoversTheCorners
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.frame = CGRectMake(0, 0, 100, 60);
+  node.cornerRoundingType = ASCornerRoundingTypeClipping;
+  node.cornerRadius = 40;
+  node.clipCornerColor = [UIColor whiteColor];
+  ASDisplayNode *subnode = [[ASDisplayNode alloc] init];
+  [node addSubnode:subnode];
+  [node.layer layoutIfNeeded];
+
+  XCTAssertEqual(node.layer.cornerRadius, 0);
+  NSArray<CALayer *> *cornerLayers = [node.layer.sublayers filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(CALayer *layer, NSDictionary *bindings) {
+    return layer != subnode.layer;
+  }]];
+  XCTAssertEqual(cornerLayers.count, 4);
+  for (CALayer *cornerLayer in cornerLayers) {
+    // The radius is limited to half of the height.
+    XCTAssertTrue(CGSizeEqualToSize(cornerLayer.frame.size, CGSizeMake(30, 30)));
+    XCTAssertGreaterThan(cornerLayer.zPosition, subnode.layer.zPosition);
+  }
+  XCTAssertTrue(CGPointEqualToPoint(cornerLayers[3].frame.origin, CGPointMake(70, 30)));
+
+  node.clipCornerColor = nil;
+  XCTAssertEqualObjects(node.layer.sublayers, @[ subnode.layer ]);
+}
+
+#pragma mark - Benchmarks
+
+/**
+ * Renders 50 rounded nodes the way the compositor would, including the display pass when precompositing.
+ */
+- (void)measureRenderingWithCornerRoundingType:(ASCornerRoundingType)cornerRoundingType
+{
+  NSMutableArray<ASDisplayNode *> *nodes = [NSMutableArray array];
+  for (NSInteger i = 0; i < 50; i++) {
+    ASDisplayNode *node = [self drawingNodeWithCornerRoundingType:cornerRoundingType];
+    node.clipsToBounds = (cornerRoundingType == ASCornerRoundingTypeDefaultSlowCALayer);
+    [nodes addObject:node];
+  }
+  [self measureBlock:^{
+    for (ASDisplayNode *node in nodes) {
+      [self pixelsOfDisplayedNode:node];
+    }
+  }];
+}
+
+- (void)testPerformanceOfLayerCorners
+{
+  [self measureRenderingWithCornerRoundingType:ASCornerRoundingTypeDefaultSlowCALayer];
+}
+
+- (void)testPerformanceOfPrecompositedCorners
+{
+  [self measureRenderingWithCornerRoundingType:ASCornerRoundingTypePrecomposited];
+}
+
+@end
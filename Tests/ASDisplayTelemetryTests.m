@@ -0,0 +1,166 @@
+//
+//  ASDisplayTelemetryTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+#import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
+
+@interface ASTelemetryTestNode : ASDisplayNode
+@end
+
+@implementation ASTelemetryTestNode
+
++ (void)drawRect:(CGRect)bounds withParameters:(id)parameters isCancelled:(asdisplaynode_iscancelled_block_t)isCancelledBlock isRasterizing:(BOOL)isRasterizing
+{
+  [[UIColor redColor] setFill];
+  UIRectFill(bounds);
+}
+
+@end
+
+@interface ASTelemetryOtherTestNode : ASDisplayNode
+@end
+
+@implementation ASTelemetryOtherTestNode
+@end
+
+@interface ASDisplayTelemetryTests : XCTestCase
+@end
+
+@implementation ASDisplayTelemetryTests
+
+- (void)setUp
+{
+  [super setUp];
+  ASDisplayTelemetry.enabled = YES;
+  [ASDisplayTelemetry reset];
+}
+
+- (void)tearDown
+{
+  ASDisplayTelemetry.enabled = YES;
+  [super tearDown];
+}
+
+- (ASDisplayTelemetryRecord *)recordForClass:(Class)nodeClass inSnapshot:(NSArray<ASDisplayTelemetryRecord *> *)snapshot
+{
+  for (ASDisplayTelemetryRecord *record in snapshot) {
+    if (record.nodeClass == nodeClass) {
+      return record;
+    }
+  }
+  return nil;
+}
+
+- (void)testThatDurationsAreBucketed
+{
+  Class nodeClass = [ASTelemetryTestNode class];
+  ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, 0.0000005);
+  ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, 0.0015);
+  ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, 0.0016);
+  ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, 0.010);
+
+  ASDisplayTelemetryHistogram *histogram = [[self recordForClass:nodeClass inSnapshot:[ASDisplayTelemetry snapshot]] histogramForMetric:ASDisplayTelemetryMetricDrawTime];
+  XCTAssertEqual(histogram.count, 4);
+  XCTAssertEqualWithAccuracy(histogram.totalDuration, 0.0131005, 0.000001);
+  XCTAssertEqualWithAccuracy(histogram.maximumDuration, 0.010, 0.000001);
+  XCTAssertEqualObjects(histogram.bucketCounts[0], @1);
+  // 1500µs and 1600µs are both under 2048µs.
+  XCTAssertEqualObjects(histogram.bucketCounts[11], @2);
+  XCTAssertEqualObjects(histogram.bucketCounts[14], @1);
+  XCTAssertEqualWithAccuracy([histogram durationAtPercentile:50], 0.002048, 0.000001);
+  XCTAssertEqualWithAccuracy([histogram durationAtPercentile:100], 0.010, 0.000001, @"The maximum bounds the last bucket");
+  XCTAssertEqual([[self recordForClass:nodeClass inSnapshot:[ASDisplayTelemetry snapshot]] histogramForMetric:ASDisplayTelemetryMetricLayoutTime].count, 0);
+}
+
+- (void)testThatSnapshotsAreSortedByDrawTime
+{
+  ASDisplayTelemetryRecordDuration([ASTelemetryOtherTestNode class], ASDisplayTelemetryMetricDrawTime, 0.001);
+  ASDisplayTelemetryRecordDuration([ASTelemetryTestNode class], ASDisplayTelemetryMetricDrawTime, 0.002);
+  NSArray<ASDisplayTelemetryRecord *> *snapshot = [ASDisplayTelemetry snapshot];
+  XCTAssertEqual(snapshot.count, 2);
+  XCTAssertEqual(snapshot[0].nodeClass, [ASTelemetryTestNode class]);
+  XCTAssertEqual(snapshot[1].nodeClass, [ASTelemetryOtherTestNode class]);
+}
+
+- (void)testThatResettingClearsTheCounters
+{
+  ASDisplayTelemetryRecordDisplay([ASTelemetryTestNode class], YES);
+  ASDisplayTelemetryRecordDisplay([ASTelemetryTestNode class], NO);
+  ASDisplayTelemetryRecordDisplay([ASTelemetryTestNode class], NO);
+  ASDisplayTelemetryRecordDisplay([ASTelemetryTestNode class], NO);
+
+  ASDisplayTelemetryRecord *record = [self recordForClass:[ASTelemetryTestNode class] inSnapshot:[ASDisplayTelemetry snapshotAndReset]];
+  XCTAssertEqual(record.completedDisplayCount, 3);
+  XCTAssertEqual(record.cancelledDisplayCount, 1);
+  XCTAssertEqualWithAccuracy(record.cancellationRate, 0.25, DBL_EPSILON);
+  XCTAssertEqual([ASDisplayTelemetry snapshot].count, 0);
+}
+
+- (void)testThatSamplesFromAllThreadsAreSummed
+{
+  Class nodeClass = [ASTelemetryTestNode class];
+  dispatch_apply(8, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+    for (NSInteger j = 0; j < 1000; j++) {
+      ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricQueueWaitTime, 0.001);
+    }
+  });
+
+  // Threads that exit hand their samples over.
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  [NSThread detachNewThreadWithBlock:^{
+    ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricQueueWaitTime, 0.001);
+    dispatch_semaphore_signal(semaphore);
+  }];
+  dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+
+  ASDisplayTelemetryRecord *record = [self recordForClass:nodeClass inSnapshot:[ASDisplayTelemetry snapshot]];
+  XCTAssertEqual([record histogramForMetric:ASDisplayTelemetryMetricQueueWaitTime].count, 8001);
+}
+
+- (void)testThatNodesRecordDrawAndLayoutTimes
+{
+  ASTelemetryTestNode *node = [[ASTelemetryTestNode alloc] init];
+  node.displaysAsynchronously = NO;
+  node.style.preferredSize = CGSizeMake(50, 50);
+  ASLayout *layout = [node layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(100, 100))];
+  node.frame = CGRectMake(0, 0, layout.size.width, layout.size.height);
+  [node.layer setNeedsDisplay];
+  [node.layer displayIfNeeded];
+
+  ASDisplayTelemetryRecord *record = [self recordForClass:[ASTelemetryTestNode class] inSnapshot:[ASDisplayTelemetry snapshot]];
+  XCTAssertGreaterThanOrEqual([record histogramForMetric:ASDisplayTelemetryMetricLayoutTime].count, 1);
+  XCTAssertEqual([record histogramForMetric:ASDisplayTelemetryMetricDrawTime].count, 1);
+  XCTAssertEqual([record histogramForMetric:ASDisplayTelemetryMetricQueueWaitTime].count, 0, @"Synchronous displays don't wait");
+  XCTAssertEqual(record.completedDisplayCount, 1);
+}
+
+- (void)testThatNothingIsRecordedWhenDisabled
+{
+  ASDisplayTelemetry.enabled = NO;
+  ASDisplayTelemetryRecordDuration([ASTelemetryTestNode class], ASDisplayTelemetryMetricDrawTime, 0.001);
+  ASDisplayTelemetryRecordDisplay([ASTelemetryTestNode class], NO);
+  XCTAssertEqual([ASDisplayTelemetry snapshot].count, 0);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceOfRecording
+{
+  Class nodeClass = [ASTelemetryTestNode class];
+  [self measureBlock:^{
+    for (NSInteger i = 0; i < 100000; i++) {
+      ASDisplayTelemetryRecordDuration(nodeClass, ASDisplayTelemetryMetricDrawTime, 0.001);
+    }
+  }];
+}
+
+@end
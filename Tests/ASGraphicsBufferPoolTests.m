@@ -0,0 +1,183 @@
+//
+//  ASGraphicsBufferPoolTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASGraphicsBufferPool.h>
+
+@interface ASGraphicsBufferPoolTests : XCTestCase
+@end
+
+@implementation ASGraphicsBufferPoolTests
+
+- (void)setUp
+{
+  [super setUp];
+  ASGraphicsBufferPool.enabled = YES;
+  [[ASGraphicsBufferPool sharedPool] removeAllBuffers];
+  [[ASGraphicsBufferPool sharedPool] resetMetrics];
+}
+
+- (void)tearDown
+{
+  ASGraphicsBufferPool.enabled = YES;
+  [ASGraphicsBufferPool sharedPool].byteLimit = 16 * 1024 * 1024;
+  [super tearDown];
+}
+
+/**
+ * Returns the red and alpha components of the pixel at the given point of the image's bitmap.
+ */
+- (void)getRed:(uint8_t *)red alpha:(uint8_t *)alpha ofPixelAtX:(size_t)x y:(size_t)y inImage:(UIImage *)image
+{
+  CGImageRef imageRef = image.CGImage;
+  size_t width = CGImageGetWidth(imageRef), height = CGImageGetHeight(imageRef);
+  uint8_t pixels[width * height * 4];
+  CGColorSpaceRef colorSpace = CGColorSpaceCreateDeviceRGB();
+  CGContextRef context = CGBitmapContextCreate(pixels, width, height, 8, width * 4, colorSpace, kCGImageAlphaPremultipliedLast);
+  CGColorSpaceRelease(colorSpace);
+  CGContextClearRect(context, CGRectMake(0, 0, width, height));
+  CGContextDrawImage(context, CGRectMake(0, 0, width, height), imageRef);
+  CGContextRelease(context);
+  uint8_t *pixel = pixels + (y * width + x) * 4;
+  *red = pixel[0];
+  *alpha = pixel[3];
+}
+
+- (UIImage *)imageBySplittingSize:(CGSize)size scale:(CGFloat)scale
+{
+  ASGraphicsBeginImageContextWithOptions(size, NO, scale);
+  [[UIColor redColor] setFill];
+  UIRectFill(CGRectMake(0, 0, size.width, size.height / 2));
+  return ASGraphicsGetImageAndEndCurrentContext();
+}
+
+- (void)testThatImagesMatchWhatWasDrawn
+{
+  UIImage *image = [self imageBySplittingSize:CGSizeMake(10, 20) scale:2];
+  XCTAssertEqual(image.scale, 2);
+  XCTAssertTrue(CGSizeEqualToSize(image.size, CGSizeMake(10, 20)));
+
+  // The top half is red, the bottom half is clear.
+  uint8_t red, alpha;
+  [self getRed:&red alpha:&alpha ofPixelAtX:5 y:2 inImage:image];
+  XCTAssertEqual(red, 255);
+  XCTAssertEqual(alpha, 255);
+  [self getRed:&red alpha:&alpha ofPixelAtX:5 y:37 inImage:image];
+  XCTAssertEqual(alpha, 0);
+}
+
+- (void)testThatBuffersAreReusedOnceImagesAreReleased
+{
+  ASGraphicsBufferPool *pool = [ASGraphicsBufferPool sharedPool];
+  @autoreleasepool {
+    UIImage *image = [self imageBySplittingSize:CGSizeMake(100, 100) scale:1];
+    XCTAssertNotNil(image);
+    XCTAssertEqual(pool.metrics.pooledByteCount, 0);
+  }
+  XCTAssertEqual(pool.metrics.allocatedBufferCount, 1);
+  XCTAssertGreaterThan(pool.metrics.pooledByteCount, 0);
+
+  // A slightly smaller bitmap falls in the same size class, and its buffer is cleared before drawing.
+  ASGraphicsBeginImageContextWithOptions(CGSizeMake(100, 99), NO, 1);
+  UIImage *image = ASGraphicsGetImageAndEndCurrentContext();
+  XCTAssertEqual(pool.metrics.reusedBufferCount, 1);
+  XCTAssertEqual(pool.metrics.allocatedBufferCount, 1);
+  uint8_t red, alpha;
+  [self getRed:&red alpha:&alpha ofPixelAtX:50 y:10 inImage:image];
+  XCTAssertEqual(alpha, 0);
+}
+
+- (void)testThatEndingAContextReturnsItsBuffer
+{
+  ASGraphicsBufferPool *pool = [ASGraphicsBufferPool sharedPool];
+  ASGraphicsBeginImageContextWithOptions(CGSizeMake(50, 50), YES, 1);
+  XCTAssertTrue(UIGraphicsGetCurrentContext() != NULL);
+  ASGraphicsEndImageContext();
+  XCTAssertTrue(UIGraphicsGetCurrentContext() == NULL);
+  XCTAssertGreaterThan(pool.metrics.pooledByteCount, 0);
+}
+
+- (void)testThatContextsNest
+{
+  ASGraphicsBeginImageContextWithOptions(CGSizeMake(10, 10), NO, 1);
+  CGContextRef outerContext = UIGraphicsGetCurrentContext();
+  UIImage *innerImage = [self imageBySplittingSize:CGSizeMake(20, 20) scale:1];
+  XCTAssertTrue(UIGraphicsGetCurrentContext() == outerContext);
+  UIImage *outerImage = ASGraphicsGetImageAndEndCurrentContext();
+  XCTAssertTrue(CGSizeEqualToSize(innerImage.size, CGSizeMake(20, 20)));
+  XCTAssertTrue(CGSizeEqualToSize(outerImage.size, CGSizeMake(10, 10)));
+}
+
+- (void)testThatBuffersOverTheByteLimitAreFreed
+{
+  ASGraphicsBufferPool *pool = [ASGraphicsBufferPool sharedPool];
+  pool.byteLimit = 0;
+  @autoreleasepool {
+    XCTAssertNotNil([self imageBySplittingSize:CGSizeMake(100, 100) scale:1]);
+  }
+  XCTAssertEqual(pool.metrics.pooledByteCount, 0);
+  XCTAssertEqual(pool.metrics.discardedBufferCount, 1);
+}
+
+- (void)testThatThePoolIsEmptiedOnMemoryWarnings
+{
+  ASGraphicsBufferPool *pool = [ASGraphicsBufferPool sharedPool];
+  @autoreleasepool {
+    XCTAssertNotNil([self imageBySplittingSize:CGSizeMake(100, 100) scale:1]);
+  }
+  XCTAssertGreaterThan(pool.metrics.pooledByteCount, 0);
+  [[NSNotificationCenter defaultCenter] postNotificationName:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+  XCTAssertEqual(pool.metrics.pooledByteCount, 0);
+}
+
+- (void)testThatDisablingThePoolFallsBackToUIKit
+{
+  ASGraphicsBufferPool.enabled = NO;
+  UIImage *image = [self imageBySplittingSize:CGSizeMake(10, 20) scale:2];
+  XCTAssertTrue(CGSizeEqualToSize(image.size, CGSizeMake(10, 20)));
+  XCTAssertEqual([ASGraphicsBufferPool sharedPool].metrics.allocatedBufferCount, 0);
+}
+
+#pragma mark - Benchmarks
+
+/**
+ * Draws a 400x800 bitmap the way display blocks do, repeatedly, releasing each image before drawing the next.
+ */
+- (void)measureDrawingWithPoolEnabled:(BOOL)enabled
+{
+  ASGraphicsBufferPool.enabled = enabled;
+  [self measureBlock:^{
+    for (NSInteger i = 0; i < 50; i++) {
+      @autoreleasepool {
+        ASGraphicsBeginImageContextWithOptions(CGSizeMake(400, 800), NO, 1);
+        [[UIColor redColor] setFill];
+        UIRectFill(CGRectMake(0, 0, 40, 40));
+        UIImage *image = ASGraphicsGetImageAndEndCurrentContext();
+        // Make sure the pixels are materialized, as they are when a layer shows the image.
+        CFRelease(CGDataProviderCopyData(CGImageGetDataProvider(image.CGImage)));
+      }
+    }
+  }];
+  ASGraphicsBufferPoolMetrics metrics = [ASGraphicsBufferPool sharedPool].metrics;
+  NSLog(@"%@: allocated %tu buffers (%llu bytes), reused %tu (%llu bytes)", self.name, metrics.allocatedBufferCount, metrics.allocatedByteCount, metrics.reusedBufferCount, metrics.reusedByteCount);
+}
+
+- (void)testPerformanceOfDrawingWithoutThePool
+{
+  [self measureDrawingWithPoolEnabled:NO];
+}
+
+- (void)testPerformanceOfDrawingWithThePool
+{
+  [self measureDrawingWithPoolEnabled:YES];
+}
+
+@end
@@ -0,0 +1,249 @@
+//
+//  ASHierarchyChangeSetTests.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+#import <UIKit/UIKit.h>
+
+#import <AsyncDisplayKit/_ASHierarchyChangeSet.h>
+#import <AsyncDisplayKit/ASIndexRangeSet.h>
+#import <AsyncDisplayKit/NSIndexSet+ASHelpers.h>
+
+static NSUInteger const kBenchmarkItemCount = 20000;
+static NSUInteger const kBenchmarkEditCount = 5000;
+
+/**
+ * Translates reloaded index paths the way the change set did before it used AS::IndexRangeSet, i.e. with an
+ * NSIndexSet per section, for comparison.
+ */
+static NSArray<NSIndexPath *> *ASReferenceTranslateReloads(NSArray<NSIndexPath *> *reloads, NSIndexSet *deletes, NSIndexSet *inserts)
+{
+  NSMutableArray<NSIndexPath *> *result = [NSMutableArray arrayWithCapacity:reloads.count];
+  NSDictionary<NSNumber *, NSIndexSet *> *deletedIndexPathsMap = @{ @0 : deletes };
+  NSDictionary<NSNumber *, NSIndexSet *> *insertedIndexPathsMap = @{ @0 : inserts };
+  for (NSIndexPath *indexPath in reloads) {
+    NSUInteger item = indexPath.item;
+    NSIndexSet *indicesDeletedInSection = deletedIndexPathsMap[@(indexPath.section)];
+    item -= [indicesDeletedInSection countOfIndexesInRange:NSMakeRange(0, item)];
+    NSIndexSet *indicesInsertedInSection = insertedIndexPathsMap[@(indexPath.section)];
+    item += [indicesInsertedInSection as_indexChangeByInsertingItemsBelowIndex:item];
+    [result addObject:[NSIndexPath indexPathForItem:item inSection:indexPath.section]];
+  }
+  return result;
+}
+
+static NSArray<NSIndexPath *> *ASIndexPathsFromChanges(NSArray<_ASHierarchyItemChange *> *changes)
+{
+  NSMutableArray<NSIndexPath *> *result = [NSMutableArray array];
+  for (_ASHierarchyItemChange *change in changes) {
+    [result addObjectsFromArray:change.indexPaths];
+  }
+  return result;
+}
+
+static NSArray<NSIndexPath *> *ASIndexPathsInSection(NSIndexSet *indexes, NSUInteger section)
+{
+  NSMutableArray<NSIndexPath *> *result = [NSMutableArray array];
+  [indexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL * _Nonnull stop) {
+    [result addObject:[NSIndexPath indexPathForItem:idx inSection:section]];
+  }];
+  return result;
+}
+
+/// A quarter of the items deleted, a quarter reloaded, and as many inserted as deleted.
+static void ASMakeBenchmarkEdit(NSMutableIndexSet *deletes, NSMutableIndexSet *inserts, NSMutableIndexSet *reloads)
+{
+  for (NSUInteger i = 0; i < kBenchmarkEditCount; i++) {
+    [deletes addIndex:i * 4];
+    [reloads addIndex:i * 4 + 1];
+    [inserts addIndex:i * 3 + 2];
+  }
+}
+
+@interface ASHierarchyChangeSetTests : XCTestCase
+@end
+
+@implementation ASHierarchyChangeSetTests
+
+- (void)testThatIndexRangeSetMatchesIndexSet
+{
+  srand(1);
+  for (NSUInteger trial = 0; trial < 50; trial++) {
+    AS::IndexRangeSet set;
+    NSMutableIndexSet *reference = [NSMutableIndexSet indexSet];
+    for (NSUInteger i = 0; i < 20; i++) {
+      NSRange range = NSMakeRange(rand() % 200, rand() % 8);
+      set.add(range);
+      [reference addIndexesInRange:range];
+    }
+
+    XCTAssertEqual(set.count(), reference.count);
+    for (NSUInteger index = 0; index < 220; index++) {
+      XCTAssertEqual(set.contains(index), [reference containsIndex:index]);
+      XCTAssertEqual(set.countOfIndexesBelow(index), [reference countOfIndexesInRange:NSMakeRange(0, index)]);
+      XCTAssertEqual(set.indexByInsertingItemsBelowIndex(index), index + [reference as_indexChangeByInsertingItemsBelowIndex:index]);
+    }
+  }
+}
+
+- (void)testThatIndexRangeSetFindsCommonIndexes
+{
+  AS::IndexRangeSet a;
+  a.add(NSMakeRange(0, 3));
+  a.add(NSMakeRange(10, 5));
+  AS::IndexRangeSet b;
+  b.add(NSMakeRange(3, 7));
+  XCTAssertEqual(a.firstIndexInCommonWith(b), NSNotFound);
+  b.add(14);
+  XCTAssertEqual(a.firstIndexInCommonWith(b), 14);
+}
+
+- (void)testThatReloadsAreTranslatedPastDeletesAndInserts
+{
+  _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 10 }];
+  [changeSet deleteItems:@[ [NSIndexPath indexPathForItem:2 inSection:0], [NSIndexPath indexPathForItem:3 inSection:0] ] animationOptions:0];
+  [changeSet insertItems:@[ [NSIndexPath indexPathForItem:0 inSection:0] ] animationOptions:0];
+  [changeSet reloadItems:@[ [NSIndexPath indexPathForItem:5 inSection:0] ] animationOptions:0];
+  [changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ 9 }];
+
+  NSArray *deletes = ASIndexPathsFromChanges([changeSet itemChangesOfType:_ASHierarchyChangeTypeDelete]);
+  NSArray *inserts = ASIndexPathsFromChanges([changeSet itemChangesOfType:_ASHierarchyChangeTypeInsert]);
+  XCTAssertEqualObjects(deletes, (@[ [NSIndexPath indexPathForItem:5 inSection:0], [NSIndexPath indexPathForItem:3 inSection:0], [NSIndexPath indexPathForItem:2 inSection:0] ]));
+  XCTAssertEqualObjects(inserts, (@[ [NSIndexPath indexPathForItem:0 inSection:0], [NSIndexPath indexPathForItem:4 inSection:0] ]));
+}
+
+- (void)testThatReloadTranslationMatchesTheReferenceImplementation
+{
+  NSMutableIndexSet *deletes = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *inserts = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *reloads = [NSMutableIndexSet indexSet];
+  srand(2);
+  for (NSUInteger item = 0; item < 500; item++) {
+    switch (rand() % 4) {
+      case 0: [deletes addIndex:item]; break;
+      case 1: [reloads addIndex:item]; break;
+      default: break;
+    }
+  }
+  while (inserts.count < deletes.count) {
+    [inserts addIndex:rand() % 500];
+  }
+
+  _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 500 }];
+  [changeSet deleteItemsAtIndexes:deletes inSection:0 animationOptions:0];
+  [changeSet insertItemsAtIndexes:inserts inSection:0 animationOptions:0];
+  [changeSet reloadItemsAtIndexes:reloads inSection:0 animationOptions:0];
+  [changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ 500 }];
+
+  NSMutableIndexSet *expectedInserts = [inserts mutableCopy];
+  for (NSIndexPath *indexPath in ASReferenceTranslateReloads(ASIndexPathsInSection(reloads, 0), deletes, inserts)) {
+    [expectedInserts addIndex:indexPath.item];
+  }
+  NSArray *actualInserts = ASIndexPathsFromChanges([changeSet itemChangesOfType:_ASHierarchyChangeTypeInsert]);
+  XCTAssertEqualObjects(actualInserts, ASIndexPathsInSection(expectedInserts, 0));
+}
+
+- (void)testThatBulkChangesMatchIndexPathChanges
+{
+  NSIndexSet *deletes = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(10, 20)];
+  NSIndexSet *inserts = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 20)];
+  NSIndexSet *reloads = [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(40, 5)];
+
+  _ASHierarchyChangeSet *bulk = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 50, 50 }];
+  [bulk deleteItemsAtIndexes:deletes inSection:1 animationOptions:0];
+  [bulk insertItemsAtIndexes:inserts inSection:1 animationOptions:0];
+  [bulk reloadItemsAtIndexes:reloads inSection:1 animationOptions:0];
+  [bulk markCompletedWithNewItemCounts:std::vector<NSInteger>{ 50, 50 }];
+
+  _ASHierarchyChangeSet *indexPaths = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 50, 50 }];
+  [indexPaths deleteItems:ASIndexPathsInSection(deletes, 1) animationOptions:0];
+  [indexPaths insertItems:ASIndexPathsInSection(inserts, 1) animationOptions:0];
+  [indexPaths reloadItems:ASIndexPathsInSection(reloads, 1) animationOptions:0];
+  [indexPaths markCompletedWithNewItemCounts:std::vector<NSInteger>{ 50, 50 }];
+
+  for (_ASHierarchyChangeType type : { _ASHierarchyChangeTypeDelete, _ASHierarchyChangeTypeInsert }) {
+    XCTAssertEqualObjects(ASIndexPathsFromChanges([bulk itemChangesOfType:type]), ASIndexPathsFromChanges([indexPaths itemChangesOfType:type]));
+  }
+}
+
+- (void)testThatChangesAreGroupedByAnimationOptions
+{
+  _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 0 }];
+  [changeSet insertItemsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(5, 5)] inSection:0 animationOptions:2];
+  [changeSet insertItemsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 5)] inSection:0 animationOptions:1];
+  [changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ 10 }];
+
+  NSArray<_ASHierarchyItemChange *> *changes = [changeSet itemChangesOfType:_ASHierarchyChangeTypeInsert];
+  XCTAssertEqual(changes.count, 2);
+  XCTAssertEqual(changes[0].animationOptions, 1);
+  XCTAssertEqualObjects(changes[0].indexPaths.firstObject, [NSIndexPath indexPathForItem:0 inSection:0]);
+  XCTAssertEqual(changes[1].animationOptions, 2);
+  XCTAssertEqualObjects(changes[1].indexPaths.firstObject, [NSIndexPath indexPathForItem:5 inSection:0]);
+}
+
+- (void)testThatDeletingAReloadedItemFailsValidation
+{
+  _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ 10 }];
+  [changeSet deleteItemsAtIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(2, 3)] inSection:0 animationOptions:0];
+  [changeSet reloadItemsAtIndexes:[NSIndexSet indexSetWithIndex:4] inSection:0 animationOptions:0];
+  XCTAssertThrows([changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ 7 }]);
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceOfLargeBatchUpdate
+{
+  NSMutableIndexSet *deletes = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *inserts = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *reloads = [NSMutableIndexSet indexSet];
+  ASMakeBenchmarkEdit(deletes, inserts, reloads);
+  NSArray *deletedIndexPaths = ASIndexPathsInSection(deletes, 0);
+  NSArray *insertedIndexPaths = ASIndexPathsInSection(inserts, 0);
+  NSArray *reloadedIndexPaths = ASIndexPathsInSection(reloads, 0);
+
+  [self measureBlock:^{
+    _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ (NSInteger)kBenchmarkItemCount }];
+    [changeSet deleteItems:deletedIndexPaths animationOptions:0];
+    [changeSet insertItems:insertedIndexPaths animationOptions:0];
+    [changeSet reloadItems:reloadedIndexPaths animationOptions:0];
+    [changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ (NSInteger)kBenchmarkItemCount }];
+  }];
+}
+
+- (void)testPerformanceOfLargeBulkBatchUpdate
+{
+  NSMutableIndexSet *deletes = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *inserts = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *reloads = [NSMutableIndexSet indexSet];
+  ASMakeBenchmarkEdit(deletes, inserts, reloads);
+
+  [self measureBlock:^{
+    _ASHierarchyChangeSet *changeSet = [[_ASHierarchyChangeSet alloc] initWithOldData:std::vector<NSInteger>{ (NSInteger)kBenchmarkItemCount }];
+    [changeSet deleteItemsAtIndexes:deletes inSection:0 animationOptions:0];
+    [changeSet insertItemsAtIndexes:inserts inSection:0 animationOptions:0];
+    [changeSet reloadItemsAtIndexes:reloads inSection:0 animationOptions:0];
+    [changeSet markCompletedWithNewItemCounts:std::vector<NSInteger>{ (NSInteger)kBenchmarkItemCount }];
+  }];
+}
+
+/// The reload translation the change set used before, on the same edit, as a baseline for the benchmarks above.
+- (void)testPerformanceOfReferenceReloadTranslation
+{
+  NSMutableIndexSet *deletes = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *inserts = [NSMutableIndexSet indexSet];
+  NSMutableIndexSet *reloads = [NSMutableIndexSet indexSet];
+  ASMakeBenchmarkEdit(deletes, inserts, reloads);
+  NSArray *reloadedIndexPaths = ASIndexPathsInSection(reloads, 0);
+
+  [self measureBlock:^{
+    ASReferenceTranslateReloads(reloadedIndexPaths, deletes, inserts);
+  }];
+}
+
+@end
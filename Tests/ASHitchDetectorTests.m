@@ -0,0 +1,112 @@
+//
+//  ASHitchDetectorTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASHitchDetector.h>
+#import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
+
+@interface ASHitchTestNode : ASDisplayNode
+@end
+
+@implementation ASHitchTestNode
+
+- (CGSize)calculateSizeThatFits:(CGSize)constrainedSize
+{
+  [NSThread sleepForTimeInterval:0.05];
+  return CGSizeMake(10, 10);
+}
+
+@end
+
+@interface ASHitchDetectorTests : XCTestCase
+@end
+
+@implementation ASHitchDetectorTests
+
+- (void)runMainRunLoopPerformingBlock:(dispatch_block_t)block
+{
+  dispatch_async(dispatch_get_main_queue(), block);
+  [[NSRunLoop mainRunLoop] runUntilDate:[NSDate dateWithTimeIntervalSinceNow:0.2]];
+}
+
+- (void)testThatLongIterationsAreReportedWithTheirSpans
+{
+  ASHitchDetector *detector = [[ASHitchDetector alloc] initWithThreshold:0.03];
+  __block NSUInteger handledReportCount = 0;
+  detector.hitchHandler = ^(ASHitchReport *report) {
+    handledReportCount++;
+  };
+  [detector start];
+  [self runMainRunLoopPerformingBlock:^{
+    ASTraceBufferBeginSpan(ASTraceSpanPendingStateFlush, Nil);
+    (void)[[[ASHitchTestNode alloc] init] layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(100, 100))];
+    ASTraceBufferEndSpan(ASTraceSpanPendingStateFlush, Nil);
+  }];
+  [detector stop];
+
+  XCTAssertEqual(detector.reports.count, 1, @"%@", detector.reports);
+  XCTAssertEqual(handledReportCount, 1);
+  ASHitchReport *report = detector.reports.firstObject;
+  XCTAssertGreaterThanOrEqual(report.duration, 0.05);
+  XCTAssertLessThan(report.unattributedDuration, report.duration);
+
+  ASHitchSpan *flushSpan = report.spans.firstObject;
+  XCTAssertEqual(flushSpan.kind, ASTraceSpanPendingStateFlush);
+  XCTAssertEqualObjects(flushSpan.name, @"pendingStateFlush");
+  XCTAssertEqual(flushSpan.depth, 0);
+  XCTAssertGreaterThanOrEqual(flushSpan.duration, 0.05);
+
+  NSUInteger layoutSpanIndex = [report.spans indexOfObjectPassingTest:^BOOL(ASHitchSpan *span, NSUInteger idx, BOOL *stop) {
+    return span.kind == ASTraceSpanLayout && span.spanClass == [ASHitchTestNode class];
+  }];
+  XCTAssertNotEqual(layoutSpanIndex, NSNotFound);
+  XCTAssertEqual(report.spans[layoutSpanIndex].depth, 1);
+  XCTAssertEqualObjects(report.spans[layoutSpanIndex].name, @"ASHitchTestNode");
+  XCTAssertGreaterThanOrEqual(report.spans[layoutSpanIndex].startOffset, flushSpan.startOffset);
+
+  XCTAssertTrue([NSJSONSerialization isValidJSONObject:[report dictionaryRepresentation]]);
+}
+
+- (void)testThatShortIterationsAreNotReported
+{
+  ASHitchDetector *detector = [[ASHitchDetector alloc] initWithThreshold:0.15];
+  [detector start];
+  [self runMainRunLoopPerformingBlock:^{
+    ASTraceBufferBeginSpan(ASTraceSpanPendingStateFlush, Nil);
+    ASTraceBufferEndSpan(ASTraceSpanPendingStateFlush, Nil);
+  }];
+  [detector stop];
+  XCTAssertEqualObjects(detector.reports, @[]);
+}
+
+- (void)testThatRunningDetectorsRecordSpans
+{
+  ASTraceBuffer.enabled = NO;
+  ASHitchDetector *detector = [[ASHitchDetector alloc] initWithThreshold:0.03];
+  [detector start];
+  XCTAssertTrue(ASTraceBufferIsEnabled());
+  XCTAssertFalse(ASTraceBuffer.enabled);
+  [detector stop];
+  XCTAssertFalse(ASTraceBufferIsEnabled());
+}
+
+- (void)testThatStoppedDetectorsDontReport
+{
+  ASHitchDetector *detector = [[ASHitchDetector alloc] initWithThreshold:0.03];
+  [detector start];
+  [detector stop];
+  [self runMainRunLoopPerformingBlock:^{
+    [NSThread sleepForTimeInterval:0.05];
+  }];
+  XCTAssertEqualObjects(detector.reports, @[]);
+}
+
+@end
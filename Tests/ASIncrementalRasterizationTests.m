@@ -0,0 +1,184 @@
+//
+//  ASIncrementalRasterizationTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASDisplayNode+Beta.h>
+#import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
+#import <AsyncDisplayKit/ASTextNode.h>
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wdeprecated-declarations"
+
+@interface ASRasterizationTestNode : ASDisplayNode
+@property (atomic, strong) UIColor *color;
+@property (atomic, assign) NSUInteger drawCount;
+@end
+
+@implementation ASRasterizationTestNode
+
+- (id<NSObject>)drawParametersForAsyncLayer:(_ASDisplayLayer *)layer
+{
+  return self;
+}
+
++ (void)drawRect:(CGRect)bounds withParameters:(ASRasterizationTestNode *)node isCancelled:(asdisplaynode_iscancelled_block_t)isCancelledBlock isRasterizing:(BOOL)isRasterizing
+{
+  node.drawCount++;
+  [node.color setFill];
+  UIRectFill(CGRectInset(bounds, 5, 5));
+}
+
+@end
+
+@interface ASIncrementalRasterizationTests : XCTestCase
+@end
+
+@implementation ASIncrementalRasterizationTests
+
+/**
+ * Returns a 100x100 container rasterizing four nodes laid out in a grid.
+ */
+- (ASDisplayNode *)containerRasterizingIncrementally:(BOOL)incremental
+{
+  ASDisplayNode *container = [[ASDisplayNode alloc] init];
+  container.shouldRasterizeDescendants = YES;
+  container.rasterizesDescendantsIncrementally = incremental;
+  container.displaysAsynchronously = NO;
+  container.backgroundColor = [UIColor whiteColor];
+  container.frame = CGRectMake(0, 0, 100, 100);
+  NSArray<UIColor *> *colors = @[ [UIColor redColor], [UIColor greenColor], [UIColor blueColor], [UIColor yellowColor] ];
+  for (NSUInteger i = 0; i < colors.count; i++) {
+    ASRasterizationTestNode *node = [[ASRasterizationTestNode alloc] init];
+    node.color = colors[i];
+    node.frame = CGRectMake((i % 2) * 50, (i / 2) * 50, 50, 50);
+    [container addSubnode:node];
+  }
+  return container;
+}
+
+- (NSData *)displayContainer:(ASDisplayNode *)container
+{
+  [container.layer setNeedsDisplay];
+  [container.layer displayIfNeeded];
+  CGImageRef image = (__bridge CGImageRef)container.layer.contents;
+  XCTAssertTrue(image != NULL);
+  return CFBridgingRelease(CGDataProviderCopyData(CGImageGetDataProvider(image)));
+}
+
+- (NSArray<NSNumber *> *)drawCountsOfContainer:(ASDisplayNode *)container
+{
+  return [container.subnodes valueForKey:@"drawCount"];
+}
+
+- (void)testThatOnlyChangedNodesAreRedrawn
+{
+  ASDisplayNode *container = [self containerRasterizingIncrementally:YES];
+  [self displayContainer:container];
+  XCTAssertEqualObjects([self drawCountsOfContainer:container], (@[ @1, @1, @1, @1 ]));
+
+  ASRasterizationTestNode *node = (ASRasterizationTestNode *)container.subnodes[1];
+  node.color = [UIColor blackColor];
+  [node setNeedsDisplay];
+  [self displayContainer:container];
+  XCTAssertEqualObjects([self drawCountsOfContainer:container], (@[ @1, @2, @1, @1 ]));
+}
+
+- (void)testThatIncrementalUpdatesMatchFullRasterization
+{
+  ASDisplayNode *container = [self containerRasterizingIncrementally:YES];
+  [self displayContainer:container];
+  ASRasterizationTestNode *node = (ASRasterizationTestNode *)container.subnodes[2];
+  node.color = [UIColor blackColor];
+  [node setNeedsDisplay];
+  NSData *incrementalContents = [self displayContainer:container];
+
+  ASDisplayNode *referenceContainer = [self containerRasterizingIncrementally:NO];
+  ((ASRasterizationTestNode *)referenceContainer.subnodes[2]).color = [UIColor blackColor];
+  XCTAssertEqualObjects(incrementalContents, [self displayContainer:referenceContainer]);
+}
+
+- (void)testThatLayoutChangesRedrawTheContainerReusingTiles
+{
+  ASDisplayNode *container = [self containerRasterizingIncrementally:YES];
+  [self displayContainer:container];
+  ((ASDisplayNode *)container.subnodes[3]).frame = CGRectMake(25, 25, 50, 50);
+  NSData *incrementalContents = [self displayContainer:container];
+  XCTAssertEqualObjects([self drawCountsOfContainer:container], (@[ @1, @1, @1, @1 ]));
+
+  ASDisplayNode *referenceContainer = [self containerRasterizingIncrementally:NO];
+  ((ASDisplayNode *)referenceContainer.subnodes[3]).frame = CGRectMake(25, 25, 50, 50);
+  XCTAssertEqualObjects(incrementalContents, [self displayContainer:referenceContainer]);
+}
+
+- (void)testThatClearingContentsReleasesTiles
+{
+  ASDisplayNode *container = [self containerRasterizingIncrementally:YES];
+  [self displayContainer:container];
+  [container clearContents];
+  [self displayContainer:container];
+  XCTAssertEqualObjects([self drawCountsOfContainer:container], (@[ @2, @2, @2, @2 ]));
+}
+
+- (void)testThatNonIncrementalRasterizationRedrawsEverything
+{
+  ASDisplayNode *container = [self containerRasterizingIncrementally:NO];
+  [self displayContainer:container];
+  [container.subnodes[0] setNeedsDisplay];
+  [self displayContainer:container];
+  XCTAssertEqualObjects([self drawCountsOfContainer:container], (@[ @2, @2, @2, @2 ]));
+}
+
+#pragma mark - Benchmarks
+
+/**
+ * Updates a counter in a cell-like container rasterizing 30 text nodes, redrawing the container after each update.
+ */
+- (void)measureCounterUpdatesRasterizingIncrementally:(BOOL)incremental
+{
+  ASDisplayNode *container = [[ASDisplayNode alloc] init];
+  container.shouldRasterizeDescendants = YES;
+  container.rasterizesDescendantsIncrementally = incremental;
+  container.displaysAsynchronously = NO;
+  container.backgroundColor = [UIColor whiteColor];
+  container.frame = CGRectMake(0, 0, 320, 640);
+  for (NSInteger i = 0; i < 30; i++) {
+    ASTextNode *textNode = [[ASTextNode alloc] init];
+    textNode.attributedText = [[NSAttributedString alloc] initWithString:@"A line of static text in a rasterized cell"];
+    textNode.frame = CGRectMake(0, i * 20, 320, 20);
+    [container addSubnode:textNode];
+  }
+  ASTextNode *counterNode = [[ASTextNode alloc] init];
+  counterNode.frame = CGRectMake(0, 610, 100, 20);
+  [container addSubnode:counterNode];
+  [self displayContainer:container];
+
+  __block NSInteger count = 0;
+  [self measureBlock:^{
+    for (NSInteger i = 0; i < 20; i++) {
+      counterNode.attributedText = [[NSAttributedString alloc] initWithString:[NSString stringWithFormat:@"%zd likes", ++count]];
+      [self displayContainer:container];
+    }
+  }];
+}
+
+- (void)testPerformanceOfCounterUpdatesWithFullRasterization
+{
+  [self measureCounterUpdatesRasterizingIncrementally:NO];
+}
+
+- (void)testPerformanceOfCounterUpdatesWithIncrementalRasterization
+{
+  [self measureCounterUpdatesRasterizingIncrementally:YES];
+}
+
+@end
+
+#pragma clang diagnostic pop
@@ -0,0 +1,100 @@
+//
+//  ASInterfaceStateBatchTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+#import <AsyncDisplayKit/ASInterfaceStateBatch.h>
+
+static ASInterfaceState const kPreloadState = (ASInterfaceState)(ASInterfaceStateMeasureLayout | ASInterfaceStatePreload);
+
+@interface ASInterfaceStateBatchTests : XCTestCase
+@end
+
+@implementation ASInterfaceStateBatchTests
+
+- (ASCellNode *)nodeWithInterfaceState:(ASInterfaceState)interfaceState
+{
+  ASCellNode *node = [[ASCellNode alloc] init];
+  node.hierarchyState |= ASHierarchyStateRangeManaged;
+  [node recursivelySetInterfaceState:interfaceState];
+  return node;
+}
+
+- (void)testThatChangesAreAppliedAtCommit
+{
+  ASInterfaceStateBatch *batch = [[ASInterfaceStateBatch alloc] init];
+  ASCellNode *node = [self nodeWithInterfaceState:ASInterfaceStateMeasureLayout];
+  [batch setInterfaceState:kPreloadState forNode:node];
+  XCTAssertEqual(node.interfaceState, ASInterfaceStateMeasureLayout);
+
+  [batch commitDeferringExits:YES];
+  XCTAssertEqual(node.interfaceState, kPreloadState);
+  XCTAssertEqual(batch.deferredCount, 0);
+}
+
+- (void)testThatLeavingTheVisibleStateIsNotDeferred
+{
+  ASInterfaceStateBatch *batch = [[ASInterfaceStateBatch alloc] init];
+  ASCellNode *node = [self nodeWithInterfaceState:ASInterfaceStateInHierarchy];
+  [batch setInterfaceState:kPreloadState forNode:node];
+  [batch commitDeferringExits:YES];
+  XCTAssertEqual(node.interfaceState, kPreloadState);
+}
+
+- (void)testThatExitsAreDeferredAndAppliedInOrder
+{
+  ASInterfaceStateBatch *batch = [[ASInterfaceStateBatch alloc] init];
+  ASCellNode *first = [self nodeWithInterfaceState:kPreloadState];
+  ASCellNode *second = [self nodeWithInterfaceState:kPreloadState];
+  [batch setInterfaceState:ASInterfaceStateMeasureLayout forNode:first];
+  [batch setInterfaceState:ASInterfaceStateMeasureLayout forNode:second];
+  [batch commitDeferringExits:YES];
+  XCTAssertEqual(first.interfaceState, kPreloadState);
+  XCTAssertEqual(batch.deferredCount, 2);
+
+  // At least one change is applied however small the budget.
+  XCTAssertTrue([batch applyDeferredInterfaceStatesWithTimeBudget:0]);
+  XCTAssertEqual(first.interfaceState, ASInterfaceStateMeasureLayout);
+  XCTAssertEqual(second.interfaceState, kPreloadState);
+
+  XCTAssertFalse([batch applyDeferredInterfaceStatesWithTimeBudget:0]);
+  XCTAssertEqual(second.interfaceState, ASInterfaceStateMeasureLayout);
+  XCTAssertEqual(batch.deferredCount, 0);
+}
+
+- (void)testThatCancelledExitsAreDropped
+{
+  ASInterfaceStateBatch *batch = [[ASInterfaceStateBatch alloc] init];
+  ASCellNode *node = [self nodeWithInterfaceState:kPreloadState];
+  [batch setInterfaceState:ASInterfaceStateMeasureLayout forNode:node];
+  [batch commitDeferringExits:YES];
+  [batch cancelDeferredInterfaceStateForNode:node];
+  [batch flushDeferredInterfaceStates];
+  XCTAssertEqual(node.interfaceState, kPreloadState);
+}
+
+- (void)testThatExitsAreAppliedAtCommitWhenNotDeferring
+{
+  ASInterfaceStateBatch *batch = [[ASInterfaceStateBatch alloc] init];
+  ASCellNode *deferred = [self nodeWithInterfaceState:kPreloadState];
+  ASCellNode *node = [self nodeWithInterfaceState:kPreloadState];
+  [batch setInterfaceState:ASInterfaceStateMeasureLayout forNode:deferred];
+  [batch commitDeferringExits:YES];
+
+  // Changes deferred by earlier commits are applied too.
+  [batch setInterfaceState:ASInterfaceStateMeasureLayout forNode:node];
+  [batch commitDeferringExits:NO];
+  XCTAssertEqual(deferred.interfaceState, ASInterfaceStateMeasureLayout);
+  XCTAssertEqual(node.interfaceState, ASInterfaceStateMeasureLayout);
+}
+
+@end
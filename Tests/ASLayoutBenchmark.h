@@ -0,0 +1,68 @@
+//
+//  ASLayoutBenchmark.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <Foundation/Foundation.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+#import <AsyncDisplayKit/ASDimension.h>
+#import <AsyncDisplayKit/ASLayoutElement.h>
+
+NS_ASSUME_NONNULL_BEGIN
+
+/**
+ * Returns the layout element to lay out in one iteration of a case. Like -layoutSpecThatFits:, it is called for each
+ * layout, so that building the specs is measured with laying them out.
+ */
+typedef id<ASLayoutElement> _Nonnull (^ASLayoutBenchmarkElementBlock)(void);
+
+@interface ASLayoutBenchmarkResult : NSObject
+
+@property (nonatomic, copy, readonly) NSString *name;
+/// The number of children, or the nesting depth, that the case scales with.
+@property (nonatomic, readonly) NSUInteger childCount;
+@property (nonatomic, readonly) NSUInteger iterationCount;
+@property (nonatomic, readonly) double nanosecondsPerLayout;
+/// Heap allocations made on the benchmarking thread per layout.
+@property (nonatomic, readonly) double allocationsPerLayout;
+@property (nonatomic, readonly) CGSize layoutSize;
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+/**
+ * Measures layouts of layout specs synchronously on the calling thread. Nodes are laid out without loading their views
+ * or layers, and nothing waits for the run loop, so the benchmarks need neither a display nor a running main run loop.
+ *
+ * Each case is warmed up, then laid out repeatedly for at least the minimum duration to measure time per layout. Heap
+ * allocations are counted in separate iterations, so that counting them doesn't skew the times.
+ */
+@interface ASLayoutBenchmark : NSObject
+
+/// How long each case is laid out for to measure its time. Defaults to 0.1 seconds.
+@property (nonatomic, assign) NSTimeInterval minimumDuration;
+
+/**
+ * Measures the case and adds its result.
+ */
+- (ASLayoutBenchmarkResult *)addCaseWithName:(NSString *)name
+                                  childCount:(NSUInteger)childCount
+                                   sizeRange:(ASSizeRange)sizeRange
+                                elementBlock:(AS_NOESCAPE ASLayoutBenchmarkElementBlock)elementBlock;
+
+@property (nonatomic, copy, readonly) NSArray<ASLayoutBenchmarkResult *> *results;
+
+/**
+ * The results as JSON, for regression tracking: {"device": ..., "system": ..., "results": [...]}.
+ */
+- (NSData *)JSONData;
+
+@end
+
+NS_ASSUME_NONNULL_END
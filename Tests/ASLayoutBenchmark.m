@@ -0,0 +1,186 @@
+//
+//  ASLayoutBenchmark.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import "ASLayoutBenchmark.h"
+
+#import <UIKit/UIKit.h>
+#import <mach/mach_time.h>
+#import <pthread.h>
+#import <stdatomic.h>
+#import <sys/utsname.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASLayout.h>
+
+static const NSUInteger ASLayoutBenchmarkWarmUpIterationCount = 10;
+static const NSUInteger ASLayoutBenchmarkAllocationIterationCount = 10;
+
+#pragma mark - Allocation Counting
+
+// The logger libmalloc calls for each allocation and deallocation, which the allocation tools install.
+typedef void (ASMallocLogger)(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip);
+extern ASMallocLogger *malloc_logger;
+
+// From libmalloc's stack logging flags.
+static const uint32_t ASMallocLogTypeAllocate = 2;
+
+static ASMallocLogger *__previousMallocLogger;
+static pthread_t __countedThread;
+static atomic_ulong __allocationCount;
+
+static void ASLayoutBenchmarkMallocLogger(uint32_t type, uintptr_t arg1, uintptr_t arg2, uintptr_t arg3, uintptr_t result, uint32_t numberOfHotFramesToSkip)
+{
+  if ((type & ASMallocLogTypeAllocate) && pthread_equal(pthread_self(), __countedThread)) {
+    atomic_fetch_add_explicit(&__allocationCount, 1, memory_order_relaxed);
+  }
+  if (__previousMallocLogger != NULL) {
+    __previousMallocLogger(type, arg1, arg2, arg3, result, numberOfHotFramesToSkip + 1);
+  }
+}
+
+/**
+ * Returns the number of heap allocations the block makes on the calling thread.
+ */
+static NSUInteger ASLayoutBenchmarkCountAllocations(AS_NOESCAPE dispatch_block_t block)
+{
+  __countedThread = pthread_self();
+  atomic_store(&__allocationCount, 0);
+  __previousMallocLogger = malloc_logger;
+  malloc_logger = ASLayoutBenchmarkMallocLogger;
+  block();
+  malloc_logger = __previousMallocLogger;
+  return (NSUInteger)atomic_load(&__allocationCount);
+}
+
+#pragma mark - ASLayoutBenchmarkResult
+
+@interface ASLayoutBenchmarkResult ()
+@property (nonatomic, copy) NSString *name;
+@property (nonatomic) NSUInteger childCount;
+@property (nonatomic) NSUInteger iterationCount;
+@property (nonatomic) double nanosecondsPerLayout;
+@property (nonatomic) double allocationsPerLayout;
+@property (nonatomic) CGSize layoutSize;
+@end
+
+@implementation ASLayoutBenchmarkResult
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  return @{
+    @"name" : _name,
+    @"childCount" : @(_childCount),
+    @"iterationCount" : @(_iterationCount),
+    @"nanosecondsPerLayout" : @(_nanosecondsPerLayout),
+    @"allocationsPerLayout" : @(_allocationsPerLayout),
+    @"layoutWidth" : @(_layoutSize.width),
+    @"layoutHeight" : @(_layoutSize.height),
+  };
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%-28s children=%4tu ns/layout=%10.0f allocations/layout=%8.1f size=%@>",
+          _name.UTF8String, _childCount, _nanosecondsPerLayout, _allocationsPerLayout, NSStringFromCGSize(_layoutSize)];
+}
+
+@end
+
+#pragma mark - ASLayoutBenchmark
+
+@implementation ASLayoutBenchmark {
+  NSMutableArray<ASLayoutBenchmarkResult *> *_results;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _minimumDuration = 0.1;
+    _results = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (ASLayoutBenchmarkResult *)addCaseWithName:(NSString *)name
+                                  childCount:(NSUInteger)childCount
+                                   sizeRange:(ASSizeRange)sizeRange
+                                elementBlock:(AS_NOESCAPE ASLayoutBenchmarkElementBlock)elementBlock
+{
+  __block CGSize layoutSize = CGSizeZero;
+  dispatch_block_t layoutBlock = ^{
+    @autoreleasepool {
+      layoutSize = [elementBlock() layoutThatFits:sizeRange].size;
+    }
+  };
+
+  for (NSUInteger i = 0; i < ASLayoutBenchmarkWarmUpIterationCount; i++) {
+    layoutBlock();
+  }
+
+  mach_timebase_info_data_t timebase;
+  mach_timebase_info(&timebase);
+  uint64_t minimumTicks = (uint64_t)(_minimumDuration * NSEC_PER_SEC * timebase.denom / timebase.numer);
+  NSUInteger iterationCount = 0;
+  uint64_t startTime = mach_absolute_time();
+  uint64_t elapsedTicks = 0;
+  do {
+    layoutBlock();
+    iterationCount++;
+    elapsedTicks = mach_absolute_time() - startTime;
+  } while (elapsedTicks < minimumTicks);
+
+  NSUInteger allocationCount = ASLayoutBenchmarkCountAllocations(^{
+    for (NSUInteger i = 0; i < ASLayoutBenchmarkAllocationIterationCount; i++) {
+      layoutBlock();
+    }
+  });
+
+  ASLayoutBenchmarkResult *result = [[ASLayoutBenchmarkResult alloc] init];
+  result.name = name;
+  result.childCount = childCount;
+  result.iterationCount = iterationCount;
+  result.nanosecondsPerLayout = (double)elapsedTicks * timebase.numer / timebase.denom / iterationCount;
+  result.allocationsPerLayout = (double)allocationCount / ASLayoutBenchmarkAllocationIterationCount;
+  result.layoutSize = layoutSize;
+  [_results addObject:result];
+  return result;
+}
+
+- (NSArray<ASLayoutBenchmarkResult *> *)results
+{
+  return [_results copy];
+}
+
+- (NSData *)JSONData
+{
+  struct utsname systemInfo;
+  uname(&systemInfo);
+  NSMutableArray<NSDictionary *> *results = [NSMutableArray arrayWithCapacity:_results.count];
+  for (ASLayoutBenchmarkResult *result in _results) {
+    [results addObject:[result dictionaryRepresentation]];
+  }
+  NSDictionary *benchmark = @{
+    @"device" : @(systemInfo.machine),
+    @"system" : [NSString stringWithFormat:@"%@ %@", [UIDevice currentDevice].systemName, [UIDevice currentDevice].systemVersion],
+    @"results" : results,
+  };
+  return [NSJSONSerialization dataWithJSONObject:benchmark options:NSJSONWritingPrettyPrinted error:NULL];
+}
+
+- (NSString *)description
+{
+  NSMutableString *description = [NSMutableString stringWithString:@"Layout benchmark results:\n"];
+  for (ASLayoutBenchmarkResult *result in _results) {
+    [description appendFormat:@"\t%@\n", result];
+  }
+  return description;
+}
+
+@end
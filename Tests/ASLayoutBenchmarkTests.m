@@ -0,0 +1,316 @@
+//
+//  ASLayoutBenchmarkTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ASLayoutBenchmark.h"
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+
+/**
+ * Benchmarks of the layout spec engine. The results of all cases are logged and written as JSON to the path in the
+ * AS_LAYOUT_BENCHMARK_OUTPUT_PATH environment variable, or to ASLayoutBenchmarkResults.json in the temporary directory.
+ *
+ * Stack cases scale with their number of children, single-child specs with their nesting depth.
+ */
+@interface ASLayoutBenchmarkTests : XCTestCase
+@end
+
+static ASLayoutBenchmark *__benchmark;
+static const ASSizeRange ASLayoutBenchmarkCellSizeRange = {{320, 0}, {320, CGFLOAT_MAX}};
+
+static ASDisplayNode *ASLayoutBenchmarkLeaf(CGSize size)
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.style.preferredSize = size;
+  return node;
+}
+
+static NSArray<ASDisplayNode *> *ASLayoutBenchmarkLeaves(NSUInteger count, CGSize size)
+{
+  NSMutableArray<ASDisplayNode *> *leaves = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; i++) {
+    [leaves addObject:ASLayoutBenchmarkLeaf(size)];
+  }
+  return leaves;
+}
+
+/**
+ * Returns leaves 20 points high, whose widths are their flex basis, grown or shrunk by stacks.
+ */
+static NSArray<ASDisplayNode *> *ASLayoutBenchmarkFlexibleLeaves(NSUInteger count, CGFloat flexBasis, CGFloat flexGrow, CGFloat flexShrink)
+{
+  NSMutableArray<ASDisplayNode *> *leaves = [NSMutableArray arrayWithCapacity:count];
+  for (NSUInteger i = 0; i < count; i++) {
+    ASDisplayNode *node = [[ASDisplayNode alloc] init];
+    node.style.height = ASDimensionMake(20);
+    node.style.flexBasis = ASDimensionMake(flexBasis);
+    node.style.flexGrow = flexGrow;
+    node.style.flexShrink = flexShrink;
+    [leaves addObject:node];
+  }
+  return leaves;
+}
+
+static ASTextNode *ASLayoutBenchmarkTextNode(NSString *string, CGFloat fontSize)
+{
+  ASTextNode *textNode = [[ASTextNode alloc] init];
+  textNode.attributedText = [[NSAttributedString alloc] initWithString:string attributes:@{ NSFontAttributeName : [UIFont systemFontOfSize:fontSize] }];
+  return textNode;
+}
+
+@implementation ASLayoutBenchmarkTests
+
++ (void)setUp
+{
+  [super setUp];
+  __benchmark = [[ASLayoutBenchmark alloc] init];
+}
+
++ (void)tearDown
+{
+  NSLog(@"%@", __benchmark);
+  NSString *path = [NSProcessInfo processInfo].environment[@"AS_LAYOUT_BENCHMARK_OUTPUT_PATH"];
+  if (path.length == 0) {
+    path = [NSTemporaryDirectory() stringByAppendingPathComponent:@"ASLayoutBenchmarkResults.json"];
+  }
+  if ([[__benchmark JSONData] writeToFile:path atomically:YES]) {
+    NSLog(@"Wrote layout benchmark results to %@", path);
+  }
+  __benchmark = nil;
+  [super tearDown];
+}
+
+- (NSArray<NSNumber *> *)childCounts
+{
+  return @[ @10, @50, @200 ];
+}
+
+- (NSArray<NSNumber *> *)nestingDepths
+{
+  return @[ @1, @10, @50 ];
+}
+
+#pragma mark - Stacks
+
+- (void)testStackWithoutWrapping
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSArray<ASDisplayNode *> *children = ASLayoutBenchmarkLeaves(count.unsignedIntegerValue, CGSizeMake(20, 20));
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"stack.noWrap" childCount:count.unsignedIntegerValue sizeRange:ASSizeRangeUnconstrained elementBlock:^{
+      return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStart children:children];
+    }];
+    XCTAssertEqual(result.layoutSize.width, count.unsignedIntegerValue * 20);
+  }
+}
+
+- (void)testStackWithWrapping
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSArray<ASDisplayNode *> *children = ASLayoutBenchmarkLeaves(count.unsignedIntegerValue, CGSizeMake(20, 20));
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"stack.wrap" childCount:count.unsignedIntegerValue sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:^{
+      ASStackLayoutSpec *stack = [ASStackLayoutSpec horizontalStackLayoutSpec];
+      stack.flexWrap = ASStackLayoutFlexWrapWrap;
+      stack.alignContent = ASStackLayoutAlignContentStart;
+      stack.children = children;
+      return stack;
+    }];
+    // 16 children fit on each line.
+    XCTAssertEqual(result.layoutSize.height, ceil(count.doubleValue / 16) * 20);
+  }
+}
+
+- (void)testStackWithBaselineAlignment
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSMutableArray<ASTextNode *> *children = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count.unsignedIntegerValue; i++) {
+      [children addObject:ASLayoutBenchmarkTextNode(@"Baseline", 10 + i % 8)];
+    }
+    [__benchmark addCaseWithName:@"stack.baseline" childCount:count.unsignedIntegerValue sizeRange:ASSizeRangeUnconstrained elementBlock:^{
+      return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:4 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsBaselineFirst children:children];
+    }];
+  }
+}
+
+- (void)testStackWithFlexGrow
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSArray<ASDisplayNode *> *children = ASLayoutBenchmarkFlexibleLeaves(count.unsignedIntegerValue, 1, 1, 0);
+    CGFloat width = count.doubleValue * 4;
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"stack.flexGrow" childCount:count.unsignedIntegerValue sizeRange:ASSizeRangeMake(CGSizeMake(width, 0), CGSizeMake(width, CGFLOAT_MAX)) elementBlock:^{
+      return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStart children:children];
+    }];
+    XCTAssertEqual(result.layoutSize.width, width);
+  }
+}
+
+- (void)testStackWithFlexShrink
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSArray<ASDisplayNode *> *children = ASLayoutBenchmarkFlexibleLeaves(count.unsignedIntegerValue, 40, 0, 1);
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"stack.flexShrink" childCount:count.unsignedIntegerValue sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:^{
+      return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStart children:children];
+    }];
+    XCTAssertEqual(result.layoutSize.width, 320);
+  }
+}
+
+#pragma mark - Single-Child Specs
+
+- (void)testNestedInsets
+{
+  ASDisplayNode *leaf = ASLayoutBenchmarkLeaf(CGSizeMake(20, 20));
+  for (NSNumber *depth in [self nestingDepths]) {
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"inset" childCount:depth.unsignedIntegerValue sizeRange:ASSizeRangeUnconstrained elementBlock:^{
+      id<ASLayoutElement> element = leaf;
+      for (NSUInteger i = 0; i < depth.unsignedIntegerValue; i++) {
+        element = [ASInsetLayoutSpec insetLayoutSpecWithInsets:UIEdgeInsetsMake(1, 1, 1, 1) child:element];
+      }
+      return element;
+    }];
+    XCTAssertEqual(result.layoutSize.width, 20 + depth.unsignedIntegerValue * 2);
+  }
+}
+
+- (void)testNestedRatios
+{
+  ASDisplayNode *leaf = ASLayoutBenchmarkLeaf(CGSizeMake(20, 20));
+  for (NSNumber *depth in [self nestingDepths]) {
+    [__benchmark addCaseWithName:@"ratio" childCount:depth.unsignedIntegerValue sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:^{
+      id<ASLayoutElement> element = leaf;
+      for (NSUInteger i = 0; i < depth.unsignedIntegerValue; i++) {
+        element = [ASRatioLayoutSpec ratioLayoutSpecWithRatio:(i % 2 ? 0.5 : 2) child:element];
+      }
+      return element;
+    }];
+  }
+}
+
+- (void)testNestedRelativePositions
+{
+  ASDisplayNode *leaf = ASLayoutBenchmarkLeaf(CGSizeMake(20, 20));
+  for (NSNumber *depth in [self nestingDepths]) {
+    ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"relative" childCount:depth.unsignedIntegerValue sizeRange:ASSizeRangeMake(CGSizeMake(320, 320)) elementBlock:^{
+      id<ASLayoutElement> element = leaf;
+      for (NSUInteger i = 0; i < depth.unsignedIntegerValue; i++) {
+        element = [ASRelativeLayoutSpec relativePositionLayoutSpecWithHorizontalPosition:ASRelativeLayoutSpecPositionEnd verticalPosition:ASRelativeLayoutSpecPositionCenter sizingOption:ASRelativeLayoutSpecSizingOptionDefault child:element];
+      }
+      return element;
+    }];
+    XCTAssertTrue(CGSizeEqualToSize(result.layoutSize, CGSizeMake(320, 320)));
+  }
+}
+
+#pragma mark - Absolute Positions
+
+- (void)testAbsolutePositions
+{
+  for (NSNumber *count in [self childCounts]) {
+    NSArray<ASDisplayNode *> *children = ASLayoutBenchmarkLeaves(count.unsignedIntegerValue, CGSizeMake(20, 20));
+    [children enumerateObjectsUsingBlock:^(ASDisplayNode *child, NSUInteger i, BOOL *stop) {
+      child.style.layoutPosition = CGPointMake((i * 20) % 300, (i / 15) * 20);
+    }];
+    [__benchmark addCaseWithName:@"absolute" childCount:count.unsignedIntegerValue sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:^{
+      return [ASAbsoluteLayoutSpec absoluteLayoutSpecWithSizing:ASAbsoluteLayoutSpecSizingSizeToFit children:children];
+    }];
+  }
+}
+
+#pragma mark - Posts
+
+/**
+ * Returns a block building the layout spec of the PostNode of the SocialAppLayout example, with the same subnodes.
+ */
+- (ASLayoutBenchmarkElementBlock)postLayoutBlock
+{
+  ASTextNode *nameNode = ASLayoutBenchmarkTextNode(@"Apple Guy", 15);
+  nameNode.maximumNumberOfLines = 1;
+  ASTextNode *usernameNode = ASLayoutBenchmarkTextNode(@"@appleguy", 13);
+  usernameNode.style.flexShrink = 1;
+  usernameNode.truncationMode = NSLineBreakByTruncatingTail;
+  usernameNode.maximumNumberOfLines = 1;
+  ASTextNode *timeNode = ASLayoutBenchmarkTextNode(@"3m", 13);
+  ASTextNode *postNode = ASLayoutBenchmarkTextNode(@"Check out the layout specs in the examples, https://github.com/facebook/AsyncDisplayKit", 15);
+  ASDisplayNode *viaNode = ASLayoutBenchmarkLeaf(CGSizeMake(16, 16));
+  ASDisplayNode *avatarNode = ASLayoutBenchmarkLeaf(CGSizeMake(44, 44));
+  ASDisplayNode *mediaNode = [[ASDisplayNode alloc] init];
+  ASDisplayNode *likesNode = ASLayoutBenchmarkLeaf(CGSizeMake(60, 20));
+  ASDisplayNode *commentsNode = ASLayoutBenchmarkLeaf(CGSizeMake(60, 20));
+  ASDisplayNode *optionsNode = ASLayoutBenchmarkLeaf(CGSizeMake(20, 20));
+
+  return ^id<ASLayoutElement>{
+    ASLayoutSpec *spacer = [[ASLayoutSpec alloc] init];
+    spacer.style.flexGrow = 1.0;
+
+    ASStackLayoutSpec *nameStack = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:5.0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsCenter children:@[ nameNode, usernameNode, spacer, viaNode, timeNode ]];
+    nameStack.style.alignSelf = ASStackLayoutAlignSelfStretch;
+
+    ASStackLayoutSpec *controlsStack = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:10 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsCenter children:@[ likesNode, commentsNode, optionsNode ]];
+    controlsStack.style.spacingAfter = 3.0;
+    controlsStack.style.spacingBefore = 3.0;
+
+    ASRatioLayoutSpec *imagePlace = [ASRatioLayoutSpec ratioLayoutSpecWithRatio:0.5 child:mediaNode];
+    imagePlace.style.spacingAfter = 3.0;
+    imagePlace.style.spacingBefore = 3.0;
+
+    ASStackLayoutSpec *contentSpec = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionVertical spacing:8.0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStretch children:@[ nameStack, postNode, imagePlace, controlsStack ]];
+    contentSpec.style.flexShrink = 1.0;
+
+    ASStackLayoutSpec *avatarContentSpec = [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionHorizontal spacing:8.0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStart children:@[ avatarNode, contentSpec ]];
+
+    return [ASInsetLayoutSpec insetLayoutSpecWithInsets:UIEdgeInsetsMake(10, 10, 10, 10) child:avatarContentSpec];
+  };
+}
+
+- (void)testPost
+{
+  ASLayoutBenchmarkResult *result = [__benchmark addCaseWithName:@"post" childCount:1 sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:[self postLayoutBlock]];
+  XCTAssertEqual(result.layoutSize.width, 320);
+  XCTAssertGreaterThan(result.layoutSize.height, 44 + 20);
+}
+
+- (void)testFeedOfPosts
+{
+  for (NSNumber *count in @[ @1, @10, @50 ]) {
+    NSMutableArray<ASLayoutBenchmarkElementBlock> *postBlocks = [NSMutableArray array];
+    for (NSUInteger i = 0; i < count.unsignedIntegerValue; i++) {
+      [postBlocks addObject:[self postLayoutBlock]];
+    }
+    [__benchmark addCaseWithName:@"post.feed" childCount:count.unsignedIntegerValue sizeRange:ASLayoutBenchmarkCellSizeRange elementBlock:^{
+      NSMutableArray<id<ASLayoutElement>> *posts = [NSMutableArray arrayWithCapacity:postBlocks.count];
+      for (ASLayoutBenchmarkElementBlock postBlock in postBlocks) {
+        [posts addObject:postBlock()];
+      }
+      return [ASStackLayoutSpec stackLayoutSpecWithDirection:ASStackLayoutDirectionVertical spacing:0 justifyContent:ASStackLayoutJustifyContentStart alignItems:ASStackLayoutAlignItemsStretch children:posts];
+    }];
+  }
+}
+
+#pragma mark - Results
+
+- (void)testThatResultsAreMachineReadable
+{
+  ASLayoutBenchmark *benchmark = [[ASLayoutBenchmark alloc] init];
+  benchmark.minimumDuration = 0.01;
+  ASDisplayNode *leaf = ASLayoutBenchmarkLeaf(CGSizeMake(20, 20));
+  ASLayoutBenchmarkResult *result = [benchmark addCaseWithName:@"inset" childCount:1 sizeRange:ASSizeRangeUnconstrained elementBlock:^{
+    return [ASInsetLayoutSpec insetLayoutSpecWithInsets:UIEdgeInsetsZero child:leaf];
+  }];
+  XCTAssertGreaterThan(result.iterationCount, 0);
+  XCTAssertGreaterThan(result.nanosecondsPerLayout, 0);
+  XCTAssertGreaterThan(result.allocationsPerLayout, 0, @"At least the spec and its layout are allocated");
+
+  NSDictionary *json = [NSJSONSerialization JSONObjectWithData:[benchmark JSONData] options:0 error:NULL];
+  XCTAssertNotNil(json[@"device"]);
+  XCTAssertEqualObjects([json[@"results"] valueForKey:@"name"], @[ @"inset" ]);
+  XCTAssertEqualObjects(json[@"results"][0][@"childCount"], @1);
+}
+
+@end
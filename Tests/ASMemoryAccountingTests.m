@@ -0,0 +1,109 @@
+//
+//  ASMemoryAccountingTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASMemoryAccounting.h>
+#import <AsyncDisplayKit/ASImageNode.h>
+#import <AsyncDisplayKit/ASTextNode.h>
+
+static UIImage *ASMemoryAccountingTestImage(CGSize size)
+{
+  UIGraphicsBeginImageContextWithOptions(size, NO, 1);
+  [[UIColor redColor] setFill];
+  UIRectFill((CGRect){CGPointZero, size});
+  UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+  UIGraphicsEndImageContext();
+  return image;
+}
+
+@interface ASMemoryAccountingTests : XCTestCase
+@end
+
+@implementation ASMemoryAccountingTests
+
+- (void)testThatBackingStoresOfUnloadedNodesAreCounted
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  XCTAssertEqual([node estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore], 0);
+  node.contents = (id)ASMemoryAccountingTestImage(CGSizeMake(10, 20)).CGImage;
+
+  XCTAssertGreaterThanOrEqual([node estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore], 10 * 20 * 4);
+  XCTAssertGreaterThan([node estimatedBytesForMemoryCategory:ASMemoryCategoryPendingState], 0);
+}
+
+- (void)testThatBackingStoresOfLoadedNodesAreCounted
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  node.layerBacked = YES;
+  [node layer];
+  node.contents = (id)ASMemoryAccountingTestImage(CGSizeMake(10, 20)).CGImage;
+  XCTAssertGreaterThanOrEqual([node estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore], 10 * 20 * 4);
+}
+
+- (void)testThatUsageIncludesSubnodes
+{
+  ASDisplayNode *node = [[ASDisplayNode alloc] init];
+  ASDisplayNode *subnode = [[ASDisplayNode alloc] init];
+  ASDisplayNode *subsubnode = [[ASDisplayNode alloc] init];
+  [node addSubnode:subnode];
+  [subnode addSubnode:subsubnode];
+  subnode.contents = (id)ASMemoryAccountingTestImage(CGSizeMake(10, 10)).CGImage;
+  subsubnode.contents = (id)ASMemoryAccountingTestImage(CGSizeMake(10, 10)).CGImage;
+
+  ASMemoryUsage *usage = [node estimatedMemoryUsage];
+  XCTAssertEqualObjects(usage.name, @"ASDisplayNode");
+  XCTAssertEqual([usage bytesForCategory:ASMemoryCategoryBackingStore],
+                 [subnode estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore] + [subsubnode estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore]);
+  XCTAssertGreaterThanOrEqual(usage.totalBytes, [usage bytesForCategory:ASMemoryCategoryBackingStore]);
+}
+
+- (void)testThatImageNodesReportTheirImages
+{
+  ASImageNode *imageNode = [[ASImageNode alloc] init];
+  imageNode.image = ASMemoryAccountingTestImage(CGSizeMake(30, 10));
+  XCTAssertGreaterThanOrEqual([imageNode estimatedBytesForMemoryCategory:ASMemoryCategoryImage], 30 * 10 * 4);
+  XCTAssertEqual([[[ASDisplayNode alloc] init] estimatedBytesForMemoryCategory:ASMemoryCategoryImage], 0);
+}
+
+- (void)testThatImagesDisplayedAsTheyAreAreOnlyCountedAsBackingStores
+{
+  ASImageNode *imageNode = [[ASImageNode alloc] init];
+  UIImage *image = ASMemoryAccountingTestImage(CGSizeMake(30, 10));
+  imageNode.image = image;
+  imageNode.contents = (id)image.CGImage;
+  XCTAssertEqual([imageNode estimatedBytesForMemoryCategory:ASMemoryCategoryImage], 0);
+  XCTAssertGreaterThanOrEqual([imageNode estimatedBytesForMemoryCategory:ASMemoryCategoryBackingStore], 30 * 10 * 4);
+}
+
+- (void)testThatTextRenderersAreCountedInCacheUsage
+{
+  ASTextNode *textNode = [[ASTextNode alloc] init];
+  textNode.attributedText = [[NSAttributedString alloc] initWithString:[[NSUUID UUID] UUIDString]];
+  (void)[textNode layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(200, 200))];
+  XCTAssertGreaterThan([[ASMemoryAccounting cacheUsage] bytesForCategory:ASMemoryCategoryTextRendererCache], 0);
+}
+
+- (void)testThatSnapshotsAddUpTheirParts
+{
+  ASMemorySnapshot *snapshot = [ASMemoryAccounting snapshot];
+  NSUInteger expectedTotalBytes = snapshot.cacheUsage.totalBytes - [snapshot.cacheUsage bytesForCategory:ASMemoryCategoryImageContentsCache];
+  NSUInteger previousBytes = NSUIntegerMax;
+  for (ASMemoryUsage *usage in snapshot.rangeControllerUsages) {
+    XCTAssertLessThanOrEqual(usage.totalBytes, previousBytes);
+    previousBytes = usage.totalBytes;
+    expectedTotalBytes += usage.totalBytes;
+  }
+  XCTAssertEqual(snapshot.totalUsage.totalBytes, expectedTotalBytes);
+  XCTAssertTrue([NSJSONSerialization isValidJSONObject:[snapshot dictionaryRepresentation]]);
+  XCTAssertEqualObjects(ASMemoryCategoryGetName(ASMemoryCategoryElementMap), @"elementMap");
+}
+
+@end
@@ -14,11 +14,158 @@
 #import <AsyncDisplayKit/ASImageProtocols.h>
 #import <AsyncDisplayKit/ASMultiplexImageNode.h>
 #import <AsyncDisplayKit/ASImageContainerProtocolCategories.h>
+#import <AsyncDisplayKit/ASEqualityHelpers.h>
 
 #import <libkern/OSAtomic.h>
 
 #import <XCTest/XCTest.h>
 
+#pragma mark - Stand-ins
+
+/**
+ * A cache that holds images for a fixed set of URLs and answers asynchronously, like a real cache.
+ */
+@interface ASTestTierImageCache : NSObject <ASImageCacheProtocol>
+@property (nonatomic, copy) NSSet<NSURL *> *cachedURLs;
+@property (nonatomic, strong) UIImage *image;
+@end
+
+@implementation ASTestTierImageCache
+
+- (void)cachedImageWithURL:(NSURL *)URL callbackQueue:(dispatch_queue_t)callbackQueue completion:(ASImageCacherCompletion)completion
+{
+  UIImage *image = [self.cachedURLs containsObject:URL] ? self.image : nil;
+  dispatch_async(callbackQueue, ^{
+    completion(image);
+  });
+}
+
+@end
+
+/**
+ * A downloader that completes each URL after a fixed latency, or holds it until told to complete it.
+ */
+@interface ASTestTierImageDownloader : NSObject <ASImageDownloaderProtocol>
+@property (nonatomic, copy) NSDictionary<NSURL *, NSNumber *> *latencies;
+@property (nonatomic, copy) NSSet<NSURL *> *failedURLs;
+@property (nonatomic, strong) UIImage *image;
+- (NSArray<NSURL *> *)requestedURLs;
+- (NSArray<NSURL *> *)cancelledURLs;
+- (void)completeDownloadForURL:(NSURL *)URL;
+@end
+
+@implementation ASTestTierImageDownloader
+{
+  NSMutableArray<NSURL *> *_requestedURLs;
+  NSMutableArray<NSURL *> *_cancelledURLs;
+  NSMutableDictionary<NSUUID *, NSURL *> *_URLsByIdentifier;
+  NSMutableDictionary<NSUUID *, dispatch_block_t> *_completionsByIdentifier;
+}
+
+- (instancetype)init
+{
+  if (self = [super init]) {
+    _requestedURLs = [NSMutableArray array];
+    _cancelledURLs = [NSMutableArray array];
+    _URLsByIdentifier = [NSMutableDictionary dictionary];
+    _completionsByIdentifier = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+
+- (id)downloadImageWithURL:(NSURL *)URL callbackQueue:(dispatch_queue_t)callbackQueue downloadProgress:(ASImageDownloaderProgress)downloadProgress completion:(ASImageDownloaderCompletion)completion
+{
+  NSUUID *identifier = [NSUUID UUID];
+  BOOL fails = [self.failedURLs containsObject:URL];
+  UIImage *image = fails ? nil : self.image;
+  NSError *error = fails ? [NSError errorWithDomain:NSURLErrorDomain code:NSURLErrorBadServerResponse userInfo:nil] : nil;
+  __weak __typeof__(self) weakSelf = self;
+  dispatch_block_t complete = ^{
+    __typeof__(self) strongSelf = weakSelf;
+    @synchronized (strongSelf) {
+      if (strongSelf->_completionsByIdentifier[identifier] == nil) {
+        return;
+      }
+      [strongSelf->_completionsByIdentifier removeObjectForKey:identifier];
+    }
+    dispatch_async(callbackQueue, ^{
+      completion(image, error, identifier);
+    });
+  };
+
+  @synchronized (self) {
+    [_requestedURLs addObject:URL];
+    _URLsByIdentifier[identifier] = URL;
+    _completionsByIdentifier[identifier] = complete;
+  }
+
+  NSNumber *latency = self.latencies[URL];
+  if (latency) {
+    dispatch_after(dispatch_time(DISPATCH_TIME_NOW, (int64_t)(latency.doubleValue * NSEC_PER_SEC)), dispatch_get_global_queue(QOS_CLASS_DEFAULT, 0), complete);
+  }
+  return identifier;
+}
+
+- (void)cancelImageDownloadForIdentifier:(id)downloadIdentifier
+{
+  @synchronized (self) {
+    if (_completionsByIdentifier[downloadIdentifier] != nil) {
+      [_completionsByIdentifier removeObjectForKey:downloadIdentifier];
+      [_cancelledURLs addObject:_URLsByIdentifier[downloadIdentifier]];
+    }
+  }
+}
+
+- (void)completeDownloadForURL:(NSURL *)URL
+{
+  NSMutableArray<dispatch_block_t> *completions = [NSMutableArray array];
+  @synchronized (self) {
+    [_URLsByIdentifier enumerateKeysAndObjectsUsingBlock:^(NSUUID *identifier, NSURL *downloadURL, BOOL *stop) {
+      dispatch_block_t complete = _completionsByIdentifier[identifier];
+      if ([downloadURL isEqual:URL] && complete) {
+        [completions addObject:complete];
+      }
+    }];
+  }
+  for (dispatch_block_t complete in completions) {
+    complete();
+  }
+}
+
+- (NSArray<NSURL *> *)requestedURLs
+{
+  @synchronized (self) {
+    return [_requestedURLs copy];
+  }
+}
+
+- (NSArray<NSURL *> *)cancelledURLs
+{
+  @synchronized (self) {
+    return [_cancelledURLs copy];
+  }
+}
+
+@end
+
+/**
+ * Hands out a URL per identifier and nothing else.
+ */
+@interface ASTestTierDataSource : NSObject <ASMultiplexImageNodeDataSource>
+@property (nonatomic, copy) NSDictionary<NSString *, NSURL *> *URLs;
+@end
+
+@implementation ASTestTierDataSource
+
+- (NSURL *)multiplexImageNode:(ASMultiplexImageNode *)imageNode URLForImageIdentifier:(ASImageIdentifier)imageIdentifier
+{
+  return self.URLs[imageIdentifier];
+}
+
+@end
+
+#pragma mark -
+
 @interface ASMultiplexImageNodeTests : XCTestCase
 {
 @private
@@ -302,6 +449,160 @@
   [mockDelegate verify];
 }
 
+#pragma mark -
+#pragma mark Tiered loading.
+
+- (NSDictionary<NSString *, NSURL *> *)_tierURLs
+{
+  return @{
+    @"high" : [NSURL URLWithString:@"https://example.com/high.png"],
+    @"medium" : [NSURL URLWithString:@"https://example.com/medium.png"],
+    @"low" : [NSURL URLWithString:@"https://example.com/low.png"],
+  };
+}
+
+- (void)_waitForLoadedImageIdentifier:(id)imageIdentifier ofImageNode:(ASMultiplexImageNode *)imageNode
+{
+  NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+  while (!ASObjectIsEqual(imageNode.loadedImageIdentifier, imageIdentifier) && [deadline timeIntervalSinceNow] > 0) {
+    [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertEqualObjects(imageNode.loadedImageIdentifier, imageIdentifier);
+}
+
+- (void)_waitForRequestedURLCount:(NSUInteger)count ofDownloader:(ASTestTierImageDownloader *)downloader
+{
+  NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+  while (downloader.requestedURLs.count < count && [deadline timeIntervalSinceNow] > 0) {
+    [[NSRunLoop currentRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertEqual(downloader.requestedURLs.count, count);
+}
+
+- (void)testCachedTierIsDisplayedWhileBestTierDownloads
+{
+  NSDictionary<NSString *, NSURL *> *URLs = [self _tierURLs];
+  ASTestTierImageCache *cache = [[ASTestTierImageCache alloc] init];
+  cache.image = [self _testImage];
+  cache.cachedURLs = [NSSet setWithObject:URLs[@"medium"]];
+  ASTestTierImageDownloader *downloader = [[ASTestTierImageDownloader alloc] init];
+  downloader.image = [self _testImage];
+  ASTestTierDataSource *dataSource = [[ASTestTierDataSource alloc] init];
+  dataSource.URLs = URLs;
+
+  ASMultiplexImageNode *imageNode = [[ASMultiplexImageNode alloc] initWithCache:cache downloader:downloader];
+  imageNode.dataSource = dataSource;
+  imageNode.downloadsIntermediateImages = YES;
+  imageNode.imageIdentifiers = @[@"high", @"medium", @"low"];
+  [imageNode reloadImageIdentifierSources];
+
+  // The cached tier is shown without waiting for the best one, and only the best tier goes to the network.
+  [self _waitForLoadedImageIdentifier:@"medium" ofImageNode:imageNode];
+  [self _waitForRequestedURLCount:1 ofDownloader:downloader];
+  XCTAssertEqualObjects(downloader.requestedURLs, @[URLs[@"high"]]);
+
+  [downloader completeDownloadForURL:URLs[@"high"]];
+  [self _waitForLoadedImageIdentifier:@"high" ofImageNode:imageNode];
+}
+
+- (void)testPlaceholderTierDownloadsAlongsideBestTierAndIsCancelledWhenBestLands
+{
+  NSDictionary<NSString *, NSURL *> *URLs = [self _tierURLs];
+  ASTestTierImageDownloader *downloader = [[ASTestTierImageDownloader alloc] init];
+  downloader.image = [self _testImage];
+  ASTestTierDataSource *dataSource = [[ASTestTierDataSource alloc] init];
+  dataSource.URLs = URLs;
+
+  ASMultiplexImageNode *imageNode = [[ASMultiplexImageNode alloc] initWithCache:nil downloader:downloader];
+  imageNode.dataSource = dataSource;
+  imageNode.downloadsIntermediateImages = YES;
+  imageNode.imageIdentifiers = @[@"high", @"medium", @"low"];
+  [imageNode reloadImageIdentifierSources];
+
+  // Both the best and the worst tier are in flight before either completes; the middle tier is skipped.
+  [self _waitForRequestedURLCount:2 ofDownloader:downloader];
+  XCTAssertEqualObjects([NSSet setWithArray:downloader.requestedURLs], ([NSSet setWithObjects:URLs[@"high"], URLs[@"low"], nil]));
+
+  [downloader completeDownloadForURL:URLs[@"high"]];
+  [self _waitForLoadedImageIdentifier:@"high" ofImageNode:imageNode];
+  XCTAssertEqualObjects(downloader.cancelledURLs, @[URLs[@"low"]]);
+}
+
+- (void)testPlaceholderTierIsReplacedByBestTier
+{
+  NSDictionary<NSString *, NSURL *> *URLs = [self _tierURLs];
+  ASTestTierImageDownloader *downloader = [[ASTestTierImageDownloader alloc] init];
+  downloader.image = [self _testImage];
+  ASTestTierDataSource *dataSource = [[ASTestTierDataSource alloc] init];
+  dataSource.URLs = URLs;
+
+  ASMultiplexImageNode *imageNode = [[ASMultiplexImageNode alloc] initWithCache:nil downloader:downloader];
+  imageNode.dataSource = dataSource;
+  imageNode.downloadsIntermediateImages = YES;
+  imageNode.imageIdentifiers = @[@"high", @"low"];
+  [imageNode reloadImageIdentifierSources];
+  [self _waitForRequestedURLCount:2 ofDownloader:downloader];
+
+  [downloader completeDownloadForURL:URLs[@"low"]];
+  [self _waitForLoadedImageIdentifier:@"low" ofImageNode:imageNode];
+  [downloader completeDownloadForURL:URLs[@"high"]];
+  [self _waitForLoadedImageIdentifier:@"high" ofImageNode:imageNode];
+  XCTAssertEqual(downloader.requestedURLs.count, 2);
+  XCTAssertEqual(downloader.cancelledURLs.count, 0);
+}
+
+- (void)testFailedBestTierFallsBackToNextBestTier
+{
+  NSDictionary<NSString *, NSURL *> *URLs = [self _tierURLs];
+  ASTestTierImageDownloader *downloader = [[ASTestTierImageDownloader alloc] init];
+  downloader.image = [self _testImage];
+  downloader.failedURLs = [NSSet setWithObject:URLs[@"high"]];
+  ASTestTierDataSource *dataSource = [[ASTestTierDataSource alloc] init];
+  dataSource.URLs = URLs;
+
+  ASMultiplexImageNode *imageNode = [[ASMultiplexImageNode alloc] initWithCache:nil downloader:downloader];
+  imageNode.dataSource = dataSource;
+  imageNode.downloadsIntermediateImages = YES;
+  imageNode.imageIdentifiers = @[@"high", @"medium", @"low"];
+  [imageNode reloadImageIdentifierSources];
+  [self _waitForRequestedURLCount:2 ofDownloader:downloader];
+
+  // The middle tier was skipped in favour of the best one, so it's downloaded once the best one fails.
+  [downloader completeDownloadForURL:URLs[@"high"]];
+  [self _waitForRequestedURLCount:3 ofDownloader:downloader];
+  XCTAssertEqualObjects(downloader.requestedURLs.lastObject, URLs[@"medium"]);
+
+  [downloader completeDownloadForURL:URLs[@"medium"]];
+  [self _waitForLoadedImageIdentifier:@"medium" ofImageNode:imageNode];
+  XCTAssertEqualObjects(downloader.cancelledURLs, @[URLs[@"low"]]);
+}
+
+- (void)testTimeToBestImage
+{
+  // Each tier takes the same time to download. Loading the tiers one after another would take twice that to reach the
+  // best image; loading them side by side takes it once.
+  const NSTimeInterval latency = 0.5;
+  NSDictionary<NSString *, NSURL *> *URLs = [self _tierURLs];
+  ASTestTierImageDownloader *downloader = [[ASTestTierImageDownloader alloc] init];
+  downloader.image = [self _testImage];
+  downloader.latencies = @{ URLs[@"high"] : @(latency), URLs[@"low"] : @(latency) };
+  ASTestTierDataSource *dataSource = [[ASTestTierDataSource alloc] init];
+  dataSource.URLs = URLs;
+
+  ASMultiplexImageNode *imageNode = [[ASMultiplexImageNode alloc] initWithCache:nil downloader:downloader];
+  imageNode.dataSource = dataSource;
+  imageNode.downloadsIntermediateImages = YES;
+  imageNode.imageIdentifiers = @[@"high", @"low"];
+
+  CFTimeInterval start = CACurrentMediaTime();
+  [imageNode reloadImageIdentifierSources];
+  [self _waitForLoadedImageIdentifier:@"high" ofImageNode:imageNode];
+  CFTimeInterval timeToBestImage = CACurrentMediaTime() - start;
+
+  XCTAssertGreaterThanOrEqual(timeToBestImage, latency);
+  XCTAssertLessThan(timeToBestImage, 2 * latency);
+}
+
 - (void)testThatSettingAnImageExternallyWillThrow
 {
   ASMultiplexImageNode *multiplexImageNode = [[ASMultiplexImageNode alloc] init];
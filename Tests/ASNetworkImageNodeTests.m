@@ -10,6 +10,7 @@
 #import <OCMock/OCMock.h>
 #import <AsyncDisplayKit/AsyncDisplayKit.h>
 #import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+#import <AsyncDisplayKit/ASBasicImageCache.h>
 
 @interface ASNetworkImageNodeTests : XCTestCase
 
@@ -83,6 +84,43 @@
   XCTAssertEqualObjects(image, networkImageNode.image);
 }
 
+- (void)testThatImagesStayInTheMemoryCacheWhenExitingPreloadState
+{
+  UIGraphicsBeginImageContextWithOptions(CGSizeMake(10, 10), YES, 1);
+  UIImage *image = UIGraphicsGetImageFromCurrentImageContext();
+  UIGraphicsEndImageContext();
+
+  ASBasicImageCache *imageCache = [ASBasicImageDownloader sharedImageDownloader].cache;
+  NSURL *URL = [NSURL URLWithString:[NSString stringWithFormat:@"http://example.com/%@.png", [NSUUID UUID].UUIDString]];
+  [imageCache setImage:image data:nil downsampled:NO forURL:URL];
+
+  ASNetworkImageNode *networkImageNode = [[ASNetworkImageNode alloc] init];
+  networkImageNode.URL = URL;
+  [networkImageNode enterInterfaceState:ASInterfaceStatePreload];
+  [self waitForImage:image onNode:networkImageNode];
+
+  [networkImageNode exitInterfaceState:ASInterfaceStatePreload];
+  XCTAssertNil(networkImageNode.image);
+  XCTAssertEqual([imageCache memoryCachedImageForURL:URL], image);
+
+  [imageCache resetMetrics];
+  [networkImageNode enterInterfaceState:ASInterfaceStatePreload];
+  [self waitForImage:image onNode:networkImageNode];
+  XCTAssertEqual([imageCache metrics].memoryHitCount, 1);
+  XCTAssertEqual([imageCache metrics].missCount, 0);
+
+  [imageCache removeImageFromMemoryForURL:URL];
+}
+
+- (void)waitForImage:(UIImage *)image onNode:(ASNetworkImageNode *)networkImageNode
+{
+  NSDate *deadline = [NSDate dateWithTimeIntervalSinceNow:5];
+  while (networkImageNode.image != image && [deadline timeIntervalSinceNow] > 0) {
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertEqual(networkImageNode.image, image);
+}
+
 @end
 
 @implementation ASTestImageCache
@@ -0,0 +1,308 @@
+//
+//  ASRangeControllerTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/AsyncDisplayKit.h>
+#import <AsyncDisplayKit/ASCollectionElement.h>
+#import <AsyncDisplayKit/ASDisplayNode+FrameworkPrivate.h>
+#import <AsyncDisplayKit/ASRangeController.h>
+#import <AsyncDisplayKit/ASSection.h>
+
+/**
+ * Treats the items of the map as a single list, with the visible items given by a range of item indexes and a
+ * screenful being the length of that range.
+ */
+@interface ASTestRangeLayoutController : ASAbstractLayoutController
+@property (nonatomic, copy) NSArray<ASCollectionElement *> *elements;
+@property (nonatomic, assign) NSRange visibleRange;
+@end
+
+@implementation ASTestRangeLayoutController
+
+- (NSSet<ASCollectionElement *> *)elementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode rangeType:(ASLayoutRangeType)rangeType map:(ASElementMap *)map
+{
+  return [self elementsForTuningParameters:[self tuningParametersForRangeMode:rangeMode rangeType:rangeType] map:map];
+}
+
+- (void)allElementsForScrolling:(ASScrollDirection)scrollDirection rangeMode:(ASLayoutRangeMode)rangeMode displaySet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)displaySet preloadSet:(NSSet<ASCollectionElement *> *__autoreleasing  _Nullable *)preloadSet map:(ASElementMap *)map
+{
+  *displaySet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypeDisplay map:map];
+  *preloadSet = [self elementsForScrolling:scrollDirection rangeMode:rangeMode rangeType:ASLayoutRangeTypePreload map:map];
+}
+
+- (NSSet<ASCollectionElement *> *)elementsForTuningParameters:(ASRangeTuningParameters)tuningParameters map:(ASElementMap *)map
+{
+  NSArray<ASCollectionElement *> *elements = _elements;
+  NSInteger length = _visibleRange.length;
+  NSInteger start = MAX(0, (NSInteger)_visibleRange.location - (NSInteger)(tuningParameters.trailingBufferScreenfuls * length));
+  NSInteger end = MIN((NSInteger)elements.count, (NSInteger)NSMaxRange(_visibleRange) + (NSInteger)(tuningParameters.leadingBufferScreenfuls * length));
+  return [NSSet setWithArray:[elements subarrayWithRange:NSMakeRange(start, MAX(end - start, 0))]];
+}
+
+@end
+
+@interface ASRangeControllerTests : XCTestCase <ASRangeControllerDataSource>
+@property (nonatomic, strong) ASRangeController *rangeController;
+@property (nonatomic, strong) ASTestRangeLayoutController *layoutController;
+@property (nonatomic, strong) ASElementMap *map;
+@property (nonatomic, strong) ASDisplayNode *owningNode;
+@end
+
+@implementation ASRangeControllerTests
+
+- (void)setUp
+{
+  [super setUp];
+  _owningNode = [[ASDisplayNode alloc] init];
+
+  _layoutController = [[ASTestRangeLayoutController alloc] init];
+  ASRangeTuningParameters displayParameters = { .leadingBufferScreenfuls = 1, .trailingBufferScreenfuls = 1 };
+  ASRangeTuningParameters preloadParameters = { .leadingBufferScreenfuls = 2, .trailingBufferScreenfuls = 2 };
+  [_layoutController setTuningParameters:displayParameters forRangeMode:ASLayoutRangeModeFull rangeType:ASLayoutRangeTypeDisplay];
+  [_layoutController setTuningParameters:preloadParameters forRangeMode:ASLayoutRangeModeFull rangeType:ASLayoutRangeTypePreload];
+
+  _rangeController = [[ASRangeController alloc] init];
+  _rangeController.layoutController = _layoutController;
+  _rangeController.dataSource = self;
+  [_rangeController updateCurrentRangeWithMode:ASLayoutRangeModeFull];
+}
+
+- (void)setItemCounts:(NSArray<NSNumber *> *)itemCounts allocateNodes:(BOOL)allocateNodes
+{
+  NSMutableArray<ASSection *> *sections = [NSMutableArray array];
+  NSMutableArray<NSArray<ASCollectionElement *> *> *items = [NSMutableArray array];
+  for (NSNumber *itemCount in itemCounts) {
+    [sections addObject:[[ASSection alloc] initWithSectionID:sections.count context:nil]];
+    NSMutableArray<ASCollectionElement *> *sectionItems = [NSMutableArray array];
+    for (NSInteger item = 0; item < itemCount.integerValue; item++) {
+      ASCollectionElement *element = [[ASCollectionElement alloc] initWithNodeBlock:^{
+        ASCellNode *node = [[ASCellNode alloc] init];
+        node.hierarchyState |= ASHierarchyStateRangeManaged;
+        return node;
+      } supplementaryElementKind:nil constrainedSize:ASSizeRangeZero owningNode:_owningNode traitCollection:ASPrimitiveTraitCollectionMakeDefault()];
+      if (allocateNodes) {
+        [element node];
+      }
+      [sectionItems addObject:element];
+    }
+    [items addObject:sectionItems];
+  }
+  _map = [[ASElementMap alloc] initWithSections:sections items:items supplementaryElements:@{}];
+  _layoutController.elements = _map.itemElements;
+}
+
+- (void)updateWithVisibleRange:(NSRange)visibleRange
+{
+  [self updateWithVisibleRange:visibleRange flushDeferredInterfaceStates:YES];
+}
+
+- (void)updateWithVisibleRange:(NSRange)visibleRange flushDeferredInterfaceStates:(BOOL)flush
+{
+  _layoutController.visibleRange = visibleRange;
+  [_rangeController setNeedsUpdate];
+  [_rangeController updateIfNeeded];
+  if (flush) {
+    [_rangeController flushDeferredInterfaceStates];
+  }
+}
+
+- (ASInterfaceState)interfaceStateOfItem:(NSUInteger)index
+{
+  return _layoutController.elements[index].nodeIfAllocated.interfaceState;
+}
+
+- (void)assertInterfaceStatesForVisibleRange:(NSRange)visibleRange
+{
+  NSArray<ASCollectionElement *> *elements = _layoutController.elements;
+  NSRange displayRange = NSIntersectionRange(NSMakeRange(0, elements.count), NSMakeRange(visibleRange.location - visibleRange.length, visibleRange.length * 3));
+  NSRange preloadRange = NSIntersectionRange(NSMakeRange(0, elements.count), NSMakeRange(visibleRange.location - visibleRange.length * 2, visibleRange.length * 5));
+  for (NSUInteger index = 0; index < elements.count; index++) {
+    ASInterfaceState expected = ASInterfaceStateMeasureLayout;
+    if (NSLocationInRange(index, visibleRange)) {
+      expected = ASInterfaceStateInHierarchy;
+    } else {
+      if (NSLocationInRange(index, displayRange)) {
+        expected |= ASInterfaceStateDisplay;
+      }
+      if (NSLocationInRange(index, preloadRange)) {
+        expected |= ASInterfaceStatePreload;
+      }
+    }
+    XCTAssertEqual([self interfaceStateOfItem:index], expected, @"Item %lu", (unsigned long)index);
+  }
+}
+
+#pragma mark - ASRangeControllerDataSource
+
+- (NSArray<ASCollectionElement *> *)visibleElementsForRangeController:(ASRangeController *)rangeController
+{
+  return [_layoutController.elements subarrayWithRange:_layoutController.visibleRange];
+}
+
+- (ASScrollDirection)scrollDirectionForRangeController:(ASRangeController *)rangeController
+{
+  return ASScrollDirectionDown;
+}
+
+- (ASInterfaceState)interfaceStateForRangeController:(ASRangeController *)rangeController
+{
+  return ASInterfaceStateInHierarchy;
+}
+
+- (ASElementMap *)elementMapForRangeController:(ASRangeController *)rangeController
+{
+  return _map;
+}
+
+- (NSString *)nameForRangeControllerDataSource
+{
+  return NSStringFromClass([self class]);
+}
+
+#pragma mark - Tests
+
+- (void)testThatInterfaceStatesMatchTheRanges
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(40, 10)];
+}
+
+- (void)testThatItemsAreNumberedAcrossSections
+{
+  [self setItemCounts:@[ @30, @0, @20, @50 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(45, 10)];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(45, 10)];
+  [self updateWithVisibleRange:NSMakeRange(25, 10)];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(25, 10)];
+}
+
+- (void)testThatScrollingOnlyVisitsItemsThatChangedRanges
+{
+  [self setItemCounts:@[ @1000 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(100, 10)];
+  XCTAssertEqual(_rangeController.metrics.visitedItemCount, 1000);
+
+  [_rangeController resetMetrics];
+  [self updateWithVisibleRange:NSMakeRange(101, 10)];
+  // One item enters and one leaves each of the visible, display and preload ranges.
+  XCTAssertEqual(_rangeController.metrics.visitedItemCount, 6);
+  XCTAssertEqual(_rangeController.metrics.modifiedItemCount, 6);
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(101, 10)];
+
+  [_rangeController resetMetrics];
+  [self updateWithVisibleRange:NSMakeRange(101, 10)];
+  XCTAssertEqual(_rangeController.metrics.visitedItemCount, 0);
+}
+
+- (void)testThatJumpingVisitsBothRanges
+{
+  [self setItemCounts:@[ @1000 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(100, 10)];
+  [_rangeController resetMetrics];
+  [self updateWithVisibleRange:NSMakeRange(800, 10)];
+  XCTAssertEqual(_rangeController.metrics.visitedItemCount, 100);
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(800, 10)];
+}
+
+- (void)testThatNodesAllocatedLaterGetTheirInterfaceState
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:NO];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+
+  ASCellNode *node = _layoutController.elements[45].node;
+  XCTAssertEqual(node.interfaceState, ASInterfaceStateNone);
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  XCTAssertEqual(node.interfaceState, ASInterfaceStateInHierarchy);
+}
+
+- (void)testThatClearingContentsRestoresDisplayOnNextUpdate
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [_rangeController clearContents];
+  XCTAssertFalse(ASInterfaceStateIncludesDisplay([self interfaceStateOfItem:55]));
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(40, 10)];
+}
+
+- (void)testThatLeavingRangesIsDeferredUntilFlushed
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [self updateWithVisibleRange:NSMakeRange(0, 10) flushDeferredInterfaceStates:NO];
+
+  // Entering a range, and leaving the visible range, are applied right away.
+  XCTAssertEqual([self interfaceStateOfItem:5], ASInterfaceStateInHierarchy);
+  XCTAssertEqual([self interfaceStateOfItem:45], ASInterfaceStateMeasureLayout);
+  // Leaving the display and preload ranges waits.
+  XCTAssertTrue(ASInterfaceStateIncludesDisplay([self interfaceStateOfItem:35]));
+  XCTAssertTrue(ASInterfaceStateIncludesPreload([self interfaceStateOfItem:65]));
+
+  [_rangeController flushDeferredInterfaceStates];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(0, 10)];
+}
+
+- (void)testThatReenteringARangeCancelsTheDeferredExit
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [self updateWithVisibleRange:NSMakeRange(0, 10) flushDeferredInterfaceStates:NO];
+  [self updateWithVisibleRange:NSMakeRange(40, 10) flushDeferredInterfaceStates:NO];
+
+  [_rangeController flushDeferredInterfaceStates];
+  [self assertInterfaceStatesForVisibleRange:NSMakeRange(40, 10)];
+}
+
+- (void)testThatFreeingMemoryIsNotDeferred
+{
+  [self setItemCounts:@[ @100 ] allocateNodes:YES];
+  [self updateWithVisibleRange:NSMakeRange(40, 10)];
+  [_rangeController updateCurrentRangeWithMode:ASLayoutRangeModeVisibleOnly];
+  [self updateWithVisibleRange:NSMakeRange(40, 10) flushDeferredInterfaceStates:NO];
+
+  XCTAssertEqual([self interfaceStateOfItem:35], ASInterfaceStateMeasureLayout);
+  XCTAssertEqual([self interfaceStateOfItem:65], ASInterfaceStateMeasureLayout);
+  XCTAssertEqual([self interfaceStateOfItem:45], ASInterfaceStateInHierarchy);
+}
+
+- (void)testThatUpdateCostStaysFlatAsContentGrows
+{
+  for (NSNumber *itemCount in @[ @1000, @20000 ]) {
+    [self setUp];
+    [self setItemCounts:@[ itemCount ] allocateNodes:YES];
+    [self updateWithVisibleRange:NSMakeRange(100, 10)];
+    [_rangeController resetMetrics];
+    for (NSUInteger location = 101; location < 600; location++) {
+      [self updateWithVisibleRange:NSMakeRange(location, 10)];
+    }
+    ASRangeControllerMetrics metrics = _rangeController.metrics;
+    XCTAssertEqual(metrics.visitedItemCount, metrics.updateCount * 6, @"%@ items", itemCount);
+  }
+}
+
+- (void)testPerformanceOfScrollingUpdates
+{
+  [self setItemCounts:@[ @5000 ] allocateNodes:YES];
+  [_layoutController setTuningParameters:(ASRangeTuningParameters){ .leadingBufferScreenfuls = 20, .trailingBufferScreenfuls = 20 }
+                            forRangeMode:ASLayoutRangeModeFull
+                               rangeType:ASLayoutRangeTypePreload];
+  __block NSUInteger location = 500;
+  [self updateWithVisibleRange:NSMakeRange(location, 10)];
+  [self measureBlock:^{
+    for (NSUInteger i = 0; i < 200; i++) {
+      location += 1;
+      [self updateWithVisibleRange:NSMakeRange(location, 10)];
+    }
+  }];
+}
+
+@end
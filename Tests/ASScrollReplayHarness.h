@@ -0,0 +1,136 @@
+//
+//  ASScrollReplayHarness.h
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <UIKit/UIKit.h>
+#import <AsyncDisplayKit/ASBaseDefines.h>
+
+@class ASCellNode;
+
+NS_ASSUME_NONNULL_BEGIN
+
+typedef NS_ENUM(NSInteger, ASScrollReplayStepType) {
+  ASScrollReplayStepTypeContentOffset,
+  ASScrollReplayStepTypeInsert,
+  ASScrollReplayStepTypeDelete,
+  ASScrollReplayStepTypeReload,
+};
+
+/**
+ * What the harness does in one frame: scroll to a vertical content offset, or apply one change set to the feed.
+ */
+@interface ASScrollReplayStep : NSObject
+
++ (instancetype)stepWithContentOffset:(CGFloat)contentOffset;
++ (instancetype)insertStepWithItems:(NSArray *)items atIndexes:(NSIndexSet *)indexes;
++ (instancetype)deleteStepWithIndexes:(NSIndexSet *)indexes;
++ (instancetype)reloadStepWithIndexes:(NSIndexSet *)indexes;
+
+@property (nonatomic, readonly) ASScrollReplayStepType type;
+@property (nonatomic, readonly) CGFloat contentOffset;
+/// The item indexes the change set applies to. Insertions are at indexes of the updated feed, like -insertObjects:atIndexes:.
+@property (nonatomic, copy, readonly, nullable) NSIndexSet *indexes;
+@property (nonatomic, copy, readonly, nullable) NSArray *items;
+
+@end
+
+/**
+ * A recorded sequence of steps, replayed one step per frame.
+ *
+ * Scripts are stored as JSON, so that traces recorded from representative feeds can be kept and replayed offline:
+ *
+ *   {"steps": [{"offset": 120}, {"insert": [0, 1], "items": ["a", "b"]}, {"delete": [3]}, {"reload": [4]}]}
+ */
+@interface ASScrollReplayScript : NSObject
+
+- (instancetype)initWithSteps:(NSArray<ASScrollReplayStep *> *)steps NS_DESIGNATED_INITIALIZER;
+- (instancetype)init NS_UNAVAILABLE;
+
++ (nullable instancetype)scriptWithJSONData:(NSData *)data error:(NSError **)error;
+
+/**
+ * A fling from the top: scrolls down by distance over the frames, fast at first and decelerating to a stop.
+ */
++ (instancetype)flingScriptWithDistance:(CGFloat)distance frameCount:(NSUInteger)frameCount;
+
+@property (nonatomic, copy, readonly) NSArray<ASScrollReplayStep *> *steps;
+
+/**
+ * The script as JSON. Items must be valid JSON objects.
+ */
+- (nullable NSData *)JSONData;
+
+@end
+
+@interface ASScrollReplayResult : NSObject
+
+/// The time between consecutive frames of the replay, one per step. Frames the main thread was too busy for add up.
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *frameDurations;
+/// The time the main thread spent running, rather than waiting, during each frame.
+@property (nonatomic, copy, readonly) NSArray<NSNumber *> *mainThreadBusyDurations;
+/// Frames that took longer than one and a half refresh intervals.
+@property (nonatomic, readonly) NSUInteger droppedFrameCount;
+
+/// Cell nodes created by the node blocks.
+@property (nonatomic, readonly) NSUInteger allocatedCellCount;
+/// Layouts computed by nodes, as recorded by ASDisplayTelemetry.
+@property (nonatomic, readonly) NSUInteger layoutCount;
+/// Display operations that completed, as recorded by ASDisplayTelemetry.
+@property (nonatomic, readonly) NSUInteger displayCount;
+/// Display operations that were cancelled, as recorded by ASDisplayTelemetry.
+@property (nonatomic, readonly) NSUInteger cancelledDisplayCount;
+
+/// The highest physical memory footprint of the process sampled during the replay, in bytes.
+@property (nonatomic, readonly) uint64_t peakMemoryFootprint;
+/// How much the footprint grew from the start of the replay to its peak, in bytes.
+@property (nonatomic, readonly) uint64_t peakMemoryGrowth;
+
+/**
+ * Returns the frame duration at or below which the given fraction of frames fall, e.g. 0.95.
+ */
+- (NSTimeInterval)frameDurationAtPercentile:(double)percentile AS_WARN_UNUSED_RESULT;
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+
+@end
+
+/**
+ * Creates the cell node for an item of the feed. Called on background threads.
+ */
+typedef ASCellNode * _Nonnull (^ASScrollReplayNodeBlock)(id item);
+
+/**
+ * Drives an ASTableNode or an ASCollectionNode, in a window of the screen's size, through replay scripts, and measures
+ * what each replay costs. The node shows a single section of items, which change sets insert, delete and reload.
+ *
+ * Replays are deterministic in what they do: each step is applied in its own frame, from a display link, whatever
+ * happened in the frames before. Only how long the frames take varies, so results of the same script on the same
+ * device can be compared across changes to the range controller, the data controller or the scheduler.
+ */
+@interface ASScrollReplayHarness : NSObject
+
+- (instancetype)initWithTableNodeItems:(NSArray *)items nodeBlock:(ASScrollReplayNodeBlock)nodeBlock;
+- (instancetype)initWithCollectionViewLayout:(UICollectionViewLayout *)layout items:(NSArray *)items nodeBlock:(ASScrollReplayNodeBlock)nodeBlock;
+- (instancetype)init NS_UNAVAILABLE;
+
+/// The ASTableNode or ASCollectionNode.
+@property (nonatomic, strong, readonly) __kindof ASDisplayNode *node;
+@property (nonatomic, strong, readonly) UIScrollView *scrollView;
+/// The items of the feed, including the changes of replayed scripts.
+@property (nonatomic, copy, readonly) NSArray *items;
+
+/**
+ * Replays the script, running the main run loop until its last frame has finished and its updates are committed.
+ * Must be called on the main thread.
+ */
+- (ASScrollReplayResult *)replayScript:(ASScrollReplayScript *)script;
+
+@end
+
+NS_ASSUME_NONNULL_END
@@ -0,0 +1,530 @@
+//
+//  ASScrollReplayHarness.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import "ASScrollReplayHarness.h"
+
+#import <QuartzCore/QuartzCore.h>
+#import <mach/mach.h>
+#import <stdatomic.h>
+
+#import <AsyncDisplayKit/ASAssert.h>
+#import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASCollectionNode.h>
+#import <AsyncDisplayKit/ASDisplayTelemetry.h>
+#import <AsyncDisplayKit/ASTableNode.h>
+
+// A frame counts as dropped when it takes longer than this many refresh intervals.
+static const double ASScrollReplayDroppedFrameFactor = 1.5;
+
+static uint64_t ASScrollReplayMemoryFootprint(void)
+{
+  task_vm_info_data_t info;
+  mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+  if (task_info(mach_task_self(), TASK_VM_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) {
+    return 0;
+  }
+  return info.phys_footprint;
+}
+
+#pragma mark - ASScrollReplayStep
+
+@interface ASScrollReplayStep ()
+@property (nonatomic) ASScrollReplayStepType type;
+@property (nonatomic) CGFloat contentOffset;
+@property (nonatomic, copy, nullable) NSIndexSet *indexes;
+@property (nonatomic, copy, nullable) NSArray *items;
++ (nullable instancetype)stepWithDictionary:(NSDictionary *)dictionary;
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation;
+@end
+
+@implementation ASScrollReplayStep
+
++ (instancetype)stepWithContentOffset:(CGFloat)contentOffset
+{
+  ASScrollReplayStep *step = [[self alloc] init];
+  step.type = ASScrollReplayStepTypeContentOffset;
+  step.contentOffset = contentOffset;
+  return step;
+}
+
++ (instancetype)insertStepWithItems:(NSArray *)items atIndexes:(NSIndexSet *)indexes
+{
+  ASDisplayNodeAssert(items.count == indexes.count, @"Each inserted index needs an item.");
+  ASScrollReplayStep *step = [[self alloc] init];
+  step.type = ASScrollReplayStepTypeInsert;
+  step.items = items;
+  step.indexes = indexes;
+  return step;
+}
+
++ (instancetype)deleteStepWithIndexes:(NSIndexSet *)indexes
+{
+  ASScrollReplayStep *step = [[self alloc] init];
+  step.type = ASScrollReplayStepTypeDelete;
+  step.indexes = indexes;
+  return step;
+}
+
++ (instancetype)reloadStepWithIndexes:(NSIndexSet *)indexes
+{
+  ASScrollReplayStep *step = [[self alloc] init];
+  step.type = ASScrollReplayStepTypeReload;
+  step.indexes = indexes;
+  return step;
+}
+
+- (NSArray<NSNumber *> *)_indexArray
+{
+  NSMutableArray<NSNumber *> *indexes = [NSMutableArray arrayWithCapacity:_indexes.count];
+  [_indexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+    [indexes addObject:@(idx)];
+  }];
+  return indexes;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  switch (_type) {
+    case ASScrollReplayStepTypeContentOffset:
+      return @{ @"offset" : @(_contentOffset) };
+    case ASScrollReplayStepTypeInsert:
+      return @{ @"insert" : [self _indexArray], @"items" : _items };
+    case ASScrollReplayStepTypeDelete:
+      return @{ @"delete" : [self _indexArray] };
+    case ASScrollReplayStepTypeReload:
+      return @{ @"reload" : [self _indexArray] };
+  }
+}
+
+static NSIndexSet *ASScrollReplayIndexSetFromJSON(id object)
+{
+  if (![object isKindOfClass:[NSArray class]]) {
+    return nil;
+  }
+  NSMutableIndexSet *indexes = [NSMutableIndexSet indexSet];
+  for (id index in object) {
+    if (![index isKindOfClass:[NSNumber class]] || [index integerValue] < 0) {
+      return nil;
+    }
+    [indexes addIndex:[index unsignedIntegerValue]];
+  }
+  return indexes;
+}
+
++ (nullable instancetype)stepWithDictionary:(NSDictionary *)dictionary
+{
+  if (![dictionary isKindOfClass:[NSDictionary class]]) {
+    return nil;
+  }
+  id offset = dictionary[@"offset"];
+  if ([offset isKindOfClass:[NSNumber class]]) {
+    return [self stepWithContentOffset:[offset doubleValue]];
+  }
+  if (dictionary[@"insert"] != nil) {
+    NSIndexSet *indexes = ASScrollReplayIndexSetFromJSON(dictionary[@"insert"]);
+    NSArray *items = dictionary[@"items"];
+    if (indexes == nil || ![items isKindOfClass:[NSArray class]] || items.count != indexes.count) {
+      return nil;
+    }
+    return [self insertStepWithItems:items atIndexes:indexes];
+  }
+  if (dictionary[@"delete"] != nil) {
+    NSIndexSet *indexes = ASScrollReplayIndexSetFromJSON(dictionary[@"delete"]);
+    return (indexes != nil ? [self deleteStepWithIndexes:indexes] : nil);
+  }
+  if (dictionary[@"reload"] != nil) {
+    NSIndexSet *indexes = ASScrollReplayIndexSetFromJSON(dictionary[@"reload"]);
+    return (indexes != nil ? [self reloadStepWithIndexes:indexes] : nil);
+  }
+  return nil;
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; %@>", self.class, self, [self dictionaryRepresentation]];
+}
+
+@end
+
+#pragma mark - ASScrollReplayScript
+
+@implementation ASScrollReplayScript
+
+- (instancetype)initWithSteps:(NSArray<ASScrollReplayStep *> *)steps
+{
+  if (self = [super init]) {
+    _steps = [steps copy];
+  }
+  return self;
+}
+
++ (nullable instancetype)scriptWithJSONData:(NSData *)data error:(NSError **)error
+{
+  NSDictionary *script = [NSJSONSerialization JSONObjectWithData:data options:0 error:error];
+  if (script == nil) {
+    return nil;
+  }
+  NSArray *stepDictionaries = ([script isKindOfClass:[NSDictionary class]] ? script[@"steps"] : nil);
+  NSMutableArray<ASScrollReplayStep *> *steps = [NSMutableArray array];
+  for (NSDictionary *stepDictionary in ([stepDictionaries isKindOfClass:[NSArray class]] ? stepDictionaries : nil)) {
+    ASScrollReplayStep *step = [ASScrollReplayStep stepWithDictionary:stepDictionary];
+    if (step == nil) {
+      stepDictionaries = nil;
+      break;
+    }
+    [steps addObject:step];
+  }
+  if (![stepDictionaries isKindOfClass:[NSArray class]]) {
+    if (error != NULL) {
+      *error = [NSError errorWithDomain:NSCocoaErrorDomain code:NSPropertyListReadCorruptError userInfo:@{
+        NSLocalizedDescriptionKey : @"The data isn't a replay script."
+      }];
+    }
+    return nil;
+  }
+  return [[self alloc] initWithSteps:steps];
+}
+
++ (instancetype)flingScriptWithDistance:(CGFloat)distance frameCount:(NSUInteger)frameCount
+{
+  NSMutableArray<ASScrollReplayStep *> *steps = [NSMutableArray arrayWithCapacity:frameCount];
+  for (NSUInteger i = 1; i <= frameCount; i++) {
+    // Cubic ease-out, like a deceleration: the velocity falls to zero at the last frame.
+    double remaining = 1 - (double)i / frameCount;
+    [steps addObject:[ASScrollReplayStep stepWithContentOffset:round(distance * (1 - remaining * remaining * remaining))]];
+  }
+  return [[self alloc] initWithSteps:steps];
+}
+
+- (nullable NSData *)JSONData
+{
+  NSMutableArray<NSDictionary *> *steps = [NSMutableArray arrayWithCapacity:_steps.count];
+  for (ASScrollReplayStep *step in _steps) {
+    [steps addObject:[step dictionaryRepresentation]];
+  }
+  NSDictionary *script = @{ @"steps" : steps };
+  if (![NSJSONSerialization isValidJSONObject:script]) {
+    return nil;
+  }
+  return [NSJSONSerialization dataWithJSONObject:script options:0 error:NULL];
+}
+
+@end
+
+#pragma mark - ASScrollReplayResult
+
+@interface ASScrollReplayResult ()
+@property (nonatomic, copy) NSArray<NSNumber *> *frameDurations;
+@property (nonatomic, copy) NSArray<NSNumber *> *mainThreadBusyDurations;
+@property (nonatomic) NSUInteger droppedFrameCount;
+@property (nonatomic) NSUInteger allocatedCellCount;
+@property (nonatomic) NSUInteger layoutCount;
+@property (nonatomic) NSUInteger displayCount;
+@property (nonatomic) NSUInteger cancelledDisplayCount;
+@property (nonatomic) uint64_t peakMemoryFootprint;
+@property (nonatomic) uint64_t peakMemoryGrowth;
+@end
+
+@implementation ASScrollReplayResult
+
+- (NSTimeInterval)frameDurationAtPercentile:(double)percentile
+{
+  if (_frameDurations.count == 0) {
+    return 0;
+  }
+  NSArray<NSNumber *> *sortedDurations = [_frameDurations sortedArrayUsingSelector:@selector(compare:)];
+  NSUInteger index = (NSUInteger)ceil(MIN(MAX(percentile, 0), 1) * sortedDurations.count);
+  return sortedDurations[MAX(index, 1) - 1].doubleValue;
+}
+
+- (NSDictionary<NSString *, id> *)dictionaryRepresentation
+{
+  return @{
+    @"frameCount" : @(_frameDurations.count),
+    @"frameDurationP50" : @([self frameDurationAtPercentile:0.5]),
+    @"frameDurationP95" : @([self frameDurationAtPercentile:0.95]),
+    @"frameDurationP99" : @([self frameDurationAtPercentile:0.99]),
+    @"droppedFrameCount" : @(_droppedFrameCount),
+    @"frameDurations" : _frameDurations,
+    @"mainThreadBusyDurations" : _mainThreadBusyDurations,
+    @"allocatedCellCount" : @(_allocatedCellCount),
+    @"layoutCount" : @(_layoutCount),
+    @"displayCount" : @(_displayCount),
+    @"cancelledDisplayCount" : @(_cancelledDisplayCount),
+    @"peakMemoryFootprint" : @(_peakMemoryFootprint),
+    @"peakMemoryGrowth" : @(_peakMemoryGrowth),
+  };
+}
+
+- (NSString *)description
+{
+  return [NSString stringWithFormat:@"<%@: %p; frames = %tu, p50 = %.1fms, p95 = %.1fms, dropped = %tu, cells = %tu, layouts = %tu, displays = %tu, peak growth = %lluKB>",
+          self.class, self, _frameDurations.count, [self frameDurationAtPercentile:0.5] * 1000,
+          [self frameDurationAtPercentile:0.95] * 1000, _droppedFrameCount, _allocatedCellCount, _layoutCount,
+          _displayCount, _peakMemoryGrowth / 1024];
+}
+
+@end
+
+#pragma mark - ASScrollReplayHarness
+
+@interface ASScrollReplayHarness () <ASTableDataSource, ASCollectionDataSource>
+@end
+
+@implementation ASScrollReplayHarness {
+  UIWindow *_window;
+  NSMutableArray *_items;
+  ASScrollReplayNodeBlock _nodeBlock;
+  atomic_ulong _allocatedCellCount;
+
+  // The replay in progress.
+  NSArray<ASScrollReplayStep *> *_steps;
+  NSUInteger _nextStepIndex;
+  CFTimeInterval _lastFrameTimestamp;
+  CFTimeInterval _refreshInterval;
+  NSMutableArray<NSNumber *> *_frameDurations;
+  NSMutableArray<NSNumber *> *_busyDurations;
+  CFTimeInterval _busyStartTime;
+  CFTimeInterval _busyDuration;
+  uint64_t _peakMemoryFootprint;
+  BOOL _finished;
+}
+
+- (instancetype)initWithItems:(NSArray *)items nodeBlock:(ASScrollReplayNodeBlock)nodeBlock
+{
+  if (self = [super init]) {
+    _items = [items mutableCopy];
+    _nodeBlock = [nodeBlock copy];
+    _window = [[UIWindow alloc] initWithFrame:[UIScreen mainScreen].bounds];
+  }
+  return self;
+}
+
+- (instancetype)initWithTableNodeItems:(NSArray *)items nodeBlock:(ASScrollReplayNodeBlock)nodeBlock
+{
+  if (self = [self initWithItems:items nodeBlock:nodeBlock]) {
+    ASTableNode *tableNode = [[ASTableNode alloc] initWithStyle:UITableViewStylePlain];
+    tableNode.dataSource = self;
+    _node = tableNode;
+    [self _loadNode];
+  }
+  return self;
+}
+
+- (instancetype)initWithCollectionViewLayout:(UICollectionViewLayout *)layout items:(NSArray *)items nodeBlock:(ASScrollReplayNodeBlock)nodeBlock
+{
+  if (self = [self initWithItems:items nodeBlock:nodeBlock]) {
+    ASCollectionNode *collectionNode = [[ASCollectionNode alloc] initWithCollectionViewLayout:layout];
+    collectionNode.dataSource = self;
+    _node = collectionNode;
+    [self _loadNode];
+  }
+  return self;
+}
+
+- (void)_loadNode
+{
+  _node.frame = _window.bounds;
+  [_window addSubview:_node.view];
+  _window.hidden = NO;
+  [_node reloadData];
+  [_node waitUntilAllUpdatesAreCommitted];
+  [_node.view layoutIfNeeded];
+}
+
+- (UIScrollView *)scrollView
+{
+  return (UIScrollView *)_node.view;
+}
+
+- (NSArray *)items
+{
+  return [_items copy];
+}
+
+#pragma mark Data Source
+
+- (NSInteger)tableNode:(ASTableNode *)tableNode numberOfRowsInSection:(NSInteger)section
+{
+  return _items.count;
+}
+
+- (ASCellNodeBlock)tableNode:(ASTableNode *)tableNode nodeBlockForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+  return [self _nodeBlockForItem:_items[indexPath.row]];
+}
+
+- (NSInteger)collectionNode:(ASCollectionNode *)collectionNode numberOfItemsInSection:(NSInteger)section
+{
+  return _items.count;
+}
+
+- (ASCellNodeBlock)collectionNode:(ASCollectionNode *)collectionNode nodeBlockForItemAtIndexPath:(NSIndexPath *)indexPath
+{
+  return [self _nodeBlockForItem:_items[indexPath.item]];
+}
+
+- (ASCellNodeBlock)_nodeBlockForItem:(id)item
+{
+  ASScrollReplayNodeBlock nodeBlock = _nodeBlock;
+  atomic_ulong *allocatedCellCount = &_allocatedCellCount;
+  return ^{
+    atomic_fetch_add_explicit(allocatedCellCount, 1, memory_order_relaxed);
+    return nodeBlock(item);
+  };
+}
+
+#pragma mark Replay
+
+- (ASScrollReplayResult *)replayScript:(ASScrollReplayScript *)script
+{
+  ASDisplayNodeAssertMainThread();
+  BOOL telemetryEnabled = ASDisplayTelemetry.enabled;
+  ASDisplayTelemetry.enabled = YES;
+  NSArray<ASDisplayTelemetryRecord *> *initialRecords = [ASDisplayTelemetry snapshot];
+  atomic_store(&_allocatedCellCount, 0);
+
+  _steps = script.steps;
+  _nextStepIndex = 0;
+  _lastFrameTimestamp = 0;
+  _frameDurations = [NSMutableArray arrayWithCapacity:_steps.count];
+  _busyDurations = [NSMutableArray arrayWithCapacity:_steps.count];
+  _busyStartTime = CACurrentMediaTime();
+  _busyDuration = 0;
+  uint64_t initialMemoryFootprint = ASScrollReplayMemoryFootprint();
+  _peakMemoryFootprint = initialMemoryFootprint;
+  _finished = NO;
+
+  // The observer only runs during -replayScript:, which releases it before returning.
+  __unsafe_unretained __typeof__(self) weakSelf = self;
+  CFRunLoopObserverRef busyObserver = CFRunLoopObserverCreateWithHandler(NULL, kCFRunLoopAfterWaiting | kCFRunLoopBeforeWaiting, true, LONG_MAX, ^(CFRunLoopObserverRef observer, CFRunLoopActivity activity) {
+    [weakSelf _runLoopDidChangeActivity:activity];
+  });
+  CFRunLoopAddObserver(CFRunLoopGetMain(), busyObserver, kCFRunLoopCommonModes);
+  CADisplayLink *displayLink = [CADisplayLink displayLinkWithTarget:self selector:@selector(_displayLinkDidFire:)];
+  [displayLink addToRunLoop:[NSRunLoop mainRunLoop] forMode:NSRunLoopCommonModes];
+
+  while (!_finished) {
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate distantFuture]];
+  }
+
+  [displayLink invalidate];
+  CFRunLoopObserverInvalidate(busyObserver);
+  CFRelease(busyObserver);
+  [_node waitUntilAllUpdatesAreCommitted];
+
+  ASScrollReplayResult *result = [[ASScrollReplayResult alloc] init];
+  result.frameDurations = _frameDurations;
+  result.mainThreadBusyDurations = _busyDurations;
+  NSUInteger droppedFrameCount = 0;
+  for (NSNumber *duration in _frameDurations) {
+    if (duration.doubleValue > _refreshInterval * ASScrollReplayDroppedFrameFactor) {
+      droppedFrameCount++;
+    }
+  }
+  result.droppedFrameCount = droppedFrameCount;
+  result.allocatedCellCount = (NSUInteger)atomic_load(&_allocatedCellCount);
+  [self _addTelemetryFromRecords:[ASDisplayTelemetry snapshot] sign:1 toResult:result];
+  [self _addTelemetryFromRecords:initialRecords sign:-1 toResult:result];
+  result.peakMemoryFootprint = _peakMemoryFootprint;
+  result.peakMemoryGrowth = _peakMemoryFootprint - MIN(initialMemoryFootprint, _peakMemoryFootprint);
+
+  ASDisplayTelemetry.enabled = telemetryEnabled;
+  _steps = nil;
+  _frameDurations = nil;
+  _busyDurations = nil;
+  return result;
+}
+
+- (void)_addTelemetryFromRecords:(NSArray<ASDisplayTelemetryRecord *> *)records sign:(NSInteger)sign toResult:(ASScrollReplayResult *)result
+{
+  for (ASDisplayTelemetryRecord *record in records) {
+    result.layoutCount += sign * [record histogramForMetric:ASDisplayTelemetryMetricLayoutTime].count;
+    result.displayCount += sign * record.completedDisplayCount;
+    result.cancelledDisplayCount += sign * record.cancelledDisplayCount;
+  }
+}
+
+- (void)_runLoopDidChangeActivity:(CFRunLoopActivity)activity
+{
+  CFTimeInterval now = CACurrentMediaTime();
+  if (activity == kCFRunLoopAfterWaiting) {
+    _busyStartTime = now;
+  } else if (_busyStartTime > 0) {
+    _busyDuration += now - _busyStartTime;
+    _busyStartTime = 0;
+  }
+}
+
+- (void)_displayLinkDidFire:(CADisplayLink *)displayLink
+{
+  // The frame of the previous step ends where this one begins.
+  if (_lastFrameTimestamp > 0) {
+    [_frameDurations addObject:@(displayLink.timestamp - _lastFrameTimestamp)];
+    CFTimeInterval now = CACurrentMediaTime();
+    [_busyDurations addObject:@(_busyDuration + (_busyStartTime > 0 ? now - _busyStartTime : 0))];
+    _busyDuration = 0;
+    if (_busyStartTime > 0) {
+      _busyStartTime = now;
+    }
+    _peakMemoryFootprint = MAX(_peakMemoryFootprint, ASScrollReplayMemoryFootprint());
+  }
+  _lastFrameTimestamp = displayLink.timestamp;
+  _refreshInterval = displayLink.duration;
+
+  if (_nextStepIndex == _steps.count) {
+    _finished = YES;
+    return;
+  }
+  [self _applyStep:_steps[_nextStepIndex++]];
+}
+
+- (void)_applyStep:(ASScrollReplayStep *)step
+{
+  BOOL isTable = [_node isKindOfClass:[ASTableNode class]];
+  NSMutableArray<NSIndexPath *> *indexPaths = [NSMutableArray arrayWithCapacity:step.indexes.count];
+  [step.indexes enumerateIndexesUsingBlock:^(NSUInteger idx, BOOL *stop) {
+    [indexPaths addObject:(isTable ? [NSIndexPath indexPathForRow:idx inSection:0] : [NSIndexPath indexPathForItem:idx inSection:0])];
+  }];
+
+  switch (step.type) {
+    case ASScrollReplayStepTypeContentOffset: {
+      UIScrollView *scrollView = self.scrollView;
+      CGFloat maximumOffset = MAX(scrollView.contentSize.height + scrollView.contentInset.bottom - scrollView.bounds.size.height, 0);
+      scrollView.contentOffset = CGPointMake(scrollView.contentOffset.x, MIN(MAX(step.contentOffset, 0), maximumOffset));
+      break;
+    }
+    case ASScrollReplayStepTypeInsert:
+      [_items insertObjects:step.items atIndexes:step.indexes];
+      if (isTable) {
+        [(ASTableNode *)_node insertRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+      } else {
+        [(ASCollectionNode *)_node insertItemsAtIndexPaths:indexPaths];
+      }
+      break;
+    case ASScrollReplayStepTypeDelete:
+      [_items removeObjectsAtIndexes:step.indexes];
+      if (isTable) {
+        [(ASTableNode *)_node deleteRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+      } else {
+        [(ASCollectionNode *)_node deleteItemsAtIndexPaths:indexPaths];
+      }
+      break;
+    case ASScrollReplayStepTypeReload:
+      if (isTable) {
+        [(ASTableNode *)_node reloadRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+      } else {
+        [(ASCollectionNode *)_node reloadItemsAtIndexPaths:indexPaths];
+      }
+      break;
+  }
+}
+
+@end
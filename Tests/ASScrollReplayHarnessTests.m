@@ -0,0 +1,130 @@
+//
+//  ASScrollReplayHarnessTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import "ASScrollReplayHarness.h"
+
+#import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASCollectionNode.h>
+#import <AsyncDisplayKit/ASTableNode.h>
+
+static const NSUInteger ASScrollReplayTestItemCount = 200;
+
+@interface ASScrollReplayHarnessTests : XCTestCase
+@end
+
+@implementation ASScrollReplayHarnessTests
+
+- (NSArray<NSString *> *)items
+{
+  NSMutableArray<NSString *> *items = [NSMutableArray arrayWithCapacity:ASScrollReplayTestItemCount];
+  for (NSUInteger i = 0; i < ASScrollReplayTestItemCount; i++) {
+    [items addObject:[NSString stringWithFormat:@"Item %tu", i]];
+  }
+  return items;
+}
+
+- (ASScrollReplayNodeBlock)nodeBlock
+{
+  return ^ASCellNode *(NSString *item) {
+    ASTextCellNode *node = [[ASTextCellNode alloc] init];
+    node.text = item;
+    return node;
+  };
+}
+
+- (void)testThatScriptsRoundTripThroughJSON
+{
+  NSData *data = [@"{\"steps\": [{\"offset\": 120}, {\"insert\": [0, 1], \"items\": [\"a\", \"b\"]}, {\"delete\": [3]}, {\"reload\": [4]}]}" dataUsingEncoding:NSUTF8StringEncoding];
+  NSError *error = nil;
+  ASScrollReplayScript *script = [ASScrollReplayScript scriptWithJSONData:data error:&error];
+  XCTAssertNotNil(script, @"%@", error);
+  XCTAssertEqual(script.steps.count, 4);
+  XCTAssertEqual(script.steps[0].type, ASScrollReplayStepTypeContentOffset);
+  XCTAssertEqual(script.steps[0].contentOffset, 120);
+  XCTAssertEqual(script.steps[1].type, ASScrollReplayStepTypeInsert);
+  XCTAssertEqualObjects(script.steps[1].items, (@[ @"a", @"b" ]));
+  XCTAssertEqualObjects(script.steps[1].indexes, [NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]);
+  XCTAssertEqual(script.steps[2].type, ASScrollReplayStepTypeDelete);
+  XCTAssertEqual(script.steps[3].type, ASScrollReplayStepTypeReload);
+  XCTAssertEqualObjects(script.steps[3].indexes, [NSIndexSet indexSetWithIndex:4]);
+
+  ASScrollReplayScript *roundTrippedScript = [ASScrollReplayScript scriptWithJSONData:[script JSONData] error:NULL];
+  XCTAssertEqualObjects([roundTrippedScript JSONData], [script JSONData]);
+}
+
+- (void)testThatMalformedScriptsAreRejected
+{
+  NSError *error = nil;
+  NSData *data = [@"{\"steps\": [{\"insert\": [0]}]}" dataUsingEncoding:NSUTF8StringEncoding];
+  XCTAssertNil([ASScrollReplayScript scriptWithJSONData:data error:&error]);
+  XCTAssertNotNil(error);
+  XCTAssertNil([ASScrollReplayScript scriptWithJSONData:[@"[]" dataUsingEncoding:NSUTF8StringEncoding] error:NULL]);
+}
+
+- (void)testThatFlingScriptsDecelerateToTheDistance
+{
+  ASScrollReplayScript *script = [ASScrollReplayScript flingScriptWithDistance:1000 frameCount:20];
+  XCTAssertEqual(script.steps.count, 20);
+  XCTAssertEqual(script.steps.lastObject.contentOffset, 1000);
+  CGFloat firstDelta = script.steps[1].contentOffset - script.steps[0].contentOffset;
+  CGFloat lastDelta = script.steps[19].contentOffset - script.steps[18].contentOffset;
+  XCTAssertGreaterThan(firstDelta, lastDelta);
+}
+
+- (void)testThatTableReplaysAreMeasured
+{
+  ASScrollReplayHarness *harness = [[ASScrollReplayHarness alloc] initWithTableNodeItems:[self items] nodeBlock:[self nodeBlock]];
+  ASScrollReplayScript *script = [ASScrollReplayScript flingScriptWithDistance:2000 frameCount:30];
+  ASScrollReplayResult *result = [harness replayScript:script];
+
+  XCTAssertEqual(result.frameDurations.count, 30);
+  XCTAssertEqual(result.mainThreadBusyDurations.count, 30);
+  XCTAssertGreaterThan([result frameDurationAtPercentile:0.5], 0);
+  XCTAssertLessThanOrEqual([result frameDurationAtPercentile:0.5], [result frameDurationAtPercentile:0.95]);
+  XCTAssertGreaterThan(result.peakMemoryFootprint, 0);
+  XCTAssertEqual(harness.scrollView.contentOffset.y, 2000);
+  XCTAssertTrue([NSJSONSerialization isValidJSONObject:[result dictionaryRepresentation]]);
+}
+
+- (void)testThatReplayedUpdatesAreCountedAndApplied
+{
+  ASScrollReplayHarness *harness = [[ASScrollReplayHarness alloc] initWithTableNodeItems:[self items] nodeBlock:[self nodeBlock]];
+  ASScrollReplayScript *script = [[ASScrollReplayScript alloc] initWithSteps:@[
+    [ASScrollReplayStep insertStepWithItems:@[ @"New 0", @"New 1" ] atIndexes:[NSIndexSet indexSetWithIndexesInRange:NSMakeRange(0, 2)]],
+    [ASScrollReplayStep deleteStepWithIndexes:[NSIndexSet indexSetWithIndex:5]],
+    [ASScrollReplayStep reloadStepWithIndexes:[NSIndexSet indexSetWithIndex:3]],
+  ]];
+  ASScrollReplayResult *result = [harness replayScript:script];
+
+  ASTableNode *tableNode = harness.node;
+  XCTAssertEqual([tableNode numberOfRowsInSection:0], ASScrollReplayTestItemCount + 1);
+  XCTAssertEqualObjects(harness.items[0], @"New 0");
+  XCTAssertEqualObjects(((ASTextCellNode *)[tableNode nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:1 inSection:0]]).text, @"New 1");
+  // Two inserted cells and one reloaded cell.
+  XCTAssertEqual(result.allocatedCellCount, 3);
+  XCTAssertGreaterThanOrEqual(result.layoutCount, 3);
+}
+
+- (void)testThatCollectionReplaysAreMeasured
+{
+  UICollectionViewFlowLayout *layout = [[UICollectionViewFlowLayout alloc] init];
+  ASScrollReplayHarness *harness = [[ASScrollReplayHarness alloc] initWithCollectionViewLayout:layout items:[self items] nodeBlock:[self nodeBlock]];
+  NSMutableArray<ASScrollReplayStep *> *steps = [[ASScrollReplayScript flingScriptWithDistance:1500 frameCount:20].steps mutableCopy];
+  [steps insertObject:[ASScrollReplayStep deleteStepWithIndexes:[NSIndexSet indexSetWithIndex:0]] atIndex:10];
+  ASScrollReplayResult *result = [harness replayScript:[[ASScrollReplayScript alloc] initWithSteps:steps]];
+
+  XCTAssertEqual(result.frameDurations.count, 21);
+  XCTAssertEqual([(ASCollectionNode *)harness.node numberOfItemsInSection:0], ASScrollReplayTestItemCount - 1);
+  XCTAssertGreaterThan(result.displayCount + result.cancelledDisplayCount, 0);
+}
+
+@end
@@ -0,0 +1,309 @@
+//
+//  ASSnapshotTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASSnapshot.h>
+
+static ASSnapshot *ASSnapshotMake(NSArray *sections, NSArray<NSArray *> *items, NSArray<NSArray<NSNumber *> *> *hashes)
+{
+  return [[ASSnapshot alloc] initWithSectionIdentifiers:sections itemIdentifiers:items contentHashes:hashes];
+}
+
+@interface ASSnapshotTests : XCTestCase
+@end
+
+@implementation ASSnapshotTests
+
+/**
+ * Applies the diff to the old snapshot the way a batch update does, with moves as a delete and an insert, and checks
+ * that the result is the new snapshot and that exactly the items that stayed put with different content are reloaded.
+ */
+- (void)assertDiffFromSnapshot:(ASSnapshot *)from toSnapshot:(ASSnapshot *)to
+{
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+
+  NSMutableIndexSet *removedSections = [diff.deletedSections mutableCopy];
+  NSMutableIndexSet *addedSections = [diff.insertedSections mutableCopy];
+  [diff.movedSections enumerateKeysAndObjectsUsingBlock:^(NSNumber *oldSection, NSNumber *newSection, BOOL *stop) {
+    [removedSections addIndex:oldSection.integerValue];
+    [addedSections addIndex:newSection.integerValue];
+  }];
+
+  NSMutableIndexSet *keptSections = [NSMutableIndexSet indexSetWithIndexesInRange:NSMakeRange(0, from.numberOfSections)];
+  [keptSections removeIndexes:removedSections];
+  XCTAssertEqual(keptSections.count + addedSections.count, to.numberOfSections);
+
+  NSMutableDictionary<NSNumber *, NSMutableIndexSet *> *removedItems = [NSMutableDictionary dictionary];
+  NSMutableDictionary<NSNumber *, NSMutableIndexSet *> *addedItems = [NSMutableDictionary dictionary];
+  void (^addIndexPath)(NSMutableDictionary *, NSIndexPath *) = ^(NSMutableDictionary *indexes, NSIndexPath *indexPath) {
+    NSMutableIndexSet *set = indexes[@(indexPath.section)] ?: (indexes[@(indexPath.section)] = [NSMutableIndexSet indexSet]);
+    XCTAssertFalse([set containsIndex:indexPath.item], @"Index path %@ is changed twice", indexPath);
+    [set addIndex:indexPath.item];
+  };
+  for (NSIndexPath *indexPath in diff.deletedItems) {
+    addIndexPath(removedItems, indexPath);
+  }
+  for (NSIndexPath *indexPath in diff.insertedItems) {
+    addIndexPath(addedItems, indexPath);
+  }
+  [diff.movedItems enumerateKeysAndObjectsUsingBlock:^(NSIndexPath *oldIndexPath, NSIndexPath *newIndexPath, BOOL *stop) {
+    addIndexPath(removedItems, oldIndexPath);
+    addIndexPath(addedItems, newIndexPath);
+  }];
+  NSMutableSet<NSIndexPath *> *reloadedItems = [NSMutableSet setWithArray:diff.reloadedItems];
+  XCTAssertEqual(reloadedItems.count, diff.reloadedItems.count);
+
+  NSUInteger oldSection = keptSections.firstIndex;
+  for (NSInteger section = 0; section < to.numberOfSections; section++) {
+    if ([addedSections containsIndex:section]) {
+      XCTAssertNil(addedItems[@(section)], @"Items inserted into inserted section %ld", (long)section);
+      continue;
+    }
+    XCTAssertEqualObjects(from.sectionIdentifiers[oldSection], to.sectionIdentifiers[section]);
+
+    NSMutableArray *items = [NSMutableArray array];
+    NSMutableArray<NSIndexPath *> *oldIndexPaths = [NSMutableArray array];
+    NSIndexSet *removed = removedItems[@(oldSection)];
+    for (NSInteger item = 0; item < [from numberOfItemsInSection:oldSection]; item++) {
+      if (![removed containsIndex:item]) {
+        [items addObject:from.itemIdentifiers[oldSection][item]];
+        [oldIndexPaths addObject:[NSIndexPath indexPathForItem:item inSection:oldSection]];
+      }
+    }
+    [addedItems[@(section)] enumerateIndexesUsingBlock:^(NSUInteger item, BOOL *stop) {
+      [items insertObject:to.itemIdentifiers[section][item] atIndex:item];
+      [oldIndexPaths insertObject:(NSIndexPath *)[NSNull null] atIndex:item];
+    }];
+    XCTAssertEqualObjects(items, to.itemIdentifiers[section]);
+
+    for (NSInteger item = 0; item < (NSInteger)oldIndexPaths.count && item < [to numberOfItemsInSection:section]; item++) {
+      NSIndexPath *oldIndexPath = oldIndexPaths[item];
+      if ((id)oldIndexPath == [NSNull null]) {
+        continue;
+      }
+      BOOL changed = (from.contentHashes != nil && to.contentHashes != nil
+                      && ![from.contentHashes[oldIndexPath.section][oldIndexPath.item] isEqual:to.contentHashes[section][item]]);
+      XCTAssertEqual([reloadedItems containsObject:oldIndexPath], changed, @"Reload of %@", oldIndexPath);
+      [reloadedItems removeObject:oldIndexPath];
+    }
+    oldSection = [keptSections indexGreaterThanIndex:oldSection];
+  }
+  XCTAssertEqual(reloadedItems.count, 0, @"Reloaded items that didn't stay put: %@", reloadedItems);
+
+  for (NSNumber *section in removedItems) {
+    XCTAssertFalse([removedSections containsIndex:section.integerValue], @"Items deleted from deleted section %@", section);
+  }
+}
+
+- (void)testThatIdenticalSnapshotsHaveAnEmptyDiff
+{
+  ASSnapshot *snapshot = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B" ] ], @[ @[ @1, @2 ] ]);
+  ASSnapshot *copy = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B" ] ], @[ @[ @1, @2 ] ]);
+  XCTAssertTrue([ASSnapshotDiff diffFromSnapshot:snapshot toSnapshot:copy].isEmpty);
+}
+
+- (void)testThatInsertedAndDeletedItemsAreFound
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B", @"C", @"D" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"C", @"E", @"D" ] ], nil);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  XCTAssertEqualObjects(diff.deletedItems, @[ [NSIndexPath indexPathForItem:1 inSection:0] ]);
+  XCTAssertEqualObjects(diff.insertedItems, @[ [NSIndexPath indexPathForItem:2 inSection:0] ]);
+  XCTAssertEqual(diff.movedItems.count, 0);
+  XCTAssertEqual(diff.reloadedItems.count, 0);
+}
+
+- (void)testThatChangedContentIsReloaded
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B", @"C" ] ], @[ @[ @1, @2, @3 ] ]);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S" ], @[ @[ @"X", @"A", @"B", @"C" ] ], @[ @[ @0, @1, @5, @3 ] ]);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  // Reloads are addressed by index path before the update.
+  XCTAssertEqualObjects(diff.reloadedItems, @[ [NSIndexPath indexPathForItem:1 inSection:0] ]);
+  [self assertDiffFromSnapshot:from toSnapshot:to];
+}
+
+- (void)testThatItemsMovingBetweenSectionsAreMoved
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S0", @"S1" ], @[ @[ @"A", @"B" ], @[ @"C" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S0", @"S1" ], @[ @[ @"A" ], @[ @"B", @"C" ] ], nil);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  XCTAssertEqualObjects(diff.movedItems, @{ [NSIndexPath indexPathForItem:1 inSection:0] : [NSIndexPath indexPathForItem:0 inSection:1] });
+  XCTAssertEqual(diff.insertedItems.count, 0);
+  XCTAssertEqual(diff.deletedItems.count, 0);
+}
+
+- (void)testThatMovingOneItemToTheTopOnlyMovesThatItem
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B", @"C", @"D", @"E" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S" ], @[ @[ @"E", @"A", @"B", @"C", @"D" ] ], nil);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  XCTAssertEqualObjects(diff.movedItems, @{ [NSIndexPath indexPathForItem:4 inSection:0] : [NSIndexPath indexPathForItem:0 inSection:0] });
+  XCTAssertEqual(diff.insertedItems.count, 0);
+  XCTAssertEqual(diff.deletedItems.count, 0);
+  [self assertDiffFromSnapshot:from toSnapshot:to];
+}
+
+- (void)testThatMovingOneSectionToTheTopOnlyMovesThatSection
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S0", @"S1", @"S2", @"S3" ], @[ @[ @"A" ], @[ @"B" ], @[ @"C" ], @[ @"D" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S3", @"S0", @"S1", @"S2" ], @[ @[ @"D" ], @[ @"A" ], @[ @"B" ], @[ @"C" ] ], nil);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  XCTAssertEqualObjects(diff.movedSections, @{ @3 : @0 });
+  XCTAssertEqual(diff.movedItems.count, 0);
+  [self assertDiffFromSnapshot:from toSnapshot:to];
+}
+
+- (void)testThatSectionChangesCoverTheirItems
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S0", @"S1", @"S2", @"S3" ], @[ @[ @"A" ], @[ @"B", @"C" ], @[ @"D" ], @[ @"F" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S0", @"S3", @"S2", @"S4" ], @[ @[ @"A", @"B" ], @[ @"F" ], @[ @"D" ], @[ @"E" ] ], nil);
+  ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+  XCTAssertEqualObjects(diff.deletedSections, [NSIndexSet indexSetWithIndex:1]);
+  XCTAssertEqualObjects(diff.insertedSections, [NSIndexSet indexSetWithIndex:3]);
+  // S2 and S3 swap places; only one of them needs to move.
+  XCTAssertEqualObjects(diff.movedSections, (@{ @3 : @1 }));
+  // B leaves the deleted section for one that stays put, so it's inserted there; C goes with S1.
+  XCTAssertEqualObjects(diff.insertedItems, @[ [NSIndexPath indexPathForItem:1 inSection:0] ]);
+  XCTAssertEqual(diff.deletedItems.count, 0);
+  XCTAssertEqual(diff.movedItems.count, 0);
+  [self assertDiffFromSnapshot:from toSnapshot:to];
+}
+
+- (void)testThatRandomDiffsApplyCleanly
+{
+  srandom(38);
+  NSInteger nextItem = 0, nextSection = 0;
+  for (NSInteger trial = 0; trial < 200; trial++) {
+    NSMutableArray *sections = [NSMutableArray array];
+    NSMutableArray<NSMutableArray *> *items = [NSMutableArray array];
+    NSMutableArray<NSMutableArray *> *hashes = [NSMutableArray array];
+    NSInteger sectionCount = random() % 5;
+    for (NSInteger section = 0; section < sectionCount; section++) {
+      [sections addObject:@(nextSection++)];
+      NSMutableArray *sectionItems = [NSMutableArray array];
+      NSMutableArray *sectionHashes = [NSMutableArray array];
+      for (NSInteger item = random() % 8; item > 0; item--) {
+        [sectionItems addObject:@(nextItem++)];
+        [sectionHashes addObject:@(random() % 2)];
+      }
+      [items addObject:sectionItems];
+      [hashes addObject:sectionHashes];
+    }
+    ASSnapshot *from = ASSnapshotMake(sections, items, hashes);
+
+    // Shuffle sections, then delete, insert, move items around and change their content.
+    for (NSInteger i = 0; i < sectionCount && random() % 2; i++) {
+      NSUInteger a = random() % sections.count, b = random() % sections.count;
+      [sections exchangeObjectAtIndex:a withObjectAtIndex:b];
+      [items exchangeObjectAtIndex:a withObjectAtIndex:b];
+      [hashes exchangeObjectAtIndex:a withObjectAtIndex:b];
+    }
+    if (sections.count > 0 && random() % 3 == 0) {
+      NSUInteger section = random() % sections.count;
+      [sections removeObjectAtIndex:section];
+      [items removeObjectAtIndex:section];
+      [hashes removeObjectAtIndex:section];
+    }
+    if (random() % 3 == 0) {
+      NSUInteger section = random() % (sections.count + 1);
+      [sections insertObject:@(nextSection++) atIndex:section];
+      [items insertObject:[NSMutableArray arrayWithObject:@(nextItem++)] atIndex:section];
+      [hashes insertObject:[NSMutableArray arrayWithObject:@0] atIndex:section];
+    }
+    for (NSInteger change = random() % 6; change > 0 && sections.count > 0; change--) {
+      NSUInteger section = random() % sections.count;
+      NSMutableArray *sectionItems = items[section];
+      NSMutableArray *sectionHashes = hashes[section];
+      NSUInteger item = sectionItems.count > 0 ? random() % sectionItems.count : 0;
+      switch (random() % 4) {
+        case 0:
+          [sectionItems insertObject:@(nextItem++) atIndex:item];
+          [sectionHashes insertObject:@0 atIndex:item];
+          break;
+        case 1:
+          if (sectionItems.count > 0) {
+            [sectionItems removeObjectAtIndex:item];
+            [sectionHashes removeObjectAtIndex:item];
+          }
+          break;
+        case 2:
+          if (sectionItems.count > 0) {
+            id identifier = sectionItems[item];
+            id hash = sectionHashes[item];
+            [sectionItems removeObjectAtIndex:item];
+            [sectionHashes removeObjectAtIndex:item];
+            NSUInteger destination = random() % sections.count;
+            NSUInteger index = random() % (items[destination].count + 1);
+            [items[destination] insertObject:identifier atIndex:index];
+            [hashes[destination] insertObject:hash atIndex:index];
+          }
+          break;
+        default:
+          if (sectionItems.count > 0) {
+            sectionHashes[item] = @(2 + random() % 2);
+          }
+          break;
+      }
+    }
+    ASSnapshot *to = ASSnapshotMake(sections, items, hashes);
+    [self assertDiffFromSnapshot:from toSnapshot:to];
+  }
+}
+
+- (void)testThatAsynchronousDiffsCompleteOnTheMainThread
+{
+  ASSnapshot *from = ASSnapshotMake(@[ @"S" ], @[ @[ @"A" ] ], nil);
+  ASSnapshot *to = ASSnapshotMake(@[ @"S" ], @[ @[ @"A", @"B" ] ], nil);
+  XCTestExpectation *expectation = [self expectationWithDescription:@"diff"];
+  [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to completion:^(ASSnapshotDiff *diff) {
+    XCTAssertTrue([NSThread isMainThread]);
+    XCTAssertEqual(diff.insertedItems.count, 1);
+    [expectation fulfill];
+  }];
+  [self waitForExpectationsWithTimeout:5 handler:nil];
+}
+
+- (void)testPerformanceOfDiffingLargeSnapshots
+{
+  NSMutableArray *sections = [NSMutableArray array];
+  NSMutableArray *fromItems = [NSMutableArray array];
+  NSMutableArray *toItems = [NSMutableArray array];
+  NSMutableArray *fromHashes = [NSMutableArray array];
+  NSMutableArray *toHashes = [NSMutableArray array];
+  for (NSInteger section = 0; section < 10; section++) {
+    [sections addObject:@(section)];
+    NSMutableArray *sectionFromItems = [NSMutableArray array];
+    NSMutableArray *sectionToItems = [NSMutableArray array];
+    NSMutableArray *sectionFromHashes = [NSMutableArray array];
+    NSMutableArray *sectionToHashes = [NSMutableArray array];
+    for (NSInteger item = 0; item < 1000; item++) {
+      NSNumber *identifier = @(section * 1000 + item);
+      [sectionFromItems addObject:identifier];
+      [sectionFromHashes addObject:@0];
+      // Every hundredth item is replaced, and the one after it changes.
+      [sectionToItems addObject:(item % 100 == 0) ? @(-identifier.integerValue - 1) : identifier];
+      [sectionToHashes addObject:@(item % 100 == 1)];
+    }
+    [fromItems addObject:sectionFromItems];
+    [toItems addObject:sectionToItems];
+    [fromHashes addObject:sectionFromHashes];
+    [toHashes addObject:sectionToHashes];
+  }
+  ASSnapshot *from = ASSnapshotMake(sections, fromItems, fromHashes);
+  ASSnapshot *to = ASSnapshotMake(sections, toItems, toHashes);
+  [self measureBlock:^{
+    ASSnapshotDiff *diff = [ASSnapshotDiff diffFromSnapshot:from toSnapshot:to];
+    XCTAssertEqual(diff.reloadedItems.count, 100);
+  }];
+}
+
+@end
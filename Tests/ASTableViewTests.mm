@@ -15,6 +15,8 @@
 #import <AsyncDisplayKit/ASTableViewInternal.h>
 #import <AsyncDisplayKit/ASDisplayNode+Subclasses.h>
 #import <AsyncDisplayKit/ASCellNode.h>
+#import <AsyncDisplayKit/ASCellNode+Internal.h>
+#import <AsyncDisplayKit/ASCellNodeReusePool.h>
 #import <AsyncDisplayKit/ASTableNode.h>
 #import <AsyncDisplayKit/ASTableView+Undeprecated.h>
 #import <JGMethodSwizzler/JGMethodSwizzler.h>
@@ -212,6 +214,72 @@
 
 @end
 
+@interface ASTableViewReusableCellNode : ASCellNode
+@end
+
+@implementation ASTableViewReusableCellNode
+@end
+
+@interface ASTableViewReusingDataSource : NSObject <ASTableDataSource, ASTableDelegate>
+@property (nonatomic, assign) NSInteger rowCount;
+@end
+
+@implementation ASTableViewReusingDataSource
+
+- (NSInteger)tableNode:(ASTableNode *)tableNode numberOfRowsInSection:(NSInteger)section
+{
+  return _rowCount;
+}
+
+- (ASCellNodeBlock)tableNode:(ASTableNode *)tableNode nodeBlockForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+  return ^{
+    return [[ASCellNode alloc] init];
+  };
+}
+
+- (Class)tableNode:(ASTableNode *)tableNode reusableNodeClassForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+  return [ASTableViewReusableCellNode class];
+}
+
+- (ASCellNodeConfigurationBlock)tableNode:(ASTableNode *)tableNode nodeConfigurationBlockForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+  return ^(ASCellNode *node) {
+    node.style.preferredSize = CGSizeMake(100, 44);
+  };
+}
+
+@end
+
+@interface ASTableViewSnapshotDataSource : NSObject <ASTableDataSource>
+@property (nonatomic, strong) ASSnapshot *snapshot;
+@end
+
+@implementation ASTableViewSnapshotDataSource
+
+- (NSInteger)numberOfSectionsInTableNode:(ASTableNode *)tableNode
+{
+  return _snapshot.numberOfSections;
+}
+
+- (NSInteger)tableNode:(ASTableNode *)tableNode numberOfRowsInSection:(NSInteger)section
+{
+  return [_snapshot numberOfItemsInSection:section];
+}
+
+- (ASCellNodeBlock)tableNode:(ASTableNode *)tableNode nodeBlockForRowAtIndexPath:(NSIndexPath *)indexPath
+{
+  NSString *identifier = (NSString *)_snapshot.itemIdentifiers[indexPath.section][indexPath.row];
+  return ^{
+    ASTextCellNode *node = [[ASTextCellNode alloc] init];
+    node.text = identifier;
+    return node;
+  };
+}
+
+@end
+
 @interface ASTableViewTests : XCTestCase
 @property (nonatomic, retain) ASTableView *testTableView;
 @end
@@ -825,6 +893,114 @@
   XCTAssertEqual(node.view.contentOffset.y, 10);
 }
 
+- (void)testThatNodesOfDeletedRowsAreReusedByAnotherTableWithItsOwnWiring
+{
+  ASTableViewReusingDataSource *invertedDataSource = [[ASTableViewReusingDataSource alloc] init];
+  invertedDataSource.rowCount = 3;
+  ASTableNode *invertedNode = [[ASTableNode alloc] initWithStyle:UITableViewStylePlain];
+  invertedNode.frame = CGRectMake(0, 0, 100, 400);
+  invertedNode.inverted = YES;
+  invertedNode.dataSource = invertedDataSource;
+  invertedNode.delegate = invertedDataSource;
+
+  ASTableViewReusingDataSource *dataSource = [[ASTableViewReusingDataSource alloc] init];
+  ASTableNode *node = [[ASTableNode alloc] initWithStyle:UITableViewStylePlain];
+  node.frame = CGRectMake(0, 0, 100, 400);
+  node.dataSource = dataSource;
+  node.delegate = dataSource;
+
+  ASCellNodeReusePool *pool = invertedNode.view.dataController.nodeReusePool;
+  node.view.dataController.nodeReusePool = pool;
+  [invertedNode waitUntilAllUpdatesAreCommitted];
+  [node waitUntilAllUpdatesAreCommitted];
+
+  NSArray<NSIndexPath *> *indexPaths = @[ [NSIndexPath indexPathForRow:0 inSection:0],
+                                          [NSIndexPath indexPathForRow:1 inSection:0],
+                                          [NSIndexPath indexPathForRow:2 inSection:0] ];
+  NSMutableSet<ASCellNode *> *deletedNodes = [NSMutableSet set];
+  for (NSIndexPath *indexPath in indexPaths) {
+    ASCellNode *cellNode = [invertedNode nodeForRowAtIndexPath:indexPath];
+    XCTAssertEqual((id)cellNode.interactionDelegate, (id)invertedNode.view);
+    XCTAssertTrue(CATransform3DEqualToTransform(cellNode.transform, CATransform3DMakeScale(1, -1, 1)));
+    [deletedNodes addObject:cellNode];
+  }
+
+  invertedDataSource.rowCount = 0;
+  [invertedNode deleteRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+  [invertedNode waitUntilAllUpdatesAreCommitted];
+  XCTAssertEqual([pool countOfNodesOfClass:[ASTableViewReusableCellNode class]], 3);
+  for (ASCellNode *cellNode in deletedNodes) {
+    XCTAssertNil(cellNode.interactionDelegate);
+  }
+
+  dataSource.rowCount = 3;
+  [node insertRowsAtIndexPaths:indexPaths withRowAnimation:UITableViewRowAnimationNone];
+  [node waitUntilAllUpdatesAreCommitted];
+  XCTAssertEqual([pool countOfNodesOfClass:[ASTableViewReusableCellNode class]], 0);
+  XCTAssertEqual(pool.metrics.reusedNodeCount, 3);
+  for (NSIndexPath *indexPath in indexPaths) {
+    ASCellNode *cellNode = [node nodeForRowAtIndexPath:indexPath];
+    XCTAssertTrue([deletedNodes containsObject:cellNode]);
+    XCTAssertEqual((id)cellNode.interactionDelegate, (id)node.view);
+    XCTAssertTrue(CATransform3DIsIdentity(cellNode.transform));
+  }
+}
+
+- (void)applySnapshot:(ASSnapshot *)snapshot toTableNode:(ASTableNode *)node dataSource:(ASTableViewSnapshotDataSource *)dataSource
+{
+  __block BOOL updated = NO;
+  __block BOOL completed = NO;
+  [node applySnapshot:snapshot animated:NO updates:^{
+    XCTAssertFalse(completed);
+    dataSource.snapshot = snapshot;
+    updated = YES;
+  } completion:^(BOOL finished) {
+    XCTAssertTrue(updated);
+    // The batch update has been committed to the table view by now.
+    XCTAssertEqual([node.view numberOfRowsInSection:0], [snapshot numberOfItemsInSection:0]);
+    completed = YES;
+  }];
+  NSDate *timeout = [NSDate dateWithTimeIntervalSinceNow:5];
+  while (!completed && [timeout timeIntervalSinceNow] > 0) {
+    [[NSRunLoop mainRunLoop] runMode:NSDefaultRunLoopMode beforeDate:[NSDate dateWithTimeIntervalSinceNow:0.01]];
+  }
+  XCTAssertTrue(completed);
+  XCTAssertEqual(node.currentSnapshot, snapshot);
+}
+
+- (void)testThatApplyingSnapshotsUpdatesRowsAndKeepsTheNodesOfUnchangedRows
+{
+  ASTableViewSnapshotDataSource *dataSource = [[ASTableViewSnapshotDataSource alloc] init];
+  ASTableNode *node = [[ASTableNode alloc] initWithStyle:UITableViewStylePlain];
+  node.frame = CGRectMake(0, 0, 100, 400);
+  node.dataSource = dataSource;
+  [node view];
+
+  ASSnapshot *first = [[ASSnapshot alloc] initWithSectionIdentifiers:@[ @"section" ]
+                                                      itemIdentifiers:@[ @[ @"a", @"b", @"c" ] ]
+                                                        contentHashes:nil];
+  [self applySnapshot:first toTableNode:node dataSource:dataSource];
+  ASCellNode *nodeA = [node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:0 inSection:0]];
+  ASCellNode *nodeC = [node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:0]];
+  XCTAssertEqualObjects(((ASTextCellNode *)nodeA).text, @"a");
+  XCTAssertEqualObjects(((ASTextCellNode *)nodeC).text, @"c");
+
+  // Deletes "b" and inserts "d" in front; "a" and "c" stay put.
+  ASSnapshot *second = [[ASSnapshot alloc] initWithSectionIdentifiers:@[ @"section" ]
+                                                       itemIdentifiers:@[ @[ @"d", @"a", @"c" ] ]
+                                                         contentHashes:nil];
+  [self applySnapshot:second toTableNode:node dataSource:dataSource];
+
+  NSArray<NSString *> *expectedTexts = @[ @"d", @"a", @"c" ];
+  XCTAssertEqual([node numberOfRowsInSection:0], (NSInteger)expectedTexts.count);
+  for (NSInteger row = 0; row < (NSInteger)expectedTexts.count; row++) {
+    ASTextCellNode *cellNode = (ASTextCellNode *)[node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:row inSection:0]];
+    XCTAssertEqualObjects(cellNode.text, expectedTexts[row]);
+  }
+  XCTAssertEqual([node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:1 inSection:0]], nodeA, @"Rows that didn't change shouldn't get new nodes");
+  XCTAssertEqual([node nodeForRowAtIndexPath:[NSIndexPath indexPathForRow:2 inSection:0]], nodeC, @"Rows that didn't change shouldn't get new nodes");
+}
+
 @end
 
 @implementation UITableView (Testing)
@@ -0,0 +1,118 @@
+//
+//  ASTextKitRasterCacheTests.mm
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+
+#import <AsyncDisplayKit/ASTextKitAttributes.h>
+#import <AsyncDisplayKit/ASTextKitRasterCache.h>
+#import <AsyncDisplayKit/ASTextKitRenderer.h>
+
+@interface ASTextKitRasterCacheTests : XCTestCase
+
+@end
+
+static ASTextKitAttributes attributesWithString(NSString *string)
+{
+  return {
+    .attributedString = [[NSAttributedString alloc] initWithString:string attributes:@{ NSFontAttributeName : [UIFont systemFontOfSize:14] }],
+    .lineBreakMode = NSLineBreakByWordWrapping,
+  };
+}
+
+@implementation ASTextKitRasterCacheTests
+
+- (UIImage *)imageFromCache:(ASTextKitRasterCache *)cache attributes:(ASTextKitAttributes)attributes size:(CGSize)size rendererCalls:(NSUInteger *)rendererCalls
+{
+  return [cache imageForAttributes:attributes constrainedSize:size contentsScale:2 rendererBlock:^{
+    (*rendererCalls)++;
+    return [[ASTextKitRenderer alloc] initWithTextKitAttributes:attributes constrainedSize:size];
+  }];
+}
+
+- (void)testSecondRequestIsServedFromCacheWithoutRenderer
+{
+  ASTextKitRasterCache *cache = [[ASTextKitRasterCache alloc] initWithByteLimit:1024 * 1024];
+  ASTextKitAttributes attributes = attributesWithString(@"Hello, world");
+  CGSize size = CGSizeMake(100, 20);
+  NSUInteger rendererCalls = 0;
+
+  UIImage *first = [self imageFromCache:cache attributes:attributes size:size rendererCalls:&rendererCalls];
+  UIImage *second = [self imageFromCache:cache attributes:attributes size:size rendererCalls:&rendererCalls];
+
+  XCTAssertNotNil(first);
+  XCTAssertEqual(first, second);
+  XCTAssertEqual(rendererCalls, 1);
+  XCTAssertEqual(first.scale, 2);
+
+  ASTextNodeRasterCacheMetrics metrics = [cache metrics];
+  XCTAssertEqual(metrics.hitCount, 1);
+  XCTAssertEqual(metrics.missCount, 1);
+  XCTAssertEqual(metrics.imageCount, 1);
+  XCTAssertGreaterThanOrEqual(metrics.byteCount, 200 * 40 * 4);
+}
+
+- (void)testDifferentContentsScaleOrShadowMisses
+{
+  ASTextKitRasterCache *cache = [[ASTextKitRasterCache alloc] initWithByteLimit:1024 * 1024];
+  ASTextKitAttributes attributes = attributesWithString(@"Hello, world");
+  CGSize size = CGSizeMake(100, 20);
+  NSUInteger rendererCalls = 0;
+
+  [self imageFromCache:cache attributes:attributes size:size rendererCalls:&rendererCalls];
+  XCTAssertNil([cache imageForAttributes:attributes constrainedSize:size contentsScale:3]);
+
+  ASTextKitAttributes shadowed = attributes;
+  shadowed.shadowRadius = 2;
+  shadowed.shadowOpacity = 0.5;
+  shadowed.shadowColor = [UIColor blackColor];
+  XCTAssertNil([cache imageForAttributes:shadowed constrainedSize:size contentsScale:2]);
+  XCTAssertNotNil([cache imageForAttributes:attributes constrainedSize:size contentsScale:2]);
+}
+
+- (void)testLeastRecentlyUsedImageIsEvictedAtByteLimit
+{
+  CGSize size = CGSizeMake(100, 20);
+  // Room for two 200x40 RGBA bitmaps, with slack for row padding.
+  ASTextKitRasterCache *cache = [[ASTextKitRasterCache alloc] initWithByteLimit:2 * 200 * 40 * 4 + 1024];
+  NSUInteger rendererCalls = 0;
+
+  ASTextKitAttributes a = attributesWithString(@"A");
+  ASTextKitAttributes b = attributesWithString(@"B");
+  ASTextKitAttributes c = attributesWithString(@"C");
+  [self imageFromCache:cache attributes:a size:size rendererCalls:&rendererCalls];
+  [self imageFromCache:cache attributes:b size:size rendererCalls:&rendererCalls];
+  // Touch A so that B becomes the least recently used entry.
+  XCTAssertNotNil([cache imageForAttributes:a constrainedSize:size contentsScale:2]);
+  [self imageFromCache:cache attributes:c size:size rendererCalls:&rendererCalls];
+
+  XCTAssertNotNil([cache imageForAttributes:a constrainedSize:size contentsScale:2]);
+  XCTAssertNil([cache imageForAttributes:b constrainedSize:size contentsScale:2]);
+  XCTAssertNotNil([cache imageForAttributes:c constrainedSize:size contentsScale:2]);
+  XCTAssertEqual([cache metrics].evictionCount, 1);
+  XCTAssertLessThanOrEqual([cache metrics].byteCount, cache.byteLimit);
+}
+
+- (void)testLoweringByteLimitEvictsAndUnboundedSizesAreNotCached
+{
+  ASTextKitRasterCache *cache = [[ASTextKitRasterCache alloc] initWithByteLimit:1024 * 1024];
+  NSUInteger rendererCalls = 0;
+  ASTextKitAttributes attributes = attributesWithString(@"Hello");
+  [self imageFromCache:cache attributes:attributes size:CGSizeMake(100, 20) rendererCalls:&rendererCalls];
+
+  cache.byteLimit = 0;
+  XCTAssertEqual([cache metrics].imageCount, 0);
+  XCTAssertEqual([cache metrics].byteCount, 0);
+
+  cache.byteLimit = 1024 * 1024;
+  XCTAssertNil([self imageFromCache:cache attributes:attributes size:CGSizeMake(100, INFINITY) rendererCalls:&rendererCalls]);
+  XCTAssertEqual(rendererCalls, 1);
+}
+
+@end
@@ -0,0 +1,177 @@
+//
+//  ASTraceBufferTests.m
+//  AsyncDisplayKit
+//
+//  Copyright (c) 2014-present, Facebook, Inc.  All rights reserved.
+//  This source code is licensed under the BSD-style license found in the
+//  LICENSE file in the root directory of this source tree. An additional grant
+//  of patent rights can be found in the PATENTS file in the same directory.
+//
+
+#import <XCTest/XCTest.h>
+#import <pthread.h>
+
+#import <AsyncDisplayKit/ASTraceBuffer.h>
+#import <AsyncDisplayKit/ASDisplayNode.h>
+
+@interface ASTraceTestNode : ASDisplayNode
+@end
+
+@implementation ASTraceTestNode
+@end
+
+@interface ASTraceBufferTests : XCTestCase
+@end
+
+@implementation ASTraceBufferTests
+
+- (void)setUp
+{
+  [super setUp];
+  ASTraceBuffer.enabled = YES;
+  [ASTraceBuffer clear];
+}
+
+- (void)tearDown
+{
+  ASTraceBuffer.enabled = NO;
+  [ASTraceBuffer clear];
+  [super tearDown];
+}
+
+/**
+ * Exports the buffers, checking that the export is valid JSON, and returns the begin and end events.
+ */
+- (NSArray<NSDictionary *> *)exportedSpanEvents
+{
+  NSError *error = nil;
+  NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[ASTraceBuffer chromeTraceData] options:0 error:&error];
+  XCTAssertNil(error);
+  XCTAssertTrue([trace[@"traceEvents"] isKindOfClass:[NSArray class]]);
+  return [trace[@"traceEvents"] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"ph IN {'B', 'E'}"]];
+}
+
+- (void)testThatSpansAreExported
+{
+  ASTraceBufferBeginSpan(ASTraceSpanRangeUpdate, Nil);
+  ASTraceBufferBeginSpan(ASTraceSpanLayout, [ASTraceTestNode class]);
+  ASTraceBufferEndSpan(ASTraceSpanLayout, [ASTraceTestNode class]);
+  ASTraceBufferEndSpan(ASTraceSpanRangeUpdate, Nil);
+
+  NSArray<NSDictionary *> *events = [self exportedSpanEvents];
+  XCTAssertEqual(events.count, 4);
+  XCTAssertEqualObjects([events valueForKey:@"ph"], (@[ @"B", @"B", @"E", @"E" ]));
+  XCTAssertEqualObjects([events valueForKey:@"name"], (@[ @"rangeUpdate", @"ASTraceTestNode", @"ASTraceTestNode", @"rangeUpdate" ]));
+  XCTAssertEqualObjects([events valueForKey:@"cat"], (@[ @"rangeUpdate", @"layout", @"layout", @"rangeUpdate" ]));
+  XCTAssertEqualObjects(events[0][@"pid"], @(getpid()));
+  XCTAssertEqualObjects(events[0][@"tid"], events[3][@"tid"]);
+  XCTAssertLessThanOrEqual([events[0][@"ts"] doubleValue], [events[3][@"ts"] doubleValue]);
+}
+
+- (void)testThatEndsWithoutBeginningsAreDropped
+{
+  ASTraceBufferEndSpan(ASTraceSpanDisplay, Nil);
+  ASTraceBufferBeginSpan(ASTraceSpanDisplay, Nil);
+  XCTAssertEqualObjects([[self exportedSpanEvents] valueForKey:@"ph"], (@[ @"B" ]));
+}
+
+- (void)testThatBuffersKeepTheLatestEvents
+{
+  for (NSInteger i = 0; i < 3000; i++) {
+    ASTraceBufferBeginSpan(ASTraceSpanDisplay, Nil);
+    ASTraceBufferEndSpan(ASTraceSpanDisplay, Nil);
+  }
+  // The oldest events may be left out, as if they were being overwritten during the export.
+  NSArray<NSDictionary *> *events = [self exportedSpanEvents];
+  XCTAssertGreaterThan(events.count, 4000);
+  XCTAssertLessThanOrEqual(events.count, 4096);
+  XCTAssertEqualObjects(events.firstObject[@"ph"], @"B");
+  XCTAssertEqualObjects(events.lastObject[@"ph"], @"E");
+}
+
+- (void)testThatNothingIsRecordedWhenDisabled
+{
+  ASTraceBuffer.enabled = NO;
+  ASTraceBufferBeginSpan(ASTraceSpanLayout, Nil);
+  ASTraceBufferEndSpan(ASTraceSpanLayout, Nil);
+  XCTAssertEqual([self exportedSpanEvents].count, 0);
+}
+
+- (void)testThatSpansInProgressEndAfterDisabling
+{
+  ASTraceBufferBeginSpan(ASTraceSpanPendingStateFlush, Nil);
+  ASTraceBuffer.enabled = NO;
+  ASTraceBufferEndSpan(ASTraceSpanPendingStateFlush, Nil);
+  XCTAssertEqualObjects([[self exportedSpanEvents] valueForKey:@"ph"], (@[ @"B", @"E" ]));
+}
+
+- (void)testThatEventsOfAllThreadsAreExported
+{
+  dispatch_apply(4, dispatch_get_global_queue(QOS_CLASS_USER_INITIATED, 0), ^(size_t i) {
+    ASTraceBufferBeginSpan(ASTraceSpanDisplay, Nil);
+    ASTraceBufferEndSpan(ASTraceSpanDisplay, Nil);
+  });
+
+  // Threads that exit keep their events.
+  dispatch_semaphore_t semaphore = dispatch_semaphore_create(0);
+  __block NSNumber *exitedThreadID = nil;
+  [NSThread detachNewThreadWithBlock:^{
+    [NSThread currentThread].name = @"ASTraceBufferTests";
+    ASTraceBufferBeginSpan(ASTraceSpanDataControllerAllocateNodes, Nil);
+    ASTraceBufferEndSpan(ASTraceSpanDataControllerAllocateNodes, Nil);
+    uint64_t threadID;
+    pthread_threadid_np(NULL, &threadID);
+    exitedThreadID = @(threadID);
+    dispatch_semaphore_signal(semaphore);
+  }];
+  dispatch_semaphore_wait(semaphore, DISPATCH_TIME_FOREVER);
+  // Give the thread time to exit.
+  [NSThread sleepForTimeInterval:0.1];
+
+  XCTAssertEqual([[self exportedSpanEvents] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"cat == 'display'"]].count, 8);
+  NSDictionary *trace = [NSJSONSerialization JSONObjectWithData:[ASTraceBuffer chromeTraceData] options:0 error:NULL];
+  NSArray<NSDictionary *> *exitedThreadEvents = [trace[@"traceEvents"] filteredArrayUsingPredicate:[NSPredicate predicateWithFormat:@"tid == %@", exitedThreadID]];
+  XCTAssertEqual(exitedThreadEvents.count, 3);
+  XCTAssertEqualObjects(exitedThreadEvents[0][@"ph"], @"M");
+  XCTAssertEqualObjects(exitedThreadEvents[0][@"args"][@"name"], @"ASTraceBufferTests");
+}
+
+- (void)testThatNodesRecordLayoutSpans
+{
+  ASTraceTestNode *node = [[ASTraceTestNode alloc] init];
+  node.style.preferredSize = CGSizeMake(50, 50);
+  (void)[node layoutThatFits:ASSizeRangeMake(CGSizeZero, CGSizeMake(100, 100))];
+
+  NSArray<NSDictionary *> *events = [self exportedSpanEvents];
+  XCTAssertGreaterThanOrEqual(events.count, 2);
+  XCTAssertEqualObjects(events[0][@"name"], @"ASTraceTestNode");
+  XCTAssertEqualObjects(events[0][@"cat"], @"layout");
+}
+
+#pragma mark - Benchmarks
+
+- (void)testPerformanceOfRecordingSpans
+{
+  [self measureBlock:^{
+    for (NSInteger i = 0; i < 100000; i++) {
+      ASTraceBufferBeginSpan(ASTraceSpanLayout, Nil);
+      ASTraceBufferEndSpan(ASTraceSpanLayout, Nil);
+    }
+  }];
+}
+
+- (void)testPerformanceOfRecordingSpansWhenDisabled
+{
+  ASTraceBuffer.enabled = NO;
+  // Like ASDN::TraceScope, skip the end of spans that didn't begin.
+  [self measureBlock:^{
+    for (NSInteger i = 0; i < 100000; i++) {
+      if (ASTraceBufferIsEnabled()) {
+        ASTraceBufferBeginSpan(ASTraceSpanLayout, Nil);
+        ASTraceBufferEndSpan(ASTraceSpanLayout, Nil);
+      }
+    }
+  }];
+}
+
+@end